@@ -44,110 +44,28 @@
  
  * ## Application Design
  *
- * support functions:
+ * the tables of the application:
  *
- * - app_init
- *   initializes the stack values.
- * - register_resources
- *   function that registers all endpoints,
- *   e.g. sets the GET/PUT/POST/DELETE
- *      handlers for each end point
+ * - g_datapoints, g_parameters
+ *   the data points and parameters, with their resources and global variables
+ * - g_url_index
+ *   the url lookup index
+ * - g_datapoint_types
+ *   the descriptors of the DPTs of the application
+ * - g_app_info
+ *   the device information, app_init_screen sets up the eink screen
  *
- * - main
- *   starts the stack, with the registered resources.
- *   can be compiled out with NO_MAIN
- *
- *  handlers for the implemented methods (get/put):
- *   - get_[path]
- *     function that is being called when a GET is called on [path]
- *     set the global variables in the output
- *   - put_[path]
- *     function that is being called when a PUT is called on [path]
- *     if input data is of the correct type
- *       updates the global variables
- *
- * ## stack specific defines
- * - __linux__
- *   build for Linux
- * - WIN32
- *   build for Windows
- * - OC_OSCORE
- *   oscore is enabled as compile flag
- * ## File specific defines
- * - NO_MAIN
- *   compile out the function main()
- * - INCLUDE_EXTERNAL
- *   includes header file "external_header.h", so that other tools/dependencies
- *   can be included without changing this code
- * - KNX_GUI
- *   build the GUI with console option, so that all
- *   logging can be seen in the command window
+ * The handlers, the codecs, app_init, register_resources and main are
+ * implemented by the shared runtime, see knx_iot_runtime.c
  */
 #include "oc_api.h"
-#include "oc_core_res.h"
-#include "oc_rep.h"
-#include "oc_helpers.h"
-#include "api/oc_knx_fp.h"
-#include "port/oc_clock.h"
-#include <signal.h>
-/* test purpose only; commandline reset */
-#include "api/oc_knx_dev.h"
-#ifdef OC_SPAKE
-#include "security/oc_spake2plus.h"
-#endif
-#ifdef INCLUDE_EXTERNAL
-/* import external definitions from header file*/
-/* this file should be externally supplied */
-#include "external_header.h"
-#endif
 #include "knx_eink_battleships.h"
-
-#include <stdlib.h>
-#include <ctype.h>
-
-#ifdef __linux__
-/** linux specific code */
-#include <pthread.h>
-#ifndef NO_MAIN
-static pthread_mutex_t mutex;
-static pthread_cond_t cv;
-static struct timespec ts;
-#endif /* NO_MAIN */
-#endif
-
-#include <stdio.h> /* defines FILENAME_MAX */
-#include <string.h>
-#include <stdbool.h>
-#include <ctype.h>
-#define STORE_PREFIX "app"
-
-#define MY_NAME "KNX Battleships Demo" /**< The name of the application */
-#define APP_MAX_STRING 30
-
-#ifdef WIN32
-/** windows specific code */
-#include <windows.h>
-static CONDITION_VARIABLE cv; /**< event loop variable */
-static CRITICAL_SECTION cs;   /**< event loop variable */
-#include <direct.h>
-#define GetCurrentDir _getcwd
-#else
-#include <unistd.h>
-#define GetCurrentDir getcwd
+#ifdef APP_BENCH
+#include "knx_eink_battleships_bench.h"
 #endif
 
-#ifdef HARDWARE_INIT
- void hardware_init(void);
-#endif /* hardware init */
-
-#define btoa(x) ((x) ? "true" : "false")
-volatile int quit = 0;  /**< stop variable, used by handle_signal */
-bool g_reset = false;   /**< reset variable, set by commandline arguments */
 char g_serial_number[20] = "00fa10010713";
 
-
-
-
 volatile DPT_Uint_XY gSendShot;   /**< global variable for SendShot */
 volatile DPT_Uint_XY gReceiveShot;   /**< global variable for ReceiveShot */
 volatile DPT_Shot_Status gSendShotStatus;   /**< global variable for SendShotStatus */
@@ -425,2873 +343,145 @@ _Pragma("warning(default:4090)")
 _Pragma("GCC diagnostic pop")
 #endif
 
-typedef const void* (*app_get_variable_fn)(const char*, void*);
-typedef const void* (*app_get_array_fn)(const char*, void*, int);
-typedef const void* (*app_get_array_elems_fn)(const char*, void*, int start, int n);
-typedef void (*app_set_default_value_fn)(const char*);
-typedef void (*app_set_variable_fn)(const char*, const void*);
-typedef void (*app_set_array_fn)(const char*, const void*, int n, bool store_persistently);
-typedef void (*app_set_array_elems_fn)(const char*, const void*, int start, int n, bool store_persistently);
-typedef void (*oc_encode_fn)(const void*, bool is_metadata);
-typedef void (*oc_encode_array_fn)(const void*, int n);
-typedef void (*oc_encode_array_fn)(const void*, int n);
-typedef bool (*oc_parse_fn)(oc_rep_t *rep, void *out);
-typedef bool (*oc_parse_array_fn)(oc_rep_t *rep, void *out, int n);
-typedef bool (*persistent_load_fn)(const char *filename, void *out);
-typedef bool (*persistent_load_array_fn)(const char *filename, void *out, int n);
-
-struct datapoint_type_t {
-  size_t size;
-  app_get_variable_fn app_get_variable;
-  app_get_array_fn app_get_array;
-  app_get_array_elems_fn app_get_array_elems;
-  app_set_default_value_fn app_set_default_value;
-  app_set_variable_fn app_set_variable;
-  app_set_array_fn app_set_array;
-  app_set_array_elems_fn app_set_array_elems;
-  oc_encode_fn oc_encode;
-  oc_encode_array_fn oc_encode_array;
-  oc_parse_fn oc_parse;
-  oc_parse_array_fn oc_parse_array;
-  persistent_load_fn persistent_load;
-  persistent_load_array_fn persistent_load_array;
+/**
+ * @brief url lookup index, covering datapoints (/p/o) and parameters (/p/p)
+ *
+ * sorted on the suffix (strcmp order), so that a binary search can be used
+ */
+const url_index_entry_t g_url_index[] = {
+  { "o_1_1", &g_datapoints[0] },
+  { "o_1_2", &g_datapoints[1] },
+  { "o_1_3", &g_datapoints[2] },
+  { "o_1_4", &g_datapoints[3] },
+  { "o_1_5", &g_datapoints[4] },
+  { "o_1_6", &g_datapoints[5] },
+  { "p_1_1", &g_parameters[0] },
 };
+const size_t g_url_index_size =
+  sizeof(g_url_index) / sizeof(g_url_index[0]);
 
-const struct datapoint_type_t g_datapoint_types[DatapointType_MAX_NUM] = {
-  {sizeof(bool)},
-  {sizeof(int)},
-  {sizeof(float)},
-  {sizeof(char*)},
-  {
-    sizeof(DPT_Param_Bool),   // DPT_Param_Bool DPT_Param_Bool
-    (app_get_variable_fn)app_get_DPT_Param_Bool_variable,
-    (app_get_array_fn)app_get_DPT_Param_Bool_array,
-    (app_get_array_elems_fn)app_get_DPT_Param_Bool_array_elems,
-    (app_set_default_value_fn)app_set_DPT_Param_Bool_default_value,
-    (app_set_variable_fn)app_set_DPT_Param_Bool_variable,
-    (app_set_array_fn)app_set_DPT_Param_Bool_array,
-    (app_set_array_elems_fn)app_set_DPT_Param_Bool_array_elems,
-    (oc_encode_fn)oc_encode_DPT_Param_Bool,
-    (oc_encode_array_fn)oc_encode_DPT_Param_Bool_array,
-    (oc_parse_fn)oc_parse_DPT_Param_Bool,
-    (oc_parse_array_fn)oc_parse_DPT_Param_Bool_array,
-    (persistent_load_fn)persistent_load_DPT_Param_Bool,
-    (persistent_load_array_fn)persistent_load_DPT_Param_Bool_array,
-  },
-  {
-    sizeof(DPT_Shot_Status),   // DPT_Shot_Status DPT_Shot_Status
-    (app_get_variable_fn)app_get_DPT_Shot_Status_variable,
-    (app_get_array_fn)app_get_DPT_Shot_Status_array,
-    (app_get_array_elems_fn)app_get_DPT_Shot_Status_array_elems,
-    (app_set_default_value_fn)app_set_DPT_Shot_Status_default_value,
-    (app_set_variable_fn)app_set_DPT_Shot_Status_variable,
-    (app_set_array_fn)app_set_DPT_Shot_Status_array,
-    (app_set_array_elems_fn)app_set_DPT_Shot_Status_array_elems,
-    (oc_encode_fn)oc_encode_DPT_Shot_Status,
-    (oc_encode_array_fn)oc_encode_DPT_Shot_Status_array,
-    (oc_parse_fn)oc_parse_DPT_Shot_Status,
-    (oc_parse_array_fn)oc_parse_DPT_Shot_Status_array,
-    (persistent_load_fn)persistent_load_DPT_Shot_Status,
-    (persistent_load_array_fn)persistent_load_DPT_Shot_Status_array,
-  },
-  {
-    sizeof(DPT_Start),   // DPT_Start DPT_Start
-    (app_get_variable_fn)app_get_DPT_Start_variable,
-    (app_get_array_fn)app_get_DPT_Start_array,
-    (app_get_array_elems_fn)app_get_DPT_Start_array_elems,
-    (app_set_default_value_fn)app_set_DPT_Start_default_value,
-    (app_set_variable_fn)app_set_DPT_Start_variable,
-    (app_set_array_fn)app_set_DPT_Start_array,
-    (app_set_array_elems_fn)app_set_DPT_Start_array_elems,
-    (oc_encode_fn)oc_encode_DPT_Start,
-    (oc_encode_array_fn)oc_encode_DPT_Start_array,
-    (oc_parse_fn)oc_parse_DPT_Start,
-    (oc_parse_array_fn)oc_parse_DPT_Start_array,
-    (persistent_load_fn)persistent_load_DPT_Start,
-    (persistent_load_array_fn)persistent_load_DPT_Start_array,
-  },
-  {
-    sizeof(DPT_Uint_XY),   // DPT_Uint_XY DPT_Uint_XY
-    (app_get_variable_fn)app_get_DPT_Uint_XY_variable,
-    (app_get_array_fn)app_get_DPT_Uint_XY_array,
-    (app_get_array_elems_fn)app_get_DPT_Uint_XY_array_elems,
-    (app_set_default_value_fn)app_set_DPT_Uint_XY_default_value,
-    (app_set_variable_fn)app_set_DPT_Uint_XY_variable,
-    (app_set_array_fn)app_set_DPT_Uint_XY_array,
-    (app_set_array_elems_fn)app_set_DPT_Uint_XY_array_elems,
-    (oc_encode_fn)oc_encode_DPT_Uint_XY,
-    (oc_encode_array_fn)oc_encode_DPT_Uint_XY_array,
-    (oc_parse_fn)oc_parse_DPT_Uint_XY,
-    (oc_parse_array_fn)oc_parse_DPT_Uint_XY_array,
-    (persistent_load_fn)persistent_load_DPT_Uint_XY,
-    (persistent_load_array_fn)persistent_load_DPT_Uint_XY_array,
-  }, 
+/**
+ * @brief scratch area for the value of a single GET or PUT request
+ *
+ * sized for the largest data point (num_elements * size of the type),
+ * so that the request path does not need any heap allocations
+ */
+typedef union dp_scratch_t
+{
+  DPT_Uint_XY v_DPT_Uint_XY[1];
+  DPT_Shot_Status v_DPT_Shot_Status[1];
+  DPT_Start v_DPT_Start[1];
+  DPT_Param_Bool v_DPT_Param_Bool[1];
+  uint64_t align;
+} dp_scratch_t;
+static dp_scratch_t g_get_scratch; /**< scratch area used by oc_encode_datapoint */
+static dp_scratch_t g_put_scratch; /**< scratch area used by put_generic */
+const app_scratch_t g_dp_scratch = { &g_get_scratch, &g_put_scratch, sizeof(dp_scratch_t) };
+
+/* the fields of the DPTs, in encoding order */
+static const dpt_field_t fDPT_Param_Bool[] = { DPT_SCALAR(DPT_Param_Bool, DPT_FIELD_INT) };
+static const dpt_field_t fDPT_Shot_Status[] = {
+  DPT_FIELD(DPT_Shot_Status, DPST_60004_1_F_1, DPT_FIELD_BOOL),
+  DPT_FIELD(DPT_Shot_Status, DPST_60004_1_F_2, DPT_FIELD_BOOL),
+  DPT_FIELD(DPT_Shot_Status, DPST_60004_1_F_3, DPT_FIELD_INT),
+};
+static const dpt_field_t fDPT_Start[] = { DPT_SCALAR(DPT_Start, DPT_FIELD_BOOL) };
+static const dpt_field_t fDPT_Uint_XY[] = {
+  DPT_FIELD(DPT_Uint_XY, DPST_60009_1_F_1, DPT_FIELD_UINT),
+  DPT_FIELD(DPT_Uint_XY, DPST_60009_1_F_2, DPT_FIELD_UINT),
 };
 
-size_t get_dpt_size(DatapointType t) {
-  return g_datapoint_types[t].size;
-}
-
-static const char *get_datapoint_name(const datapoint_t *dp) {
-  return oc_string(dp->resource.name);
-}
-
-static const char *get_datapoint_url(const datapoint_t *dp) {
-  return oc_string(dp->resource.uri);
-}
-
-static const char *get_datapoint_dpt(const datapoint_t *dp) {
-  return oc_string(dp->resource.dpt);
-}
-
-static const char *get_datapoint_dpa(const datapoint_t *dp) {
-  for (int i = 0; i < oc_string_array_size(dp->resource.types); i++) {
-    const char *rt = oc_string_array(dp->resource.types)[i];
-    if (strstr(rt, "dpa.") != NULL)
-      return rt;
-  }
-  return NULL;
-}
-
-static const char *const *get_datapoint_metadata(const datapoint_t *dp) {
-  return dp->metadata;
-}
-
-static bool oc_encode_datapoint(const datapoint_t *dp, int pn, int ps, bool is_metadata) {
-  size_t count = dp->num_elements;
-  const struct datapoint_type_t *dpt = &g_datapoint_types[dp->type];
-  int n = ps;
-  count = count?count:1;
-  if (pn*ps+n >= count)
-    n = count-pn*ps;
-  if (ps > 1 && dpt->oc_encode_array == NULL)
-    return false;
-  if (ps == 1 && dpt->oc_encode == NULL)
-    return false;
-  if (dpt->app_get_array_elems == NULL)
-    return false;
-  void *var = malloc(get_dpt_size(dp->type) * (ps));
-  if(g_datapoint_types[dp->type].app_get_array_elems(get_datapoint_url(dp), var, pn*ps, n) == NULL) {
-    free(var);
-    return false;
-  }
-  
-  if (ps > 1) 
-    g_datapoint_types[dp->type].oc_encode_array(var, n);
-  else 
-    g_datapoint_types[dp->type].oc_encode(var, is_metadata);
-  
-  free(var);
-  return true;
-}
-
-static bool oc_parse_datapoint(const datapoint_t *dp, oc_rep_t *rep, void *out, int n) {
-  const struct datapoint_type_t *dpt = &g_datapoint_types[dp->type];
-  if (out == NULL || rep == NULL)
-    return false;
-  if (n > 1){
-    if (dpt->oc_parse_array == NULL)
-      return false;
-    return dpt->oc_parse_array(rep, out, n);
-  }
-  else{
-    if (dpt->oc_parse == NULL)
-      return false;
-    return dpt->oc_parse(rep, out);
-  } 
-}
-
-void datapoint_set(const datapoint_t *dp, void *in, int start, int n) 
-{
-  if (in == NULL)
-    return;
-  if (start > 0 || n > 1){
-    if (g_datapoint_types[dp->type].app_set_array)
-      g_datapoint_types[dp->type].app_set_array_elems(get_datapoint_url(dp), in, start, n, true);
-  }
-  else
-    if (g_datapoint_types[dp->type].app_set_variable)
-      g_datapoint_types[dp->type].app_set_variable(get_datapoint_url(dp), in);
-}
-
-const datapoint_t *get_datapoint_by_url(const char *url) {
-  //this can likely be optimised in the future for speed
-  //with a binary search or similar
-  
-  bool is_param = false;
-  if (strncmp(url,"/p/p",4) == 0) {
-    is_param = true;
-  }
-  
-
-  if (is_param == false) {
-    for(int i = 0; i < num_datapoints; i++) {
-      const datapoint_t *it = &g_datapoints[i];
-      const char *_url = get_datapoint_url(it);
-      // it always start with /p/<url>
-      if (strcmp((char *)&_url[3], (char *)&url[3]) == 0) {
-        return it;
-      }
-    }
-  } 
-
-  for(int i = 0; i < num_parameters; i++) {
-    const datapoint_t *it = &g_parameters[i];
-    const char *_url = get_datapoint_url(it);
-    // it always start with /p/p<url>
-    if (strcmp((char*)&_url[4], (char*)&url[4]) == 0) {
-      return it;
-    }
-  } 
-  return NULL;
-}
-
-int app_get_url_array_size(const char *url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL)
-    return -1;
-  return dp->num_elements;
-}
-
-bool get_module_url(char* out_url, const char* in_url, int module_index)
-{
-  int digits_after_underscore = 0;
-  size_t url_length = strlen(in_url);
-  size_t keep_len;
-  char temp[50];
-      
-  // Find out how many more digits we have after the underscore
-  for (int i = url_length - 1; i >= 0; --i)
-  {
-      // We have reached the underscore, we can stop counting
-      if (*(in_url + i) == '_')
-          break; 
-          
-      // We have counted one more digit after the underscore
-      if (isdigit(*(in_url + i)))
-          ++digits_after_underscore;
-      else // We have encountered a non-digit and non-underscore, which is unexpected.
-          return true; 
-  }
-  
-  // We can now calculate the number of characters that we need to keep from the original URL
-  keep_len = url_length - digits_after_underscore;
-  
-  // Copy over those characters into a temp array
-  strncpy(temp, in_url, keep_len);
-  temp[keep_len] = '\0';
-  
-  // Add the module number at the end, and set the out_url pointer
-  sprintf(temp + strlen(temp), "%d", module_index);
-  strcpy(out_url, temp);
-  
-  return false;
-}
-
-// Getters/Setters for DPT_Param_Bool
-
-bool app_is_DPT_Param_Bool_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  
-  if (dp->type == DatapointType_DPT_Param_Bool) {
-    return true;
-  }
-  return false;
-}
-
-void app_set_DPT_Param_Bool_default_value(const char* url)
-{
-  (void)url;
-  // No default value, do nothing...
-}
-
-void app_set_DPT_Param_Bool_array_elems(const char* url, const DPT_Param_Bool* in, int start, int n, bool store_persistently)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return;
-  }
-  if (start+n > max_elem) {
-    n = max_elem-start;
-  }
-  if (dp->g_var) {
-    memcpy(&((DPT_Param_Bool*)dp->g_var)[start], in, sizeof(DPT_Param_Bool)*n);
-    if (dp->persistent && store_persistently) {
-      persistent_store_DPT_Param_Bool_array(get_datapoint_url(dp), (DPT_Param_Bool*)dp->g_var, max_elem);
-    }
-  }else if (dp->persistent && store_persistently) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Param_Bool *data = calloc(sizeof(DPT_Param_Bool), count);
-    memcpy(&data[start], in, n*sizeof(DPT_Param_Bool));
-    persistent_store_DPT_Param_Bool_array(get_datapoint_url(dp), data, count);
-    free(data);
-  }
-  return;
-}
-
-void app_set_DPT_Param_Bool_array(const char* url, const DPT_Param_Bool* in, int n, bool store_persistently)
-{
-  app_set_DPT_Param_Bool_array_elems(url, in, 0, n, store_persistently);
-}
-
-void app_set_DPT_Param_Bool_variable(const char* url, const DPT_Param_Bool* in)
-{
-  app_set_DPT_Param_Bool_array(url, in, 1, true);
-}
-
-const DPT_Param_Bool* app_get_DPT_Param_Bool_array_elems(const char *url, DPT_Param_Bool* out, int start, int n)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return NULL;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return NULL;
-  }
-  if (start+n > max_elem){
-    n = max_elem - start;
-  }
-  if (dp->g_var) {
-    if (out == NULL) {
-      return dp->g_var;
-    }
-    memcpy(out, &((DPT_Param_Bool*)dp->g_var)[start], sizeof(DPT_Param_Bool)*n);
-    return out;
-  }else if (dp->persistent && out) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Param_Bool *data = calloc(sizeof(DPT_Param_Bool), count);
-    memset(out, 0, n*sizeof(DPT_Param_Bool));
-    if (persistent_load_DPT_Param_Bool_array(get_datapoint_url(dp), data, count)) {
-      memcpy(out, &data[start], n*sizeof(DPT_Param_Bool));
-    }
-    free(data);
-    return out;
-  }
-  return NULL;
-}
-
-const DPT_Param_Bool* app_get_DPT_Param_Bool_array(const char *url, DPT_Param_Bool* out, int n)
-{
-  return app_get_DPT_Param_Bool_array_elems(url, out, 0, n);
-}
-
-const DPT_Param_Bool* app_get_DPT_Param_Bool_variable(const char *url, DPT_Param_Bool* out)
-{
-  return app_get_DPT_Param_Bool_array(url, out, 1);
-}
-
-bool oc_parse_DPT_Param_Bool_single(oc_rep_t *rep, DPT_Param_Bool *out)
-{
-  oc_array_t arr;
-// ('Enumeration', OrderedDict([('@Id', 'DPST-60012-3_F-1'), ('@Name', 'ValueBool'), ('@Width', '8'), ('EnumValue', [OrderedDict([('@Id', 'DPST-60012-3_F-1-1'), ('@Value', '0'), ('@Text', 'False')]), OrderedDict([('@Id', 'DPST-60012-3_F-1-2'), ('@Value', '1'), ('@Text', 'True')])])]))
-  if (rep->type != OC_REP_INT) return false;
-  int64_t temp = 0;
-  int64_t *out_temp;
-  out_temp = &temp;
-  bool ret = oc_rep_i_get_int(rep, 1, out_temp);
-  DPT_Param_Bool temp2 = (DPT_Param_Bool)*out_temp;
-  *out = temp2;
-  
-  
-  return ret;
-}
-
-bool oc_parse_DPT_Param_Bool(oc_rep_t *rep, DPT_Param_Bool *out)
-{
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && rep->iname != 1) {
-    rep = rep->next;
-  }
-  if (rep == NULL) {
-    return false;
-  }
-  return oc_parse_DPT_Param_Bool_single(rep, out);
-}
-
-bool oc_parse_DPT_Param_Bool_array(oc_rep_t *rep, DPT_Param_Bool *out, int n)
-{
-  oc_rep_t *rep_arr;
-  int i = 0;
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && i < n){
-    if (rep->type != OC_REP_OBJECT) {
-      return false;
-    }
-    oc_parse_DPT_Param_Bool(rep->value.object, &out[i]);
-    rep = rep->next;
-    i++;
-  }
-  return true;
-}
-
-void oc_encode_DPT_Param_Bool_single(CborEncoder *parent, const DPT_Param_Bool *in)
+/* the specialised codecs of the DPTs, with APP_DPT_FUNCTION_TABLE */
+DPT_SCALAR_CODECS(DPT_Param_Bool, INT)
+DPT_SCALAR_CODECS(DPT_Start, BOOL)
+#if APP_DPT_FUNCTION_TABLE
+/* 1: [[hit, sunk], ship type] */
+static void dpt_encode_DPT_Shot_Status(CborEncoder *parent, const void *in)
 {
-  if (in == NULL) {
-    return;
-  }
+  const DPT_Shot_Status *v = in;
   oc_rep_i_set_key(parent, 1);
-  cbor_encode_int(parent, (int64_t)*in);
-}
-
-void oc_encode_DPT_Param_Bool(const DPT_Param_Bool *in, bool is_metadata)
-{
-  if (in == NULL) {
-    return;
-  }
-  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
-    oc_rep_begin_root_object();
-  }
-  oc_encode_DPT_Param_Bool_single(oc_rep_object(root), in);
-  if (!is_metadata) {
-    oc_rep_end_root_object();
-  }
-}
-
-void oc_encode_DPT_Param_Bool_array(const DPT_Param_Bool *in, int n)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_begin_links_array();
-  for (int i = 0; i < n; i++) {
-    oc_rep_begin_object(oc_rep_array(links), obj);
-    oc_encode_DPT_Param_Bool_single(oc_rep_object(obj), &in[i]);
-    oc_rep_end_object(oc_rep_array(links), obj);
-  }
-  oc_rep_end_links_array();
-}
-
-void persistent_store_DPT_Param_Bool(const char *name, const DPT_Param_Bool *in)
-{
-  persistent_store_DPT_Param_Bool_array(name, in, 1);
-}
-
-void persistent_store_DPT_Param_Bool_array(const char *name, const DPT_Param_Bool *in, int n)
-{
-  uint8_t *rep_buf;
-  long ret;
-  const size_t max_size = 8 * n + 2;
-  rep_buf = malloc(max_size);
-#ifdef OPTIMIZE_STORAGE
-// use input as storage name with "/p/" prefix removed
- const char* store_name = (char *)&name[3];
-#else
-    char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/');
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-
-  oc_rep_new(rep_buf, max_size);
-  oc_encode_DPT_Param_Bool_array(in, n);
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    PRINT_APP("storing '%s', size: %d\n", name, size);
-    for(int i = 0; i < size; i++) {
-      PRINT_APP("%02X ", rep_buf[i]);
-    }
-    PRINT_APP("\n");
-    ret = oc_storage_write(store_name, rep_buf, size);
-  }else{
-    PRINT_APP("Error encoding DPT_Param_Bool %s for storage\n", name);
-  }
-
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_write failed with error: %d\n", -ret);
-  }
-  free(rep_buf);
-}
-
-bool persistent_load_DPT_Param_Bool(const char *name, DPT_Param_Bool *out)
-{
-  return persistent_load_DPT_Param_Bool_array(name, out, 1);
-}
-
-bool persistent_load_DPT_Param_Bool_array(const char *name, DPT_Param_Bool *out, int n)
-{
-  oc_rep_t *rep = NULL;
-  int max_size = 8 * n + 2;
-  uint8_t *oc_storage_buf;
-#ifdef OPTIMIZE_STORAGE
- // use input as storage name with "/p/" prefix removed
-  const char* store_name = (char *)&name[3];
-#else
-  char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/'); 
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-  long ret;
-  bool error = true;
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-  oc_storage_buf = malloc(max_size);
-  struct oc_memb *prev_rep_obj = oc_rep_get_pool();
-  oc_rep_set_pool(&rep_objects);
-
-  ret = oc_storage_read(store_name, oc_storage_buf, max_size);
-  PRINT_APP("oc_storage_read() returned %d\n", ret);
-  for(int i = 0; i < ret; i++) {
-    PRINT_APP("%02X ", oc_storage_buf[i]);
-  }
-  PRINT_APP("\n");
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_read failed with error: %d\n", -ret);
-    goto err;
-  }
-  if (oc_parse_rep(oc_storage_buf, ret, &rep) != CborNoError) {
-    goto err;
-  }
-  if (oc_parse_DPT_Param_Bool_array(rep, out, n) != true) {
-    goto err;
-  }
-  error = false;
-err:
-  free(oc_storage_buf);
-  oc_free_rep(rep);
-  if(error) {
-    oc_storage_erase(name);
-  }
-  oc_rep_set_pool(prev_rep_obj);
-  return !error;
-}
-
-int app_sprintf_DPT_Param_Bool(const DPT_Param_Bool *in, char* text, int size)
-{
-  char item[50];
-  memset(text, 0, size);
-  if (in == NULL) {
-    return 1;
-  }
-  sprintf(item," %d ", *in);
-  strcat(text, item);
-
-  return 0;
-}
-
-int app_sscanf_DPT_Param_Bool(DPT_Param_Bool *in, char* text)
-{
-  char temp_string[300];
-  const char s[2] = " ";
-  char *token;
-  
-  if (text == NULL) {
-    return 1;
-  }
-  memset(temp_string, 0, 300);
-  strncpy(temp_string, text, 299);
-  int retval = 0;
-
-  // strtok is destructing the input string so copy it first
-  token = strtok(temp_string, s);
-  // Enumeration
-  retval = sscanf(token, " %d", in);
-  if (retval != 1) return 1;
-  token = strtok(NULL, s);
-
-  return 0;
-}
-
-int app_str_expected_DPT_Param_Bool(int select, char* text)
-{
-  if (text == NULL) {
-    return 1;
-  }
-  if (select == 1) {
-  // Enumeration
-    strcat(text, " %d");
-    return 0;
-  }
-  
-  if (select == 2) {
-    strcat(text, " 0");
-    return 0;
-  }
-  
-  return 1;
+  oc_rep_begin_array(parent, value);
+  oc_rep_begin_array(oc_rep_array(value), bools);
+  g_err |= cbor_encode_boolean(oc_rep_array(bools), v->Hit);
+  g_err |= cbor_encode_boolean(oc_rep_array(bools), v->Sunk);
+  oc_rep_end_array(oc_rep_array(value), bools);
+  g_err |= cbor_encode_int(oc_rep_array(value), v->ShipType);
+  oc_rep_end_array(parent, value);
 }
 
-
-
-// Getters/Setters for DPT_Shot_Status
-
-bool app_is_DPT_Shot_Status_url(const char* url)
+static bool dpt_parse_DPT_Shot_Status(const oc_rep_t *rep, void *out)
 {
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
+  DPT_Shot_Status *v = out;
+  const oc_rep_t *bools = rep->type == OC_REP_MIXED_ARRAY ? rep->value.mixed_array : NULL;
+  if (bools == NULL || bools->type != OC_REP_BOOL_ARRAY ||
+      oc_bool_array_size(bools->value.array) != 2 ||
+      bools->next == NULL || bools->next->type != OC_REP_INT) {
     return false;
   }
-  
-  if (dp->type == DatapointType_DPT_Shot_Status) {
-    return true;
-  }
-  return false;
-}
-
-void app_set_DPT_Shot_Status_default_value(const char* url)
-{
-  (void)url;
-  // No default value, do nothing...
-}
-
-void app_set_DPT_Shot_Status_array_elems(const char* url, const DPT_Shot_Status* in, int start, int n, bool store_persistently)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return;
-  }
-  if (start+n > max_elem) {
-    n = max_elem-start;
-  }
-  if (dp->g_var) {
-    memcpy(&((DPT_Shot_Status*)dp->g_var)[start], in, sizeof(DPT_Shot_Status)*n);
-    if (dp->persistent && store_persistently) {
-      persistent_store_DPT_Shot_Status_array(get_datapoint_url(dp), (DPT_Shot_Status*)dp->g_var, max_elem);
-    }
-  }else if (dp->persistent && store_persistently) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Shot_Status *data = calloc(sizeof(DPT_Shot_Status), count);
-    memcpy(&data[start], in, n*sizeof(DPT_Shot_Status));
-    persistent_store_DPT_Shot_Status_array(get_datapoint_url(dp), data, count);
-    free(data);
-  }
-  return;
-}
-
-void app_set_DPT_Shot_Status_array(const char* url, const DPT_Shot_Status* in, int n, bool store_persistently)
-{
-  app_set_DPT_Shot_Status_array_elems(url, in, 0, n, store_persistently);
-}
-
-void app_set_DPT_Shot_Status_variable(const char* url, const DPT_Shot_Status* in)
-{
-  app_set_DPT_Shot_Status_array(url, in, 1, true);
-}
-
-const DPT_Shot_Status* app_get_DPT_Shot_Status_array_elems(const char *url, DPT_Shot_Status* out, int start, int n)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return NULL;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return NULL;
-  }
-  if (start+n > max_elem){
-    n = max_elem - start;
-  }
-  if (dp->g_var) {
-    if (out == NULL) {
-      return dp->g_var;
-    }
-    memcpy(out, &((DPT_Shot_Status*)dp->g_var)[start], sizeof(DPT_Shot_Status)*n);
-    return out;
-  }else if (dp->persistent && out) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Shot_Status *data = calloc(sizeof(DPT_Shot_Status), count);
-    memset(out, 0, n*sizeof(DPT_Shot_Status));
-    if (persistent_load_DPT_Shot_Status_array(get_datapoint_url(dp), data, count)) {
-      memcpy(out, &data[start], n*sizeof(DPT_Shot_Status));
-    }
-    free(data);
-    return out;
-  }
-  return NULL;
-}
-
-const DPT_Shot_Status* app_get_DPT_Shot_Status_array(const char *url, DPT_Shot_Status* out, int n)
-{
-  return app_get_DPT_Shot_Status_array_elems(url, out, 0, n);
-}
-
-const DPT_Shot_Status* app_get_DPT_Shot_Status_variable(const char *url, DPT_Shot_Status* out)
-{
-  return app_get_DPT_Shot_Status_array(url, out, 1);
-}
-
-bool oc_parse_DPT_Shot_Status_single(oc_rep_t *rep, DPT_Shot_Status *out)
-{
-  oc_array_t arr;
-  if (rep->type != OC_REP_MIXED_ARRAY)
-    return false;
-  rep = rep->value.mixed_array;
-  if (rep == NULL) return false;
-  if (rep->type != OC_REP_BOOL_ARRAY)
-    return false;
-  arr = rep->value.array;
-  if (oc_bool_array_size(arr) < 2)
-    return false;
-  out->DPST_60004_1_F_1 = oc_bool_array(arr)[0];
-  out->DPST_60004_1_F_2 = oc_bool_array(arr)[1];
-  rep = rep->next;
-  if (rep == NULL) return false;
-  if (rep->type != OC_REP_INT) return false;
-  out->DPST_60004_1_F_3 = rep->value.integer;
+  v->Hit = oc_bool_array(bools->value.array)[0];
+  v->Sunk = oc_bool_array(bools->value.array)[1];
+  v->ShipType = (enum DPT_Shot_StatusShipType)bools->next->value.integer;
   return true;
 }
 
-bool oc_parse_DPT_Shot_Status(oc_rep_t *rep, DPT_Shot_Status *out)
+/* 1: [x, y] */
+static void dpt_encode_DPT_Uint_XY(CborEncoder *parent, const void *in)
 {
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && rep->iname != 1) {
-    rep = rep->next;
-  }
-  if (rep == NULL) {
-    return false;
-  }
-  return oc_parse_DPT_Shot_Status_single(rep, out);
+  const DPT_Uint_XY *v = in;
+  oc_rep_i_set_key(parent, 1);
+  oc_rep_begin_array(parent, value);
+  g_err |= cbor_encode_int(oc_rep_array(value), v->X);
+  g_err |= cbor_encode_int(oc_rep_array(value), v->Y);
+  oc_rep_end_array(parent, value);
 }
 
-bool oc_parse_DPT_Shot_Status_array(oc_rep_t *rep, DPT_Shot_Status *out, int n)
+static bool dpt_parse_DPT_Uint_XY(const oc_rep_t *rep, void *out)
 {
-  oc_rep_t *rep_arr;
-  int i = 0;
-  if (rep == NULL || out == NULL) {
+  DPT_Uint_XY *v = out;
+  if (rep->type != OC_REP_INT_ARRAY || oc_int_array_size(rep->value.array) != 2) {
     return false;
   }
-  while (rep != NULL && i < n){
-    if (rep->type != OC_REP_OBJECT) {
-      return false;
-    }
-    oc_parse_DPT_Shot_Status(rep->value.object, &out[i]);
-    rep = rep->next;
-    i++;
-  }
+  v->X = (unsigned int)oc_int_array(rep->value.array)[0];
+  v->Y = (unsigned int)oc_int_array(rep->value.array)[1];
   return true;
 }
+#endif /* APP_DPT_FUNCTION_TABLE */
 
-void oc_encode_DPT_Shot_Status_single(CborEncoder *parent, const DPT_Shot_Status *in)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_i_set_key(parent, 1);
-  oc_rep_begin_array(parent, arr);
-  oc_rep_begin_array(oc_rep_array(arr), bool);
-  oc_rep_add_boolean(bool, in->DPST_60004_1_F_1);
-  oc_rep_add_boolean(bool, in->DPST_60004_1_F_2);
-  oc_rep_end_array(oc_rep_array(arr), bool);
-  oc_rep_add_int(arr, in->DPST_60004_1_F_3);
-  oc_rep_end_array(parent, arr);
-}
+/**
+ * @brief the descriptors of the data types, indexed with DatapointType
+ */
+const struct datapoint_type_t g_datapoint_types[DatapointType_MAX_NUM] = {
+  DATAPOINT_TYPE_GENERIC_ROWS,
+  /* DPT_Param_Bool */ { sizeof(DPT_Param_Bool), fDPT_Param_Bool, 1, 0, NULL DPT_CODECS(DPT_Param_Bool) },
+  /* DPT_Shot_Status */ { sizeof(DPT_Shot_Status), fDPT_Shot_Status, 3, 2, NULL DPT_CODECS(DPT_Shot_Status) },
+  /* DPT_Start */ { sizeof(DPT_Start), fDPT_Start, 1, 0, NULL DPT_CODECS(DPT_Start) },
+  /* DPT_Uint_XY */ { sizeof(DPT_Uint_XY), fDPT_Uint_XY, 2, 0, NULL DPT_CODECS(DPT_Uint_XY) },
+};
+const size_t num_datapoint_types = DatapointType_MAX_NUM;
 
-void oc_encode_DPT_Shot_Status(const DPT_Shot_Status *in, bool is_metadata)
-{
-  if (in == NULL) {
-    return;
-  }
-  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
-    oc_rep_begin_root_object();
-  }
-  oc_encode_DPT_Shot_Status_single(oc_rep_object(root), in);
-  if (!is_metadata) {
-    oc_rep_end_root_object();
-  }
-}
+/* state of the data points, num_datapoints + num_parameters */
+datapoint_state_t g_datapoint_state[7];
 
-void oc_encode_DPT_Shot_Status_array(const DPT_Shot_Status *in, int n)
+/* sets up the screen, at the end of app_init */
+static void app_init_screen(void)
 {
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_begin_links_array();
-  for (int i = 0; i < n; i++) {
-    oc_rep_begin_object(oc_rep_array(links), obj);
-    oc_encode_DPT_Shot_Status_single(oc_rep_object(obj), &in[i]);
-    oc_rep_end_object(oc_rep_array(links), obj);
+#ifdef NO_MAIN
+  // only for embedded
+  app_initialize();
+  if (oc_is_device_in_runtime(0) == false) {
+    // only for embedded systems
+    refresh_screen(true);
   }
-  oc_rep_end_links_array();
-}
-
-void persistent_store_DPT_Shot_Status(const char *name, const DPT_Shot_Status *in)
-{
-  persistent_store_DPT_Shot_Status_array(name, in, 1);
+#elif defined(APP_BENCH)
+  // the replay runs the game logic with a null display
+  bench_logic_initialize();
+#endif /* NO_MAIN */
 }
 
-void persistent_store_DPT_Shot_Status_array(const char *name, const DPT_Shot_Status *in, int n)
-{
-  uint8_t *rep_buf;
-  long ret;
-  const size_t max_size = 14 * n + 2;
-  rep_buf = malloc(max_size);
-#ifdef OPTIMIZE_STORAGE
-// use input as storage name with "/p/" prefix removed
- const char* store_name = (char *)&name[3];
-#else
-    char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/');
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-
-  oc_rep_new(rep_buf, max_size);
-  oc_encode_DPT_Shot_Status_array(in, n);
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    PRINT_APP("storing '%s', size: %d\n", name, size);
-    for(int i = 0; i < size; i++) {
-      PRINT_APP("%02X ", rep_buf[i]);
-    }
-    PRINT_APP("\n");
-    ret = oc_storage_write(store_name, rep_buf, size);
-  }else{
-    PRINT_APP("Error encoding DPT_Shot_Status %s for storage\n", name);
-  }
-
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_write failed with error: %d\n", -ret);
-  }
-  free(rep_buf);
-}
-
-bool persistent_load_DPT_Shot_Status(const char *name, DPT_Shot_Status *out)
-{
-  return persistent_load_DPT_Shot_Status_array(name, out, 1);
-}
-
-bool persistent_load_DPT_Shot_Status_array(const char *name, DPT_Shot_Status *out, int n)
-{
-  oc_rep_t *rep = NULL;
-  int max_size = 14 * n + 2;
-  uint8_t *oc_storage_buf;
-#ifdef OPTIMIZE_STORAGE
- // use input as storage name with "/p/" prefix removed
-  const char* store_name = (char *)&name[3];
-#else
-  char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/'); 
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-  long ret;
-  bool error = true;
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-  oc_storage_buf = malloc(max_size);
-  struct oc_memb *prev_rep_obj = oc_rep_get_pool();
-  oc_rep_set_pool(&rep_objects);
-
-  ret = oc_storage_read(store_name, oc_storage_buf, max_size);
-  PRINT_APP("oc_storage_read() returned %d\n", ret);
-  for(int i = 0; i < ret; i++) {
-    PRINT_APP("%02X ", oc_storage_buf[i]);
-  }
-  PRINT_APP("\n");
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_read failed with error: %d\n", -ret);
-    goto err;
-  }
-  if (oc_parse_rep(oc_storage_buf, ret, &rep) != CborNoError) {
-    goto err;
-  }
-  if (oc_parse_DPT_Shot_Status_array(rep, out, n) != true) {
-    goto err;
-  }
-  error = false;
-err:
-  free(oc_storage_buf);
-  oc_free_rep(rep);
-  if(error) {
-    oc_storage_erase(name);
-  }
-  oc_rep_set_pool(prev_rep_obj);
-  return !error;
-}
-
-int app_sprintf_DPT_Shot_Status(const DPT_Shot_Status *in, char* text, int size)
-{
-  char item[50];
-  memset(text, 0, size);
-  if (in == NULL) {
-    return 1;
-  }
-  sprintf(item," %d ", in->DPST_60004_1_F_1);
-  strcat(text, item);
-  sprintf(item," %d ", in->DPST_60004_1_F_2);
-  strcat(text, item);
-  sprintf(item," %d ", in->DPST_60004_1_F_3);
-  strcat(text, item);
-
-  return 0;
-}
-
-int app_sscanf_DPT_Shot_Status(DPT_Shot_Status *in, char* text)
-{
-  char temp_string[300];
-  const char s[2] = " ";
-  char *token;
-  
-  if (text == NULL) {
-    return 1;
-  }
-  memset(temp_string, 0, 300);
-  strncpy(temp_string, text, 299);
-  int retval = 0;
-
-  // strtok is destructing the input string so copy it first
-  token = strtok(temp_string, s);
-  {
-    int var;
-    retval = sscanf(token, " %d", &var);
-    in->DPST_60004_1_F_1 = (bool)var;
-  }
-  if (retval != 1) return 1;
-  token = strtok(NULL, s);
-  {
-    int var;
-    retval = sscanf(token, " %d", &var);
-    in->DPST_60004_1_F_2 = (bool)var;
-  }
-  if (retval != 1) return 1;
-  token = strtok(NULL, s);
-  {
-    int var;
-    retval = sscanf(token, " %d", &var);
-    if (retval != 1) return 1;
-    in->DPST_60004_1_F_3 = var;
-  }
-  token = strtok(NULL, s);
-
-  return 0;
-}
-
-int app_str_expected_DPT_Shot_Status(int select, char* text)
-{
-  if (text == NULL) {
-    return 1;
-  }
-  if (select == 1) {
-    strcat(text, " %d");
-    strcat(text, " %d");
-    strcat(text, " %d");
-    return 0;
-  }
-  
-  if (select == 2) {
-    strcat(text, " 0");
-    strcat(text, " 0");
-    strcat(text, " 0");
-    return 0;
-  }
-  
-  return 1;
-}
-
-
-
-// Getters/Setters for DPT_Start
-
-bool app_is_DPT_Start_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  
-  if (dp->type == DatapointType_DPT_Start) {
-    return true;
-  }
-  return false;
-}
-
-void app_set_DPT_Start_default_value(const char* url)
-{
-  (void)url;
-  // No default value, do nothing...
-}
-
-void app_set_DPT_Start_array_elems(const char* url, const DPT_Start* in, int start, int n, bool store_persistently)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return;
-  }
-  if (start+n > max_elem) {
-    n = max_elem-start;
-  }
-  if (dp->g_var) {
-    memcpy(&((DPT_Start*)dp->g_var)[start], in, sizeof(DPT_Start)*n);
-    if (dp->persistent && store_persistently) {
-      persistent_store_DPT_Start_array(get_datapoint_url(dp), (DPT_Start*)dp->g_var, max_elem);
-    }
-  }else if (dp->persistent && store_persistently) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Start *data = calloc(sizeof(DPT_Start), count);
-    memcpy(&data[start], in, n*sizeof(DPT_Start));
-    persistent_store_DPT_Start_array(get_datapoint_url(dp), data, count);
-    free(data);
-  }
-  return;
-}
-
-void app_set_DPT_Start_array(const char* url, const DPT_Start* in, int n, bool store_persistently)
-{
-  app_set_DPT_Start_array_elems(url, in, 0, n, store_persistently);
-}
-
-void app_set_DPT_Start_variable(const char* url, const DPT_Start* in)
-{
-  app_set_DPT_Start_array(url, in, 1, true);
-}
-
-const DPT_Start* app_get_DPT_Start_array_elems(const char *url, DPT_Start* out, int start, int n)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return NULL;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return NULL;
-  }
-  if (start+n > max_elem){
-    n = max_elem - start;
-  }
-  if (dp->g_var) {
-    if (out == NULL) {
-      return dp->g_var;
-    }
-    memcpy(out, &((DPT_Start*)dp->g_var)[start], sizeof(DPT_Start)*n);
-    return out;
-  }else if (dp->persistent && out) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Start *data = calloc(sizeof(DPT_Start), count);
-    memset(out, 0, n*sizeof(DPT_Start));
-    if (persistent_load_DPT_Start_array(get_datapoint_url(dp), data, count)) {
-      memcpy(out, &data[start], n*sizeof(DPT_Start));
-    }
-    free(data);
-    return out;
-  }
-  return NULL;
-}
-
-const DPT_Start* app_get_DPT_Start_array(const char *url, DPT_Start* out, int n)
-{
-  return app_get_DPT_Start_array_elems(url, out, 0, n);
-}
-
-const DPT_Start* app_get_DPT_Start_variable(const char *url, DPT_Start* out)
-{
-  return app_get_DPT_Start_array(url, out, 1);
-}
-
-bool oc_parse_DPT_Start_single(oc_rep_t *rep, DPT_Start *out)
-{
-  oc_array_t arr;
-// ('bool', OrderedDict([('@Id', 'DPST-1-10_F-1'), ('@Cleared', 'Stop'), ('@Set', 'Start')]))
-  if (rep->type != OC_REP_BOOL) return false;
-  if (rep->type != OC_REP_BOOL) return false;
-  // todo Fix void
-   bool ret = oc_rep_i_get_bool(rep, 1, (void*)out);
-  
-  return ret;
-}
-
-bool oc_parse_DPT_Start(oc_rep_t *rep, DPT_Start *out)
-{
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && rep->iname != 1) {
-    rep = rep->next;
-  }
-  if (rep == NULL) {
-    return false;
-  }
-  return oc_parse_DPT_Start_single(rep, out);
-}
-
-bool oc_parse_DPT_Start_array(oc_rep_t *rep, DPT_Start *out, int n)
-{
-  oc_rep_t *rep_arr;
-  int i = 0;
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && i < n){
-    if (rep->type != OC_REP_OBJECT) {
-      return false;
-    }
-    oc_parse_DPT_Start(rep->value.object, &out[i]);
-    rep = rep->next;
-    i++;
-  }
-  return true;
-}
-
-void oc_encode_DPT_Start_single(CborEncoder *parent, const DPT_Start *in)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_i_set_key(parent, 1);
-  cbor_encode_boolean(parent, (bool)*in);
-}
-
-void oc_encode_DPT_Start(const DPT_Start *in, bool is_metadata)
-{
-  if (in == NULL) {
-    return;
-  }
-  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
-    oc_rep_begin_root_object();
-  }
-  oc_encode_DPT_Start_single(oc_rep_object(root), in);
-  if (!is_metadata) {
-    oc_rep_end_root_object();
-  }
-}
-
-void oc_encode_DPT_Start_array(const DPT_Start *in, int n)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_begin_links_array();
-  for (int i = 0; i < n; i++) {
-    oc_rep_begin_object(oc_rep_array(links), obj);
-    oc_encode_DPT_Start_single(oc_rep_object(obj), &in[i]);
-    oc_rep_end_object(oc_rep_array(links), obj);
-  }
-  oc_rep_end_links_array();
-}
-
-void persistent_store_DPT_Start(const char *name, const DPT_Start *in)
-{
-  persistent_store_DPT_Start_array(name, in, 1);
-}
-
-void persistent_store_DPT_Start_array(const char *name, const DPT_Start *in, int n)
-{
-  uint8_t *rep_buf;
-  long ret;
-  const size_t max_size = 4 * n + 2;
-  rep_buf = malloc(max_size);
-#ifdef OPTIMIZE_STORAGE
-// use input as storage name with "/p/" prefix removed
- const char* store_name = (char *)&name[3];
-#else
-    char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/');
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-
-  oc_rep_new(rep_buf, max_size);
-  oc_encode_DPT_Start_array(in, n);
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    PRINT_APP("storing '%s', size: %d\n", name, size);
-    for(int i = 0; i < size; i++) {
-      PRINT_APP("%02X ", rep_buf[i]);
-    }
-    PRINT_APP("\n");
-    ret = oc_storage_write(store_name, rep_buf, size);
-  }else{
-    PRINT_APP("Error encoding DPT_Start %s for storage\n", name);
-  }
-
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_write failed with error: %d\n", -ret);
-  }
-  free(rep_buf);
-}
-
-bool persistent_load_DPT_Start(const char *name, DPT_Start *out)
-{
-  return persistent_load_DPT_Start_array(name, out, 1);
-}
-
-bool persistent_load_DPT_Start_array(const char *name, DPT_Start *out, int n)
-{
-  oc_rep_t *rep = NULL;
-  int max_size = 4 * n + 2;
-  uint8_t *oc_storage_buf;
-#ifdef OPTIMIZE_STORAGE
- // use input as storage name with "/p/" prefix removed
-  const char* store_name = (char *)&name[3];
-#else
-  char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/'); 
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-  long ret;
-  bool error = true;
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-  oc_storage_buf = malloc(max_size);
-  struct oc_memb *prev_rep_obj = oc_rep_get_pool();
-  oc_rep_set_pool(&rep_objects);
-
-  ret = oc_storage_read(store_name, oc_storage_buf, max_size);
-  PRINT_APP("oc_storage_read() returned %d\n", ret);
-  for(int i = 0; i < ret; i++) {
-    PRINT_APP("%02X ", oc_storage_buf[i]);
-  }
-  PRINT_APP("\n");
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_read failed with error: %d\n", -ret);
-    goto err;
-  }
-  if (oc_parse_rep(oc_storage_buf, ret, &rep) != CborNoError) {
-    goto err;
-  }
-  if (oc_parse_DPT_Start_array(rep, out, n) != true) {
-    goto err;
-  }
-  error = false;
-err:
-  free(oc_storage_buf);
-  oc_free_rep(rep);
-  if(error) {
-    oc_storage_erase(name);
-  }
-  oc_rep_set_pool(prev_rep_obj);
-  return !error;
-}
-
-int app_sprintf_DPT_Start(const DPT_Start *in, char* text, int size)
-{
-  char item[50];
-  memset(text, 0, size);
-  if (in == NULL) {
-    return 1;
-  }
-  sprintf(item," %d ", *in);
-  strcat(text, item);
-
-  return 0;
-}
-
-int app_sscanf_DPT_Start(DPT_Start *in, char* text)
-{
-  char temp_string[300];
-  const char s[2] = " ";
-  char *token;
-  
-  if (text == NULL) {
-    return 1;
-  }
-  memset(temp_string, 0, 300);
-  strncpy(temp_string, text, 299);
-  int retval = 0;
-
-  // strtok is destructing the input string so copy it first
-  token = strtok(temp_string, s);
-  // bool
-  {
-    int var;
-    retval = sscanf(token, " %d", &var);
-    if (retval != 1) return 1;
-    *in = (bool)var;
-  }
-
-  return 0;
-}
-
-int app_str_expected_DPT_Start(int select, char* text)
-{
-  if (text == NULL) {
-    return 1;
-  }
-  if (select == 1) {
-  // bool
-    strcat(text, " %d");
-    return 0;
-  }
-  
-  if (select == 2) {
-    strcat(text, " 0");
-    return 0;
-  }
-  
-  return 1;
-}
-
-
-
-// Getters/Setters for DPT_Uint_XY
-
-bool app_is_DPT_Uint_XY_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  
-  if (dp->type == DatapointType_DPT_Uint_XY) {
-    return true;
-  }
-  return false;
-}
-
-void app_set_DPT_Uint_XY_default_value(const char* url)
-{
-  (void)url;
-  // No default value, do nothing...
-}
-
-void app_set_DPT_Uint_XY_array_elems(const char* url, const DPT_Uint_XY* in, int start, int n, bool store_persistently)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return;
-  }
-  if (start+n > max_elem) {
-    n = max_elem-start;
-  }
-  if (dp->g_var) {
-    memcpy(&((DPT_Uint_XY*)dp->g_var)[start], in, sizeof(DPT_Uint_XY)*n);
-    if (dp->persistent && store_persistently) {
-      persistent_store_DPT_Uint_XY_array(get_datapoint_url(dp), (DPT_Uint_XY*)dp->g_var, max_elem);
-    }
-  }else if (dp->persistent && store_persistently) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Uint_XY *data = calloc(sizeof(DPT_Uint_XY), count);
-    memcpy(&data[start], in, n*sizeof(DPT_Uint_XY));
-    persistent_store_DPT_Uint_XY_array(get_datapoint_url(dp), data, count);
-    free(data);
-  }
-  return;
-}
-
-void app_set_DPT_Uint_XY_array(const char* url, const DPT_Uint_XY* in, int n, bool store_persistently)
-{
-  app_set_DPT_Uint_XY_array_elems(url, in, 0, n, store_persistently);
-}
-
-void app_set_DPT_Uint_XY_variable(const char* url, const DPT_Uint_XY* in)
-{
-  app_set_DPT_Uint_XY_array(url, in, 1, true);
-}
-
-const DPT_Uint_XY* app_get_DPT_Uint_XY_array_elems(const char *url, DPT_Uint_XY* out, int start, int n)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return NULL;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return NULL;
-  }
-  if (start+n > max_elem){
-    n = max_elem - start;
-  }
-  if (dp->g_var) {
-    if (out == NULL) {
-      return dp->g_var;
-    }
-    memcpy(out, &((DPT_Uint_XY*)dp->g_var)[start], sizeof(DPT_Uint_XY)*n);
-    return out;
-  }else if (dp->persistent && out) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Uint_XY *data = calloc(sizeof(DPT_Uint_XY), count);
-    memset(out, 0, n*sizeof(DPT_Uint_XY));
-    if (persistent_load_DPT_Uint_XY_array(get_datapoint_url(dp), data, count)) {
-      memcpy(out, &data[start], n*sizeof(DPT_Uint_XY));
-    }
-    free(data);
-    return out;
-  }
-  return NULL;
-}
-
-const DPT_Uint_XY* app_get_DPT_Uint_XY_array(const char *url, DPT_Uint_XY* out, int n)
-{
-  return app_get_DPT_Uint_XY_array_elems(url, out, 0, n);
-}
-
-const DPT_Uint_XY* app_get_DPT_Uint_XY_variable(const char *url, DPT_Uint_XY* out)
-{
-  return app_get_DPT_Uint_XY_array(url, out, 1);
-}
-
-bool oc_parse_DPT_Uint_XY_single(oc_rep_t *rep, DPT_Uint_XY *out)
-{
-  oc_array_t arr;
-  if (rep->type != OC_REP_INT_ARRAY) return false;
-  arr = rep->value.array;
-  if (oc_int_array_size(arr) < 2)
-    return false;
-  out->DPST_60009_1_F_1 = oc_int_array(arr)[0];
-  out->DPST_60009_1_F_2 = oc_int_array(arr)[1]; 
-  return true;
-}
-
-bool oc_parse_DPT_Uint_XY(oc_rep_t *rep, DPT_Uint_XY *out)
-{
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && rep->iname != 1) {
-    rep = rep->next;
-  }
-  if (rep == NULL) {
-    return false;
-  }
-  return oc_parse_DPT_Uint_XY_single(rep, out);
-}
-
-bool oc_parse_DPT_Uint_XY_array(oc_rep_t *rep, DPT_Uint_XY *out, int n)
-{
-  oc_rep_t *rep_arr;
-  int i = 0;
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && i < n){
-    if (rep->type != OC_REP_OBJECT) {
-      return false;
-    }
-    oc_parse_DPT_Uint_XY(rep->value.object, &out[i]);
-    rep = rep->next;
-    i++;
-  }
-  return true;
-}
-
-void oc_encode_DPT_Uint_XY_single(CborEncoder *parent, const DPT_Uint_XY *in)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_i_set_key(parent, 1);
-  oc_rep_begin_array(parent, arr);
-  oc_rep_add_int(arr, in->DPST_60009_1_F_1);
-  oc_rep_add_int(arr, in->DPST_60009_1_F_2);
-  oc_rep_end_array(parent, arr);
-}
-
-void oc_encode_DPT_Uint_XY(const DPT_Uint_XY *in, bool is_metadata)
-{
-  if (in == NULL) {
-    return;
-  }
-  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
-    oc_rep_begin_root_object();
-  }
-  oc_encode_DPT_Uint_XY_single(oc_rep_object(root), in);
-  if (!is_metadata) {
-    oc_rep_end_root_object();
-  }
-}
-
-void oc_encode_DPT_Uint_XY_array(const DPT_Uint_XY *in, int n)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_begin_links_array();
-  for (int i = 0; i < n; i++) {
-    oc_rep_begin_object(oc_rep_array(links), obj);
-    oc_encode_DPT_Uint_XY_single(oc_rep_object(obj), &in[i]);
-    oc_rep_end_object(oc_rep_array(links), obj);
-  }
-  oc_rep_end_links_array();
-}
-
-void persistent_store_DPT_Uint_XY(const char *name, const DPT_Uint_XY *in)
-{
-  persistent_store_DPT_Uint_XY_array(name, in, 1);
-}
-
-void persistent_store_DPT_Uint_XY_array(const char *name, const DPT_Uint_XY *in, int n)
-{
-  uint8_t *rep_buf;
-  long ret;
-  const size_t max_size = 15 * n + 2;
-  rep_buf = malloc(max_size);
-#ifdef OPTIMIZE_STORAGE
-// use input as storage name with "/p/" prefix removed
- const char* store_name = (char *)&name[3];
-#else
-    char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/');
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-
-  oc_rep_new(rep_buf, max_size);
-  oc_encode_DPT_Uint_XY_array(in, n);
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    PRINT_APP("storing '%s', size: %d\n", name, size);
-    for(int i = 0; i < size; i++) {
-      PRINT_APP("%02X ", rep_buf[i]);
-    }
-    PRINT_APP("\n");
-    ret = oc_storage_write(store_name, rep_buf, size);
-  }else{
-    PRINT_APP("Error encoding DPT_Uint_XY %s for storage\n", name);
-  }
-
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_write failed with error: %d\n", -ret);
-  }
-  free(rep_buf);
-}
-
-bool persistent_load_DPT_Uint_XY(const char *name, DPT_Uint_XY *out)
-{
-  return persistent_load_DPT_Uint_XY_array(name, out, 1);
-}
-
-bool persistent_load_DPT_Uint_XY_array(const char *name, DPT_Uint_XY *out, int n)
-{
-  oc_rep_t *rep = NULL;
-  int max_size = 15 * n + 2;
-  uint8_t *oc_storage_buf;
-#ifdef OPTIMIZE_STORAGE
- // use input as storage name with "/p/" prefix removed
-  const char* store_name = (char *)&name[3];
-#else
-  char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/'); 
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-  long ret;
-  bool error = true;
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-  oc_storage_buf = malloc(max_size);
-  struct oc_memb *prev_rep_obj = oc_rep_get_pool();
-  oc_rep_set_pool(&rep_objects);
-
-  ret = oc_storage_read(store_name, oc_storage_buf, max_size);
-  PRINT_APP("oc_storage_read() returned %d\n", ret);
-  for(int i = 0; i < ret; i++) {
-    PRINT_APP("%02X ", oc_storage_buf[i]);
-  }
-  PRINT_APP("\n");
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_read failed with error: %d\n", -ret);
-    goto err;
-  }
-  if (oc_parse_rep(oc_storage_buf, ret, &rep) != CborNoError) {
-    goto err;
-  }
-  if (oc_parse_DPT_Uint_XY_array(rep, out, n) != true) {
-    goto err;
-  }
-  error = false;
-err:
-  free(oc_storage_buf);
-  oc_free_rep(rep);
-  if(error) {
-    oc_storage_erase(name);
-  }
-  oc_rep_set_pool(prev_rep_obj);
-  return !error;
-}
-
-int app_sprintf_DPT_Uint_XY(const DPT_Uint_XY *in, char* text, int size)
-{
-  char item[50];
-  memset(text, 0, size);
-  if (in == NULL) {
-    return 1;
-  }
-  sprintf(item," %u ", in->DPST_60009_1_F_1);
-  strcat(text, item);
-  sprintf(item," %u ", in->DPST_60009_1_F_2);
-  strcat(text, item);
-
-  return 0;
-}
-
-int app_sscanf_DPT_Uint_XY(DPT_Uint_XY *in, char* text)
-{
-  char temp_string[300];
-  const char s[2] = " ";
-  char *token;
-  
-  if (text == NULL) {
-    return 1;
-  }
-  memset(temp_string, 0, 300);
-  strncpy(temp_string, text, 299);
-  int retval = 0;
-
-  // strtok is destructing the input string so copy it first
-  token = strtok(temp_string, s);
-  {
-    unsigned int var;
-    retval = sscanf(token, " %u", &var);
-    if (retval != 1) return 1;
-    in->DPST_60009_1_F_1 = var;
-  }
-  token = strtok(NULL, s);
-  {
-    unsigned int var;
-    retval = sscanf(token, " %u", &var);
-    if (retval != 1) return 1;
-    in->DPST_60009_1_F_2 = var;
-  }
-  token = strtok(NULL, s);
-
-  return 0;
-}
-
-int app_str_expected_DPT_Uint_XY(int select, char* text)
-{
-  if (text == NULL) {
-    return 1;
-  }
-  if (select == 1) {
-    strcat(text, " %u");
-    strcat(text, " %u");
-    return 0;
-  }
-  
-  if (select == 2) {
-    strcat(text, " 0");
-    strcat(text, " 0");
-    return 0;
-  }
-  
-  return 1;
-}
-
-// BOOLEAN code
-
-/**
- * @brief function to check if the url is represented by a boolean
- *
- * @param true = url value is a boolean
- * @param false = url is not a boolean
- */
-bool app_is_bool_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  return dp->type == DatapointType_bool;
-}
-
-/**
- * @brief sets the global boolean variable at the url
- *
- * Note: if the url is ot found then the value is not changed
- *
- * @param url the url indicating the global variable
- * @param value the value to be set
- */
-void app_set_bool_variable(const char* url, bool value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  if (dp->type != DatapointType_bool) {
-    return;
-  }
-  if (dp->g_var) {
-    *((bool*)dp->g_var) = value;
-  }
-}
-
-/**
- * @brief retrieve the global boolean variable at the url
- *
- * @param url the url indicating the global variable
- * @return the value of the variable
- */
-bool app_retrieve_bool_variable(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->type != DatapointType_bool) {
-    return false;
-  }
-  if (dp->g_var) {
-    return *((bool*)dp->g_var);
-  }
-  return false;
-}
-
-
-/**
- * @brief retrieve the global int variable at the url
- *
- * @param url the url indicating the global variable
- * @param value ptr to value (which is going to be set)
- * @return the true if variable is set
- */
-bool app_retrieve_int_variable(const char* url, int* value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->type != DatapointType_int) {
-    return false;
-  }
-  if (dp->g_var) {
-    value = ((int*)dp->g_var);
-    return true;
-  }
-  return false;
-}
-
-
-// FAULT code
-
-/**
- * @brief set the fault (boolean) variable at the url
- *
- * @param url the url indicating the fault variable
- * @param value the value of the fault variable
- */
-void app_set_fault_variable(const char* url, bool value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  if ((dp->resource.interfaces & OC_IF_A) == 0) {
-    return;
-  }
-  if (dp->g_fault) {
-    *((bool*)dp->g_fault) = value;
-  }
-  //TODO: Add back support for changing the feedback variable
-}
-
-/**
- * @brief retrieve the fault (boolean) variable at the url
- *
- * @param url the url indicating the fault variable
- * @return the value of the fault variable
- */
-bool app_retrieve_fault_variable(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->resource.interfaces & OC_IF_A == 0) {
-    return false;
-  }
-  if (dp->g_fault) {
-    return *((bool*)dp->g_fault);
-  }
-  return false;
-}
-
-// PARAMETER code
-
-bool app_is_url_parameter(const char* url)
-{
-  // all parametes start with /p/pxxx
-  if (strncmp(url,"/p/p",4) == 0 ) {
-    return false;
-  }
-
-  for (int i = 0; i < num_parameters; i++) {
-    const datapoint_t *dp = &g_parameters[i];
-    if (strcmp(get_datapoint_url(dp), url) == 0) {
-      return true;
-    }
-  } 
-  return false;
-}
-
-const char* app_get_parameter_url(int index)
-{
-if (index < num_parameters) {
-    return get_datapoint_url(&g_parameters[index]);
-  } 
-  return NULL;
-}
-
-const char* app_get_parameter_name(int index)
-{
-  if (index < num_parameters) {
-    return get_datapoint_name(&g_parameters[index]);
-  } 
-  return NULL;
-}
-
-bool app_is_secure()
-{
-#ifdef OC_OSCORE
-  return true;
-#else
-  return false;
-#endif /* OC_OSCORE */
-}
-
-static oc_put_struct_t app_put = { NULL };
-
-void
-app_set_put_cb(oc_put_cb_t cb)
-{
-  app_put.cb = cb;
-}
-
-oc_put_struct_t *
-oc_get_put_cb(void)
-{
-  return &app_put;
-}
-
-void do_put_cb(const char* url)
-{
-  oc_put_struct_t *my_cb = oc_get_put_cb();
-  if (my_cb && my_cb->cb) {
-    my_cb->cb(url);
-  }
-}
-
-static oc_get_struct_t app_get = { NULL };
-
-void
-app_set_get_cb(oc_get_cb_t cb)
-{
-  app_get.cb = cb;
-}
-
-oc_get_struct_t *
-oc_get_get_cb(void)
-{
-  return &app_get;
-}
-
-void do_get_cb(const char* url)
-{
-  oc_get_struct_t *my_cb = oc_get_get_cb();
-  if (my_cb && my_cb->cb) {
-    my_cb->cb(url);
-  }
-}
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-int app_initialize_stack();
-void signal_event_loop(void);
-void register_resources(void);
-void initialize_variables();
-void reset_variables();
-void logic_initialize();
-int app_init(void);
-#ifdef __cplusplus
-}
-#endif
-
-// DEVBOARD code
-
-/**
- * @brief devboard button toggle callback
- *
- */
-// we no longer have app_set_bool_variable
-//void dev_btn_toggle_cb(char *url)
-//{
-//  PRINT_APP("Handling %s\n", url);
-//  bool val = app_retrieve_bool_variable(url);
-//  if (val == true)
-//  {
-//    val = false;
-//  }
-//  else
-//  {
-//    val = true;
-//  }
-//  app_set_bool_variable(url, val);
-//  oc_do_s_mode_with_scope(5, url, "w");
-//}
-
-/**
- * @brief s-mode response callback
- * will be called when a response is received on an s-mode read request
- *
- * @param url the url
- * @param rep the full response
- * @param rep_value the parsed value of the response
- */
-void
-oc_add_s_mode_response_cb(char *url, oc_rep_t *rep, oc_rep_t *rep_value)
-{
-  (void)rep;
-  (void)rep_value;
-
-  PRINT("oc_add_s_mode_response_cb %s\n", url);
-}
-
-
-
-/**
- * @brief function to set the input string to upper case
- *
- * @param str the string to make upper case
- *
- */
-void app_str_to_upper(char *str){
-  while (*str != '\0')
-  {
-    *str = toupper(*str);
-    str++;
-  }
-}
-
-/**
- * @brief function to set up the device.
- *
- * sets the:
- * - manufacturer     : cascoda
- * - serial number    : 00fa10010713
- * - base path
- * - knx spec version
- * - hardware version : [0, 4, 0]
- * - firmware version : [0, 4, 0]
- * - hardware type    : 000000000000
- * - device model     : KNX Battleships Demo eink
- *
- */
-int
-app_init(void)
-{
-  int ret = oc_init_platform("cascoda", NULL, NULL);
-  char serial_number_uppercase[20];
-
-  /* set the application name, version, base url, device serial number */
-  ret |= oc_add_device(MY_NAME, "1.0.0", "//", g_serial_number, NULL, NULL);
-
-  oc_device_info_t *device = oc_core_get_device_info(0);
-
-#ifdef LINUX
-  #define MAX_HOSTNAME 50
-  char hostname[50];
-  // set the hostname
-  ret = gethostname(&hostname[0], 50);
-  if (ret != -1) {
-    printf("Hostname (linux):    %s\n", hostname);
-    oc_core_set_device_hostname(0, hostname);
-  }
-#endif
-#ifdef WIN32
-  char hostname_str[50];
-  int error = gethostname(hostname_str, 50);
-  if (error == 0) {
-    printf("Hostname (win32):    %s\n", hostname_str);
-    oc_core_set_device_hostname(0, hostname_str);
-  }
-#endif
-
-  
-  /* set the hardware version 0.4.0 */
-  oc_core_set_device_hwv(0, 0, 4, 0);
-  
-  
-  /* set the firmware version 0.4.0 */
-  oc_core_set_device_fwv(0, 0, 4, 0);
-  
-  
-  /* manufacturer id */
-  oc_core_set_device_mid(0, 0x00FA);
-  /* set the hardware type*/
-  oc_core_set_device_hwt(0, "000000000000");
-  /* set the model */
-  oc_core_set_device_model(0, "KNX Battleships Demo eink");
-
-  oc_set_s_mode_response_cb(oc_add_s_mode_response_cb);
-#define PASSWORD "0MK4U5LV950ST3VRXL8G"
-#ifdef OC_SPAKE
-  if (strlen(oc_spake_get_password()) == 0)
-    oc_spake_set_password(PASSWORD);
-
-
-  strncpy(serial_number_uppercase, oc_string(device->serialnumber), 19);
-  app_str_to_upper(serial_number_uppercase);
-  printf("\n === QR Code: KNX:S:%s;P:%s ===\n", serial_number_uppercase, oc_spake_get_password());
-#endif
-
-  initialize_variables();
-  #ifdef NO_MAIN
-  // only for embedded
-  app_initialize();
-  #endif 
-  if (oc_is_device_in_runtime(0) == false) {
-#ifdef NO_MAIN
-    // only for embedded systems
-    refresh_screen(true);
-#endif /* NO_MAIN */
-  } 
-
-  return ret;
-}
-
-/**
- * @brief returns the password
- */
-const char* app_get_password()
-{
-#ifdef OC_SPAKE
-  return oc_spake_get_password();
-#else
-  return PASSWORD;
-#endif
-}
-
-
-bool request_query_get_int(oc_request_t *request, const char *query, int *out)
-{
-  char *query_str;
-  
-  int query_len = oc_get_query_value(request, query, &query_str);
-  if(query_len <= 0) {
-    return false;
-  }
-  char buf[16];
-  strncpy(buf, query_str, query_len);
-  *out = atoi(buf);
-  return true;
-}
-
-void
-get_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
-{
-  
-  const datapoint_t *dp = user_data; 
-
-  bool error_state = false; /* the error state, the generated code */
-
-  if (dp == NULL) {
-    dp = get_datapoint_by_url(request->uri_path);
-    if (dp == NULL) {
-      PRINT("Error dp is NULL\n");
-      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-      return;
-    }
-  }
-
-  PRINT("-- Begin get_generic  (%s) \n", get_datapoint_name(dp));
-
-  /* MANUFACTORER: SENSOR add here the code to talk to the HW if one implements a
-     sensor. the call to the HW needs to fill in the global variable before it
-     returns to this function here. alternative is to have a callback from the
-     hardware that sets the global variables.
-  */
-
-  /* check if the accept header is CBOR */
-  if (oc_check_accept_header(request, APPLICATION_CBOR) == false) {
-    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-    return;
-  }
-
-  // check the query parameter m with the various values
-  char *m;
-  char* m_key;
-  size_t m_key_len;
-  size_t m_len = (int)oc_get_query_value(request, "m", &m);
-  int pn, ps;
-  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
-  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
-  if (m_len != -1) {
-    PRINT("  Query param: %.*s\n",(int)m_len, m);
-    oc_init_query_iterator();
-    size_t device_index = request->resource->device;
-    oc_device_info_t *device = oc_core_get_device_info(device_index);
-    if (device != NULL) {
-      bool m_valid = false;
-      oc_rep_begin_root_object();
-      while (oc_iterate_query(request, &m_key, &m_key_len, &m, &m_len) != -1) {
-        // value
-        if ((strncmp(m, "value", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          if (oc_encode_datapoint(dp, pn, ps, true) == false) {
-            oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-            goto done;
-          }
-        }
-        // unique identifier
-        if ((strncmp(m, "id", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          char mystring[100];
-          snprintf(mystring,99,"knx://sn.%s%s",oc_string(device->serialnumber),
-            oc_string(request->resource->uri));
-          oc_rep_i_set_text_string(root, 0, mystring);
-        }
-        // href, i.e. url
-        if ((strncmp(m, "href", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          // Valid and mandatory metadata, but "can be omitted in response"
-          m_valid = true;
-          oc_rep_set_text_string(root, href, get_datapoint_url(dp));
-        }
-        // resource types
-        if ((strncmp(m, "rt", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          const char *dpa = get_datapoint_dpa(dp);
-          if (dpa)
-            oc_rep_set_text_string(root, rt, &dpa[7]);
-        }
-        // interfaces
-        if ((strncmp(m, "if", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          oc_rep_set_key(oc_rep_object(root), "if");
-          oc_rep_begin_array(oc_rep_object(root), if);
-          for (int i = 1; i <= (1<<OC_MAX_IF_MASKS); i <<=1)
-            if (dp->resource.interfaces&i)
-              oc_rep_add_text_string(if, get_interface_string(dp->resource.interfaces&i));
-          oc_rep_end_array(oc_rep_object(root), if);
-        }
-        if ((strncmp(m, "dpt", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          char *full_dpt = oc_string(request->resource->dpt);
-          oc_rep_set_text_string(root, dpt, &full_dpt[7]);
-        }
-        // ga
-        if ((strncmp(m, "ga", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          int index = oc_core_find_group_object_table_url(oc_string(request->resource->uri));
-          if (index > -1) {
-            oc_group_object_table_t* got_table_entry = oc_core_get_group_object_table_entry(index);
-            if (got_table_entry) {
-               oc_rep_set_int_array(root, ga, got_table_entry->ga, got_table_entry->ga_len);
-            }
-          }
-        }
-        for (const char *const *md = get_datapoint_metadata(dp); md && *md; md+=2) {
-          if((strncmp(m, md[0], m_len) == 0) |
-              (strncmp(m, "*", m_len) == 0) ) {
-                m_valid = true;
-                oc_rep_set_text_string_no_tag(root, md[0]);
-                oc_rep_set_text_string_no_tag(root, md[1]);
-              }
-        }
-      } /* query iterator */
-      oc_rep_end_root_object();
-      if (m_valid == false) {
-        oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
-        goto done;
-      }
-    } else {
-      /* device is NULL */
-      oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-      goto done;
-    }
-    oc_send_cbor_response(request, OC_STATUS_OK);
-    goto done;
-  }
-  if (oc_encode_datapoint(dp, pn, ps, false) == false) {
-    oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-    goto done;
-  }
-  if (g_err) {
-    error_state = true;
-  }
-  PRINT("CBOR encoder size %d\n", oc_rep_get_encoded_payload_size());
-  if (error_state == false) {
-    oc_send_cbor_response(request, OC_STATUS_OK);
-  } else {
-    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-  }
-done:
-  PRINT("-- End get_generic (%s)\n", get_datapoint_url(dp));
-}
-
-
-void
-put_generic(oc_request_t *request, oc_interface_mask_t interfaces,
-                void *user_data)
-{
-  (void)interfaces;
-  const datapoint_t *dp = user_data;
-  bool error_state = true;
-
-  if (dp == NULL) {
-    dp = get_datapoint_by_url(request->uri_path);
-    if (dp == NULL) {
-      PRINT("Error dp is NULL\n");
-      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-      return;
-    }
-  }
-
-  PRINT("-- Begin put_generic (%s):\n", get_datapoint_url(dp));
-
-  oc_rep_t *rep = NULL;
-  int pn, ps;
-  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
-  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
-  /* handle the different requests e.g. via s-mode or normal CoAP call*/
-  if (oc_is_redirected_request(request)) {
-    PRINT("  redirected request..\n");
-  }
-  rep = request->request_payload;
-  /* loop over all the entries in the request */
-  /* handle the type of payload correctly. */
-  void *new_value = malloc(get_dpt_size(dp->type) * ps);
-  error_state = !oc_parse_datapoint(dp, rep, new_value, ps);
-
-  if (error_state == false){
-    const oc_resource_t *my_resource =
-    oc_ri_get_app_resource_by_uri(request->uri_path, strlen(request->uri_path), 0);
-    if (my_resource != NULL)
-      oc_notify_observers(my_resource);
-
-    oc_send_response_no_format(request, OC_STATUS_CHANGED);
-    datapoint_set(dp, new_value, pn*ps, ps);
-    if (dp->feedback_url) {
-      //check types match
-      const datapoint_t *feedback = get_datapoint_by_url(dp->feedback_url);
-      if (feedback->type == dp->type && feedback->num_elements == dp->num_elements) {
-        datapoint_set(feedback, new_value, pn*ps, ps);
-        PRINT("  Send status to '%s' with flag: 'w'\n", get_datapoint_url(feedback));
-        oc_do_s_mode_with_scope(5, dp->feedback_url, "w");
-      }
-    }
-
-    do_put_cb(get_datapoint_url(dp));
-  } else {
-    /* request data was not recognized, so it was a bad request */
-    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
-  }
-  free(new_value);
-  PRINT("-- End put_generic (%s)\n", get_datapoint_url(dp));
-}
-
-
-/**
- * @brief register all the data point resources to the stack
- * this function registers all data point level resources:
- * - each resource path is bind to a specific function for the supported methods
- *  (GET, PUT)
- * - each resource is
- *   - secure
- *   - observable
- *   - discoverable through well-known/core
- *   - used interfaces as: dpa.xxx.yyy
- *      - xxx : function block number
- *      - yyy : data point function number
- */
-void
-register_resources(void)
-{
-  const datapoint_t *it;
-  const char *_t[2] = {
-    "Datapoint",
-    "Parameter"
-  };
-  const char **t = _t;
-  PRINT_APP("Adding const resource block\n");
-  const datapoint_t *dp = &g_datapoints[0];
-
-  oc_ri_add_resource_block(&g_datapoints[0].resource); 
-}
-
-#ifdef MQTT_PROXY
-void
-configure_mqtt_from_parameters() {
-  strncpy(g_mqttconf_server, gMQTT_hostname0, sizeof(g_mqttconf_server));
-  g_mqttconf_port = gMQTT_port_number0;
-  strncpy(g_mqttconf_username, gMQTT_username0, sizeof(g_mqttconf_username));
-  strncpy(g_mqttconf_pwd, gMQTT_password0, sizeof(g_mqttconf_pwd));
-  strncpy(g_iid_name, gIID_name0, sizeof(g_iid_name));
-  PRINT("MQTT configuration:\n");
-  PRINT(" hostname: %s\n", g_mqttconf_server);
-  PRINT(" port    : %d\n", g_mqttconf_port);
-  PRINT(" username: %s\n", g_mqttconf_username);
-  PRINT(" password: %s\n", g_mqttconf_pwd);
-  PRINT(" IID name: %s\n", g_iid_name);
-}
-#endif
-
-/**
- * @brief callback when a/lsm state changes
- * @param device_index the device identifier of the list of devices
- * @param current_state current state (i.e. after the change)
- * @param data the supplied data.
- */
-void
-lsm_change_cb(size_t device_index, oc_lsm_state_t current_state, void *data)
-{
-  (void)device_index;
-  (void)data;
-}
-
-/**
- * @brief initiate preset for device
- * current implementation: device reset as command line argument
- * @param device_index the device identifier of the list of devices
- * @param data the supplied data.
- */
-void
-factory_presets_cb(size_t device_index, void *data)
-{
-  (void)device_index;
-  (void)data;
-  reset_variables();
-}
-
-/**
- * @brief set the host name on the device (application depended)
- *
- * @param device_index the device identifier of the list of devices
- * @param host_name the host name to be set on the device
- * @param data the supplied data.
- */
-void
-hostname_cb(size_t device_index, oc_string_t host_name, void *data)
-{
-  (void)device_index;
-  (void)data;
-
-  PRINT("-----host name ------- %s\n", oc_string(host_name));
-}
-
-static oc_event_callback_retval_t send_delayed_response(void *context)
-{
-  oc_separate_response_t *response = (oc_separate_response_t *)context;
-
-  if (response->active)
-  {
-    oc_set_separate_response_buffer(response);
-    oc_send_separate_response(response, OC_STATUS_CHANGED);
-    PRINT_APP("Delayed response sent\n");
-  }
-  else
-  {
-    PRINT_APP("Delayed response NOT active\n");
-  }
-
-  return OC_EVENT_DONE;
-}
-
-#if defined WIN32 || defined __linux__
-/**
- * @brief software update callback
- *
- * @param device the device index
- * @param response the instance of an internal struct that is used to track
- *       		   the state of the separate response
- * @param binary_size the full size of the binary
- * @param offset the offset of the image
- * @param payload the image data
- * @param len the length of the image data
- * @param data the user data
- */
-void swu_cb(size_t device,
-            oc_separate_response_t *response,
-            size_t binary_size,
-            size_t offset,
-            uint8_t *payload,
-            size_t len,
-            void *data)
-{
-  (void)device;
-  (void)binary_size;
-  char filename[] = "./downloaded.bin";
-  PRINT(" swu_cb %s block=%d size=%d \n", filename, (int)offset, (int)len);
-
-  FILE *write_ptr = fopen("downloaded_bin", "ab");
-  size_t r = fwrite(payload, sizeof(*payload), len, write_ptr);
-  fclose(write_ptr);
-
-  oc_set_delayed_callback(response, &send_delayed_response, 0);
-}
-#endif
-
-/**
- * @brief initializes the global variables
- * for the resources
- * for the parameters
- */
-void
-initialize_variables(void)
-{
-  /* initialize global variables for resources */
-  /* if wanted read them from persistent storage */
-  /* parameter variables */
-  uint8_t oc_storage_buf[32];
-  long ret;
-  bool err;
-
-  PRINT_APP("Initializing persistent data\n");
-
-  for(int i = 0; i < num_datapoints; i++) {
-    const datapoint_t *it = &g_datapoints[i];
-    if (!it->persistent && !it->default_present) continue;
-    if (it->g_var == NULL) continue;
-    if (it->num_elements){
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load_array == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load_array(get_datapoint_url(it), (void*)it->g_var, it->num_elements);
-        }
-      }
-    } else {
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load(get_datapoint_url(it), (void*)it->g_var);
-        }
-      }
-    }
-  } 
-
-  for(int i = 0; i < num_parameters; i++) {
-    const datapoint_t *it = &g_parameters[i];
-    if (!it->persistent && !it->default_present) continue;
-    if (it->g_var == NULL) continue;
-    if (it->num_elements){
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load_array == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load_array(get_datapoint_url(it), (void*)it->g_var, it->num_elements);
-        }
-      }
-    } else {
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load(get_datapoint_url(it), (void*)it->g_var);
-        }
-      }
-    }
-  } 
-}
-/**
- * @brief reset variables to default value
- * for the resources
- * for the parameters
- */
-void
-reset_variables(void)
-{
-  /* reset variables to default value */
-  PRINT_APP("Resetting to default value\n");
-
-  for(int i = 0; i < num_datapoints; i++) {
-    const datapoint_t *it = &g_datapoints[i];
-    if (it->persistent) {
-      oc_storage_erase(get_datapoint_url(it));
-    }
-    if (it->default_present){
-      g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-    }
-  } 
-
-  for(int i = 0; i < num_parameters; i++) {
-    const datapoint_t *it = &g_parameters[i];
-    if (it->persistent) {
-      oc_storage_erase(get_datapoint_url(it));
-    }
-    if (it->default_present){
-      g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-    }
-  } 
-}
-
-int app_set_serial_number(const char* serial_number)
-{
-  strncpy(g_serial_number, serial_number, 20);
-  return 0;
-}
-
-int app_initialize_stack()
-{
-  int init;
-  char *fname = "my_software_image";
-
-  PRINT("KNX-IOT Server name : \"%s\"\n", MY_NAME);
-
-  /* show the current working folder */
-  char buff[FILENAME_MAX];
-  char *retbuf = NULL;
-  retbuf = GetCurrentDir(buff, FILENAME_MAX);
-  if (retbuf != NULL) {
-    PRINT("Current working dir: %s\n", buff);
-  }
-
-  /*
-   The storage folder depends on the build system
-   the folder is created in the makefile, with $target as name with _cred as
-   post fix.
-  */
-#ifdef WIN32
-  char storage[400];
-  sprintf(storage,"./knx_eink_battleships_%s",g_serial_number);
-  PRINT("\tstorage at '%s' \n",storage);
-  oc_storage_config(storage);
-#else
-  PRINT("\tstorage at 'knx_eink_battleships_creds' \n");
-  oc_storage_config("./knx_eink_battleships_creds");
-#endif /* WIN32 */
-
-
-  /* initializes the handlers structure */
-  static oc_handler_t handler = { .init = app_init,
-                                  .signal_event_loop = signal_event_loop,
-                                  .register_resources = register_resources,
-                                  .requests_entry = NULL };
-
-  /* set the application callbacks */
-  oc_set_hostname_cb(hostname_cb, NULL);
-  oc_set_factory_presets_cb(factory_presets_cb, NULL);
-	oc_set_lsm_change_cb(lsm_change_cb, NULL);
-
-#if defined WIN32 || defined __linux__
-  oc_set_swu_cb(swu_cb, (void *)fname);
-#endif /* WIN32 || defined __linux__ */
-
-  /* start the stack */
-  init = oc_main_init(&handler);
-
-  if (init < 0) {
-    PRINT("oc_main_init failed %d, exiting.\n", init);
-    return init;
-  }
-
-  if (g_reset) {
-    PRINT("factory_presets_cb: resetting device\n");
-    oc_knx_device_storage_reset(0, 2);
-  }
-
-  oc_knx_knx_ignore_smessage_from_self(true);
-
-#ifdef OC_OSCORE
-  PRINT("OSCORE - Enabled\n");
-#else
-  PRINT("OSCORE - Disabled\n");
-#endif /* OC_OSCORE */
-
-  oc_device_info_t *device = oc_core_get_device_info(0);
-  PRINT("serial number: %s\n", oc_string(device->serialnumber));
-  oc_endpoint_t *my_ep = oc_connectivity_get_endpoints(0);
-  if (my_ep != NULL) {
-    PRINTipaddr(*my_ep);
-    PRINT("\n");
-  }
-  PRINT("Server \"%s\" running, waiting on incoming "
-        "connections.\n",
-        MY_NAME);
-  return 0;
-}
-
-#ifdef WIN32
-/**
- * @brief signal the event loop (windows version)
- * wakes up the main function to handle the next callback
- */
-void
-signal_event_loop(void)
-{
-
-#ifndef NO_MAIN
-  WakeConditionVariable(&cv);
-#endif /* NO_MAIN */
-}
-#endif /* WIN32 */
-
-#ifdef __linux__
-/**
- * @brief signal the event loop (Linux)
- * wakes up the main function to handle the next callback
- */
-void
-signal_event_loop(void)
-{
-#ifndef NO_MAIN
-  pthread_mutex_lock(&mutex);
-  pthread_cond_signal(&cv);
-  pthread_mutex_unlock(&mutex);
-#endif /* NO_MAIN */
-}
-#endif /* __linux__ */
-
-
-#ifndef NO_MAIN
-
-/**
- * @brief handle Ctrl-C
- * @param signal the captured signal
- */
-static void
-handle_signal(int signal)
-{
-  (void)signal;
-  signal_event_loop();
-  quit = 1;
-}
-
-/**
- * @brief print usage and quits
- *
- */
-static void
-print_usage()
-{
-  PRINT("Usage:\n");
-  PRINT("no arguments : starts the server\n");
-  PRINT("-help  : this message\n");
-  PRINT("reset  : does an full reset of the device\n");
-  PRINT("-s <serial number> : sets the serial number of the device\n");
-#ifdef MQTT_PROXY
-  PRINT("MQTT proxy configurations (only used before ETS download):\n");
-  PRINT("-host : sets the MQTT broker hostname\n");
-  PRINT("-port : sets the MQTT broker port number\n");
-  PRINT("-username : sets the MQTT username\n");
-  PRINT("-pwd : sets the MQTT password\n");
-#endif
-  exit(0);
-}
-
-/**
- * @brief main application.
- * initializes the global variables
- * registers and starts the handler
- * handles (in a loop) the next event.
- * shuts down the stack
- */
-int
-main(int argc, char *argv[])
-{
-  oc_clock_time_t next_event;
-  bool do_send_s_mode = false;
-
-
-#ifdef HARDWARE_INIT
-  hardware_init();
-#endif /* hardware init */
-
-
-#ifdef KNX_GUI
-  WinMain(GetModuleHandle(NULL), NULL, (LPSTR)GetCommandLine(), SW_SHOWNORMAL);
-#endif /* KNX_GUI */
-
-#ifdef WIN32
-  /* windows specific */
-  InitializeCriticalSection(&cs);
-  InitializeConditionVariable(&cv);
-  /* install Ctrl-C */
-  signal(SIGINT, handle_signal);
-#endif /* WIN32 */
-#ifdef __linux__
-  /* Linux specific */
-  struct sigaction sa;
-  sigfillset(&sa.sa_mask);
-  sa.sa_flags = 0;
-  sa.sa_handler = handle_signal;
-  /* install Ctrl-C */
-  sigaction(SIGINT, &sa, NULL);
-  #define MAX_HOSTNAME 256
-  char hostname[MAX_HOSTNAME];
-  // set the hostname
-  ret = gethostname(&hostname[0], MAX_HOSTNAME);
-  if (ret != -1) {
-    printf("Hostname:    %s\n", hostname);
-    oc_core_set_device_hostname(0, hostname, MAX_HOSTNAME);
-  }
-#endif  /* __linux__ */
-
-  for (int i = 0; i < argc; i++) {
-    PRINT_APP("argv[%d] = %s\n", i, argv[i]);
-    if (strcmp(argv[i], "-help") == 0) {
-      print_usage();
-    }
-    if (strcmp(argv[i], "reset") == 0) {
-      PRINT(" internal reset\n");
-      g_reset = true;
-    }
-    if (strcmp(argv[i], "-s") == 0) {
-      if (i + 1 < argc) {
-        // serial number
-        PRINT("serial number %s\n", argv[i + 1]);
-        app_set_serial_number(argv[i + 1]);
-      } else {
-        PRINT("ERROR: \"-s\" flag detected, but no serial number provided!\n");
-      }
-    }
-#ifdef MQTT_PROXY
-      if (strcmp(argv[i], "-host") == 0) {
-        if (i + 1 < argc) {
-          // hostname for MQTT proxy server
-          PRINT("MQTT proxy host %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_server, argv[i + 1], sizeof(g_mqttconf_server));
-        } else {
-          PRINT("ERROR: \"-host\" flag detected, but no hostname provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-port") == 0) {
-        if (i + 1 < argc) {
-          // port number for MQTT proxy server
-          PRINT("MQTT proxy port number %s\n", argv[i + 1]);
-          g_mqttconf_port = atoi(argv[i + 1]);
-        } else {
-          PRINT("ERROR: \"-port\" flag detected, but no port number provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-username") == 0) {
-        if (i + 1 < argc) {
-          // username for MQTT proxy server
-          PRINT("MQTT proxy username %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_username, argv[i + 1], sizeof(g_mqttconf_username));
-        } else {
-          PRINT("ERROR: \"-username\" flag detected, but no username provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-pwd") == 0) {
-        if (i + 1 < argc) {
-          // password for MQTT proxy server
-          PRINT("MQTT proxy pwd %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_pwd, argv[i + 1], sizeof(g_mqttconf_pwd));
-        } else {
-          PRINT("ERROR: \"-pwd\" flag detected, but no password provided!\n");
-        }
-      }
-#endif
-  }
-
-  /* do all initialization */
-  app_initialize_stack();
-
-#ifdef WIN32
-  /* windows specific loop */
-  while (quit != 1) {
-    next_event = oc_main_poll();
-    if (next_event == 0) {
-      SleepConditionVariableCS(&cv, &cs, INFINITE);
-    } else {
-      oc_clock_time_t now = oc_clock_time();
-      if (now < next_event) {
-        SleepConditionVariableCS(
-          &cv, &cs, (DWORD)((next_event - now) * 1000 / OC_CLOCK_SECOND));
-      }
-    }
-  }
-#endif /* WIN32 */
-
-#ifdef __linux__
-  /* Linux specific loop */
-  while (quit != 1) {
-    next_event = oc_main_poll();
-    pthread_mutex_lock(&mutex);
-    if (next_event == 0) {
-      pthread_cond_wait(&cv, &mutex);
-    } else {
-      ts.tv_sec = (next_event / OC_CLOCK_SECOND);
-      ts.tv_nsec = (next_event % OC_CLOCK_SECOND) * 1.e09 / OC_CLOCK_SECOND;
-      pthread_cond_timedwait(&cv, &mutex, &ts);
-    }
-    pthread_mutex_unlock(&mutex);
-  }
-#endif /* __linux__ */
-
-  /* shut down the stack */
-  oc_main_shutdown();
-  return 0;
-}
-#endif /* NO_MAIN */
+const app_info_t g_app_info = {
+  "KNX Battleships Demo",      /* name */
+  "KNX Battleships Demo eink", /* model */
+  "0MK4U5LV950ST3VRXL8G",      /* spake password */
+  "knx_eink_battleships",      /* storage */
+  app_init_screen,             /* init */
+};
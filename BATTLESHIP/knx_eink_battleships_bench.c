@@ -0,0 +1,370 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2022 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+*/
+/**
+ * @file
+ *
+ * Host replacements of the SDK for the game logic in the bench (APP_BENCH),
+ * see knx_eink_battleships_bench.h. The replay runs the due tasklets after
+ * each event and reports the bytes pushed to the display.
+ */
+
+#include "oc_api.h"
+#include <stdlib.h>
+#include <string.h>
+#include "knx_eink_battleships.h"
+#include "knx_eink_battleships_bench.h"
+
+#ifndef BENCH_STEP_MS
+/**
+ * @brief virtual time of one replayed event, the tasklets due in it are run
+ */
+#define BENCH_STEP_MS (10 * 1000)
+#endif
+
+// knx_eink_battleships_logic.c
+void logic_initialize();
+
+///////////////////////////////////////////////////////////////////////////////
+//               Tasklets                                                    //
+///////////////////////////////////////////////////////////////////////////////
+
+static ca_tasklet *g_tasklets = NULL; // queued tasklets, sorted by fire time
+static uint32_t g_now_ms = 0;         // virtual time
+
+ca_error TASKLET_Init(ca_tasklet *aTasklet, ca_tasklet_callback aCallback)
+{
+  memset(aTasklet, 0, sizeof(*aTasklet));
+  aTasklet->callback = aCallback;
+  return CA_ERROR_SUCCESS;
+}
+
+ca_error TASKLET_Cancel(ca_tasklet *aTasklet)
+{
+  for (ca_tasklet **it = &g_tasklets; *it != NULL; it = &(*it)->next) {
+    if (*it == aTasklet) {
+      *it = aTasklet->next;
+      aTasklet->queued = false;
+      return CA_ERROR_SUCCESS;
+    }
+  }
+  return CA_ERROR_INVALID_STATE;
+}
+
+ca_error TASKLET_ScheduleDelta(ca_tasklet *aTasklet, uint32_t aTimeDelta, void *aContext)
+{
+  if (aTasklet->callback == NULL)
+    return CA_ERROR_INVALID_STATE; // not initialised yet
+  if (aTasklet->queued)
+    TASKLET_Cancel(aTasklet);
+  aTasklet->fireTime = g_now_ms + aTimeDelta;
+  aTasklet->context = aContext;
+  // behind the tasklets of the same time, in order of scheduling
+  ca_tasklet **it = &g_tasklets;
+  while (*it != NULL && (*it)->fireTime <= aTasklet->fireTime)
+    it = &(*it)->next;
+  aTasklet->next = *it;
+  *it = aTasklet;
+  aTasklet->queued = true;
+  return CA_ERROR_SUCCESS;
+}
+
+/* runs the tasklets due in the next BENCH_STEP_MS of virtual time */
+static void bench_step(void)
+{
+  uint32_t end = g_now_ms + BENCH_STEP_MS;
+  while (g_tasklets != NULL && g_tasklets->fireTime <= end) {
+    ca_tasklet *tasklet = g_tasklets;
+    g_tasklets = tasklet->next;
+    tasklet->queued = false;
+    g_now_ms = tasklet->fireTime;
+    tasklet->callback(tasklet->context);
+  }
+  g_now_ms = end;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//               Display                                                     //
+///////////////////////////////////////////////////////////////////////////////
+
+// null display: the drawing is not rendered, the renders are counted
+static uint8_t g_framebuffer[BENCH_DISPLAY_FRAME_BYTES];
+static uint32_t g_display_bytes = 0;
+
+const uint8_t knx_iot_logo[BENCH_DISPLAY_FRAME_BYTES];
+
+void display_clear(void)
+{
+  memset(g_framebuffer, 0xff, sizeof(g_framebuffer));
+}
+
+void display_setCursor(int16_t x, int16_t y) { (void)x; (void)y; }
+void display_setTextSize(uint8_t s) { (void)s; }
+void display_setTextColor(uint16_t c, uint16_t bg) { (void)c; (void)bg; }
+void display_puts(const char *str) { (void)str; }
+void display_puts_max_n(const char *str, int n) { (void)str; (void)n; }
+int16_t display_getWidth(void) { return BENCH_DISPLAY_WIDTH; }
+int16_t display_getHeight(void) { return BENCH_DISPLAY_HEIGHT; }
+
+void display_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  (void)x0; (void)y0; (void)x1; (void)y1; (void)color;
+}
+
+void display_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+  (void)x0; (void)y0; (void)r; (void)color;
+}
+
+void display_drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2,
+                          int16_t y2, uint16_t color)
+{
+  (void)x0; (void)y0; (void)x1; (void)y1; (void)x2; (void)y2; (void)color;
+}
+
+void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  (void)x; (void)y; (void)w; (void)h; (void)color;
+}
+
+void display_fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                           uint16_t color)
+{
+  (void)x; (void)y; (void)w; (void)h; (void)r; (void)color;
+}
+
+// the SSD1681 is sent the whole frame, also for a partial refresh
+void display_fixed_image(const uint8_t *image)
+{
+  // rendered at once, e.g. the splash screen
+  memcpy(g_framebuffer, image, sizeof(g_framebuffer));
+  g_display_bytes += BENCH_DISPLAY_FRAME_BYTES;
+}
+
+void display_render_full(void)
+{
+  g_display_bytes += BENCH_DISPLAY_FRAME_BYTES;
+}
+
+void display_render_partial(bool sleep)
+{
+  (void)sleep;
+  g_display_bytes += BENCH_DISPLAY_FRAME_BYTES;
+}
+
+uint8_t *get_framebuffer(void)
+{
+  return g_framebuffer;
+}
+
+void SIF_SSD1681_overlay_qr_code(const char *text, uint8_t *framebuffer, uint8_t scale,
+                                 uint8_t x, uint8_t y)
+{
+  (void)text; (void)framebuffer; (void)scale; (void)x; (void)y;
+}
+
+static uint32_t bench_display_bytes(void)
+{
+  return g_display_bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//               Network                                                     //
+///////////////////////////////////////////////////////////////////////////////
+
+// not attached: no Thread network, no manufacturer data
+otInstance *OT_INSTANCE = NULL;
+static const otExtAddress g_ext_address = { { 0 } };
+static const otIp6Address g_all_nodes = { { 0xff, 0x03, [15] = 0x01 } };
+
+otDeviceRole otThreadGetDeviceRole(otInstance *aInstance)
+{
+  (void)aInstance;
+  return OT_DEVICE_ROLE_DISABLED;
+}
+
+const char *otThreadDeviceRoleToString(otDeviceRole aRole)
+{
+  (void)aRole;
+  return "disabled";
+}
+
+uint16_t otThreadGetRloc16(otInstance *aInstance)
+{
+  (void)aInstance;
+  return 0xfffe;
+}
+
+otLinkModeConfig otThreadGetLinkMode(otInstance *aInstance)
+{
+  otLinkModeConfig config = { 0 };
+  (void)aInstance;
+  config.mRxOnWhenIdle = 1;
+  return config;
+}
+
+int otThreadSetLinkMode(otInstance *aInstance, otLinkModeConfig aConfig)
+{
+  (void)aInstance;
+  (void)aConfig;
+  return 0;
+}
+
+const otIp6Address *otThreadGetRealmLocalAllThreadNodesMulticastAddress(otInstance *aInstance)
+{
+  (void)aInstance;
+  return &g_all_nodes;
+}
+
+const otExtAddress *otLinkGetExtendedAddress(otInstance *aInstance)
+{
+  (void)aInstance;
+  return &g_ext_address;
+}
+
+void otLinkGetFactoryAssignedIeeeEui64(otInstance *aInstance, otExtAddress *aEui64)
+{
+  (void)aInstance;
+  *aEui64 = g_ext_address;
+}
+
+int otPingSenderPing(otInstance *aInstance, const otPingSenderConfig *aConfig)
+{
+  (void)aInstance;
+  (void)aConfig;
+  return 0;
+}
+
+void otPingSenderStop(otInstance *aInstance)
+{
+  (void)aInstance;
+}
+
+void PlatformGetQRString(char *aBuf, uint16_t aBufLen, otInstance *aInstance)
+{
+  (void)aInstance;
+  if (aBufLen > 0)
+    aBuf[0] = 0;
+}
+
+const char *PlatformGetJoinerCredential(otInstance *aInstance)
+{
+  (void)aInstance;
+  return "";
+}
+
+int knx_get_stored_thread_password(char *password)
+{
+  (void)password;
+  return 1;
+}
+
+int knx_get_stored_eui64(uint8_t *eui64)
+{
+  (void)eui64;
+  return 1;
+}
+
+int knx_get_stored_serial_number(uint8_t *serial_number)
+{
+  (void)serial_number;
+  return 1;
+}
+
+int knx_get_stored_password(char *password)
+{
+  (void)password;
+  return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//               Replay                                                      //
+///////////////////////////////////////////////////////////////////////////////
+
+static void bench_put_callback(const char *url)
+{
+  // each handler checks the url
+  onReceivedShot(url);
+  onReceivedShotStatus(url);
+  onReceivedReady(url);
+}
+
+static const struct bench_button_t
+{
+  const char *name; // <button> <press>
+  void (*cb)(void *ctx);
+} g_bench_buttons[] = {
+  { "1 short", button_1_ShortPress_cb }, { "1 long", button_1_LongPress_cb },
+  { "2 short", button_2_ShortPress_cb }, { "2 long", button_2_LongPress_cb },
+  { "3 short", button_3_ShortPress_cb }, { "3 long", button_3_LongPress_cb },
+  { "3 hold", button_3_Hold_cb },
+};
+
+/* button <1|2|3> <short|long|hold>: a press of a button of the board */
+static bool bench_event(const char *name, char *args)
+{
+  if (strcmp(name, "button") != 0 || args == NULL)
+    return false;
+  char *button = strtok(args, " \t");
+  char *press = strtok(NULL, " \t");
+  if (button == NULL || press == NULL)
+    return false;
+  for (size_t i = 0; i < sizeof(g_bench_buttons) / sizeof(g_bench_buttons[0]); i++) {
+    const char *it = g_bench_buttons[i].name;
+    size_t len = strlen(button);
+    if (strncmp(it, button, len) == 0 && it[len] == ' ' && strcmp(it + len + 1, press) == 0) {
+      g_bench_buttons[i].cb(NULL);
+      return true;
+    }
+  }
+  return false;
+}
+
+static const app_replay_app_t g_bench_replay = {
+  bench_event,         /* event */
+  bench_step,          /* step */
+  bench_display_bytes, /* display_bytes */
+};
+
+void bench_logic_initialize(void)
+{
+  app_initialize();
+  logic_initialize();
+  app_set_put_cb(bench_put_callback);
+  app_replay_set_app(&g_bench_replay);
+}
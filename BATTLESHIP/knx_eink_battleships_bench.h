@@ -0,0 +1,213 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2022 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+*/
+/**
+ * @file
+ *
+ * Host replacements of the Cascoda SDK parts used by knx_eink_battleships_logic.c,
+ * so that the bench (APP_BENCH) replays the game logic:
+ * - tasklets on a virtual clock, run by the replay step
+ * - a null display with the frame buffer of the SSD1681, counting the bytes
+ *   pushed to the panel
+ * - the OpenThread and manufacturer storage functions, without a network
+ */
+#ifndef KNX_EINK_BATTLESHIPS_BENCH_H
+#define KNX_EINK_BATTLESHIPS_BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////// cascoda-util/cascoda_tasklet.h ///////
+
+typedef enum ca_error
+{
+  CA_ERROR_SUCCESS = 0,
+  CA_ERROR_INVALID_STATE,
+} ca_error;
+
+typedef ca_error (*ca_tasklet_callback)(void *aContext);
+
+typedef struct ca_tasklet
+{
+  struct ca_tasklet *next;      /**< next tasklet of the queue */
+  uint32_t fireTime;            /**< virtual time to run at, in ms */
+  ca_tasklet_callback callback; /**< the work of the tasklet */
+  void *context;                /**< argument of the callback */
+  bool queued;                  /**< the tasklet is in the queue */
+} ca_tasklet;
+
+ca_error TASKLET_Init(ca_tasklet *aTasklet, ca_tasklet_callback aCallback);
+ca_error TASKLET_ScheduleDelta(ca_tasklet *aTasklet, uint32_t aTimeDelta, void *aContext);
+ca_error TASKLET_Cancel(ca_tasklet *aTasklet);
+
+/////// gfx_library.h, gfx_driver.h, sif_ssd1681.h ///////
+
+#define BLACK 0
+#define WHITE 1
+
+#ifndef BENCH_DISPLAY_WIDTH
+/**
+ * @brief width of the 1.54 inch SSD1681 panel, in pixels
+ */
+#define BENCH_DISPLAY_WIDTH 200
+#endif
+
+#ifndef BENCH_DISPLAY_HEIGHT
+/**
+ * @brief height of the 1.54 inch SSD1681 panel, in pixels
+ */
+#define BENCH_DISPLAY_HEIGHT 200
+#endif
+
+/**
+ * @brief the frame buffer, 1 bit per pixel, written to the panel by each render
+ */
+#define BENCH_DISPLAY_FRAME_BYTES (BENCH_DISPLAY_WIDTH * BENCH_DISPLAY_HEIGHT / 8)
+
+void display_clear(void);
+void display_setCursor(int16_t x, int16_t y);
+void display_setTextSize(uint8_t s);
+void display_setTextColor(uint16_t c, uint16_t bg);
+void display_puts(const char *str);
+void display_puts_max_n(const char *str, int n);
+int16_t display_getWidth(void);
+int16_t display_getHeight(void);
+void display_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void display_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void display_drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2,
+                          int16_t y2, uint16_t color);
+void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void display_fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                           uint16_t color);
+void display_fixed_image(const uint8_t *image);
+void display_render_full(void);
+void display_render_partial(bool sleep);
+uint8_t *get_framebuffer(void);
+void SIF_SSD1681_overlay_qr_code(const char *text, uint8_t *framebuffer, uint8_t scale,
+                                 uint8_t x, uint8_t y);
+
+/**
+ * @brief knx_iot_image_1_54.h: the splash screen
+ */
+extern const uint8_t knx_iot_logo[BENCH_DISPLAY_FRAME_BYTES];
+
+/////// openthread, platform.h, manufacturer_storage.h ///////
+
+typedef struct otInstance otInstance;
+
+typedef enum otDeviceRole
+{
+  OT_DEVICE_ROLE_DISABLED = 0,
+  OT_DEVICE_ROLE_DETACHED = 1,
+  OT_DEVICE_ROLE_CHILD = 2,
+  OT_DEVICE_ROLE_ROUTER = 3,
+  OT_DEVICE_ROLE_LEADER = 4,
+} otDeviceRole;
+
+typedef struct otExtAddress
+{
+  uint8_t m8[8];
+} otExtAddress;
+
+typedef struct otIp6Address
+{
+  uint8_t m8[16];
+} otIp6Address;
+
+typedef struct otLinkModeConfig
+{
+  bool mRxOnWhenIdle : 1;
+  bool mDeviceType : 1;
+  bool mNetworkData : 1;
+} otLinkModeConfig;
+
+typedef struct otPingSenderStatistics
+{
+  uint16_t mSentCount;
+  uint16_t mReceivedCount;
+} otPingSenderStatistics;
+
+typedef void (*otPingSenderStatisticsCallback)(const otPingSenderStatistics *aStatistics,
+                                               void *aContext);
+
+typedef struct otPingSenderConfig
+{
+  otIp6Address mDestination;
+  void *mReplyCallback;
+  otPingSenderStatisticsCallback mStatisticsCallback;
+  void *mCallbackContext;
+  uint16_t mCount;
+  uint32_t mInterval;
+  uint16_t mTimeout;
+  bool mAllowZeroHopLimit;
+} otPingSenderConfig;
+
+otDeviceRole otThreadGetDeviceRole(otInstance *aInstance);
+const char *otThreadDeviceRoleToString(otDeviceRole aRole);
+uint16_t otThreadGetRloc16(otInstance *aInstance);
+otLinkModeConfig otThreadGetLinkMode(otInstance *aInstance);
+int otThreadSetLinkMode(otInstance *aInstance, otLinkModeConfig aConfig);
+const otIp6Address *otThreadGetRealmLocalAllThreadNodesMulticastAddress(otInstance *aInstance);
+const otExtAddress *otLinkGetExtendedAddress(otInstance *aInstance);
+void otLinkGetFactoryAssignedIeeeEui64(otInstance *aInstance, otExtAddress *aEui64);
+int otPingSenderPing(otInstance *aInstance, const otPingSenderConfig *aConfig);
+void otPingSenderStop(otInstance *aInstance);
+void PlatformGetQRString(char *aBuf, uint16_t aBufLen, otInstance *aInstance);
+const char *PlatformGetJoinerCredential(otInstance *aInstance);
+int knx_get_stored_thread_password(char *password);
+int knx_get_stored_eui64(uint8_t *eui64);
+int knx_get_stored_serial_number(uint8_t *serial_number);
+int knx_get_stored_password(char *password);
+
+/////// bench ///////
+
+/**
+ * @brief starts the game logic and connects it to the replay,
+ * from app_init_screen
+ */
+void bench_logic_initialize(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KNX_EINK_BATTLESHIPS_BENCH_H */
@@ -149,6 +149,10 @@ void actuator_test_init();
  * @param url the url that received a PUT invocation.
  */
 void dev_put_callback(const char* url){
+#ifdef SLEEPY
+  // received PUT or s-mode write: poll fast for follow-up messages
+  main_PollActivity();
+#endif
   if (strcmp(url, URL_RECEIVESHOT) == 0) {
       if (strcmp(url, URL_RECEIVESHOT) == 0)
       {
@@ -255,6 +259,18 @@ void hardware_reinitialise(void)
 } 
 #endif // SLEEPY
 
+/* the screen handlers use the stack, they run from the event ring */
+static const app_event_cb_t g_button_handlers[] = {
+  button_1_ShortPress_cb, button_1_LongPress_cb,
+  button_2_ShortPress_cb, button_2_LongPress_cb,
+  button_3_ShortPress_cb, button_3_LongPress_cb, button_3_Hold_cb
+};
+
+static void button_post_cb(void *ctx)
+{
+  app_event_post_call(*(const app_event_cb_t *)ctx, NULL);
+}
+#define BUTTON_HANDLER(i) ((void *)&g_button_handlers[i])
 
 /**
  * @brief do the hardware installation
@@ -276,15 +292,15 @@ void hardware_init()
   SENSORIF_SPI_Config(SPI_NUM);
   SIF_SSD1681_Initialise();
   DVBD_RegisterButtonIRQInput(DEV_SWITCH_2, JUMPER_POS_1); 
-  DVBD_SetButtonShortPressCallback(DEV_SWITCH_2, &button_1_ShortPress_cb, NULL, BTN_SHORTPRESS_RELEASED);
-  DVBD_SetButtonLongPressCallback(DEV_SWITCH_2, &button_1_LongPress_cb, NULL, BTN_LONGPRESS_TIME_DEFAULT);   
+  DVBD_SetButtonShortPressCallback(DEV_SWITCH_2, &button_post_cb, BUTTON_HANDLER(0), BTN_SHORTPRESS_RELEASED);
+  DVBD_SetButtonLongPressCallback(DEV_SWITCH_2, &button_post_cb, BUTTON_HANDLER(1), BTN_LONGPRESS_TIME_DEFAULT);   
   DVBD_RegisterButtonIRQInput(DEV_SWITCH_3, JUMPER_POS_1); 
-  DVBD_SetButtonShortPressCallback(DEV_SWITCH_3, &button_2_ShortPress_cb, NULL, BTN_SHORTPRESS_RELEASED);
-  DVBD_SetButtonLongPressCallback(DEV_SWITCH_3, &button_2_LongPress_cb, NULL, BTN_LONGPRESS_TIME_DEFAULT);   
+  DVBD_SetButtonShortPressCallback(DEV_SWITCH_3, &button_post_cb, BUTTON_HANDLER(2), BTN_SHORTPRESS_RELEASED);
+  DVBD_SetButtonLongPressCallback(DEV_SWITCH_3, &button_post_cb, BUTTON_HANDLER(3), BTN_LONGPRESS_TIME_DEFAULT);   
   DVBD_RegisterButtonIRQInput(DEV_SWITCH_4, JUMPER_POS_1); 
-  DVBD_SetButtonShortPressCallback(DEV_SWITCH_4, &button_3_ShortPress_cb, NULL, BTN_SHORTPRESS_RELEASED);
-  DVBD_SetButtonLongPressCallback(DEV_SWITCH_4, &button_3_LongPress_cb, NULL, BTN_LONGPRESS_TIME_DEFAULT);
-  DVBD_SetButtonHoldCallback(DEV_SWITCH_4, &button_3_Hold_cb, NULL, BTN_HOLD_TIME_DEFAULT);     
+  DVBD_SetButtonShortPressCallback(DEV_SWITCH_4, &button_post_cb, BUTTON_HANDLER(4), BTN_SHORTPRESS_RELEASED);
+  DVBD_SetButtonLongPressCallback(DEV_SWITCH_4, &button_post_cb, BUTTON_HANDLER(5), BTN_LONGPRESS_TIME_DEFAULT);
+  DVBD_SetButtonHoldCallback(DEV_SWITCH_4, &button_post_cb, BUTTON_HANDLER(6), BTN_HOLD_TIME_DEFAULT);     
 
  
 
@@ -325,20 +341,8 @@ void hardware_poll()
 
 bool app_is_url_in_use(const char* url)
 {
-   int index;
-   oc_string_t oc_str;
-   int table_size = oc_core_get_group_object_table_total_size();
-
-  // check if the URL is in the Group Object Table
-  for (index = 0; index++; index < table_size) {
-    oc_str = oc_core_find_group_object_table_url_from_index( index);
-    if (oc_string_len(oc_str) > 0) {
-        if (strcmp(url, oc_string(oc_str)) == 0) {
-            return true;
-        }
-    }
-  }
-  return false;
+  // check if the URL is in the Group Object Table, using the table index
+  return app_get_got_index(url) > -1;
 }
 
 #ifdef ACTUATOR_TEST_MODE
@@ -39,7 +39,12 @@
 
 #include <ctype.h>
 #include "knx_eink_battleships.h"
+#ifdef APP_BENCH
+// host replacements of the SDK, the display and the network
+#include "knx_eink_battleships_bench.h"
+#else
 #include "cascoda-util/cascoda_tasklet.h"
+#endif
 #include "oc_core_res.h"
 #include "api/oc_knx_dev.h"
 #include "api/oc_knx_sec.h"
@@ -47,6 +52,7 @@
 #include "port/dns-sd.h"
 #include "oc_knx.h"
 #include "port/dns-sd.h"
+#ifndef APP_BENCH
 #include "openthread/thread.h"
 #include "openthread/ping_sender.h"
 #include "platform.h"
@@ -58,11 +64,12 @@
 #include "gfx_library.h"
 #include "gfx_driver.h"
 #include "knx_iot_image_1_54.h" // splash screen
+#endif /* APP_BENCH */
 
 enum Screen g_screen_nr;
 bool g_eink_clean_redraw = true;
-uint32_t g_eink_draws_without_refresh = 0;
-const uint32_t g_eink_draws_cutoff = 12;
+uint32_t g_eink_damage_area = 0; // damaged cells drawn since the last full refresh
+const uint32_t g_eink_damage_cutoff = 12 * 100; // a full screen counts as 100 cells
 enum BattDisplaySymbol g_batt_display_symbol = BATT_DISPLAY_ICON;
 ca_tasklet screen_Tasklet;
 #ifdef TRANSLATE_PRESENT
@@ -75,16 +82,22 @@ extern char *translate(const char *s);
 #define SCHEDULE_NOW 0
 
 
+#ifndef APP_BENCH
 #include "cascoda-util/cascoda_tasklet.h"
 #include "cascoda-util/cascoda_time.h"
+#endif
 
 // application specific
 #include "api/oc_knx_dev.h"
 #include "api/oc_knx_sec.h"
+#ifndef APP_BENCH
 #include "gfx_driver.h"  // include  controller driver source code
 #include "gfx_library.h" // include graphics library header
+#endif
 
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
 #include <stdbool.h>
 
 #define SPI_NUM 1                    // SPI interface used for display
@@ -113,50 +126,45 @@ enum PlayerNo{
   OBSERVER,
 };
 
-/**
- * @brief Hit state for cell
- * None: no shot on cell
- * Hit: cell shot and contained ship
- * Miss: cell shot but was empty
-*/
-enum HitState{
-  HS_NONE,
-  HS_HIT,
-  HS_MISS,
-};
-
 /**
  * @brief Ship data struct
  * contains position x/y, length
- * boolean for if sunk, ship orientation.
+ * and ship orientation. Whether the ship
+ * is sunk is kept in the board.
 */
 struct battleships_ship{
   uint8_t px, py;
   uint8_t length;
-  bool sunk;
   enum ShipOrientation orientation;
 };
 
 /**
- * @brief board cell data struct
- * Hitstate for hit/miss/none,
- * occupy index (index into ships array
- * rather than using a large pointer)
+ * @brief 10x10 cells as a bit mask, bit BB_BIT(x, y) is cell x,y.
+ * Two 64 bit words, there is no 128 bit integer on the M2351.
 */
-struct battleships_cell
+typedef struct bb128
 {
-  enum HitState hitstate:3;
-  int occupy_index:5;
-  // struct battleships_ship *occupy;
-};
+  uint64_t w[2];
+} bb128_t;
+
+#define BB_BIT(x, y) ((y) * 10 + (x))
+#define BB_BYTES 13            // packed size of the 100 cells
+#define BB_ALL_SHIPS 0x1F      // sunk mask when all 5 ships are sunk
 
 /** 
  * @brief battleships game board
- * contains 10x10 cells
+ * hit and miss masks of the shots on the board,
+ * the cells of each ship and the occupied cells.
+ * For the opponent's board the ship masks only
+ * contain the cells hit so far.
 */
 struct battleships_board
 {
-  struct battleships_cell cells[10][10];
+  bb128_t hits;
+  bb128_t misses;
+  bb128_t occupied;
+  bb128_t ships[5];
+  uint8_t sunk; // bit i: ship i is sunk
 };
 
 /**
@@ -179,6 +187,110 @@ struct battleships_game
 */
 struct battleships_game g_game;
 
+// ===============================
+// BITBOARDS
+// ===============================
+
+static inline bool bb_test(const bb128_t *b, int bit)
+{
+  return (b->w[bit >> 6] >> (bit & 63)) & 1;
+}
+
+static inline void bb_set(bb128_t *b, int bit)
+{
+  b->w[bit >> 6] |= 1ull << (bit & 63);
+}
+
+static inline bb128_t bb_and(bb128_t a, bb128_t b)
+{
+  return (bb128_t){ { a.w[0] & b.w[0], a.w[1] & b.w[1] } };
+}
+
+static inline bb128_t bb_or(bb128_t a, bb128_t b)
+{
+  return (bb128_t){ { a.w[0] | b.w[0], a.w[1] | b.w[1] } };
+}
+
+// a without the cells of b
+static inline bb128_t bb_andnot(bb128_t a, bb128_t b)
+{
+  return (bb128_t){ { a.w[0] & ~b.w[0], a.w[1] & ~b.w[1] } };
+}
+
+static inline bool bb_empty(bb128_t a)
+{
+  return (a.w[0] | a.w[1]) == 0;
+}
+
+static inline int bb_popcount(bb128_t a)
+{
+  return __builtin_popcountll(a.w[0]) + __builtin_popcountll(a.w[1]);
+}
+
+// lowest cell in the mask, -1 if empty
+static inline int bb_first(bb128_t a)
+{
+  if (a.w[0])
+    return __builtin_ctzll(a.w[0]);
+  if (a.w[1])
+    return 64 + __builtin_ctzll(a.w[1]);
+  return -1;
+}
+
+static void bb_pack(bb128_t a, uint8_t out[BB_BYTES])
+{
+  for (int i = 0; i < BB_BYTES; i++)
+    out[i] = (uint8_t)(a.w[i >> 3] >> ((i & 7) * 8));
+}
+
+static bb128_t bb_unpack(const uint8_t in[BB_BYTES])
+{
+  bb128_t a = { { 0, 0 } };
+  for (int i = 0; i < BB_BYTES; i++)
+    a.w[i >> 3] |= (uint64_t)in[i] << ((i & 7) * 8);
+  return a;
+}
+
+/**
+ * @brief Mask of the cells covered by a ship
+*/
+static bb128_t bb_ship(const struct battleships_ship *ship)
+{
+  bb128_t mask = { { 0, 0 } };
+  for (int i = 0; i < ship->length; i++)
+    bb_set(&mask, BB_BIT(ship->px + i*(ship->orientation==HORIZONTAL?1:0),
+                         ship->py + i*(ship->orientation==VERTICAL?1:0)));
+  return mask;
+}
+
+/**
+ * @brief Index of the ship on the cell, -1 if none
+*/
+static int board_ship_at(const struct battleships_board *board, int bit)
+{
+  if (!bb_test(&board->occupied, bit))
+    return -1;
+  for (int i = 0; i < 5; i++) {
+    if (bb_test(&board->ships[i], bit))
+      return i;
+  }
+  return -1;
+}
+
+static bool board_all_sunk(const struct battleships_board *board)
+{
+  return board->sunk == BB_ALL_SHIPS;
+}
+
+/**
+ * @brief Number of shots and hits on a board
+*/
+static void board_stats(const struct battleships_board *board, int *shots, int *hits)
+{
+  *hits = bb_popcount(board->hits);
+  *shots = *hits + bb_popcount(board->misses);
+}
+
 /**
  * @brief settings used to change drawing behaviour
 */
@@ -192,6 +304,262 @@ enum GraphicsSettings
   CELL_OFF = 1,
 };
 
+// ===============================
+// DAMAGE TRACKING
+// ===============================
+// Changes of cells, the target and ships mark the cells they cover as damaged.
+// A game screen that is drawn again only clears and redraws the damaged cells
+// (see load_damage_cb), other changes damage the whole screen.
+
+#define EINK_FULL_DAMAGE (GRID_COUNT * GRID_COUNT) /**< damage of a full redraw */
+
+static uint16_t g_eink_damage[GRID_COUNT]; // bit x of row y: cell x,y is damaged
+static bool g_eink_damage_all = true;
+static int g_eink_drawn_screen = -1;       // screen in the display buffer
+
+/**
+ * @brief Mark a rectangle of cells as damaged
+ *
+ * @param x first column
+ * @param y first row
+ * @param w number of columns
+ * @param h number of rows
+*/
+static void eink_damage_cells(int x, int y, int w, int h)
+{
+  for (int row = y; row < y + h && row < GRID_COUNT; row++) {
+    for (int col = x; col < x + w && col < GRID_COUNT; col++) {
+      if (row >= 0 && col >= 0)
+        g_eink_damage[row] |= (uint16_t)(1u << col);
+    }
+  }
+}
+
+/**
+ * @brief Mark the cells covered by a ship as damaged
+*/
+static void eink_damage_ship(const struct battleships_ship *ship)
+{
+  if (ship->length == 0)
+    return;
+  eink_damage_cells(ship->px, ship->py,
+                    ship->orientation == HORIZONTAL ? ship->length : 1,
+                    ship->orientation == VERTICAL ? ship->length : 1);
+}
+
+/**
+ * @brief Mark the whole screen as damaged, e.g. when the shown board changes
+*/
+static void eink_damage_all()
+{
+  g_eink_damage_all = true;
+}
+
+static bool eink_cell_is_damaged(int x, int y)
+{
+  return (g_eink_damage[y] >> x) & 1;
+}
+
+static bool eink_ship_is_damaged(const struct battleships_ship *ship, bool *all)
+{
+  bool any = false;
+  *all = true;
+  for (int i = 0; i < ship->length; i++) {
+    bool damaged = eink_cell_is_damaged(ship->px + i*(ship->orientation==HORIZONTAL?1:0),
+                                        ship->py + i*(ship->orientation==VERTICAL?1:0));
+    any |= damaged;
+    *all &= damaged;
+  }
+  return any;
+}
+
+/**
+ * @brief Number of damaged cells, EINK_FULL_DAMAGE if all are damaged
+*/
+static uint32_t eink_damage_count()
+{
+  if (g_eink_damage_all)
+    return EINK_FULL_DAMAGE;
+  uint32_t count = 0;
+  for (int y = 0; y < GRID_COUNT; y++)
+    for (uint16_t row = g_eink_damage[y]; row; row &= row - 1)
+      count++;
+  return count;
+}
+
+static void eink_damage_clear()
+{
+  memset(g_eink_damage, 0, sizeof(g_eink_damage));
+  g_eink_damage_all = false;
+}
+
+// ===============================
+// SESSION RECORD
+// ===============================
+// The screen and the game are kept in one storage record, so that a game
+// survives a reboot. The record is only written when it is changed, at the
+// end of a turn, before sleeping (app_persist_flush) or SESSION_SAVE_DELAY
+// after the last screen change. Target moves alone do not cause a write.
+
+#define SESSION_STORE_NAME "bs_session"
+#define SESSION_VERSION 2
+#define SESSION_SAVE_DELAY (10*1000) // ms after a screen load
+
+/**
+ * @brief board and ships of a player, as stored in the session record
+*/
+struct battleships_packed_board
+{
+  uint8_t hits[BB_BYTES];
+  uint8_t misses[BB_BYTES];
+  uint8_t ships[5][BB_BYTES];
+  uint8_t ship_pos[5];   // py << 4 | px
+  uint8_t ship_info[5];  // orientation << 3 | length
+  uint8_t sunk;
+};
+
+static void board_pack(int idx, struct battleships_packed_board *out)
+{
+  const struct battleships_board *board = &g_game.boards[idx];
+  bb_pack(board->hits, out->hits);
+  bb_pack(board->misses, out->misses);
+  for (int i = 0; i < 5; i++) {
+    const struct battleships_ship *ship = &g_game.ships[idx][i];
+    bb_pack(board->ships[i], out->ships[i]);
+    out->ship_pos[i] = (uint8_t)(ship->py << 4 | ship->px);
+    out->ship_info[i] = (uint8_t)(ship->orientation << 3 | ship->length);
+  }
+  out->sunk = board->sunk;
+}
+
+static void board_unpack(int idx, const struct battleships_packed_board *in)
+{
+  struct battleships_board *board = &g_game.boards[idx];
+  board->hits = bb_unpack(in->hits);
+  board->misses = bb_unpack(in->misses);
+  board->occupied = (bb128_t){ { 0, 0 } };
+  for (int i = 0; i < 5; i++) {
+    struct battleships_ship *ship = &g_game.ships[idx][i];
+    board->ships[i] = bb_unpack(in->ships[i]);
+    board->occupied = bb_or(board->occupied, board->ships[i]);
+    ship->px = in->ship_pos[i] & 0x0F;
+    ship->py = in->ship_pos[i] >> 4;
+    ship->length = in->ship_info[i] & 0x07;
+    ship->orientation = (enum ShipOrientation)(in->ship_info[i] >> 3);
+  }
+  board->sunk = in->sunk;
+}
+
+/**
+ * @brief stored session: screen and game state
+*/
+struct battleships_session
+{
+  uint8_t version;
+  uint8_t screen_nr;
+  int8_t currentShip;
+  uint8_t currentPlayerNo;
+  uint8_t myPlayerNo;
+  struct battleships_packed_board boards[2];
+  // not part of the change detection
+  int8_t tx, ty;
+};
+
+static uint32_t g_session_hash;    // hash of the stored record
+static bool g_session_save_scheduled = false;
+static ca_tasklet g_session_tasklet;
+
+static void session_fill(struct battleships_session *session)
+{
+  memset(session, 0, sizeof(*session));
+  session->version = SESSION_VERSION;
+  session->screen_nr = (uint8_t)g_screen_nr;
+  session->currentShip = g_game.currentShip;
+  session->currentPlayerNo = (uint8_t)g_game.currentPlayerNo;
+  session->myPlayerNo = (uint8_t)g_game.myPlayerNo;
+  board_pack(PLAYER1, &session->boards[PLAYER1]);
+  board_pack(PLAYER2, &session->boards[PLAYER2]);
+  session->tx = g_game.tx;
+  session->ty = g_game.ty;
+}
+
+// FNV-1a of the record, without the target position
+static uint32_t session_hash(const struct battleships_session *session)
+{
+  const uint8_t *data = (const uint8_t *)session;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < offsetof(struct battleships_session, tx); i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * @brief Write the session record if it is changed
+*/
+static void session_save()
+{
+  struct battleships_session session;
+  session_fill(&session);
+  uint32_t hash = session_hash(&session);
+  if (hash == g_session_hash)
+    return;
+  if (oc_storage_write(SESSION_STORE_NAME, (uint8_t *)&session, sizeof(session)) < 0)
+    return;
+  g_session_hash = hash;
+}
+
+static ca_error session_save_cb(void *context)
+{
+  (void)context;
+  g_session_save_scheduled = false;
+  session_save();
+  return CA_ERROR_SUCCESS;
+}
+
+/**
+ * @brief Save the session later, if it is changed
+*/
+static void session_schedule_save()
+{
+  struct battleships_session session;
+  if (g_session_save_scheduled)
+    return;
+  session_fill(&session);
+  if (session_hash(&session) == g_session_hash)
+    return;
+  g_session_save_scheduled = true;
+  TASKLET_ScheduleDelta(&g_session_tasklet, SESSION_SAVE_DELAY, NULL);
+}
+
+/**
+ * @brief Restore the screen and the game of the stored session
+ *
+ * @return true a session was restored
+*/
+static bool session_load()
+{
+  struct battleships_session session;
+  TASKLET_Init(&g_session_tasklet, &session_save_cb);
+  app_persist_set_flush_cb(&session_save);
+  long size = oc_storage_read(SESSION_STORE_NAME, (uint8_t *)&session, sizeof(session));
+  if (size != sizeof(session) || session.version != SESSION_VERSION ||
+      session.screen_nr >= NUM_SCREENS)
+    return false;
+  g_screen_nr = (enum Screen)session.screen_nr;
+  g_game.currentShip = session.currentShip;
+  g_game.currentPlayerNo = (enum PlayerNo)session.currentPlayerNo;
+  g_game.myPlayerNo = (enum PlayerNo)session.myPlayerNo;
+  board_unpack(PLAYER1, &session.boards[PLAYER1]);
+  board_unpack(PLAYER2, &session.boards[PLAYER2]);
+  g_game.tx = session.tx;
+  g_game.ty = session.ty;
+  g_session_hash = session_hash(&session);
+  eink_damage_all();
+  return true;
+}
+
 // ===============================
 // GLOBAL VARIABLE DEFINITIONS
 // ===============================
@@ -211,33 +579,6 @@ static int g_wait_time = 0;
 */
 const uint8_t ship_lens[] = {5, 4, 3, 3, 2};
 
-/**
- * @brief Get the ship* given an integer index
- * 
- * @param idx integer idx as stored in each cell
- * @return pointer to the occupying ship (if present)
-*/
-struct battleships_ship* get_occupy_from_idx(int idx) {
-  if (idx%6 == 0)
-    return NULL;
-  return &g_game.ships[idx/6][(idx%6)-1];
-}
-
-/**
- * @brief Get the ship integer index given a ship*
- * 
- * @param ship Ship to get the index of
- * @return index of ship
- * 
- * @note WILL RETURN AN INVALID INDEX IF SHIP IS NOT
- * PART OF THE GAME!
-*/
-int get_occupy_idx_from_ship(struct battleships_ship *ship) {
-  if (ship == NULL)
-    return 0;
-  return 1 + (ship - *g_game.ships);
-}
-
 /**
  * @brief Fire a shot at the opponent. 
  * Targeted square is the location of the shot.
@@ -264,8 +605,10 @@ static void game_fire_shot()
 */
 static void game_move_target(int dx, int dy)
 {
+  eink_damage_cells(g_game.tx, g_game.ty, 1, 1);
   g_game.tx = (g_game.tx + dx + 10) % 10;
   g_game.ty = (g_game.ty + dy + 10) % 10;
+  eink_damage_cells(g_game.tx, g_game.ty, 1, 1);
 }
 
 /**
@@ -288,8 +631,10 @@ static void game_move_current_ship(int dx, int dy)
   uint8_t my = 10 - (ship->orientation == HORIZONTAL?0:ship->length-1);
   px = (px + dx + mx) % mx;
   py = (py + dy + my) % my;
+  eink_damage_ship(ship);
   ship->px = px;
   ship->py = py;
+  eink_damage_ship(ship);
 }
 
 /**
@@ -351,27 +696,23 @@ static void game_place_current_ship()
     struct battleships_ship *ship =
       &g_game.ships[g_game.myPlayerNo][g_game.currentShip];
     struct battleships_board *board = &g_game.boards[g_game.myPlayerNo];
-    for(int i = 0; i < ship->length; i++){
-      uint8_t sx = ship->px + i*(ship->orientation==HORIZONTAL?1:0);
-      uint8_t sy = ship->py + i*(ship->orientation==VERTICAL?1:0);
-      if (get_occupy_from_idx(board->cells[sx][sy].occupy_index) != NULL)
-        return;
-    }
-    for(int i = 0; i < ship->length; i++){
-      uint8_t sx = ship->px + i*(ship->orientation==HORIZONTAL?1:0);
-      uint8_t sy = ship->py + i*(ship->orientation==VERTICAL?1:0);
-      board->cells[sx][sy].occupy_index = get_occupy_idx_from_ship(ship);
-    }
+    bb128_t mask = bb_ship(ship);
+    if (!bb_empty(bb_and(mask, board->occupied)))
+      return;
+    board->ships[g_game.currentShip] = mask;
+    board->occupied = bb_or(board->occupied, mask);
 
   }
   g_game.currentShip++;
   if(g_game.currentShip == 5){
     next_screen(true);
+    session_save();
     return;
   }
   struct battleships_ship *ship =
     &g_game.ships[g_game.myPlayerNo][g_game.currentShip];
   ship->length = ship_lens[g_game.currentShip];
+  eink_damage_ship(ship);
   refresh_screen(false);
   
 }
@@ -387,6 +728,7 @@ static void game_rotate_current_ship()
 {
   struct battleships_ship *ship =
     &g_game.ships[g_game.myPlayerNo][g_game.currentShip];
+  eink_damage_ship(ship);
   if (ship->orientation == VERTICAL)
     ship->orientation = HORIZONTAL;
   else if (ship->orientation == HORIZONTAL)
@@ -425,23 +767,26 @@ static void game_draw_grid()
  * whether they were hits or misses.
  * 
  * @param idx Player number to draw shots for
+ * @param damaged_only only draw the shots of damaged cells
 */
-static void game_draw_shots(int idx)
+static void game_draw_shots(int idx, bool damaged_only)
 {
   int ox = GRID_OX;
   int oy = GRID_OY;
   for(uint8_t x = 0; x < 10; x++){
     for(uint8_t y = 0; y < 10; y++){
-      struct battleships_cell *cell =
-        &g_game.boards[idx].cells[x][y];
-      enum HitState hs = cell->hitstate;
-      if (hs != HS_NONE){
+      if (damaged_only && !eink_cell_is_damaged(x, y))
+        continue;
+      const struct battleships_board *board = &g_game.boards[idx];
+      bool hit = bb_test(&board->hits, BB_BIT(x, y));
+      bool miss = bb_test(&board->misses, BB_BIT(x, y));
+      if (hit || miss){
         display_fillRoundRect(ox + CELL_OFF + 1 + x*GRID_SIZE,
                               oy + CELL_OFF + 1 + y*GRID_SIZE,
                               CELL_SIZE-2, CELL_SIZE-3,
                               2+CELL_SIZE%2, BLACK);
       }
-      if (hs == HS_MISS) {
+      if (miss) {
         display_fillRoundRect(ox + CELL_OFF + 2 + x*GRID_SIZE,
                               oy + CELL_OFF + 2 + y*GRID_SIZE,
                               CELL_SIZE-4, CELL_SIZE-5,
@@ -456,25 +801,78 @@ static void game_draw_shots(int idx)
  * and fill in sunk ships.
  * 
  * @param idx Player number to draw ships for
+ * @param damaged_only only draw the ships that cover damaged cells
 */
-static void game_draw_ships(int idx)
+static void game_draw_ships(int idx, bool damaged_only)
 {
   int ox = GRID_OX;
   int oy = GRID_OY;
   for(int i = 0; i < 5; i++){
     struct battleships_ship *ship = &g_game.ships[idx][i];
+    bool all;
     if (ship->length == 0)
       continue;
+    if (damaged_only && !eink_ship_is_damaged(ship, &all))
+      continue;
     uint8_t sx = ship->px * GRID_SIZE + ox + CELL_OFF + 1;
     uint8_t sy = ship->py * GRID_SIZE + oy + CELL_OFF + 1;
     uint8_t w = 6 + ((ship->orientation == VERTICAL) ? 0 : (ship->length-1)*GRID_SIZE);
     uint8_t h = 5 + ((ship->orientation == HORIZONTAL) ? 0 : (ship->length-1)*GRID_SIZE);
     display_fillRoundRect(sx, sy, w, h, 2, BLACK);
-    if (!ship->sunk)
+    if (!(g_game.boards[idx].sunk & (1 << i)))
       display_fillRoundRect(sx+1, sy+1, w-2, h-2, 1, WHITE);
   }
 }
 
+/**
+ * @brief Extend the damage to all cells of the ships
+ * that cover a damaged cell, so that the ships can be
+ * redrawn as a whole.
+ *
+ * @param idx Player number of the ships
+*/
+static void game_damage_expand_ships(int idx)
+{
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < 5; i++) {
+      struct battleships_ship *ship = &g_game.ships[idx][i];
+      bool all;
+      if (eink_ship_is_damaged(ship, &all) && !all) {
+        eink_damage_ship(ship);
+        changed = true;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Clear the damaged cells and draw their
+ * part of the game grid again.
+*/
+static void game_draw_damaged_grid()
+{
+  for (int y = 0; y < GRID_COUNT; y++) {
+    for (int x = 0; x < GRID_COUNT; x++) {
+      if (!eink_cell_is_damaged(x, y))
+        continue;
+      int cx = GRID_OX + x*GRID_SIZE;
+      int cy = GRID_OY + y*GRID_SIZE;
+      // same extents as the lines in game_draw_grid
+      int ex = cx + GRID_SIZE < GRID_OX + GRID_COUNT * GRID_SIZE - 2 ?
+               cx + GRID_SIZE : GRID_OX + GRID_COUNT * GRID_SIZE - 2;
+      int ey = cy + GRID_SIZE < GRID_OY + GRID_COUNT * GRID_SIZE - 1 ?
+               cy + GRID_SIZE : GRID_OY + GRID_COUNT * GRID_SIZE - 1;
+      display_fillRect(cx + 1, cy + 1, GRID_SIZE - 1, GRID_SIZE - 1, WHITE);
+      display_drawLine(cx, cy, cx, ey, BLACK);
+      display_drawLine(cx + GRID_SIZE, cy, cx + GRID_SIZE, ey, BLACK);
+      display_drawLine(cx, cy, ex, cy, BLACK);
+      display_drawLine(cx, cy + GRID_SIZE, ex, cy + GRID_SIZE, BLACK);
+    }
+  }
+}
+
 /**
  * @brief Perform game setup, including
  * initialisation of yours and opponents ships,
@@ -484,19 +882,12 @@ static void game_draw_ships(int idx)
 */
 static void game_setup()
 {
-  
+  eink_damage_all();
   for(int i = 0; i < 5; i++){
     g_game.ships[PLAYER1][i].length = 0;
     g_game.ships[PLAYER2][i].length = 0;
   }
-  for(int x = 0; x < 10; x++) {
-    for(int y = 0; y < 10; y++) {
-      g_game.boards[PLAYER1].cells[x][y].hitstate = HS_NONE;
-      g_game.boards[PLAYER1].cells[x][y].occupy_index = 0;
-      g_game.boards[PLAYER2].cells[x][y].hitstate = HS_NONE;
-      g_game.boards[PLAYER2].cells[x][y].occupy_index = 0;
-    }
-  }
+  memset(g_game.boards, 0, sizeof(g_game.boards));
   g_game.currentShip = -1;
   g_game.currentPlayerNo = g_game.myPlayerNo = PLAYER1;
   game_place_current_ship();
@@ -569,7 +960,20 @@ void stop_waiting()
 static bool load_place_ships()
 {
   game_draw_grid();
-  game_draw_ships(g_game.currentPlayerNo);
+  game_draw_ships(g_game.currentPlayerNo, false);
+  return true;
+}
+
+/**
+ * @brief Redraws the damaged cells of the PLACE_SHIPS screen
+ *
+ * @returns true (display buffer filled, please draw me)
+*/
+static bool load_place_ships_damage()
+{
+  game_damage_expand_ships(g_game.currentPlayerNo);
+  game_draw_damaged_grid();
+  game_draw_ships(g_game.currentPlayerNo, true);
   return true;
 }
 
@@ -591,8 +995,29 @@ static bool load_fire_shot()
                         GRID_OY + CELL_OFF + g_game.ty*GRID_SIZE,
                         CELL_SIZE, CELL_SIZE, BLACK);
   }
-  game_draw_ships(swapPlayers(g_game.currentPlayerNo));
-  game_draw_shots(swapPlayers(g_game.currentPlayerNo));
+  game_draw_ships(swapPlayers(g_game.currentPlayerNo), false);
+  game_draw_shots(swapPlayers(g_game.currentPlayerNo), false);
+  return true;
+}
+
+/**
+ * @brief Redraws the damaged cells of the FIRE_SHOT screen
+ *
+ * @returns true (display buffer filled, please draw me)
+*/
+static bool load_fire_shot_damage()
+{
+  int idx = swapPlayers(g_game.currentPlayerNo);
+  game_damage_expand_ships(idx);
+  game_draw_damaged_grid();
+  if (g_game.currentPlayerNo == g_game.myPlayerNo &&
+      eink_cell_is_damaged(g_game.tx, g_game.ty)){
+    display_fillRect(   GRID_OX + CELL_OFF + g_game.tx*GRID_SIZE,
+                        GRID_OY + CELL_OFF + g_game.ty*GRID_SIZE,
+                        CELL_SIZE, CELL_SIZE, BLACK);
+  }
+  game_draw_ships(idx, true);
+  game_draw_shots(idx, true);
   return true;
 }
 
@@ -783,27 +1208,22 @@ static bool load_game_over()
   display_puts("new game!");
   display_setCursor(0,0);
 
-  int i;
-  struct battleships_ship *ships;
-  //check if all our opponent's ships are sunk
-  ships = g_game.ships[swapPlayers(g_game.myPlayerNo)];
-  for (i = 0; i < 5; i++) {
-    if (!ships[i].sunk)
-      break;
-  }
+  // our shots are on the opponent's board
+  char buf[20];
+  int shots, hits;
+  board_stats(&g_game.boards[swapPlayers(g_game.myPlayerNo)], &shots, &hits);
+  display_setCursor(0, 20);
+  snprintf(buf, sizeof(buf), "Shots:%d Hits:%d", shots, hits);
+  display_puts(buf);
+  display_setCursor(0,0);
 
-  if (i == 5) {
+  //check if all our opponent's ships are sunk
+  if (board_all_sunk(&g_game.boards[swapPlayers(g_game.myPlayerNo)])) {
     display_puts("You win!");
     return true;
   }
-  //check if all our opponent's ships are sunk
-  ships = g_game.ships[g_game.myPlayerNo];
-  for (i = 0; i < 5; i++) {
-    if (!ships[i].sunk)
-      break;
-  }
-
-  if (i == 5) {
+  //check if all our ships are sunk
+  if (board_all_sunk(&g_game.boards[g_game.myPlayerNo])) {
     display_puts("You lose!");
     return true;
   }
@@ -816,6 +1236,9 @@ void app_initialize(void)
 {
 
   game_setup();
+  // continue the game of before the reboot
+  if (session_load())
+    PRINT_APP("Session restored: screen %d\n", g_screen_nr);
 
 }
 
@@ -839,67 +1262,48 @@ void onReceivedShotStatus(const char *url)
   DPT_Shot_Status *status = app_get_DPT_Shot_Status_variable(URL_RECEIVESHOTSTATUS, NULL);
   DPT_Uint_XY *shot = app_get_DPT_Uint_XY_variable(URL_SENDSHOT, NULL);
   struct battleships_board *board = &g_game.boards[player];
-  struct battleships_cell *cell = &(board->cells[shot->X][shot->Y]);
-  struct battleships_ship *ship = &g_game.ships[player][status->F_3-1];
-  int ship_idx = get_occupy_idx_from_ship(ship);
+  int bit = BB_BIT(shot->X, shot->Y);
+  eink_damage_cells(shot->X, shot->Y, 1, 1);
   if (!status->F_1 /*hit*/) {
-    cell->hitstate = HS_MISS;
-  }else{
-    cell->hitstate = HS_HIT;
-    cell->occupy_index = ship_idx;
+    bb_set(&board->misses, bit);
+  }else if (status->F_3 >= 1 && status->F_3 <= 5){
+    int ship_no = status->F_3-1;
+    struct battleships_ship *ship = &g_game.ships[player][ship_no];
+    bb_set(&board->hits, bit);
+    bb_set(&board->ships[ship_no], bit);
+    bb_set(&board->occupied, bit);
     if (status->F_2 /*sunk*/) {
-      ship->sunk = true;
+      board->sunk |= 1 << ship_no;
       ship->length = ship_lens[5-status->F_3];
-      //locate the ship
-      // it could be horizontal or vertical
-      // we could be at the edge of it
-      // if theres match at x-1, y then horiz
-      int px;
-      int py;
-      px = shot->X;
-      py = shot->Y;
-      // check up/down
-      if (   (py > 0 && board->cells[px][py-1].occupy_index == ship_idx)
-          || (py < 9 && board->cells[px][py+1].occupy_index == ship_idx)) {
-        ship->orientation = VERTICAL;
-        while(py > 0 && board->cells[px][py-1].occupy_index == ship_idx)
-          py--;
-        ship->px = px;
-        ship->py = py;
-      } else
-      // check left/right
-      if (   (px > 0 && board->cells[px-1][py].occupy_index == ship_idx)
-          || (px < 9 && board->cells[px+1][py].occupy_index == ship_idx)) {
-        ship->orientation = HORIZONTAL;
-        while(px > 0 && board->cells[px-1][py].occupy_index == ship_idx)
-          px--;
-        ship->px = px;
-        ship->py = py;
-      } else {
+      // locate the ship: all its cells are hit now, the lowest
+      // cell is the start, the next cell gives the orientation
+      int first = bb_first(board->ships[ship_no]);
+      if (first < 0 || bb_popcount(board->ships[ship_no]) != ship->length) {
         //something went wrong!!
         PRINT_APP("BAD SHIP CALCULATION!\n");
+      } else {
+        ship->px = first % 10;
+        ship->py = first / 10;
+        ship->orientation = (ship->px < 9 && bb_test(&board->ships[ship_no], first + 1)) ?
+                            HORIZONTAL : VERTICAL;
       }
+      eink_damage_ship(ship);
     }
   }
 
   //check if all our opponent's ships are sunk
-  int i;
-  struct battleships_ship *theirships = g_game.ships[swapPlayers(g_game.myPlayerNo)];
-  for (i = 0; i < 5; i++) {
-    if (!theirships[i].sunk)
-      break;
-  }
-  
-  if (i != 5) {
+  if (!board_all_sunk(&g_game.boards[swapPlayers(g_game.myPlayerNo)])) {
     //redraw
     g_eink_clean_redraw  = false;
     set_screen(SHOT_INFO);
 
     g_game.currentPlayerNo = player;
+    eink_damage_all();
   } else {
     set_screen(GAME_OVER);
   }
-
+  // end of the turn
+  session_save();
 }
 
 /**
@@ -920,9 +1324,8 @@ void onReceivedShot(const char *url)
   // place shot on our board
   enum PlayerNo player = swapPlayers(g_game.currentPlayerNo);
   struct battleships_board *board = &g_game.boards[player];
-  struct battleships_cell *cell = &(board->cells[shot->X][shot->Y]);
-  struct battleships_ship *ship = get_occupy_from_idx(cell->occupy_index);
-  struct battleships_ship *ships = g_game.ships[player];
+  int bit = BB_BIT(shot->X, shot->Y);
+  int ship_no = board_ship_at(board, bit);
 
   //it's now our turn!
 
@@ -931,49 +1334,42 @@ void onReceivedShot(const char *url)
   status->F_2 = false;
   status->F_3 = ShipTypeNo_Hit;
 
-  if(cell->hitstate == HS_HIT)
+  if (bb_test(&board->hits, bit))
     return;
 
-  if (ship) {
-    cell->hitstate = HS_HIT;
+  eink_damage_cells(shot->X, shot->Y, 1, 1);
+  if (ship_no >= 0) {
+    bb_set(&board->hits, bit);
     status->F_1 = true;
-    status->F_3 = 5-(ship-ships);
-    int i;
-    for(i = 0; i < ship->length; i++){
-      uint8_t sx = ship->px + i*((ship->orientation==HORIZONTAL)?1:0);
-      uint8_t sy = ship->py + i*((ship->orientation==VERTICAL)?1:0);
-      if (board->cells[sx][sy].hitstate != HS_HIT)
-        break;
-    }
-    if (i == ship->length){
+    status->F_3 = 5-ship_no;
+    // sunk when no cell of the ship is left without a hit
+    if (bb_empty(bb_andnot(board->ships[ship_no], board->hits))){
       status->F_2 = true; /*sunk*/
-      ship->sunk = true;
+      board->sunk |= 1 << ship_no;
+      eink_damage_ship(&g_game.ships[player][ship_no]);
     }
   }else{
-    cell->hitstate = HS_MISS;
+    bb_set(&board->misses, bit);
   }
 
-  oc_do_s_mode_with_scope(5, URL_SENDSHOTSTATUS, "w");
+  app_smode_send(5, URL_SENDSHOTSTATUS, "w");
 
   //check if all our ships are sunk
-  int i;
-  struct battleships_ship *myships = g_game.ships[g_game.myPlayerNo];
-  for (i = 0; i < 5; i++) {
-    if (!myships[i].sunk)
-      break;
-  }
-  if (i != 5) {
+  if (!board_all_sunk(&g_game.boards[g_game.myPlayerNo])) {
     //redraw
     g_eink_clean_redraw  = false;
     eink_load_screen(FIRE_SHOT);
 
     g_game.currentPlayerNo = player;
+    eink_damage_all();
 
     g_eink_clean_redraw  = false;
     TASKLET_ScheduleDelta(&screen_Tasklet, 2*1000, NULL);
   } else {
     set_screen(GAME_OVER);
   }
+  // end of the turn
+  session_save();
 }
 
 /**
@@ -1003,6 +1399,7 @@ void onReceivedReady(const char *url)
       g_game.currentPlayerNo = PLAYER1;
     else
       g_game.currentPlayerNo = PLAYER2;
+    eink_damage_all();
     go_next_screen();
   }
 }
@@ -1024,11 +1421,6 @@ int g_scroll_position;
 
 extern otInstance *OT_INSTANCE;
 
-oc_auth_at_t *get_auth_at_entry(int idx)
-{
-  return oc_get_auth_at_entry(0, idx);
-}
-
 //////////////////////////////////////////////////////////////
 //  EINK Scroll code
 //////////////////////////////////////////////////////////////
@@ -1270,7 +1662,7 @@ void menu_next()
   menu_scroll();
   refresh_screen(false);
   // do not refresh while in the menu, refresh will be done sholtly after entering a regular page
-  g_eink_draws_without_refresh = g_eink_draws_cutoff;
+  g_eink_damage_area = g_eink_damage_cutoff;
   // cache the selected menu row (only for the system menu for now)
   if(g_screen_nr == MENU_SCREEN)
     g_menu_screen_selected_row = g_selected_row;
@@ -1283,7 +1675,7 @@ void menu_prev()
     g_selected_row = (g_cur_menu_entries-1);
   menu_scroll();
   refresh_screen(false);
-  g_eink_draws_without_refresh = g_eink_draws_cutoff;
+  g_eink_damage_area = g_eink_damage_cutoff;
   if(g_screen_nr == MENU_SCREEN)
     g_menu_screen_selected_row = g_selected_row;
 }
@@ -1338,15 +1730,33 @@ bool load_dev_screen()
   display_setCursor(2, EINK_LINE_NO(6));
   display_puts(T("Model:"));
   display_puts(oc_string(device->model));
+#if APP_METRICS
+  // request totals and latencies, from the diagnostics
+  const app_metrics_t *metrics = app_metrics_get();
+  unsigned long requests = 0, errors = 0, latency_us = 0;
+  for (int i = 0; i < num_datapoints; i++) {
+    const app_dp_metrics_t *dp_metrics =
+      app_metrics_get_datapoint(oc_string(g_datapoints[i].resource.uri));
+    if (dp_metrics) {
+      requests += dp_metrics->get.count + dp_metrics->put.count;
+      errors += dp_metrics->errors;
+      if (dp_metrics->put.max_us > latency_us)
+        latency_us = dp_metrics->put.max_us;
+    }
+  }
+  display_setCursor(2, EINK_LINE_NO(7));
+  snprintf(screen_str, 19, "Req:%lu Err:%lu", requests, errors);
+  display_puts(screen_str);
+  display_setCursor(2, EINK_LINE_NO(8));
+  snprintf(screen_str, 19, "Put:%lums Wr:%lu", latency_us / 1000,
+           (unsigned long)metrics->storage_writes);
+  display_puts(screen_str);
+#endif
   return true;
 }
 
 bool load_tables_screen()
 {
-#ifdef __GNUC__
-  _Pragma("GCC diagnostic push");
-  _Pragma("GCC diagnostic ignored \"-Wincompatible-pointer-types\"");
-#endif
   app_header_draw(TABLES_SCREEN);
 
   // If the device has not been initialised, then show "device not initialised"
@@ -1375,63 +1785,30 @@ bool load_tables_screen()
   snprintf(screen_str, 17, "iid:h%s", iid_str);
   display_puts(screen_str);
 
-  uint8_t num_entries = 0;
   uint8_t cur_line = 3;
 
-  bool check_got_entry(oc_group_object_table_t *ga) { return oc_string_len(ga->href) != 0; }
-  bool check_grt_gpt_entry(oc_group_rp_table_t *grp) { return grp->id > -1; }
-  bool check_sec_entry(oc_auth_at_t *at) { return oc_string_len(at->id) != 0; }
-
-  struct table_fns_s{
+  // the counts are kept by the table index of the application
+  const app_table_summary_t *summary = app_get_table_summary();
+  struct table_count_s {
     const char *fmt;
-    int (*tbl_size_fn)(void);
-    void *(*tbl_entry_fn)(int);
-    bool (*checker)(void*);
+    int num_entries;
   };
-  struct table_fns_s table_fns[] = {
-    {
-      "Grp Obj Tbl: %d",
-      (void*)&oc_core_get_group_object_table_total_size,
-      (void*)&oc_core_get_group_object_table_entry,
-      (void*)&check_got_entry
-    }, {
-      "Rec Tbl: %d",
-      (void*)&oc_core_get_recipient_table_size,
-      (void*)&oc_core_get_recipient_table_entry,
-      (void*)&check_grt_gpt_entry
-    }, {
-      "Pub Tbl: %d",
-      (void*)&oc_core_get_publisher_table_size,
-      (void*)&oc_core_get_publisher_table_entry,
-      (void*)&check_grt_gpt_entry
-    }, {
-      "Sec Tbl: %d",
-      (void*)&oc_core_get_at_table_size,
-      (void*)&get_auth_at_entry,
-      (void*)&check_sec_entry
-    }
+  const struct table_count_s table_counts[] = {
+    { "Grp Obj Tbl: %d", summary->got_entries },
+    { "Rec Tbl: %d", summary->recipient_entries },
+    { "Pub Tbl: %d", summary->publisher_entries },
+    { "Sec Tbl: %d", summary->auth_entries }
   };
 
-  const int num_tables = (sizeof(table_fns)/sizeof(table_fns[0])); 
+  const int num_tables = (sizeof(table_counts)/sizeof(table_counts[0])); 
 
   for (int i = 0; i < num_tables; i++) {
-    struct table_fns_s *fns = &table_fns[i];
     display_setCursor(3, EINK_LINE_NO(cur_line++));
-    num_entries = 0;
-    for (uint8_t j = 0; j < (*fns->tbl_size_fn)(); ++j)
-    {
-      if ((*fns->checker)((*fns->tbl_entry_fn)(j)))
-        ++num_entries;
-    }
-
-    snprintf(screen_str, 20, fns->fmt, num_entries);
+    snprintf(screen_str, 20, table_counts[i].fmt, table_counts[i].num_entries);
     display_puts(screen_str);
   }
 
   return true;
-#ifdef __GNUC__
-_Pragma("GCC diagnostic pop")
-#endif
 }
 
 bool load_help_screen()
@@ -1803,6 +2180,7 @@ struct EinkScreenHandler g_screenHandlers[NUM_SCREENS] =
     .screen_button_3_ShortPress_cb = &prev_controls_page, 
   }, [PLACE_SHIPS] = {
     .load_screen_cb = &load_place_ships,
+    .load_damage_cb = &load_place_ships_damage,
     .title = NULL,
     .screen_button_1_ShortPress_cb = &game_move_right,
     .screen_button_1_LongPress_cb = &game_move_left,
@@ -1816,6 +2194,7 @@ struct EinkScreenHandler g_screenHandlers[NUM_SCREENS] =
     .screen_button_3_Hold_cb = &stop_waiting, 
   }, [FIRE_SHOT] = {
     .load_screen_cb = &load_fire_shot,
+    .load_damage_cb = &load_fire_shot_damage,
     .title = NULL,
     .screen_button_1_ShortPress_cb = &game_move_right,
     .screen_button_1_LongPress_cb = &game_move_left,
@@ -1906,29 +2285,44 @@ void eink_load_screen(enum Screen screen_nr)
     screen_nr = SPLASH_SCREEN;
     g_eink_clean_redraw = true;
   }
-  PRINT_APP("Loading screen %u ..\n", screen_nr);
-  display_clear();
+  // a screen that is drawn again only redraws its damaged cells
+  bool damage_only = !g_eink_clean_redraw && !g_eink_damage_all &&
+                     screen_nr == g_eink_drawn_screen &&
+                     g_screenHandlers[screen_nr].load_damage_cb;
+  uint32_t damage = eink_damage_count();
+  if (damage_only && damage == 0)
+    return;
+  PRINT_APP("Loading screen %u (damage %u)..\n", screen_nr, (unsigned)damage);
   display_setTextColor(BLACK, WHITE);
   bool ret = false;
-  if (g_screenHandlers[screen_nr].load_screen_cb)
-    ret = g_screenHandlers[screen_nr].load_screen_cb();
+  if (damage_only) {
+    ret = g_screenHandlers[screen_nr].load_damage_cb();
+  } else {
+    display_clear();
+    damage = EINK_FULL_DAMAGE;
+    if (g_screenHandlers[screen_nr].load_screen_cb)
+      ret = g_screenHandlers[screen_nr].load_screen_cb();
+  }
+  eink_damage_clear();
+  g_eink_drawn_screen = ret ? screen_nr : -1;
   if (ret == false)
     return;
   if (is_scrollable_screen())
     show_scroll_bar();
   display_setCursor(0,0);
   display_setTextSize(1);
-  if (g_eink_clean_redraw || g_eink_draws_without_refresh > g_eink_draws_cutoff) {
+  // the accumulated damage decides when a full refresh removes the ghosting
+  if (g_eink_clean_redraw || g_eink_damage_area > g_eink_damage_cutoff) {
       display_render_full();
     g_eink_clean_redraw = false;
-    g_eink_draws_without_refresh = 0;
+    g_eink_damage_area = 0;
 
   } else {
       display_render_partial(false);
-    g_eink_draws_without_refresh++;
+    g_eink_damage_area += damage;
   }
 
-  oc_storage_write("screen_nr", &screen_nr, 1);
+  session_schedule_save();
 }
 
 void go_CONNECTIVITY_SCREEN()
@@ -1975,10 +2369,8 @@ ca_error eink_initial_screen(void *args)
     g_eink_clean_redraw = true;
     eink_load_screen(SPLASH_SCREEN);
 
-    g_screen_nr = 0;
-    oc_storage_read("screen_nr", &g_screen_nr, 1);
-
-    if (g_screen_nr == 0) // Meaning nothing was read from the storage
+    // g_screen_nr is restored from the session record in app_initialize
+    if (g_screen_nr == 0) // Meaning nothing was restored
       g_screen_nr = MENU_SCREEN; // Go to the navigation menu
       
     TASKLET_ScheduleDelta(&screen_Tasklet, 3 * 1000, NULL);
@@ -0,0 +1,54 @@
+# footprint report of the build targets
+#
+# app_footprint(<target>) adds a post build step that writes
+#   ${PROJECT_BINARY_DIR}/footprint/<target>.sections.txt  (size -A, per section)
+#   ${PROJECT_BINARY_DIR}/footprint/<target>.symbols.txt   (nm, largest first)
+# and fails the build when the RAM (data + bss) or the flash (text + data) of
+# the image exceeds its budget, in bytes, 0 = no check:
+#   FOOTPRINT_RAM_BUDGET / FOOTPRINT_FLASH_BUDGET                  all targets
+#   FOOTPRINT_RAM_BUDGET_<target> / FOOTPRINT_FLASH_BUDGET_<target>  one target
+# e.g. cmake .. -DFOOTPRINT_RAM_BUDGET_knx_iot_example_sleepy=65536
+# The step is skipped when the binutils of the tool chain are not found (MSVC).
+
+set(FOOTPRINT_RAM_BUDGET 0 CACHE STRING "RAM budget (data + bss) in bytes of each image, 0 = no check")
+set(FOOTPRINT_FLASH_BUDGET 0 CACHE STRING "flash budget (text + data) in bytes of each image, 0 = no check")
+set(FOOTPRINT_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/footprint_report.cmake)
+
+# binutils of the tool chain, e.g. arm-none-eabi-size next to arm-none-eabi-gcc
+get_filename_component(FOOTPRINT_CC_NAME "${CMAKE_C_COMPILER}" NAME)
+string(REGEX REPLACE "(gcc|cc|clang)(\\.exe)?$" "" FOOTPRINT_TOOL_PREFIX "${FOOTPRINT_CC_NAME}")
+find_program(FOOTPRINT_SIZE NAMES ${FOOTPRINT_TOOL_PREFIX}size size)
+if(CMAKE_NM)
+  set(FOOTPRINT_NM ${CMAKE_NM})
+else()
+  find_program(FOOTPRINT_NM NAMES ${FOOTPRINT_TOOL_PREFIX}nm nm)
+endif()
+
+function(app_footprint target)
+  if(MSVC OR NOT FOOTPRINT_SIZE OR NOT FOOTPRINT_NM)
+    message(STATUS "footprint: no size/nm, no report for ${target}")
+    return()
+  endif()
+  set(ram_budget ${FOOTPRINT_RAM_BUDGET})
+  set(flash_budget ${FOOTPRINT_FLASH_BUDGET})
+  if(DEFINED FOOTPRINT_RAM_BUDGET_${target})
+    set(ram_budget ${FOOTPRINT_RAM_BUDGET_${target}})
+  endif()
+  if(DEFINED FOOTPRINT_FLASH_BUDGET_${target})
+    set(flash_budget ${FOOTPRINT_FLASH_BUDGET_${target}})
+  endif()
+  file(MAKE_DIRECTORY ${PROJECT_BINARY_DIR}/footprint)
+  add_custom_command(TARGET ${target}
+    POST_BUILD
+    COMMAND ${CMAKE_COMMAND}
+      -DIMAGE=$<TARGET_FILE:${target}>
+      -DNAME=${target}
+      -DOUT=${PROJECT_BINARY_DIR}/footprint
+      -DSIZE=${FOOTPRINT_SIZE}
+      -DNM=${FOOTPRINT_NM}
+      -DRAM_BUDGET=${ram_budget}
+      -DFLASH_BUDGET=${flash_budget}
+      -P ${FOOTPRINT_SCRIPT}
+    VERBATIM
+  )
+endfunction()
@@ -0,0 +1,33 @@
+# post build step of app_footprint (footprint.cmake), run with cmake -P
+# inputs: IMAGE NAME OUT SIZE NM RAM_BUDGET FLASH_BUDGET
+
+execute_process(COMMAND ${SIZE} -A -d ${IMAGE}
+  OUTPUT_FILE ${OUT}/${NAME}.sections.txt
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(WARNING "footprint: ${SIZE} failed on ${IMAGE}")
+  return()
+endif()
+# the largest symbols first, with their size and section type (b/d = RAM)
+execute_process(COMMAND ${NM} --size-sort --reverse-sort --print-size --radix=d ${IMAGE}
+  OUTPUT_FILE ${OUT}/${NAME}.symbols.txt)
+
+# Berkeley format: text data bss dec hex filename
+execute_process(COMMAND ${SIZE} -B -d ${IMAGE} OUTPUT_VARIABLE berkeley)
+if(NOT berkeley MATCHES "\n[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)")
+  message(WARNING "footprint: can't read the size of ${IMAGE}")
+  return()
+endif()
+set(text ${CMAKE_MATCH_1})
+set(data ${CMAKE_MATCH_2})
+set(bss ${CMAKE_MATCH_3})
+math(EXPR ram "${data} + ${bss}")
+math(EXPR flash "${text} + ${data}")
+message(STATUS "footprint ${NAME}: flash ${flash} bytes (text ${text}, data ${data}), ram ${ram} bytes (data ${data}, bss ${bss})")
+
+if(RAM_BUDGET GREATER 0 AND ram GREATER RAM_BUDGET)
+  message(FATAL_ERROR "footprint ${NAME}: ram ${ram} bytes exceeds the budget of ${RAM_BUDGET} bytes, see ${OUT}/${NAME}.symbols.txt")
+endif()
+if(FLASH_BUDGET GREATER 0 AND flash GREATER FLASH_BUDGET)
+  message(FATAL_ERROR "footprint ${NAME}: flash ${flash} bytes exceeds the budget of ${FLASH_BUDGET} bytes, see ${OUT}/${NAME}.sections.txt")
+endif()
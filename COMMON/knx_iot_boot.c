@@ -0,0 +1,248 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2024 Cascoda Limited
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**
+ * @file
+ *  Boot profile and SPAKE2+ parameter cache, shared by the sleepy and the
+ *  wakeful main
+ */
+#include <string.h>
+#include <stdio.h>
+
+#include "cascoda-util/cascoda_time.h"
+
+#include "knx_iot_sleepy_main.h"
+
+#include "port/oc_log.h"
+#include "knx_iot_log.h"
+#include "knx_iot_runtime.h"
+#include "security/oc_spake2plus.h"
+#include "manufacturer_storage.h"
+#include "oc_api.h"
+
+// Boot profile
+static main_boot_profile_t g_boot_profile;
+
+void main_BootPhaseDone(main_boot_phase_t phase)
+{
+	g_boot_profile.end_ms[phase] = TIME_ReadAbsoluteTime();
+}
+
+void main_BootComplete(void)
+{
+	static const char *const names[MAIN_BOOT_PHASES] = {
+		"chip", "join", "credentials", "spake", "stack", "ready", "deferred"};
+	uint32_t start = 0;
+
+	g_boot_profile.complete = true;
+	// Note: printf, so the summary is printed regardless of the log level
+	printf("boot profile (ms):");
+	for (int i = 0; i < MAIN_BOOT_PHASES; i++)
+	{
+		printf(" %s %u", names[i], (unsigned)(g_boot_profile.end_ms[i] - start));
+		start = g_boot_profile.end_ms[i];
+	}
+	printf(", total %u%s\n", (unsigned)start, g_boot_profile.spake_cached ? ", spake cached" : "");
+}
+
+const main_boot_profile_t *main_GetBootProfile(void)
+{
+	return &g_boot_profile;
+}
+
+#ifdef OC_SPAKE
+#define SPAKE_CACHE_STORE_NAME "spake_cache"
+#define SPAKE_CACHE_VERSION 2
+#define SPAKE_HASH_INIT 2166136261u
+
+// the decoded SPAKE2+ record of the manufacturer storage
+typedef struct spake_cache_t
+{
+	uint8_t version;
+	uint32_t source; // hash of the manufacturer credentials the record belongs to
+	uint8_t salt[32];
+	uint8_t rand[32];
+	uint32_t it;
+	uint8_t w0[32];
+	uint8_t L[65];
+} spake_cache_t;
+
+static uint32_t spake_hash(uint32_t hash, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// the serial number and password are read on every boot. knx-gen-data
+// generates the SPAKE2+ record from the password, so a reflash with other
+// credentials changes the hash. A new salt for the same password does not,
+// the cached salt and verifier still match that password.
+static uint32_t spake_source_hash(const uint8_t *sn, size_t sn_len, const char *pwd)
+{
+	uint32_t hash = spake_hash(SPAKE_HASH_INIT, sn, sn_len);
+	if (pwd)
+		hash = spake_hash(hash, (const uint8_t *)pwd, strlen(pwd));
+	return hash;
+}
+
+static bool spake_cache_load(spake_cache_t *cache, uint32_t source, mbedtls_mpi *w0, mbedtls_ecp_point *L)
+{
+	long ret = oc_storage_read(SPAKE_CACHE_STORE_NAME, (uint8_t *)cache, sizeof(*cache));
+	if (ret < 0)
+		return false;
+	if (ret != (long)sizeof(*cache) || cache->version != SPAKE_CACHE_VERSION || cache->source != source)
+	{
+		// another version, or other credentials were flashed
+		APP_LOG_INFO("spake cache: stale, decoding the stored record\n");
+		main_SpakeCacheClear();
+		return false;
+	}
+
+	mbedtls_ecp_group group;
+	mbedtls_ecp_group_init(&group);
+	bool ok = mbedtls_ecp_group_load(&group, MBEDTLS_ECP_DP_SECP256R1) == 0 &&
+			  mbedtls_mpi_read_binary(w0, cache->w0, sizeof(cache->w0)) == 0 &&
+			  mbedtls_ecp_point_read_binary(&group, L, cache->L, sizeof(cache->L)) == 0;
+	mbedtls_ecp_group_free(&group);
+	return ok;
+}
+
+static void spake_cache_store(spake_cache_t *cache, uint32_t source, const mbedtls_mpi *w0, const mbedtls_ecp_point *L)
+{
+	size_t len = 0;
+	mbedtls_ecp_group group;
+	mbedtls_ecp_group_init(&group);
+	cache->version = SPAKE_CACHE_VERSION;
+	cache->source = source;
+	bool ok = mbedtls_ecp_group_load(&group, MBEDTLS_ECP_DP_SECP256R1) == 0 &&
+			  mbedtls_mpi_write_binary(w0, cache->w0, sizeof(cache->w0)) == 0 &&
+			  mbedtls_ecp_point_write_binary(&group, L, MBEDTLS_ECP_PF_UNCOMPRESSED, &len, cache->L,
+											 sizeof(cache->L)) == 0 &&
+			  len == sizeof(cache->L);
+	mbedtls_ecp_group_free(&group);
+	if (ok)
+		oc_storage_write(SPAKE_CACHE_STORE_NAME, (uint8_t *)cache, sizeof(*cache));
+}
+
+void main_BootLoadSpake(const uint8_t *sn, size_t sn_len, const char *pwd)
+{
+	spake_cache_t cache;
+	mbedtls_mpi w0;
+	mbedtls_ecp_point L;
+	uint32_t source = spake_source_hash(sn, sn_len, pwd);
+	mbedtls_mpi_init(&w0);
+	mbedtls_ecp_point_init(&L);
+
+	g_boot_profile.spake_cached = spake_cache_load(&cache, source, &w0, &L);
+	if (g_boot_profile.spake_cached)
+	{
+		oc_spake_set_parameters(cache.rand, cache.salt, cache.it, w0, L);
+	}
+	else if (knx_get_stored_spake(cache.salt, cache.rand, &cache.it, &w0, &L))
+	{
+		APP_LOG_WARN("Error: Stored spake record not found! Using runtime generated values\n");
+		APP_LOG_WARN(
+			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
+	}
+	else
+	{
+		oc_spake_set_parameters(cache.rand, cache.salt, cache.it, w0, L);
+		spake_cache_store(&cache, source, &w0, &L);
+	}
+	memset(&cache, 0, sizeof(cache));
+	mbedtls_mpi_free(&w0);
+	mbedtls_ecp_point_free(&L);
+}
+
+void main_SpakeCacheClear(void)
+{
+	oc_storage_erase(SPAKE_CACHE_STORE_NAME);
+}
+#else
+void main_BootLoadSpake(const uint8_t *sn, size_t sn_len, const char *pwd)
+{
+	(void)sn;
+	(void)sn_len;
+	(void)pwd;
+}
+
+void main_SpakeCacheClear(void)
+{
+}
+#endif
+
+// Software update
+#if CASCODA_OTA_UPGRADE_ENABLED
+// Implemented in the cascoda knx-iot port, writes the block to the OTA flash area
+void swu_cb(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data);
+
+#if APP_SWU_PIPELINE
+// context of the transfer, handed to the port by the writer
+static size_t g_swu_device;
+static size_t g_swu_binary_size;
+static void *g_swu_data;
+
+// the pipeline has acknowledged the block already: the port gets a response
+// that is not active, so that it does not send a second one
+static oc_separate_response_t g_swu_handled;
+
+static bool swu_flash_write(size_t offset, const uint8_t *data, size_t len)
+{
+	memset(&g_swu_handled, 0, sizeof(g_swu_handled));
+	swu_cb(g_swu_device, &g_swu_handled, g_swu_binary_size, offset, (uint8_t *)data, len, g_swu_data);
+	return true;
+}
+#endif
+
+void main_SwuBlock(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data)
+{
+#if APP_SWU_PIPELINE
+	g_swu_device = device_index;
+	g_swu_binary_size = binary_size;
+	g_swu_data = data;
+	app_swu_set_writer(swu_flash_write);
+	app_swu_receive(response, binary_size, offset, payload, len);
+#else
+	app_swu_note_block(binary_size, offset, len);
+	swu_cb(device_index, response, binary_size, offset, payload, len, data);
+#endif
+}
+#endif
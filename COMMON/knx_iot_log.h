@@ -0,0 +1,155 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2024 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+/**
+ * @file
+ *
+ * leveled logging and binary trace for the generated application.
+ *
+ * The log macros compile to nothing when their level is above
+ * APP_LOG_LEVEL, so no formatting is done for disabled levels.
+ * The trace stores fixed size binary events in a ring buffer, for high rate
+ * events that can not be printed without changing the timing.
+ */
+#ifndef KNX_IOT_LOG_H
+#define KNX_IOT_LOG_H
+
+#include <stdint.h>
+#include "port/oc_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_LOG_LEVEL_NONE 0    //!< no logging
+#define APP_LOG_LEVEL_ERROR 1   //!< errors only
+#define APP_LOG_LEVEL_WARNING 2 //!< errors and warnings
+#define APP_LOG_LEVEL_INFO 3    //!< state changes, start up information
+#define APP_LOG_LEVEL_DEBUG 4   //!< per request information
+
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL APP_LOG_LEVEL_INFO //!< compile time log threshold
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_ERROR
+#define APP_LOG_ERR(...) PRINT_APP(__VA_ARGS__)
+#else
+#define APP_LOG_ERR(...) do { } while (0)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_WARNING
+#define APP_LOG_WARN(...) PRINT_APP(__VA_ARGS__)
+#else
+#define APP_LOG_WARN(...) do { } while (0)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO
+#define APP_LOG_INFO(...) PRINT_APP(__VA_ARGS__)
+#else
+#define APP_LOG_INFO(...) do { } while (0)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_DEBUG
+#define APP_LOG_DBG(...) PRINT_APP(__VA_ARGS__)
+#else
+#define APP_LOG_DBG(...) do { } while (0)
+#endif
+
+#ifndef APP_TRACE_SIZE
+#define APP_TRACE_SIZE 64 //!< number of trace events kept, 0 = no trace
+#endif
+
+/**
+ * @brief trace event identifiers
+ */
+enum AppTraceId {
+  APP_TRACE_GET = 1,   //!< GET request, arg0 = data point index
+  APP_TRACE_PUT,       //!< PUT request, arg0 = data point index, arg1 = error
+  APP_TRACE_STORE,     //!< storage write, arg1 = bytes
+  APP_TRACE_FLUSH,     //!< persistence flush, arg1 = records written
+  APP_TRACE_SLEEP,     //!< going to sleep, arg1 = time to next event (ms)
+  APP_TRACE_WAKE,      //!< woken up
+  APP_TRACE_RESET,     //!< reset, arg1 = reset value
+  APP_TRACE_PROG_MODE, //!< programming mode, arg1 = on/off
+};
+
+/**
+ * @brief a binary trace event
+ */
+typedef struct app_trace_event_t
+{
+  uint32_t time; //!< oc_clock_time() of the event, truncated to 32 bits
+  uint16_t id;   //!< the event, AppTraceId
+  uint16_t arg0; //!< first argument, event specific
+  uint32_t arg1; //!< second argument, event specific
+} app_trace_event_t;
+
+#if APP_TRACE_SIZE > 0
+/**
+ * @brief stores an event in the trace ring buffer
+ * when the buffer is full the oldest event is overwritten
+ *
+ * @param id the event identifier
+ * @param arg0 event specific argument
+ * @param arg1 event specific argument
+ */
+void app_trace(uint16_t id, uint16_t arg0, uint32_t arg1);
+
+/**
+ * @brief reads (and removes) the oldest events from the trace
+ *
+ * @param out array to store the events
+ * @param max size of the array
+ * @return number of events read
+ */
+int app_trace_read(app_trace_event_t *out, int max);
+
+/**
+ * @brief prints (and removes) all events in the trace
+ */
+void app_trace_dump(void);
+
+#define APP_TRACE(id, arg0, arg1) app_trace((id), (uint16_t)(arg0), (uint32_t)(arg1))
+#else
+#define APP_TRACE(id, arg0, arg1) do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KNX_IOT_LOG_H */
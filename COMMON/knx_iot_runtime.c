@@ -0,0 +1,5883 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2022-2024 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+*/
+
+/**
+ * @file
+ *
+ * shared data point runtime of the generated applications
+ *
+ * ## Application Design
+ *
+ * The application emits its tables, this file implements everything
+ * that works on the tables:
+ *
+ * - app_init
+ *   initializes the stack values, from g_app_info.
+ * - register_resources
+ *   function that registers all endpoints,
+ *   e.g. sets the GET/PUT/POST/DELETE
+ *      handlers for each end point
+ *
+ * - main
+ *   starts the stack, with the registered resources.
+ *   can be compiled out with NO_MAIN
+ *
+ *  handlers for the implemented methods (get/put):
+ *   - get_generic
+ *     function that is being called when a GET is called on a data point
+ *     encodes the global variable with the codec of the type
+ *   - put_generic
+ *     function that is being called when a PUT is called on a data point
+ *     if input data is of the correct type
+ *       updates the global variables
+ *
+ * ## stack specific defines
+ * - __linux__
+ *   build for Linux
+ * - WIN32
+ *   build for Windows
+ * - OC_OSCORE
+ *   oscore is enabled as compile flag
+ * ## File specific defines
+ * - NO_MAIN
+ *   compile out the function main()
+ * - INCLUDE_EXTERNAL
+ *   includes header file "external_header.h", so that other tools/dependencies
+ *   can be included without changing this code
+ * - KNX_GUI
+ *   build the GUI with console option, so that all
+ *   logging can be seen in the command window
+ * - APP_LOOP_TICKLESS
+ *   the main loop waits with epoll/timerfd (Linux) or
+ *   WaitForMultipleObjects (Windows), see app_loop_add_handle
+ */
+#include "oc_api.h"
+#include "oc_core_res.h"
+#include "oc_rep.h"
+#include "oc_helpers.h"
+#include "api/oc_knx_fp.h"
+#include "port/oc_clock.h"
+#include <signal.h>
+/* test purpose only; commandline reset */
+#include "api/oc_knx_dev.h"
+#include "api/oc_knx_sec.h"
+#ifdef OC_SPAKE
+#include "security/oc_spake2plus.h"
+#endif
+#ifdef INCLUDE_EXTERNAL
+/* import external definitions from header file*/
+/* this file should be externally supplied */
+#include "external_header.h"
+#endif
+#include "knx_iot_runtime.h"
+#ifdef SLEEPY
+#include "knx_iot_sleepy_main.h" /* main_SetPollPolicy */
+#endif
+
+#include <stdlib.h>
+#include <ctype.h>
+
+#if APP_METRICS && (defined(__linux__) || defined(__NEWLIB__))
+#include <malloc.h> /* mallinfo */
+#endif
+
+#ifdef APP_BENCH
+#include <time.h> /* clock, cpu time of the replay */
+#endif
+
+#ifdef __linux__
+/** linux specific code */
+#include <pthread.h>
+#ifndef NO_MAIN
+static pthread_mutex_t mutex;
+static pthread_cond_t cv;
+static struct timespec ts;
+#if APP_LOOP_TICKLESS
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif /* APP_LOOP_TICKLESS */
+#endif /* NO_MAIN */
+#endif
+
+#if defined(MQTT_PROXY) && APP_MQTT_CLIENT
+#include <errno.h>
+#include <netdb.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif /* MQTT_PROXY && APP_MQTT_CLIENT */
+
+#include <stdio.h> /* defines FILENAME_MAX */
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#define STORE_PREFIX "app"
+
+#ifdef WIN32
+/** windows specific code */
+#include <windows.h>
+static CONDITION_VARIABLE cv; /**< event loop variable */
+static CRITICAL_SECTION cs;   /**< event loop variable */
+#include <direct.h>
+#define GetCurrentDir _getcwd
+#else
+#include <unistd.h>
+#define GetCurrentDir getcwd
+#endif
+
+#ifdef HARDWARE_INIT
+ void hardware_init(void);
+#endif /* hardware init */
+
+#define btoa(x) ((x) ? "true" : "false")
+volatile int quit = 0;  /**< stop variable, used by handle_signal */
+bool g_reset = false;   /**< reset variable, set by commandline arguments */
+
+void
+get_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data);
+void
+put_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data);
+
+size_t get_dpt_size(DatapointType t)
+{
+  if (t < 0 || (size_t)t >= num_datapoint_types)
+    return 0;
+  return g_datapoint_types[t].size;
+}
+
+/* number of entries of g_datapoint_state */
+#define NUM_DP_STATE (num_datapoints + num_parameters)
+
+// ===== Type generic codecs =====
+// the fields of a type are read and written with memcpy, the DPT structs are
+// packed. The functions return false (or NULL) for types without fields.
+
+static const struct datapoint_type_t *dpt_codec(DatapointType t)
+{
+  if (t < 0 || (size_t)t >= num_datapoint_types || g_datapoint_types[t].num_fields == 0)
+    return NULL;
+  return &g_datapoint_types[t];
+}
+
+#if APP_DPT_FUNCTION_TABLE && defined(APP_BENCH)
+/* the benchmark measures the field layout path as well */
+static bool g_dpt_force_layout = false;
+#define DPT_FORCE_LAYOUT g_dpt_force_layout
+#else
+#define DPT_FORCE_LAYOUT false
+#endif
+
+/* the fields are read into and written from the member of the same size */
+typedef union dpt_field_value_t
+{
+  uint8_t u8;
+  uint16_t u16;
+  uint32_t u32;
+  uint64_t u64;
+  float f32;
+  double f64;
+} dpt_field_value_t;
+
+static int64_t dpt_field_get_int(const dpt_field_t *field, const uint8_t *in)
+{
+  dpt_field_value_t v = { 0 };
+  bool is_signed = field->kind == DPT_FIELD_INT;
+  memcpy(&v, &in[field->offset], field->size);
+  switch (field->size) {
+  case 1: return is_signed ? (int8_t)v.u8 : v.u8;
+  case 2: return is_signed ? (int16_t)v.u16 : v.u16;
+  case 4: return is_signed ? (int32_t)v.u32 : v.u32;
+  default: return (int64_t)v.u64;
+  }
+}
+
+static void dpt_field_set_int(const dpt_field_t *field, uint8_t *out, int64_t value)
+{
+  dpt_field_value_t v = { 0 };
+  switch (field->size) {
+  case 1: v.u8 = field->kind == DPT_FIELD_BOOL ? (value != 0) : (uint8_t)value; break;
+  case 2: v.u16 = (uint16_t)value; break;
+  case 4: v.u32 = (uint32_t)value; break;
+  default: v.u64 = (uint64_t)value; break;
+  }
+  memcpy(&out[field->offset], &v, field->size);
+}
+
+static double dpt_field_get_double(const dpt_field_t *field, const uint8_t *in)
+{
+  dpt_field_value_t v = { 0 };
+  memcpy(&v, &in[field->offset], field->size);
+  return field->size == sizeof(float) ? v.f32 : v.f64;
+}
+
+static void dpt_field_set_double(const dpt_field_t *field, uint8_t *out, double value)
+{
+  dpt_field_value_t v = { 0 };
+  if (field->size == sizeof(float))
+    v.f32 = (float)value;
+  else
+    v.f64 = value;
+  memcpy(&out[field->offset], &v, field->size);
+}
+
+static void dpt_field_encode(CborEncoder *encoder, const dpt_field_t *field, const uint8_t *in)
+{
+  switch (field->kind) {
+  case DPT_FIELD_BOOL:
+    g_err |= cbor_encode_boolean(encoder, dpt_field_get_int(field, in) != 0);
+    break;
+  case DPT_FIELD_FLOAT:
+    g_err |= cbor_encode_double(encoder, dpt_field_get_double(field, in));
+    break;
+  default:
+    g_err |= cbor_encode_int(encoder, dpt_field_get_int(field, in));
+    break;
+  }
+}
+
+/* encodes "1: value" in the map parent */
+static void dpt_encode_value(const struct datapoint_type_t *type, CborEncoder *parent, const uint8_t *in)
+{
+  int f = 0;
+#if APP_DPT_FUNCTION_TABLE
+  if (type->encode && !DPT_FORCE_LAYOUT) {
+    type->encode(parent, in);
+    return;
+  }
+#endif
+  oc_rep_i_set_key(parent, 1);
+  if (type->num_fields == 1) {
+    dpt_field_encode(parent, &type->fields[0], in);
+    return;
+  }
+  oc_rep_begin_array(parent, value);
+  if (type->num_bools > 0 && type->num_bools < type->num_fields) {
+    oc_rep_begin_array(oc_rep_array(value), bools);
+    for (; f < type->num_bools; f++)
+      dpt_field_encode(oc_rep_array(bools), &type->fields[f], in);
+    oc_rep_end_array(oc_rep_array(value), bools);
+  }
+  for (; f < type->num_fields; f++)
+    dpt_field_encode(oc_rep_array(value), &type->fields[f], in);
+  oc_rep_end_array(parent, value);
+}
+
+/* assigns a scalar of type rep_type to the field, the kinds must match */
+static bool dpt_field_assign(const dpt_field_t *field, uint8_t *out, oc_rep_value_type_t rep_type,
+                             int64_t i, double d)
+{
+  switch (rep_type) {
+  case OC_REP_BOOL:
+    if (field->kind != DPT_FIELD_BOOL)
+      return false;
+    dpt_field_set_int(field, out, i != 0);
+    return true;
+  case OC_REP_INT:
+    if (field->kind == DPT_FIELD_BOOL)
+      return false;
+    if (field->kind == DPT_FIELD_FLOAT)
+      dpt_field_set_double(field, out, (double)i);
+    else
+      dpt_field_set_int(field, out, i);
+    return true;
+  case OC_REP_DOUBLE:
+    if (field->kind != DPT_FIELD_FLOAT)
+      return false;
+    dpt_field_set_double(field, out, d);
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool dpt_field_parse(const dpt_field_t *field, const oc_rep_t *rep, uint8_t *out)
+{
+  switch (rep->type) {
+  case OC_REP_BOOL:
+    return dpt_field_assign(field, out, OC_REP_BOOL, rep->value.boolean, 0);
+  case OC_REP_INT:
+    return dpt_field_assign(field, out, OC_REP_INT, rep->value.integer, 0);
+  case OC_REP_DOUBLE:
+    return dpt_field_assign(field, out, OC_REP_DOUBLE, 0, rep->value.double_p);
+  default:
+    return false;
+  }
+}
+
+/* assigns the elements of a typed array to the fields from f on,
+   returns the next field, or -1 if the array does not match */
+static int dpt_fields_parse_array(const struct datapoint_type_t *type, int f, const oc_rep_t *rep,
+                                  uint8_t *out)
+{
+  oc_array_t arr = rep->value.array;
+  size_t size;
+  switch (rep->type) {
+  case OC_REP_BOOL_ARRAY: size = oc_bool_array_size(arr); break;
+  case OC_REP_INT_ARRAY: size = oc_int_array_size(arr); break;
+  case OC_REP_DOUBLE_ARRAY: size = oc_double_array_size(arr); break;
+  default: return -1;
+  }
+  for (size_t i = 0; i < size && f < type->num_fields; i++, f++) {
+    const dpt_field_t *field = &type->fields[f];
+    bool ok;
+    if (rep->type == OC_REP_BOOL_ARRAY)
+      ok = dpt_field_assign(field, out, OC_REP_BOOL, oc_bool_array(arr)[i], 0);
+    else if (rep->type == OC_REP_INT_ARRAY)
+      ok = dpt_field_assign(field, out, OC_REP_INT, oc_int_array(arr)[i], 0);
+    else
+      ok = dpt_field_assign(field, out, OC_REP_DOUBLE, 0, oc_double_array(arr)[i]);
+    if (!ok)
+      return -1;
+  }
+  return f;
+}
+
+/* parses the value of key 1, a scalar, a typed array or a mixed array */
+static bool dpt_parse_value(const struct datapoint_type_t *type, const oc_rep_t *rep, uint8_t *out)
+{
+  int f = 0;
+#if APP_DPT_FUNCTION_TABLE
+  if (type->parse && !DPT_FORCE_LAYOUT && type->parse(rep, out))
+    return true;
+#endif
+  if (type->num_fields == 1)
+    return dpt_field_parse(&type->fields[0], rep, out);
+  if (rep->type == OC_REP_MIXED_ARRAY) {
+    const oc_rep_t *item = rep->value.mixed_array;
+    for (; item != NULL && f >= 0 && f < type->num_fields; item = item->next) {
+      if (dpt_field_parse(&type->fields[f], item, out))
+        f++;
+      else
+        f = dpt_fields_parse_array(type, f, item, out);
+    }
+  } else {
+    f = dpt_fields_parse_array(type, 0, rep, out);
+  }
+  return f == type->num_fields;
+}
+
+bool oc_parse_dpt(DatapointType t, oc_rep_t *rep, void *out)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  if (type == NULL || rep == NULL || out == NULL) {
+    return false;
+  }
+  while (rep != NULL && rep->iname != 1) {
+    rep = rep->next;
+  }
+  if (rep == NULL) {
+    return false;
+  }
+  return dpt_parse_value(type, rep, out);
+}
+
+bool oc_parse_dpt_array(DatapointType t, oc_rep_t *rep, void *out, int n)
+{
+  size_t size = get_dpt_size(t);
+  int i = 0;
+  if (dpt_codec(t) == NULL || rep == NULL || out == NULL) {
+    return false;
+  }
+  while (rep != NULL && i < n) {
+    if (rep->type != OC_REP_OBJECT) {
+      return false;
+    }
+    oc_parse_dpt(t, rep->value.object, &((uint8_t *)out)[size * i]);
+    rep = rep->next;
+    i++;
+  }
+  return true;
+}
+
+bool oc_encode_dpt(DatapointType t, const void *in, bool is_metadata)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  if (type == NULL || in == NULL) {
+    return false;
+  }
+  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
+    oc_rep_begin_root_object();
+  }
+  dpt_encode_value(type, oc_rep_object(root), in);
+  if (!is_metadata) {
+    oc_rep_end_root_object();
+  }
+  return true;
+}
+
+bool oc_encode_dpt_array(DatapointType t, const void *in, int n)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  if (type == NULL || in == NULL) {
+    return false;
+  }
+  oc_rep_begin_links_array();
+  for (int i = 0; i < n; i++) {
+    oc_rep_begin_object(oc_rep_array(links), obj);
+    dpt_encode_value(type, oc_rep_object(obj), &((const uint8_t *)in)[type->size * i]);
+    oc_rep_end_object(oc_rep_array(links), obj);
+  }
+  oc_rep_end_links_array();
+  return true;
+}
+
+void persistent_store_dpt_array(DatapointType t, const char *name, const void *in, int n)
+{
+  persistent_store_elems(name, in, get_dpt_size(t), n, 0, n);
+}
+
+bool persistent_load_dpt_array(DatapointType t, const char *name, void *out, int n)
+{
+  return persistent_load_elems(name, out, get_dpt_size(t), n, 0, n);
+}
+
+int app_sprintf_dpt(DatapointType t, const void *in, char *text, int size)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  int len = 0;
+  memset(text, 0, size);
+  if (type == NULL || in == NULL) {
+    return 1;
+  }
+  for (int f = 0; f < type->num_fields && len < size; f++) {
+    const dpt_field_t *field = &type->fields[f];
+    int r;
+    if (field->kind == DPT_FIELD_FLOAT)
+      r = snprintf(&text[len], size - len, " %f ", dpt_field_get_double(field, in));
+    else if (field->kind == DPT_FIELD_UINT)
+      r = snprintf(&text[len], size - len, " %u ", (unsigned)dpt_field_get_int(field, in));
+    else
+      r = snprintf(&text[len], size - len, " %d ", (int)dpt_field_get_int(field, in));
+    if (r < 0)
+      return 1;
+    len += r;
+  }
+  return 0;
+}
+
+int app_sscanf_dpt(DatapointType t, void *in, char *text)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  char temp_string[300];
+  const char s[2] = " ";
+  char *token;
+
+  if (type == NULL || text == NULL) {
+    return 1;
+  }
+  memset(temp_string, 0, 300);
+  strncpy(temp_string, text, 299);
+
+  // strtok is destructing the input string so copy it first
+  token = strtok(temp_string, s);
+  for (int f = 0; f < type->num_fields; f++) {
+    const dpt_field_t *field = &type->fields[f];
+    if (token == NULL) {
+      return 1;
+    }
+    if (field->kind == DPT_FIELD_FLOAT) {
+      double var;
+      if (sscanf(token, " %lf", &var) != 1) return 1;
+      dpt_field_set_double(field, in, var);
+    } else if (field->kind == DPT_FIELD_UINT) {
+      unsigned int var;
+      if (sscanf(token, " %u", &var) != 1) return 1;
+      dpt_field_set_int(field, in, var);
+    } else {
+      int var;
+      if (sscanf(token, " %d", &var) != 1) return 1;
+      dpt_field_set_int(field, in, var);
+    }
+    token = strtok(NULL, s);
+  }
+  return 0;
+}
+
+int app_str_expected_dpt(DatapointType t, int select, char *text)
+{
+  const struct datapoint_type_t *type = dpt_codec(t);
+  if (type == NULL || text == NULL) {
+    return 1;
+  }
+  if (select != 1 && select != 2) {
+    return 1;
+  }
+  for (int f = 0; f < type->num_fields; f++) {
+    if (select == 2)
+      strcat(text, " 0");
+    else if (type->fields[f].kind == DPT_FIELD_FLOAT)
+      strcat(text, " %f");
+    else if (type->fields[f].kind == DPT_FIELD_UINT)
+      strcat(text, " %u");
+    else
+      strcat(text, " %d");
+  }
+  return 0;
+}
+
+// ===== Datapoint type dispatch =====
+// the runtime works on the type of the data point, the functions return
+// false (or NULL) for types without codecs.
+
+static inline const void *dpt_get_array_elems(DatapointType t, const char *url, void *out, int start, int n)
+{
+  if (dpt_codec(t) == NULL)
+    return NULL;
+  return app_get_array_elems(url, out, start, n);
+}
+
+static inline bool dpt_set_elems(DatapointType t, const char *url, const void *in, int start, int n)
+{
+  if (dpt_codec(t) == NULL)
+    return false;
+  app_set_array_elems(url, in, start, n, true);
+  return true;
+}
+
+static inline bool dpt_set_default_value(DatapointType t, const char *url)
+{
+  if (dpt_codec(t) == NULL)
+    return false;
+  app_set_dpt_default_value(url);
+  return true;
+}
+
+static inline bool dpt_encode(DatapointType t, const void *in, int n, bool as_array, bool is_metadata)
+{
+  if (as_array)
+    return oc_encode_dpt_array(t, in, n);
+  return oc_encode_dpt(t, in, is_metadata);
+}
+
+static inline bool dpt_parse(DatapointType t, oc_rep_t *rep, void *out, int n)
+{
+  return (n > 1) ? oc_parse_dpt_array(t, rep, out, n) : oc_parse_dpt(t, rep, out);
+}
+
+/* loads a single value (num_elements 0) or the whole array */
+static inline bool dpt_persistent_load(DatapointType t, const char *url, void *out, int num_elements)
+{
+  if (dpt_codec(t) == NULL)
+    return false;
+  persistent_load_dpt_array(t, url, out, num_elements ? num_elements : 1);
+  return true;
+}
+
+static inline bool dpt_persistent_store_array(DatapointType t, const char *url, const void *in, int n)
+{
+  if (dpt_codec(t) == NULL)
+    return false;
+  persistent_store_dpt_array(t, url, in, n);
+  return true;
+}
+
+static const char *get_datapoint_name(const datapoint_t *dp) {
+  return oc_string(dp->resource.name);
+}
+
+static const char *get_datapoint_url(const datapoint_t *dp) {
+  return oc_string(dp->resource.uri);
+}
+
+static const char *get_datapoint_dpt(const datapoint_t *dp) {
+  return oc_string(dp->resource.dpt);
+}
+
+static const char *get_datapoint_dpa(const datapoint_t *dp) {
+  for (int i = 0; i < oc_string_array_size(dp->resource.types); i++) {
+    const char *rt = oc_string_array(dp->resource.types)[i];
+    if (strstr(rt, "dpa.") != NULL)
+      return rt;
+  }
+  return NULL;
+}
+
+static const char *const *get_datapoint_metadata(const datapoint_t *dp) {
+  return dp->metadata;
+}
+
+/* index over g_datapoints, followed by g_parameters */
+static const datapoint_t *get_datapoint_by_index(int index)
+{
+  if (index < num_datapoints) {
+    return &g_datapoints[index];
+  }
+  if (index < num_datapoints + num_parameters) {
+    return &g_parameters[index - num_datapoints];
+  }
+  return NULL;
+}
+
+static int get_datapoint_index(const datapoint_t *dp)
+{
+  if (dp >= &g_datapoints[0] && dp < &g_datapoints[num_datapoints]) {
+    return (int)(dp - &g_datapoints[0]);
+  }
+  if (dp >= &g_parameters[0] && dp < &g_parameters[num_parameters]) {
+    return (int)(num_datapoints + (dp - &g_parameters[0]));
+  }
+  return -1;
+}
+
+// ===== Trace =====
+
+#if APP_TRACE_SIZE > 0
+static app_trace_event_t g_trace[APP_TRACE_SIZE];
+static uint32_t g_trace_head; /* total number of events written */
+static uint32_t g_trace_tail; /* total number of events read */
+
+void app_trace(uint16_t id, uint16_t arg0, uint32_t arg1)
+{
+  app_trace_event_t *event = &g_trace[g_trace_head % APP_TRACE_SIZE];
+  event->time = (uint32_t)oc_clock_time();
+  event->id = id;
+  event->arg0 = arg0;
+  event->arg1 = arg1;
+  g_trace_head++;
+  if (g_trace_head - g_trace_tail > APP_TRACE_SIZE) {
+    /* overwritten the oldest event */
+    g_trace_tail = g_trace_head - APP_TRACE_SIZE;
+  }
+}
+
+int app_trace_read(app_trace_event_t *out, int max)
+{
+  int n = 0;
+  while (n < max && g_trace_tail != g_trace_head) {
+    out[n++] = g_trace[g_trace_tail % APP_TRACE_SIZE];
+    g_trace_tail++;
+  }
+  return n;
+}
+
+void app_trace_dump(void)
+{
+  app_trace_event_t event;
+  PRINT_APP("trace: %u events\n", (unsigned)(g_trace_head - g_trace_tail));
+  while (app_trace_read(&event, 1) == 1) {
+    PRINT_APP("  %10u id=%u arg0=%u arg1=%u\n", (unsigned)event.time,
+              (unsigned)event.id, (unsigned)event.arg0, (unsigned)event.arg1);
+  }
+}
+#endif /* APP_TRACE_SIZE */
+
+// ===== Metrics =====
+
+#if APP_METRICS
+static app_metrics_t g_metrics;
+
+static void metrics_latency(app_latency_t *latency, oc_clock_time_t start)
+{
+  uint32_t us = (uint32_t)((oc_clock_time() - start) * 1000000 / OC_CLOCK_SECOND);
+  if (latency->count == 0) {
+    latency->min_us = us;
+    latency->ewma_us = us;
+  } else {
+    if (us < latency->min_us)
+      latency->min_us = us;
+    latency->ewma_us = (uint32_t)((int32_t)latency->ewma_us + ((int32_t)us - (int32_t)latency->ewma_us) / 8);
+  }
+  if (us > latency->max_us)
+    latency->max_us = us;
+  latency->count++;
+}
+
+static void metrics_request(const datapoint_t *dp, bool is_put, oc_clock_time_t start, bool error)
+{
+  int index = get_datapoint_index(dp);
+  if (index < 0)
+    return;
+  metrics_latency(is_put ? &g_datapoint_state[index].metrics.put : &g_datapoint_state[index].metrics.get, start);
+  if (error)
+    g_datapoint_state[index].metrics.errors++;
+}
+
+#define METRICS_START(t) oc_clock_time_t t = oc_clock_time()
+#define METRICS_LATENCY(field, t) metrics_latency(&g_metrics.field, t)
+#define METRICS_REQUEST(dp, is_put, t, error) metrics_request(dp, is_put, t, error)
+#define METRICS_COUNT(field) g_metrics.field++
+#define METRICS_PEAK_OF(var, value) \
+  do { \
+    uint32_t v_ = (uint32_t)(value); \
+    if (v_ > (var)) \
+      (var) = v_; \
+  } while (0)
+#define METRICS_PEAK(field, value) METRICS_PEAK_OF(g_metrics.field, value)
+#define METRICS_MALLOC(size) \
+  do { \
+    METRICS_COUNT(malloc_count); \
+    METRICS_PEAK(malloc_peak_bytes, size); \
+  } while (0)
+
+const app_metrics_t *app_metrics_get(void)
+{
+  return &g_metrics;
+}
+
+const app_dp_metrics_t *app_metrics_get_datapoint(const char *url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL)
+    return NULL;
+  int index = get_datapoint_index(dp);
+  if (index < 0)
+    return NULL;
+  return &g_datapoint_state[index].metrics;
+}
+
+void app_metrics_reset(void)
+{
+  memset(&g_metrics, 0, sizeof(g_metrics));
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    memset(&g_datapoint_state[i].metrics, 0, sizeof(app_dp_metrics_t));
+  }
+}
+
+// footprint high-water marks: the stack depth is sampled in the request
+// path, relative to the depth of the stack loop (taken at the first
+// app_event_process). The heap is sampled with mallinfo when asked for.
+
+static app_footprint_t g_footprint;
+static uintptr_t g_footprint_stack_base;
+
+static void footprint_stack(void)
+{
+  volatile uint8_t marker = 0;
+  uintptr_t sp = (uintptr_t)&marker;
+  /* the stack grows down on all targets */
+  if (g_footprint_stack_base > sp && g_footprint_stack_base - sp > g_footprint.stack_peak_bytes)
+    g_footprint.stack_peak_bytes = (uint32_t)(g_footprint_stack_base - sp);
+}
+
+static uint32_t footprint_rep_count(const oc_rep_t *rep)
+{
+  uint32_t n = 0;
+  for (; rep != NULL; rep = rep->next) {
+    n++;
+    if (rep->type == OC_REP_OBJECT)
+      n += footprint_rep_count(rep->value.object);
+    else if (rep->type == OC_REP_OBJECT_ARRAY)
+      n += footprint_rep_count(rep->value.object_array);
+  }
+  return n;
+}
+
+static void footprint_heap(void)
+{
+#if defined(__linux__) || defined(__NEWLIB__)
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 33)
+#define FOOTPRINT_MALLINFO2
+#endif
+#endif
+#ifdef FOOTPRINT_MALLINFO2
+  struct mallinfo2 mi = mallinfo2();
+#else
+  struct mallinfo mi = mallinfo();
+#endif
+  g_footprint.heap_used_bytes = (uint32_t)mi.uordblks;
+#ifdef __NEWLIB__
+  /* newlib does not give the heap back: the arena is the high-water mark */
+  METRICS_PEAK_OF(g_footprint.heap_peak_bytes, mi.arena);
+#else
+  METRICS_PEAK_OF(g_footprint.heap_peak_bytes, mi.uordblks);
+#endif
+#endif
+}
+
+#define FOOTPRINT_STACK_BASE(local) \
+  do { \
+    if (g_footprint_stack_base == 0) \
+      g_footprint_stack_base = (uintptr_t)(local); \
+  } while (0)
+#define FOOTPRINT_STACK() footprint_stack()
+#define FOOTPRINT_PAYLOAD(size) METRICS_PEAK_OF(g_footprint.payload_peak_bytes, size)
+#define FOOTPRINT_REP(rep) METRICS_PEAK_OF(g_footprint.rep_peak_objects, footprint_rep_count(rep))
+#else
+#define METRICS_START(t)
+#define METRICS_LATENCY(field, t)
+#define METRICS_REQUEST(dp, is_put, t, error)
+#define METRICS_COUNT(field)
+#define METRICS_PEAK(field, value)
+#define METRICS_MALLOC(size)
+#define FOOTPRINT_STACK_BASE(local)
+#define FOOTPRINT_STACK()
+#define FOOTPRINT_PAYLOAD(size)
+#define FOOTPRINT_REP(rep)
+#endif /* APP_METRICS */
+
+// ===== Paged storage of persistent data =====
+
+/* name of the record holding chunk 'chunk' of the data point 'url' */
+static void persistent_chunk_name(char *store_name, size_t len, const char *url, int chunk)
+{
+#ifdef OPTIMIZE_STORAGE
+  // use input as storage name with "/p/" prefix removed
+  snprintf(store_name, len, "%s_c%d", &url[3], chunk);
+#else
+  snprintf(store_name, len, STORE_PREFIX "%s_c%d", url, chunk);
+  char *pos = strchr(store_name, '/');
+  while(pos) {
+    *pos = '_';
+    pos = strchr(store_name, '/');
+  }
+#endif
+}
+
+/* number of elements per record, 0 if the element does not fit */
+static int persistent_chunk_elems(size_t elem_size)
+{
+  if (elem_size == 0 || elem_size > APP_PERSIST_CHUNK_BYTES)
+    return 0;
+  return (int)(APP_PERSIST_CHUNK_BYTES / elem_size);
+}
+
+/* size in bytes of record 'chunk', the last record can be shorter */
+static size_t persistent_chunk_size(size_t elem_size, int chunk_elems, int total, int chunk)
+{
+  int count = total - chunk * chunk_elems;
+  if (count > chunk_elems)
+    count = chunk_elems;
+  return count * elem_size;
+}
+
+bool persistent_store_elems(const char *url, const void *in, size_t elem_size, int total, int start, int n)
+{
+  uint8_t chunk[APP_PERSIST_CHUNK_BYTES];
+  char store_name[40];
+  int chunk_elems = persistent_chunk_elems(elem_size);
+  const uint8_t *src = in;
+  bool ok = true;
+
+  if (chunk_elems == 0) {
+    APP_LOG_ERR("ERR: element size %d does not fit APP_PERSIST_CHUNK_BYTES\n", (int)elem_size);
+    return false;
+  }
+  if (start < 0 || start >= total)
+    return false;
+  if (start + n > total)
+    n = total - start;
+
+  METRICS_START(t_start);
+  int index = start;
+  while (index < start + n) {
+    int c = index / chunk_elems;
+    int offset = index % chunk_elems;
+    int count = chunk_elems - offset;
+    if (count > start + n - index)
+      count = start + n - index;
+    size_t chunk_size = persistent_chunk_size(elem_size, chunk_elems, total, c);
+    persistent_chunk_name(store_name, sizeof(store_name), url, c);
+    if (count * elem_size < chunk_size) {
+      /* partial update of the record: keep the other elements */
+      METRICS_COUNT(storage_reads);
+      if (oc_storage_read(store_name, chunk, chunk_size) != (long)chunk_size)
+        memset(chunk, 0, chunk_size);
+    }
+    memcpy(&chunk[offset * elem_size], src, count * elem_size);
+    APP_LOG_DBG("storing '%s', size: %d\n", store_name, (int)chunk_size);
+    long ret = oc_storage_write(store_name, chunk, chunk_size);
+    METRICS_COUNT(storage_writes);
+    APP_TRACE(APP_TRACE_STORE, index, chunk_size);
+    if (ret <= 0) {
+      APP_LOG_ERR("oc_storage_write failed with error: %ld\n", -ret);
+      ok = false;
+    }
+    src += count * elem_size;
+    index += count;
+  }
+  METRICS_LATENCY(store, t_start);
+  return ok;
+}
+
+bool persistent_load_elems(const char *url, void *out, size_t elem_size, int total, int start, int n)
+{
+  uint8_t chunk[APP_PERSIST_CHUNK_BYTES];
+  char store_name[40];
+  int chunk_elems = persistent_chunk_elems(elem_size);
+  uint8_t *dst = out;
+
+  if (chunk_elems == 0 || start < 0 || start >= total)
+    return false;
+  if (start + n > total)
+    n = total - start;
+
+  METRICS_START(t_start);
+  int index = start;
+  while (index < start + n) {
+    int c = index / chunk_elems;
+    int offset = index % chunk_elems;
+    int count = chunk_elems - offset;
+    if (count > start + n - index)
+      count = start + n - index;
+    size_t chunk_size = persistent_chunk_size(elem_size, chunk_elems, total, c);
+    persistent_chunk_name(store_name, sizeof(store_name), url, c);
+    long ret = oc_storage_read(store_name, chunk, chunk_size);
+    METRICS_COUNT(storage_reads);
+    if (ret != (long)chunk_size) {
+      APP_LOG_ERR("oc_storage_read '%s' returned %ld, expected %d\n", store_name, ret, (int)chunk_size);
+      if (ret > 0) {
+        /* record with a different layout */
+        oc_storage_erase(store_name);
+      }
+      return false;
+    }
+    memcpy(dst, &chunk[offset * elem_size], count * elem_size);
+    dst += count * elem_size;
+    index += count;
+  }
+  METRICS_LATENCY(load, t_start);
+  return true;
+}
+
+void persistent_erase_elems(const char *url, size_t elem_size, int total)
+{
+  char store_name[40];
+  int chunk_elems = persistent_chunk_elems(elem_size);
+  if (chunk_elems == 0)
+    return;
+  for (int c = 0; c * chunk_elems < total; c++) {
+    persistent_chunk_name(store_name, sizeof(store_name), url, c);
+    oc_storage_erase(store_name);
+  }
+}
+
+// ===== Snapshot of persistent data =====
+
+#if APP_PERSIST_SNAPSHOT
+#define SNAPSHOT_STORE_NAME STORE_PREFIX "_snapshot"
+#define SNAPSHOT_MAGIC 0x534E584B /* "KXNS" */
+#define SNAPSHOT_VERSION 2
+#define FNV1A_INIT 2166136261u
+
+/**
+ * @brief header of the snapshot record
+ * the header is followed by one entry (snapshot_entry_t + contents of g_var)
+ * per persistent data point, in the order of g_datapoints (and g_parameters)
+ */
+typedef struct snapshot_header_t
+{
+  uint32_t magic;    /**< SNAPSHOT_MAGIC */
+  uint16_t version;  /**< SNAPSHOT_VERSION */
+  uint16_t count;    /**< number of entries in the snapshot */
+  uint32_t size;     /**< size of the data after the header */
+  uint32_t checksum; /**< hash of the data after the header */
+} snapshot_header_t;
+
+/**
+ * @brief header of one data point in the snapshot
+ */
+typedef struct snapshot_entry_t
+{
+  uint32_t id;   /**< hash over url and type of the data point */
+  uint32_t size; /**< size of the value after the entry */
+} snapshot_entry_t;
+
+/* the record is built and read in place, no allocation on the flush path */
+static uint8_t g_snapshot_buf[APP_PERSIST_SNAPSHOT_BYTES];
+static size_t g_snapshot_len = 0;
+static uint16_t g_snapshot_loaded = 0;
+static uint16_t g_snapshot_missed = 0;
+/* the snapshot in storage holds the current values, the individual records
+   of the data points in the snapshot are not written */
+static bool g_snapshot_valid = false;
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+  const uint8_t *p = data;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= p[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static bool snapshot_has_datapoint(const datapoint_t *dp)
+{
+  return dp->persistent && dp->g_var;
+}
+
+static uint32_t snapshot_datapoint_size(const datapoint_t *dp)
+{
+  int count = dp->num_elements;
+  count = count?count:1;
+  return (uint32_t)(get_dpt_size(dp->type) * count);
+}
+
+static uint32_t snapshot_datapoint_id(const datapoint_t *dp)
+{
+  const char *url = get_datapoint_url(dp);
+  uint32_t id = fnv1a(FNV1A_INIT, url, strlen(url));
+  return fnv1a(id, &dp->type, sizeof(dp->type));
+}
+
+/**
+ * stores the current values of all persistent data points in one record
+ * returns false when the snapshot could not be written, the individual
+ * records have to be written instead
+ */
+static bool snapshot_write(void)
+{
+  snapshot_header_t header;
+  const datapoint_t *dp;
+  size_t pos = sizeof(header);
+
+  memset(&header, 0, sizeof(header));
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  for (int i = 0; (dp = get_datapoint_by_index(i)) != NULL; i++) {
+    if (!snapshot_has_datapoint(dp))
+      continue;
+    snapshot_entry_t entry = { snapshot_datapoint_id(dp), snapshot_datapoint_size(dp) };
+    if (pos + sizeof(entry) + entry.size > sizeof(g_snapshot_buf)) {
+      APP_LOG_WARN("snapshot: larger than APP_PERSIST_SNAPSHOT_BYTES (%d)\n",
+                   (int)sizeof(g_snapshot_buf));
+      g_snapshot_valid = false;
+      return false;
+    }
+    memcpy(&g_snapshot_buf[pos], &entry, sizeof(entry));
+    memcpy(&g_snapshot_buf[pos + sizeof(entry)], dp->g_var, entry.size);
+    pos += sizeof(entry) + entry.size;
+    header.count++;
+  }
+  if (header.count == 0) {
+    g_snapshot_valid = false;
+    return false;
+  }
+  header.size = (uint32_t)(pos - sizeof(header));
+  header.checksum = fnv1a(FNV1A_INIT, &g_snapshot_buf[sizeof(header)], header.size);
+  memcpy(g_snapshot_buf, &header, sizeof(header));
+  long ret = oc_storage_write(SNAPSHOT_STORE_NAME, g_snapshot_buf, pos);
+  METRICS_COUNT(storage_writes);
+  if (ret <= 0) {
+    APP_LOG_ERR("snapshot: oc_storage_write failed with error: %ld\n", -ret);
+    /* the stored snapshot may be older than the records written from now on */
+    oc_storage_erase(SNAPSHOT_STORE_NAME);
+    g_snapshot_valid = false;
+    return false;
+  }
+  g_snapshot_valid = true;
+  return true;
+}
+
+/**
+ * reads and validates the snapshot record into g_snapshot_buf
+ * returns false when the record is missing or corrupt
+ */
+static bool snapshot_read(void)
+{
+  snapshot_header_t header;
+  g_snapshot_len = 0;
+  long ret = oc_storage_read(SNAPSHOT_STORE_NAME, g_snapshot_buf, sizeof(g_snapshot_buf));
+  METRICS_COUNT(storage_reads);
+  if (ret < (long)sizeof(header)) {
+    APP_LOG_WARN("snapshot: not found (%ld)\n", ret);
+    return false;
+  }
+  memcpy(&header, g_snapshot_buf, sizeof(header));
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+      header.size != (uint32_t)ret - sizeof(header) ||
+      header.checksum != fnv1a(FNV1A_INIT, &g_snapshot_buf[sizeof(header)], header.size)) {
+    APP_LOG_WARN("snapshot: corrupt, using the data point records\n");
+    return false;
+  }
+  g_snapshot_len = (size_t)ret;
+  return true;
+}
+
+/**
+ * copies the value of the data point from the snapshot read at start up
+ * returns false when the snapshot has no entry for the data point
+ * (e.g. a data point added by a firmware update)
+ */
+static bool snapshot_load(const datapoint_t *dp)
+{
+  snapshot_entry_t entry;
+  uint32_t id = snapshot_datapoint_id(dp);
+  uint32_t size = snapshot_datapoint_size(dp);
+  size_t pos = sizeof(snapshot_header_t);
+  while (pos + sizeof(entry) <= g_snapshot_len) {
+    memcpy(&entry, &g_snapshot_buf[pos], sizeof(entry));
+    pos += sizeof(entry);
+    if (entry.size > g_snapshot_len - pos)
+      return false;
+    if (entry.id == id && entry.size == size) {
+      memcpy(dp->g_var, &g_snapshot_buf[pos], size);
+      g_snapshot_loaded++;
+      return true;
+    }
+    pos += entry.size;
+  }
+  g_snapshot_missed++;
+  return false;
+}
+
+/* the snapshot read at start up holds all persistent data points */
+static bool snapshot_complete(void)
+{
+  return g_snapshot_len > 0 && g_snapshot_missed == 0 &&
+         g_snapshot_loaded == ((const snapshot_header_t *)g_snapshot_buf)->count;
+}
+#else
+static inline bool snapshot_load(const datapoint_t *dp)
+{
+  (void)dp;
+  return false;
+}
+#endif /* APP_PERSIST_SNAPSHOT */
+
+// ===== Deferred persistence =====
+
+static bool g_persist_scheduled = false;
+static app_persist_flush_cb_t g_persist_flush_cb = NULL;
+static uint16_t g_persist_window_s = APP_PERSIST_WINDOW_S;
+static app_persist_stats_t g_persist_stats;
+/* number of dirty data points of the device instances */
+static uint32_t g_persist_instance_dirty = 0;
+
+static oc_event_callback_retval_t persist_flush_cb(void *data);
+
+#if APP_MAX_DEVICES > 1
+/* the data points of the device instances have their own dirty flags and
+   storage names, see Device instances */
+static bool *instance_persist_dirty(const datapoint_t *dp);
+static bool instance_persist_store(const datapoint_t *dp);
+static uint32_t instances_persist_flush(bool store);
+#else
+#define instance_persist_dirty(dp) NULL
+#define instance_persist_store(dp) false
+static inline uint32_t instances_persist_flush(bool store)
+{
+  (void)store;
+  return 0;
+}
+#endif
+
+static void persist_store(const datapoint_t *dp)
+{
+  int count = dp->num_elements;
+  count = count?count:1;
+  if (dp->g_var && !instance_persist_store(dp)) {
+    dpt_persistent_store_array(dp->type, get_datapoint_url(dp), dp->g_var, count);
+  }
+}
+
+static void persist_discard(void)
+{
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    g_datapoint_state[i].persist_dirty = false;
+  }
+  instances_persist_flush(false);
+  if (g_persist_scheduled) {
+    oc_remove_delayed_callback(NULL, persist_flush_cb);
+    g_persist_scheduled = false;
+  }
+}
+
+#if APP_PERSIST_SNAPSHOT
+/**
+ * writes the snapshot, returns true when all persistent data points with a
+ * variable are stored. When the snapshot can no longer be written, the
+ * individual records (not written while the snapshot was valid) are brought
+ * up to date.
+ */
+static bool persist_snapshot(void)
+{
+  const datapoint_t *dp;
+  bool was_valid = g_snapshot_valid;
+  if (snapshot_write()) {
+    return true;
+  }
+  if (!was_valid) {
+    return false;
+  }
+  for (int i = 0; (dp = get_datapoint_by_index(i)) != NULL; i++) {
+    if (snapshot_has_datapoint(dp)) {
+      persist_store(dp);
+    }
+  }
+  return true;
+}
+#endif
+
+void app_persist_mark_dirty(const datapoint_t *dp)
+{
+  int index = get_datapoint_index(dp);
+  bool *dirty = index >= 0 ? &g_datapoint_state[index].persist_dirty : instance_persist_dirty(dp);
+  g_persist_stats.requested++;
+  if (dirty == NULL || g_persist_window_s == 0) {
+#if APP_PERSIST_SNAPSHOT
+    if (index < 0 || !snapshot_has_datapoint(dp) || !persist_snapshot())
+#endif
+    persist_store(dp);
+    g_persist_stats.written++;
+    return;
+  }
+  if (*dirty) {
+    /* already pending, this write is coalesced */
+    g_persist_stats.saved++;
+    return;
+  }
+  *dirty = true;
+  if (index < 0) {
+    g_persist_instance_dirty++;
+  }
+  if (g_persist_scheduled == false) {
+    g_persist_scheduled = true;
+    oc_set_delayed_callback(NULL, persist_flush_cb, g_persist_window_s);
+  }
+}
+
+void app_persist_flush(void)
+{
+  uint32_t written = 0;
+  oc_clock_time_t start = oc_clock_time();
+
+  if (g_persist_flush_cb) {
+    /* application state that is saved at the same moments */
+    g_persist_flush_cb();
+  }
+  if (g_persist_scheduled) {
+    oc_remove_delayed_callback(NULL, persist_flush_cb);
+    g_persist_scheduled = false;
+  }
+  for (int i = 0; i < num_datapoints + num_parameters; i++) {
+    if (g_datapoint_state[i].persist_dirty) {
+      written++;
+    }
+  }
+  uint32_t records = instances_persist_flush(true);
+  if (written + records == 0) {
+    return;
+  }
+  bool stored = false;
+#if APP_PERSIST_SNAPSHOT
+  /* one record for all data points, the individual records are skipped */
+  stored = persist_snapshot();
+#endif
+  for (int i = 0; i < num_datapoints; i++) {
+    if (g_datapoint_state[i].persist_dirty) {
+      g_datapoint_state[i].persist_dirty = false;
+      if (!stored) {
+        persist_store(&g_datapoints[i]);
+      }
+    }
+  }
+  for (int i = 0; i < num_parameters; i++) {
+    if (g_datapoint_state[num_datapoints + i].persist_dirty) {
+      g_datapoint_state[num_datapoints + i].persist_dirty = false;
+      if (!stored) {
+        persist_store(&g_parameters[i]);
+      }
+    }
+  }
+  if (written > 0) {
+    records += stored ? 1 : written;
+  }
+  written = records;
+  uint32_t duration_ms = (uint32_t)((oc_clock_time() - start) * 1000 / OC_CLOCK_SECOND);
+  g_persist_stats.written += written;
+  g_persist_stats.flushes++;
+  g_persist_stats.last_flush_ms = duration_ms;
+  if (duration_ms > g_persist_stats.max_flush_ms) {
+    g_persist_stats.max_flush_ms = duration_ms;
+  }
+  APP_TRACE(APP_TRACE_FLUSH, 0, written);
+  APP_LOG_DBG("persist flush: %u records in %u ms (saved %u writes)\n",
+    (unsigned)written, (unsigned)duration_ms, (unsigned)g_persist_stats.saved);
+}
+
+static oc_event_callback_retval_t persist_flush_cb(void *data)
+{
+  (void)data;
+  /* the callback is done, do not remove it in app_persist_flush */
+  g_persist_scheduled = false;
+  app_persist_flush();
+  return OC_EVENT_DONE;
+}
+
+bool app_persist_is_pending(void)
+{
+  if (g_persist_instance_dirty > 0) {
+    return true;
+  }
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    if (g_datapoint_state[i].persist_dirty) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void app_persist_set_flush_cb(app_persist_flush_cb_t cb)
+{
+  g_persist_flush_cb = cb;
+}
+
+void app_persist_set_window(uint16_t seconds)
+{
+  g_persist_window_s = seconds;
+  if (seconds == 0) {
+    app_persist_flush();
+  }
+}
+
+const app_persist_stats_t *app_persist_get_stats(void)
+{
+  return &g_persist_stats;
+}
+
+// ===== S-mode outbox =====
+
+typedef struct smode_entry_t
+{
+  const char *url;   /**< url of the data point, the value is read when sent */
+  const char *rp;    /**< s-mode flags, e.g. "w" */
+  uint8_t scope;     /**< scope of the message */
+} smode_entry_t;
+
+static smode_entry_t g_smode_outbox[APP_SMODE_OUTBOX_SIZE];
+static int g_smode_depth = 0;
+static bool g_smode_scheduled = false;
+static bool g_smode_in_batch = false;
+static uint16_t g_smode_window_ms = APP_SMODE_WINDOW_MS;
+static uint16_t g_smode_pace_ms = APP_SMODE_PACE_MS;
+static app_smode_stats_t g_smode_stats;
+
+static oc_event_callback_retval_t smode_flush_cb(void *data);
+
+static void smode_send(const smode_entry_t *entry)
+{
+  APP_LOG_DBG("  s-mode: '%s' scope %d flag '%s'\n", entry->url, entry->scope, entry->rp);
+  oc_do_s_mode_with_scope(entry->scope, entry->url, (char *)entry->rp);
+  g_smode_stats.sent++;
+}
+
+/* sends the oldest entry and shifts the rest of the queue */
+static void smode_send_first(void)
+{
+  smode_send(&g_smode_outbox[0]);
+  g_smode_depth--;
+  memmove(&g_smode_outbox[0], &g_smode_outbox[1], g_smode_depth * sizeof(smode_entry_t));
+}
+
+static void smode_schedule(uint16_t ms)
+{
+  if (g_smode_scheduled == false) {
+    g_smode_scheduled = true;
+    oc_set_delayed_callback_ms(NULL, smode_flush_cb, ms);
+  }
+}
+
+static void smode_discard(void)
+{
+  g_smode_stats.dropped += g_smode_depth;
+  g_smode_depth = 0;
+  g_smode_in_batch = false;
+  if (g_smode_scheduled) {
+    oc_remove_delayed_callback(NULL, smode_flush_cb);
+    g_smode_scheduled = false;
+  }
+}
+
+void app_smode_send(uint8_t scope, const char *url, const char *rp)
+{
+  g_smode_stats.requested++;
+  if (g_smode_window_ms == 0) {
+    smode_entry_t entry = { url, rp, scope };
+    smode_send(&entry);
+    return;
+  }
+  for (int i = 0; i < g_smode_depth; i++) {
+    smode_entry_t *entry = &g_smode_outbox[i];
+    if (entry->scope == scope && strcmp(entry->url, url) == 0 &&
+        strcmp(entry->rp, rp) == 0) {
+      /* the value is read when sending, so the last value is sent once */
+      g_smode_stats.deduplicated++;
+      return;
+    }
+  }
+  if (g_smode_depth == APP_SMODE_OUTBOX_SIZE) {
+    /* make room by sending the oldest entry unbatched */
+    g_smode_stats.overflows++;
+    smode_send_first();
+  }
+  g_smode_outbox[g_smode_depth].url = url;
+  g_smode_outbox[g_smode_depth].rp = rp;
+  g_smode_outbox[g_smode_depth].scope = scope;
+  g_smode_depth++;
+  if (g_smode_depth > g_smode_stats.max_depth) {
+    g_smode_stats.max_depth = g_smode_depth;
+  }
+  smode_schedule(g_smode_window_ms);
+}
+
+void app_smode_flush(void)
+{
+  if (g_smode_scheduled) {
+    oc_remove_delayed_callback(NULL, smode_flush_cb);
+    g_smode_scheduled = false;
+  }
+  if (g_smode_depth > 0 && g_smode_in_batch == false) {
+    g_smode_stats.batches++;
+  }
+  g_smode_in_batch = false;
+  while (g_smode_depth > 0) {
+    smode_send_first();
+  }
+}
+
+static oc_event_callback_retval_t smode_flush_cb(void *data)
+{
+  (void)data;
+  g_smode_scheduled = false;
+  if (g_smode_pace_ms == 0) {
+    app_smode_flush();
+    return OC_EVENT_DONE;
+  }
+  /* paced: one message per pace interval, a batch starts after the window */
+  if (g_smode_depth > 0 && g_smode_in_batch == false) {
+    g_smode_in_batch = true;
+    g_smode_stats.batches++;
+  }
+  if (g_smode_depth > 0) {
+    smode_send_first();
+  }
+  if (g_smode_depth > 0) {
+    smode_schedule(g_smode_pace_ms);
+  } else {
+    g_smode_in_batch = false;
+  }
+  return OC_EVENT_DONE;
+}
+
+void app_smode_set_timing(uint16_t window_ms, uint16_t pace_ms)
+{
+  g_smode_window_ms = window_ms;
+  g_smode_pace_ms = pace_ms;
+  if (window_ms == 0) {
+    app_smode_flush();
+  }
+}
+
+int app_smode_get_depth(void)
+{
+  return g_smode_depth;
+}
+
+const app_smode_stats_t *app_smode_get_stats(void)
+{
+  return &g_smode_stats;
+}
+
+// ===== Observe scheduler =====
+// observers are notified after the value is committed. Changes of a data
+// point within the interval after its last notification are coalesced into
+// one notification, sent when the interval has passed; the value is read when
+// the notification is encoded, so the observers get the last value.
+
+static bool g_observe_scheduled = false;
+static uint32_t g_observe_due_ms;
+static uint16_t g_observe_interval_ms = APP_OBSERVE_INTERVAL_MS;
+static app_observe_stats_t g_observe_stats;
+
+static oc_event_callback_retval_t observe_flush_cb(void *data);
+
+static uint32_t observe_now_ms(void)
+{
+  return (uint32_t)(oc_clock_time() * 1000 / OC_CLOCK_SECOND);
+}
+
+static void observe_send(const datapoint_t *dp)
+{
+  oc_resource_t *res;
+  if (get_datapoint_index(dp) >= 0) {
+    /* device 0: the resource of the data point is the registered resource */
+    res = (oc_resource_t *)&dp->resource;
+  } else {
+    /* instances register their own resources */
+    const char *url = get_datapoint_url(dp);
+    res = oc_ri_get_app_resource_by_uri(url, strlen(url), dp->resource.device);
+  }
+  if (res != NULL) {
+    oc_notify_observers(res);
+    g_observe_stats.sent++;
+  }
+}
+
+static void observe_schedule(uint32_t due_ms, uint32_t now_ms)
+{
+  if (g_observe_scheduled) {
+    if ((int32_t)(due_ms - g_observe_due_ms) >= 0) {
+      return;
+    }
+    /* the new notification is due before the scheduled one */
+    oc_remove_delayed_callback(NULL, observe_flush_cb);
+  }
+  g_observe_scheduled = true;
+  g_observe_due_ms = due_ms;
+  oc_set_delayed_callback_ms(NULL, observe_flush_cb, (uint16_t)(due_ms - now_ms));
+}
+
+static void observe_discard(void)
+{
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    g_datapoint_state[i].observe_pending = false;
+  }
+  if (g_observe_scheduled) {
+    oc_remove_delayed_callback(NULL, observe_flush_cb);
+    g_observe_scheduled = false;
+  }
+}
+
+void app_observe_notify(const datapoint_t *dp)
+{
+  int index = get_datapoint_index(dp);
+  uint32_t now_ms = observe_now_ms();
+  g_observe_stats.requested++;
+  if (index < 0 || g_observe_interval_ms == 0) {
+    observe_send(dp);
+    return;
+  }
+  datapoint_state_t *state = &g_datapoint_state[index];
+  if (state->observe_pending) {
+    /* already pending, this change is coalesced */
+    g_observe_stats.coalesced++;
+    return;
+  }
+  uint32_t due_ms = state->observe_ms + g_observe_interval_ms;
+  if (state->observe_ms == 0 || (int32_t)(now_ms - due_ms) >= 0) {
+    /* quiet data point, notify directly */
+    state->observe_ms = now_ms ? now_ms : 1;
+    observe_send(dp);
+    return;
+  }
+  state->observe_pending = true;
+  observe_schedule(due_ms, now_ms);
+}
+
+/* sends the pending notifications that are due, returns the next due time */
+static bool observe_send_due(uint32_t now_ms, bool all, uint32_t *next_ms)
+{
+  bool more = false;
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    datapoint_state_t *state = &g_datapoint_state[i];
+    if (!state->observe_pending)
+      continue;
+    uint32_t due_ms = state->observe_ms + g_observe_interval_ms;
+    if (all || (int32_t)(now_ms - due_ms) >= 0) {
+      state->observe_pending = false;
+      state->observe_ms = now_ms ? now_ms : 1;
+      observe_send(get_datapoint_by_index((int)i));
+    } else if (!more || (int32_t)(due_ms - *next_ms) < 0) {
+      more = true;
+      *next_ms = due_ms;
+    }
+  }
+  return more;
+}
+
+void app_observe_flush(void)
+{
+  uint32_t next_ms;
+  if (g_observe_scheduled) {
+    oc_remove_delayed_callback(NULL, observe_flush_cb);
+    g_observe_scheduled = false;
+  }
+  observe_send_due(observe_now_ms(), true, &next_ms);
+}
+
+static oc_event_callback_retval_t observe_flush_cb(void *data)
+{
+  (void)data;
+  uint32_t now_ms = observe_now_ms();
+  uint32_t next_ms;
+  /* the callback is done, do not remove it in observe_schedule */
+  g_observe_scheduled = false;
+  if (observe_send_due(now_ms, false, &next_ms)) {
+    observe_schedule(next_ms, now_ms);
+  }
+  return OC_EVENT_DONE;
+}
+
+void app_observe_set_interval(uint16_t interval_ms)
+{
+  g_observe_interval_ms = interval_ms;
+  if (interval_ms == 0) {
+    app_observe_flush();
+  }
+}
+
+const app_observe_stats_t *app_observe_get_stats(void)
+{
+  return &g_observe_stats;
+}
+
+static bool oc_encode_datapoint(const datapoint_t *dp, int pn, int ps, bool is_metadata) {
+  METRICS_START(t_start);
+  size_t count = dp->num_elements;
+  int n = ps;
+  count = count?count:1;
+  if (pn*ps+n >= count)
+    n = count-pn*ps;
+  size_t size = get_dpt_size(dp->type);
+  const void *var = NULL;
+  if (pn*ps >= (int)count)
+    return false;
+  if (dp->g_var) {
+    /* RAM backed: encode directly from the global variable */
+    var = &((const uint8_t *)dp->g_var)[size * pn * ps];
+  } else {
+    if (size * n > g_dp_scratch.size)
+      return false;
+    METRICS_PEAK(scratch_peak_bytes, size * n);
+    var = dpt_get_array_elems(dp->type, get_datapoint_url(dp), g_dp_scratch.get, pn*ps, n);
+    if (var == NULL)
+      return false;
+  }
+
+  if (!dpt_encode(dp->type, var, n, ps > 1, is_metadata))
+    return false;
+  FOOTPRINT_STACK();
+
+  METRICS_LATENCY(encode, t_start);
+  return true;
+}
+
+static bool oc_parse_datapoint(const datapoint_t *dp, oc_rep_t *rep, void *out, int n) {
+  if (out == NULL || rep == NULL)
+    return false;
+  return dpt_parse(dp->type, rep, out, n);
+}
+
+#ifdef MQTT_PROXY
+// ===== MQTT bridge =====
+// changes are queued per data point; the queue is published as one batch
+// after the window, each data point once with its current value (encoded as
+// the GET response). A busy client postpones the rest of the batch, a lost
+// connection is retried with a doubling interval. Encoding and publishing
+// run from a delayed callback, never inside a request handler.
+
+static const datapoint_t *g_mqtt_queue[APP_MQTT_QUEUE_SIZE];
+static int g_mqtt_depth = 0;
+static bool g_mqtt_scheduled = false;
+static bool g_mqtt_connected = false;
+static bool g_mqtt_busy = false;
+static uint8_t g_mqtt_qos = 0;
+static uint16_t g_mqtt_backoff_s = 1;
+static uint32_t g_mqtt_rate_ms;
+static uint32_t g_mqtt_rate_count;
+static const app_mqtt_transport_t *g_mqtt_transport = NULL;
+static void *g_mqtt_ctx = NULL;
+static app_mqtt_stats_t g_mqtt_stats;
+
+static oc_event_callback_retval_t mqtt_flush_cb(void *data);
+static oc_event_callback_retval_t mqtt_reconnect_cb(void *data);
+
+static void mqtt_schedule(uint16_t ms)
+{
+  if (g_mqtt_scheduled == false) {
+    g_mqtt_scheduled = true;
+    oc_set_delayed_callback_ms(NULL, mqtt_flush_cb, ms);
+  }
+}
+
+static void mqtt_connect(void)
+{
+  g_mqtt_stats.reconnects++;
+  if (!g_mqtt_transport->connect(g_mqtt_ctx, g_mqttconf_server, g_mqttconf_port,
+                                 g_mqttconf_username, g_mqttconf_pwd)) {
+    app_mqtt_connected(false);
+  }
+}
+
+static void mqtt_drop_first(void)
+{
+  g_mqtt_depth--;
+  memmove(&g_mqtt_queue[0], &g_mqtt_queue[1], g_mqtt_depth * sizeof(g_mqtt_queue[0]));
+}
+
+/* publishes the oldest entry, false if the client can't take it */
+static bool mqtt_publish_first(void)
+{
+  static uint8_t payload[APP_MQTT_PAYLOAD_SIZE];
+  char topic[sizeof(APP_MQTT_TOPIC_PREFIX) + 64];
+  const datapoint_t *dp = g_mqtt_queue[0];
+  oc_device_info_t *device = oc_core_get_device_info(dp->resource.device);
+  int count = dp->num_elements ? dp->num_elements : 1;
+
+  snprintf(topic, sizeof(topic), APP_MQTT_TOPIC_PREFIX "/%s%s",
+           device ? oc_string(device->serialnumber) : "", get_datapoint_url(dp));
+  oc_rep_new(payload, sizeof(payload));
+  if (!oc_encode_datapoint(dp, 0, count, false) || g_err) {
+    APP_LOG_ERR(" mqtt: %s does not fit in APP_MQTT_PAYLOAD_SIZE\n", topic);
+    g_mqtt_stats.dropped++;
+    mqtt_drop_first();
+    return true;
+  }
+  switch (g_mqtt_transport->publish(g_mqtt_ctx, topic, payload,
+                                    oc_rep_get_encoded_payload_size(), g_mqtt_qos)) {
+  case APP_MQTT_SENT:
+    g_mqtt_stats.published++;
+    g_mqtt_rate_count++;
+    mqtt_drop_first();
+    return true;
+  case APP_MQTT_BUSY:
+    g_mqtt_stats.busy++;
+    g_mqtt_busy = true;
+    return false;
+  case APP_MQTT_DROPPED:
+    g_mqtt_stats.dropped++;
+    mqtt_drop_first();
+    return true;
+  default:
+    app_mqtt_connected(false);
+    return false;
+  }
+}
+
+static void mqtt_update_rate(void)
+{
+  uint32_t now_ms = (uint32_t)(oc_clock_time() * 1000 / OC_CLOCK_SECOND);
+  uint32_t elapsed = now_ms - g_mqtt_rate_ms;
+  if (elapsed >= 1000) {
+    g_mqtt_stats.rate = g_mqtt_rate_count * 1000 / elapsed;
+    g_mqtt_rate_count = 0;
+    g_mqtt_rate_ms = now_ms;
+  }
+}
+
+static oc_event_callback_retval_t mqtt_flush_cb(void *data)
+{
+  (void)data;
+  g_mqtt_scheduled = false;
+  if (g_mqtt_transport == NULL || !g_mqtt_connected) {
+    /* kept queued until connected */
+    return OC_EVENT_DONE;
+  }
+  if (g_mqtt_depth > 0) {
+    g_mqtt_stats.batches++;
+  }
+  g_mqtt_busy = false;
+  while (g_mqtt_depth > 0 && mqtt_publish_first())
+    ;
+  mqtt_update_rate();
+  if (g_mqtt_depth > 0 && g_mqtt_busy) {
+    /* backpressure: retry after the window, or when the client resumes */
+    mqtt_schedule(APP_MQTT_WINDOW_MS);
+  }
+  return OC_EVENT_DONE;
+}
+
+static oc_event_callback_retval_t mqtt_reconnect_cb(void *data)
+{
+  (void)data;
+  if (g_mqtt_transport != NULL && !g_mqtt_connected) {
+    mqtt_connect();
+  }
+  return OC_EVENT_DONE;
+}
+
+void app_mqtt_set_transport(const app_mqtt_transport_t *transport, void *ctx)
+{
+  oc_remove_delayed_callback(NULL, mqtt_reconnect_cb);
+  g_mqtt_transport = transport;
+  g_mqtt_ctx = ctx;
+  g_mqtt_connected = false;
+  g_mqtt_backoff_s = 1;
+  if (transport != NULL) {
+    mqtt_connect();
+  }
+}
+
+void app_mqtt_connected(bool connected)
+{
+  if (connected == g_mqtt_connected && connected) {
+    return;
+  }
+  g_mqtt_connected = connected;
+  if (connected) {
+    APP_LOG_INFO(" mqtt: connected to %s:%d\n", g_mqttconf_server, g_mqttconf_port);
+    g_mqtt_backoff_s = 1;
+    if (g_mqtt_depth > 0) {
+      mqtt_schedule(0);
+    }
+    return;
+  }
+  if (g_mqtt_transport == NULL) {
+    return;
+  }
+  /* never blocks: the next attempt is a delayed callback */
+  APP_LOG_ERR(" mqtt: not connected, retry in %d s\n", g_mqtt_backoff_s);
+  oc_remove_delayed_callback(NULL, mqtt_reconnect_cb);
+  oc_set_delayed_callback(NULL, mqtt_reconnect_cb, g_mqtt_backoff_s);
+  if (g_mqtt_backoff_s < APP_MQTT_RECONNECT_MAX_S) {
+    g_mqtt_backoff_s *= 2;
+  }
+}
+
+void app_mqtt_resume(void)
+{
+  if (g_mqtt_busy && g_mqtt_depth > 0) {
+    g_mqtt_busy = false;
+    if (g_mqtt_scheduled) {
+      oc_remove_delayed_callback(NULL, mqtt_flush_cb);
+      g_mqtt_scheduled = false;
+    }
+    mqtt_schedule(0);
+  }
+}
+
+void app_mqtt_publish(const datapoint_t *dp)
+{
+  if (g_mqtt_transport == NULL) {
+    return;
+  }
+  g_mqtt_stats.requested++;
+  for (int i = 0; i < g_mqtt_depth; i++) {
+    if (g_mqtt_queue[i] == dp) {
+      /* the value is read when publishing, so the last value is sent once */
+      g_mqtt_stats.coalesced++;
+      return;
+    }
+  }
+  if (g_mqtt_depth == APP_MQTT_QUEUE_SIZE) {
+    g_mqtt_stats.dropped++;
+    if (g_mqtt_qos > 0) {
+      /* the queued changes are delivered, this one is lost */
+      return;
+    }
+    /* the oldest change is the least useful one */
+    mqtt_drop_first();
+  }
+  g_mqtt_queue[g_mqtt_depth++] = dp;
+  if ((uint32_t)g_mqtt_depth > g_mqtt_stats.max_depth) {
+    g_mqtt_stats.max_depth = g_mqtt_depth;
+  }
+  if (g_mqtt_connected && !g_mqtt_busy) {
+    mqtt_schedule(APP_MQTT_WINDOW_MS);
+  }
+}
+
+static void mqtt_discard(void)
+{
+  g_mqtt_stats.dropped += g_mqtt_depth;
+  g_mqtt_depth = 0;
+  if (g_mqtt_scheduled) {
+    oc_remove_delayed_callback(NULL, mqtt_flush_cb);
+    g_mqtt_scheduled = false;
+  }
+}
+
+void app_mqtt_set_qos(uint8_t qos)
+{
+  g_mqtt_qos = qos > 2 ? 2 : qos;
+}
+
+int app_mqtt_get_depth(void)
+{
+  return g_mqtt_depth;
+}
+
+const app_mqtt_stats_t *app_mqtt_get_stats(void)
+{
+  return &g_mqtt_stats;
+}
+
+#if APP_MQTT_CLIENT
+// ===== MQTT client =====
+// the default transport of the bridge on Linux: MQTT 3.1.1 over a
+// non-blocking TCP socket, QoS 0 and 1 (QoS 2 is published as QoS 1), no
+// subscriptions. The socket is served by the tickless loop
+// (app_loop_add_handle); without it, it is polled every APP_MQTT_WINDOW_MS.
+
+#define MQTT_CONNECT 0x10
+#define MQTT_CONNACK 0x20
+#define MQTT_PUBLISH 0x30
+#define MQTT_PUBACK 0x40
+#define MQTT_PINGREQ 0xC0
+#define MQTT_PINGRESP 0xD0
+#define MQTT_CONNECT_TIMEOUT_MS 5000
+
+typedef struct mqtt_client_t
+{
+  int fd;               /**< socket, -1 when closed */
+  bool served;          /**< the socket is served by the stack loop */
+  bool connecting;      /**< TCP connect in progress */
+  bool connected;       /**< CONNACK received */
+  bool polling;         /**< mqtt_client_poll_cb is scheduled */
+  bool pinging;         /**< mqtt_client_ping_cb is scheduled */
+  uint16_t waited_ms;   /**< time waited for the connection */
+  uint16_t packet_id;   /**< id of the last QoS 1 publish */
+  uint8_t inflight;     /**< QoS 1 publishes waiting for the PUBACK */
+  const char *username; /**< kept for the CONNECT after the TCP connect */
+  const char *pwd;      /**< kept for the CONNECT after the TCP connect */
+  uint8_t rx[32];       /**< received part of the next packet */
+  size_t rx_len;        /**< bytes in rx */
+  size_t rx_skip;       /**< bytes of a packet that does not fit rx, still to skip */
+  uint8_t tx[APP_MQTT_PAYLOAD_SIZE + sizeof(APP_MQTT_TOPIC_PREFIX) + 80];
+  size_t tx_len;        /**< length of the last packet */
+  size_t tx_sent;       /**< bytes of the last packet sent */
+  char host[64];        /**< the host of addr */
+  int port;             /**< the port of addr */
+  struct sockaddr_storage addr; /**< address of the broker */
+  socklen_t addr_len;   /**< length of addr, 0 = not resolved */
+} mqtt_client_t;
+
+static mqtt_client_t g_mqtt_client = { .fd = -1 };
+
+static oc_event_callback_retval_t mqtt_client_poll_cb(void *data);
+static oc_event_callback_retval_t mqtt_client_ping_cb(void *data);
+
+static void mqtt_client_close(mqtt_client_t *c)
+{
+  /* not removed from inside the callbacks, they return OC_EVENT_DONE */
+  if (c->polling) {
+    oc_remove_delayed_callback(c, mqtt_client_poll_cb);
+    c->polling = false;
+  }
+  if (c->pinging) {
+    oc_remove_delayed_callback(c, mqtt_client_ping_cb);
+    c->pinging = false;
+  }
+  if (c->fd >= 0) {
+    if (c->served) {
+      app_loop_remove_handle(c->fd);
+    }
+    close(c->fd);
+  }
+  c->fd = -1;
+  c->served = false;
+  c->connecting = false;
+  c->connected = false;
+  c->inflight = 0;
+  c->rx_len = 0;
+  c->rx_skip = 0;
+  c->tx_len = 0;
+  c->tx_sent = 0;
+}
+
+/* closes the connection, the bridge reconnects */
+static void mqtt_client_fail(mqtt_client_t *c, const char *reason)
+{
+  APP_LOG_ERR(" mqtt: %s\n", reason);
+  mqtt_client_close(c);
+  app_mqtt_connected(false);
+}
+
+/* sends the rest of the last packet, false when the connection is lost */
+static bool mqtt_client_send(mqtt_client_t *c)
+{
+  while (c->tx_sent < c->tx_len) {
+    ssize_t n = send(c->fd, &c->tx[c->tx_sent], c->tx_len - c->tx_sent, MSG_NOSIGNAL);
+    if (n < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    c->tx_sent += (size_t)n;
+  }
+  return true;
+}
+
+static bool mqtt_client_tx_pending(const mqtt_client_t *c)
+{
+  return c->tx_sent < c->tx_len;
+}
+
+/* fixed header with the remaining length, the variable part follows */
+static size_t mqtt_put_header(uint8_t *buf, uint8_t type, size_t remaining)
+{
+  size_t pos = 0;
+  buf[pos++] = type;
+  do {
+    uint8_t byte = remaining % 128;
+    remaining /= 128;
+    buf[pos++] = remaining ? (byte | 0x80) : byte;
+  } while (remaining);
+  return pos;
+}
+
+static size_t mqtt_put_string(uint8_t *buf, const char *str, size_t len)
+{
+  buf[0] = (uint8_t)(len >> 8);
+  buf[1] = (uint8_t)len;
+  memcpy(&buf[2], str, len);
+  return len + 2;
+}
+
+static bool mqtt_client_send_connect(mqtt_client_t *c)
+{
+  char client_id[32];
+  snprintf(client_id, sizeof(client_id), "knx-%s", g_serial_number);
+  size_t id_len = strlen(client_id);
+  size_t user_len = c->username ? strlen(c->username) : 0;
+  size_t pwd_len = c->pwd ? strlen(c->pwd) : 0;
+  uint8_t flags = 0x02; /* clean session */
+  size_t remaining = 10 + 2 + id_len;
+  if (user_len) {
+    flags |= 0x80;
+    remaining += 2 + user_len;
+    if (pwd_len) {
+      flags |= 0x40;
+      remaining += 2 + pwd_len;
+    }
+  }
+  if (remaining + 5 > sizeof(c->tx)) {
+    APP_LOG_ERR(" mqtt: username and password too long\n");
+    return false;
+  }
+  size_t pos = mqtt_put_header(c->tx, MQTT_CONNECT, remaining);
+  pos += mqtt_put_string(&c->tx[pos], "MQTT", 4);
+  c->tx[pos++] = 4; /* protocol level 3.1.1 */
+  c->tx[pos++] = flags;
+  c->tx[pos++] = (uint8_t)(APP_MQTT_KEEPALIVE_S >> 8);
+  c->tx[pos++] = (uint8_t)APP_MQTT_KEEPALIVE_S;
+  pos += mqtt_put_string(&c->tx[pos], client_id, id_len);
+  if (flags & 0x80) {
+    pos += mqtt_put_string(&c->tx[pos], c->username, user_len);
+  }
+  if (flags & 0x40) {
+    pos += mqtt_put_string(&c->tx[pos], c->pwd, pwd_len);
+  }
+  c->tx_len = pos;
+  c->tx_sent = 0;
+  return mqtt_client_send(c);
+}
+
+/* handles a complete packet from the broker */
+static void mqtt_client_packet(mqtt_client_t *c, const uint8_t *packet, size_t header, size_t len)
+{
+  switch (packet[0] & 0xF0) {
+  case MQTT_CONNACK:
+    if (len < header + 2 || packet[header + 1] != 0) {
+      mqtt_client_fail(c, "broker refused the connection");
+      return;
+    }
+    c->connected = true;
+    c->pinging = true;
+    oc_set_delayed_callback(c, mqtt_client_ping_cb, APP_MQTT_KEEPALIVE_S / 2);
+    app_mqtt_connected(true);
+    break;
+  case MQTT_PUBACK:
+    if (c->inflight > 0) {
+      c->inflight--;
+    }
+    app_mqtt_resume();
+    break;
+  default:
+    /* PINGRESP, nothing is subscribed */
+    break;
+  }
+}
+
+/* reads what the broker sent */
+static void mqtt_client_receive(mqtt_client_t *c)
+{
+  uint8_t buf[128];
+  for (;;) {
+    ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      mqtt_client_fail(c, "connection closed by the broker");
+      return;
+    }
+    if (n < 0) {
+      return;
+    }
+    for (ssize_t i = 0; i < n && c->fd >= 0; i++) {
+      if (c->rx_skip > 0) {
+        c->rx_skip--;
+        continue;
+      }
+      c->rx[c->rx_len++] = buf[i];
+      /* fixed header: type and up to 4 bytes of remaining length */
+      size_t remaining = 0;
+      size_t header = 1;
+      bool complete = false;
+      while (header < c->rx_len && header <= 4) {
+        remaining |= (size_t)(c->rx[header] & 0x7F) << (7 * (header - 1));
+        if ((c->rx[header++] & 0x80) == 0) {
+          complete = true;
+          break;
+        }
+      }
+      if (!complete) {
+        if (c->rx_len > 4) {
+          mqtt_client_fail(c, "malformed packet from the broker");
+        }
+        continue;
+      }
+      if (header + remaining > sizeof(c->rx)) {
+        /* e.g. a retained message, not used by the bridge */
+        c->rx_skip = header + remaining - c->rx_len;
+        c->rx_len = 0;
+      } else if (c->rx_len == header + remaining) {
+        mqtt_client_packet(c, c->rx, header, c->rx_len);
+        c->rx_len = 0;
+      }
+    }
+  }
+}
+
+static void mqtt_client_io_cb(app_loop_handle_t handle, void *ctx)
+{
+  mqtt_client_t *c = ctx;
+  (void)handle;
+  mqtt_client_receive(c);
+  if (c->fd >= 0 && !mqtt_client_send(c)) {
+    mqtt_client_fail(c, "send failed");
+  }
+}
+
+/* the TCP connect is done, false while it is in progress */
+static bool mqtt_client_tcp_done(mqtt_client_t *c, bool *ok)
+{
+  fd_set writable;
+  struct timeval now = { 0, 0 };
+  int err = 0;
+  socklen_t len = sizeof(err);
+  FD_ZERO(&writable);
+  FD_SET(c->fd, &writable);
+  if (select(c->fd + 1, NULL, &writable, NULL, &now) <= 0) {
+    return false;
+  }
+  *ok = getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0;
+  return true;
+}
+
+static oc_event_callback_retval_t mqtt_client_poll_cb(void *data)
+{
+  mqtt_client_t *c = data;
+  bool ok = false;
+  c->polling = false;
+  if (c->fd < 0) {
+    return OC_EVENT_DONE;
+  }
+  if (c->connecting && mqtt_client_tcp_done(c, &ok)) {
+    c->connecting = false;
+    if (!ok || !mqtt_client_send_connect(c)) {
+      mqtt_client_fail(c, "can't connect to the broker");
+      return OC_EVENT_DONE;
+    }
+#if APP_LOOP_TICKLESS && !defined(NO_MAIN)
+    c->served = app_loop_add_handle(c->fd, mqtt_client_io_cb, c);
+#endif
+  }
+  if (!c->connecting && !c->served) {
+    mqtt_client_io_cb(c->fd, c);
+    if (c->fd < 0) {
+      return OC_EVENT_DONE;
+    }
+  }
+  if (!c->connected) {
+    c->waited_ms += APP_MQTT_WINDOW_MS;
+    if (c->waited_ms >= MQTT_CONNECT_TIMEOUT_MS) {
+      mqtt_client_fail(c, "no answer from the broker");
+      return OC_EVENT_DONE;
+    }
+  } else if (c->served) {
+    return OC_EVENT_DONE;
+  }
+  c->polling = true;
+  return OC_EVENT_CONTINUE;
+}
+
+static oc_event_callback_retval_t mqtt_client_ping_cb(void *data)
+{
+  mqtt_client_t *c = data;
+  c->pinging = false;
+  if (!c->connected) {
+    return OC_EVENT_DONE;
+  }
+  if (!mqtt_client_tx_pending(c)) {
+    /* the broker closes the connection after 1.5 keep alive without a packet */
+    c->tx_len = mqtt_put_header(c->tx, MQTT_PINGREQ, 0);
+    c->tx_sent = 0;
+    if (!mqtt_client_send(c)) {
+      mqtt_client_fail(c, "send failed");
+      return OC_EVENT_DONE;
+    }
+  }
+  c->pinging = true;
+  return OC_EVENT_CONTINUE;
+}
+
+/* resolves the broker into c->addr, flags AI_NUMERICHOST = does not block */
+static bool mqtt_client_resolve(mqtt_client_t *c, const char *host, int port, int flags)
+{
+  struct addrinfo hints = { .ai_flags = flags, .ai_family = AF_UNSPEC,
+                            .ai_socktype = SOCK_STREAM };
+  struct addrinfo *res = NULL;
+  char service[8];
+
+  c->addr_len = 0;
+  snprintf(service, sizeof(service), "%d", port);
+  if (host == NULL || host[0] == '\0' || strlen(host) >= sizeof(c->host) ||
+      getaddrinfo(host, service, &hints, &res) != 0) {
+    return false;
+  }
+  if (res->ai_addrlen <= sizeof(c->addr)) {
+    memcpy(&c->addr, res->ai_addr, res->ai_addrlen);
+    c->addr_len = res->ai_addrlen;
+    strcpy(c->host, host);
+    c->port = port;
+  }
+  freeaddrinfo(res);
+  return c->addr_len > 0;
+}
+
+static bool mqtt_client_connect(void *ctx, const char *host, int port, const char *username,
+                                const char *pwd)
+{
+  mqtt_client_t *c = ctx;
+
+  mqtt_client_close(c);
+  c->username = username;
+  c->pwd = pwd;
+  c->waited_ms = 0;
+  /* called from the stack loop: a host name is only resolved by
+     app_mqtt_start_client, here only an address is accepted */
+  if ((c->addr_len == 0 || host == NULL || strcmp(host, c->host) != 0 || port != c->port) &&
+      !mqtt_client_resolve(c, host, port, AI_NUMERICHOST)) {
+    APP_LOG_ERR(" mqtt: can't resolve '%s'\n", host ? host : "");
+    return false;
+  }
+  c->fd = socket(c->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (c->fd < 0 ||
+      (connect(c->fd, (struct sockaddr *)&c->addr, c->addr_len) != 0 && errno != EINPROGRESS)) {
+    mqtt_client_close(c);
+    return false;
+  }
+  c->connecting = true;
+  c->polling = true;
+  oc_set_delayed_callback_ms(c, mqtt_client_poll_cb, APP_MQTT_WINDOW_MS);
+  return true;
+}
+
+static app_mqtt_result_t mqtt_client_publish(void *ctx, const char *topic, const uint8_t *payload,
+                                             size_t len, uint8_t qos)
+{
+  mqtt_client_t *c = ctx;
+  size_t topic_len = strlen(topic);
+  qos = qos > 1 ? 1 : qos;
+  if (!c->connected) {
+    return APP_MQTT_ERROR;
+  }
+  if (!mqtt_client_send(c)) {
+    mqtt_client_close(c);
+    return APP_MQTT_ERROR;
+  }
+  if (mqtt_client_tx_pending(c) || (qos > 0 && c->inflight >= APP_MQTT_INFLIGHT)) {
+    return APP_MQTT_BUSY;
+  }
+  size_t remaining = 2 + topic_len + (qos ? 2 : 0) + len;
+  if (remaining + 5 > sizeof(c->tx)) {
+    APP_LOG_ERR(" mqtt: %s too large\n", topic);
+    return APP_MQTT_DROPPED;
+  }
+  size_t pos = mqtt_put_header(c->tx, (uint8_t)(MQTT_PUBLISH | (qos << 1)), remaining);
+  pos += mqtt_put_string(&c->tx[pos], topic, topic_len);
+  if (qos) {
+    c->packet_id = c->packet_id == 0xFFFF ? 1 : c->packet_id + 1;
+    c->tx[pos++] = (uint8_t)(c->packet_id >> 8);
+    c->tx[pos++] = (uint8_t)c->packet_id;
+    c->inflight++;
+  }
+  memcpy(&c->tx[pos], payload, len);
+  c->tx_len = pos + len;
+  c->tx_sent = 0;
+  if (!mqtt_client_send(c)) {
+    mqtt_client_close(c);
+    return APP_MQTT_ERROR;
+  }
+  return APP_MQTT_SENT;
+}
+
+static const app_mqtt_transport_t g_mqtt_client_transport = {
+  .connect = mqtt_client_connect,
+  .publish = mqtt_client_publish,
+};
+
+bool app_mqtt_start_client(void)
+{
+  if (g_mqttconf_server[0] == '\0') {
+    APP_LOG_INFO(" mqtt: no broker configured, the bridge is off\n");
+    return false;
+  }
+  /* the only blocking lookup, the reconnects use the address */
+  if (!mqtt_client_resolve(&g_mqtt_client, g_mqttconf_server, g_mqttconf_port, 0)) {
+    APP_LOG_ERR(" mqtt: can't resolve '%s', the bridge is off\n", g_mqttconf_server);
+    return false;
+  }
+  app_mqtt_set_transport(&g_mqtt_client_transport, &g_mqtt_client);
+  return true;
+}
+#endif /* APP_MQTT_CLIENT */
+#endif /* MQTT_PROXY */
+
+// ===== Change tracking =====
+
+static uint32_t g_change_generation;
+static uint32_t g_table_generation;
+
+static bool datapoint_is_changed(const datapoint_t *dp, const void *in, int start, int n)
+{
+  if (dp->g_var == NULL) {
+    /* the value is only in storage, assume a change */
+    return true;
+  }
+  int max_elem = dp->num_elements ? dp->num_elements : 1;
+  if (start < 0 || start >= max_elem) {
+    return false;
+  }
+  if (start + n > max_elem) {
+    n = max_elem - start;
+  }
+  size_t size = get_dpt_size(dp->type);
+  return memcmp(&((const uint8_t *)dp->g_var)[size * start], in, size * n) != 0;
+}
+
+static void datapoint_mark_changed(const datapoint_t *dp)
+{
+  int index = get_datapoint_index(dp);
+  if (index >= 0) {
+    g_datapoint_state[index].change_count++;
+  }
+  g_change_generation++;
+}
+
+uint32_t app_get_change_count(const char *url)
+{
+  int index = get_datapoint_index(get_datapoint_by_url(url));
+  if (index < 0) {
+    return 0;
+  }
+  return g_datapoint_state[index].change_count;
+}
+
+bool app_is_changed(const char *url, uint32_t *seen)
+{
+  uint32_t count = app_get_change_count(url);
+  if (count == *seen) {
+    return false;
+  }
+  *seen = count;
+  return true;
+}
+
+uint32_t app_get_change_generation(void)
+{
+  return g_change_generation;
+}
+
+uint32_t app_get_table_generation(void)
+{
+  return g_table_generation;
+}
+
+// ===== Device instances =====
+// device 0 is served from g_datapoints, the other devices (-n <count>) get a
+// copy of the data points with their own values, serial number and storage
+// names. All devices share the oc_main_poll loop of the process.
+
+#if APP_MAX_DEVICES > 1
+typedef struct app_instance_t
+{
+  size_t device;                  /**< device index in the stack */
+  char serial_number[20];         /**< serial number of the device */
+  datapoint_t *datapoints;        /**< copies, num_datapoints + num_parameters */
+  uint8_t *state;                 /**< values of the data points */
+  bool *dirty;                    /**< data points to be stored by app_persist_flush */
+} app_instance_t;
+
+static app_instance_t g_instances[APP_MAX_DEVICES - 1];
+#endif
+static int g_num_devices = 1;
+
+bool app_set_num_devices(int count)
+{
+  if (count < 1 || count > APP_MAX_DEVICES) {
+    APP_LOG_ERR("number of devices %d out of range 1..%d\n", count, APP_MAX_DEVICES);
+    return false;
+  }
+  g_num_devices = count;
+  return true;
+}
+
+int app_get_num_devices(void)
+{
+  return g_num_devices;
+}
+
+#if APP_MAX_DEVICES > 1
+static int instance_num_datapoints(void)
+{
+  return (int)NUM_DP_STATE;
+}
+
+static app_instance_t *instance_of(const datapoint_t *dp)
+{
+  for (int i = 0; i < g_num_devices - 1; i++) {
+    app_instance_t *inst = &g_instances[i];
+    if (inst->datapoints && dp >= &inst->datapoints[0] &&
+        dp < &inst->datapoints[instance_num_datapoints()]) {
+      return inst;
+    }
+  }
+  return NULL;
+}
+
+static size_t datapoint_state_size(const datapoint_t *dp)
+{
+  return get_dpt_size(dp->type) * (dp->num_elements ? dp->num_elements : 1);
+}
+
+/* storage name of an instance data point, e.g. "/p/d1_o_1_1" */
+static void instance_store_name(const app_instance_t *inst, const datapoint_t *dp,
+                                char *name, size_t size)
+{
+  snprintf(name, size, "/p/d%u_%s", (unsigned)inst->device, &get_datapoint_url(dp)[3]);
+}
+
+/* the data point with url, in the same device as dp */
+static const datapoint_t *datapoint_in_device_of(const datapoint_t *dp, const char *url)
+{
+  const datapoint_t *found = get_datapoint_by_url(url);
+  app_instance_t *inst = instance_of(dp);
+  if (found == NULL || inst == NULL) {
+    return found;
+  }
+  return &inst->datapoints[get_datapoint_index(found)];
+}
+
+/* datapoint_set for the data points of an instance: no url lookup, own storage */
+static bool instance_set(const datapoint_t *dp, const void *in, int start, int n)
+{
+  app_instance_t *inst = instance_of(dp);
+  if (inst == NULL) {
+    return false;
+  }
+  int total = dp->num_elements ? dp->num_elements : 1;
+  size_t size = get_dpt_size(dp->type);
+  if (start < 0 || start >= total) {
+    return true;
+  }
+  if (start + n > total) {
+    n = total - start;
+  }
+  memcpy(&((uint8_t *)dp->g_var)[size * start], in, size * n);
+  if (dp->persistent) {
+    /* coalesced with the other writes, as for device 0 */
+    app_persist_mark_dirty(dp);
+  }
+  return true;
+}
+
+static bool *instance_persist_dirty(const datapoint_t *dp)
+{
+  app_instance_t *inst = instance_of(dp);
+  if (inst == NULL || inst->dirty == NULL) {
+    return NULL;
+  }
+  return &inst->dirty[dp - inst->datapoints];
+}
+
+static bool instance_persist_store(const datapoint_t *dp)
+{
+  app_instance_t *inst = instance_of(dp);
+  if (inst == NULL) {
+    return false;
+  }
+  char name[30];
+  int total = dp->num_elements ? dp->num_elements : 1;
+  instance_store_name(inst, dp, name, sizeof(name));
+  persistent_store_elems(name, dp->g_var, get_dpt_size(dp->type), total, 0, total);
+  return true;
+}
+
+/* stores (or with store false discards) the dirty data points of the
+   instances, returns the number of records written */
+static uint32_t instances_persist_flush(bool store)
+{
+  uint32_t written = 0;
+  if (g_persist_instance_dirty == 0) {
+    return 0;
+  }
+  for (int i = 0; i < g_num_devices - 1; i++) {
+    app_instance_t *inst = &g_instances[i];
+    for (int d = 0; inst->dirty && d < instance_num_datapoints(); d++) {
+      if (inst->dirty[d]) {
+        inst->dirty[d] = false;
+        if (store) {
+          instance_persist_store(&inst->datapoints[d]);
+          written++;
+        }
+      }
+    }
+  }
+  g_persist_instance_dirty = 0;
+  return written;
+}
+
+/* adds the devices of the instances, after device 0 is added */
+static int instances_add_devices(void)
+{
+  uint64_t base = strtoull(g_serial_number, NULL, 16);
+  size_t state_size = 0;
+
+  for (int d = 0; d < instance_num_datapoints(); d++) {
+    state_size += datapoint_state_size(get_datapoint_by_index(d));
+  }
+  for (int i = 0; i < g_num_devices - 1; i++) {
+    app_instance_t *inst = &g_instances[i];
+    inst->device = (size_t)(i + 1);
+    snprintf(inst->serial_number, sizeof(inst->serial_number), "%012llX",
+             (unsigned long long)(base + inst->device));
+    inst->state = calloc(1, state_size);
+    inst->datapoints = calloc(instance_num_datapoints(), sizeof(datapoint_t));
+    inst->dirty = calloc(instance_num_datapoints(), sizeof(bool));
+    if (inst->state == NULL || inst->datapoints == NULL || inst->dirty == NULL ||
+        oc_add_device(g_app_info.name, "1.0.0", "//", inst->serial_number, NULL, NULL) != 0) {
+      APP_LOG_ERR("device %d could not be added, running %d devices\n", i + 1, i + 1);
+      free(inst->state);
+      inst->state = NULL;
+      free(inst->datapoints);
+      inst->datapoints = NULL;
+      free(inst->dirty);
+      inst->dirty = NULL;
+      g_num_devices = i + 1;
+      break;
+    }
+    APP_LOG_INFO("device %d: serial number %s\n", (int)inst->device, inst->serial_number);
+  }
+  return 0;
+}
+
+/* values of the instances: start with the values of device 0, then load the
+   stored values of the instance */
+static void instances_load_values(void)
+{
+  for (int i = 0; i < g_num_devices - 1; i++) {
+    app_instance_t *inst = &g_instances[i];
+    uint8_t *state = inst->state;
+    for (int d = 0; d < instance_num_datapoints(); d++) {
+      const datapoint_t *src = get_datapoint_by_index(d);
+      datapoint_t *dp = &inst->datapoints[d];
+      *dp = *src;
+      dp->resource.device = inst->device;
+      dp->g_var = state;
+      if (src->g_var) {
+        memcpy(state, src->g_var, datapoint_state_size(src));
+      }
+      if (dp->persistent) {
+        char name[30];
+        int total = dp->num_elements ? dp->num_elements : 1;
+        instance_store_name(inst, dp, name, sizeof(name));
+        persistent_load_elems(name, state, get_dpt_size(dp->type), total, 0, total);
+      }
+      state += datapoint_state_size(src);
+    }
+  }
+}
+
+/* registers the data points of the instances as resources of their device */
+static void instances_register_resources(void)
+{
+  for (int i = 0; i < g_num_devices - 1; i++) {
+    app_instance_t *inst = &g_instances[i];
+    for (int d = 0; d < instance_num_datapoints(); d++) {
+      datapoint_t *dp = &inst->datapoints[d];
+      oc_resource_t *res = oc_new_resource(oc_string(dp->resource.name),
+        get_datapoint_url(dp), 1, inst->device);
+      oc_resource_bind_resource_type(res, oc_string_array_get_item(dp->resource.types, 0));
+      oc_resource_bind_dpt(res, get_datapoint_dpt(dp));
+      oc_resource_bind_content_type(res, APPLICATION_CBOR);
+      oc_resource_bind_resource_interface(res, dp->resource.interfaces);
+      oc_resource_set_function_block_instance(res, dp->resource.fb_instance);
+      oc_resource_set_discoverable(res, true);
+      oc_resource_set_observable(res, true);
+      oc_resource_set_request_handler(res, OC_GET, get_generic, dp);
+      if (dp->resource.put_handler.cb) {
+        oc_resource_set_request_handler(res, OC_PUT, put_generic, dp);
+      }
+      oc_add_resource(res);
+    }
+  }
+}
+#else
+#define instance_set(dp, in, start, n) false
+#define datapoint_in_device_of(dp, url) get_datapoint_by_url(url)
+#endif /* APP_MAX_DEVICES > 1 */
+
+void datapoint_set(const datapoint_t *dp, void *in, int start, int n) 
+{
+  if (in == NULL)
+    return;
+  bool changed = datapoint_is_changed(dp, in, start, n);
+  if (changed) {
+    datapoint_mark_changed(dp);
+  }
+  if (!instance_set(dp, in, start, n)) {
+    dpt_set_elems(dp->type, get_datapoint_url(dp), in, start, n);
+  }
+  FOOTPRINT_STACK();
+  if (changed) {
+    app_observe_notify(dp);
+#ifdef MQTT_PROXY
+    app_mqtt_publish(dp);
+#endif
+  }
+}
+
+const datapoint_t *get_datapoint_by_url(const char *url) {
+  // binary search on the sorted url index
+  // all urls start with /p/<url>, so the compare starts after the prefix
+  if (url == NULL || strncmp(url, "/p/", 3) != 0) {
+    return NULL;
+  }
+  const char *suffix = &url[3];
+  size_t low = 0;
+  size_t high = g_url_index_size;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int cmp = strcmp(g_url_index[mid].suffix, suffix);
+    if (cmp == 0) {
+      return g_url_index[mid].dp;
+    }
+    if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return NULL;
+}
+
+int app_get_url_array_size(const char *url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL)
+    return -1;
+  return dp->num_elements;
+}
+
+bool get_module_url(char* out_url, const char* in_url, int module_index)
+{
+  int digits_after_underscore = 0;
+  size_t url_length = strlen(in_url);
+  size_t keep_len;
+  char temp[50];
+      
+  // Find out how many more digits we have after the underscore
+  for (int i = url_length - 1; i >= 0; --i)
+  {
+      // We have reached the underscore, we can stop counting
+      if (*(in_url + i) == '_')
+          break; 
+          
+      // We have counted one more digit after the underscore
+      if (isdigit(*(in_url + i)))
+          ++digits_after_underscore;
+      else // We have encountered a non-digit and non-underscore, which is unexpected.
+          return true; 
+  }
+  
+  // We can now calculate the number of characters that we need to keep from the original URL
+  keep_len = url_length - digits_after_underscore;
+  
+  // Copy over those characters into a temp array
+  strncpy(temp, in_url, keep_len);
+  temp[keep_len] = '\0';
+  
+  // Add the module number at the end, and set the out_url pointer
+  sprintf(temp + strlen(temp), "%d", module_index);
+  strcpy(out_url, temp);
+  
+  return false;
+}
+
+// Type generic getters/setters
+
+bool app_is_dpt_url(const char *url, DatapointType t)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return false;
+  }
+  return dp->type == t;
+}
+
+void app_set_dpt_default_value(const char *url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL || dp->g_var == NULL) {
+    return;
+  }
+  const struct datapoint_type_t *type = dpt_codec(dp->type);
+  if (type == NULL || type->default_value == NULL) {
+    // No default value, do nothing...
+    return;
+  }
+  int count = dp->num_elements;
+  count = count?count:1;
+  for (int i = 0; i < count; i++) {
+    memcpy(&((uint8_t *)dp->g_var)[type->size * i], type->default_value, type->size);
+  }
+}
+
+void app_set_array_elems(const char *url, const void *in, int start, int n, bool store_persistently)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return;
+  }
+  size_t size = get_dpt_size(dp->type);
+  int max_elem = dp->num_elements;
+  if(max_elem == 0) {
+    max_elem = 1;
+  }
+  if (start >= max_elem) {
+    return;
+  }
+  if (start+n > max_elem) {
+    n = max_elem-start;
+  }
+  if (dp->g_var) {
+    memcpy(&((uint8_t *)dp->g_var)[size*start], in, size*n);
+    if (dp->persistent && store_persistently) {
+      app_persist_mark_dirty(dp);
+    }
+  }else if (dp->persistent && store_persistently) {
+    int count = dp->num_elements;
+    count = count?count:1;
+    /* only the records holding [start, start+n) are written */
+    persistent_store_elems(get_datapoint_url(dp), in, size, count, start, n);
+  }
+  return;
+}
+
+const void *app_get_array_elems(const char *url, void *out, int start, int n)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return NULL;
+  }
+  size_t size = get_dpt_size(dp->type);
+  int max_elem = dp->num_elements;
+  if(max_elem == 0) {
+    max_elem = 1;
+  }
+  if (start >= max_elem) {
+    return NULL;
+  }
+  if (start+n > max_elem){
+    n = max_elem - start;
+  }
+  if (dp->g_var) {
+    if (out == NULL) {
+      return dp->g_var;
+    }
+    memcpy(out, &((const uint8_t *)dp->g_var)[size*start], size*n);
+    return out;
+  }else if (dp->persistent && out) {
+    int count = dp->num_elements;
+    count = count?count:1;
+    /* only the records holding [start, start+n) are read */
+    if (!persistent_load_elems(get_datapoint_url(dp), out, size, count, start, n)) {
+      memset(out, 0, n*size);
+    }
+    return out;
+  }
+  return NULL;
+}
+
+// BOOLEAN code
+
+/**
+ * @brief function to check if the url is represented by a boolean
+ *
+ * @param true = url value is a boolean
+ * @param false = url is not a boolean
+ */
+bool app_is_bool_url(const char* url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return false;
+  }
+  return dp->type == DatapointType_bool;
+}
+
+/**
+ * @brief sets the global boolean variable at the url
+ *
+ * Note: if the url is ot found then the value is not changed
+ *
+ * @param url the url indicating the global variable
+ * @param value the value to be set
+ */
+void app_set_bool_variable(const char* url, bool value)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return;
+  }
+  if (dp->type != DatapointType_bool) {
+    return;
+  }
+  if (dp->g_var) {
+    *((bool*)dp->g_var) = value;
+  }
+}
+
+/**
+ * @brief retrieve the global boolean variable at the url
+ *
+ * @param url the url indicating the global variable
+ * @return the value of the variable
+ */
+bool app_retrieve_bool_variable(const char* url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return false;
+  }
+  if (dp->type != DatapointType_bool) {
+    return false;
+  }
+  if (dp->g_var) {
+    return *((bool*)dp->g_var);
+  }
+  return false;
+}
+
+
+/**
+ * @brief retrieve the global int variable at the url
+ *
+ * @param url the url indicating the global variable
+ * @param value ptr to value (which is going to be set)
+ * @return the true if variable is set
+ */
+bool app_retrieve_int_variable(const char* url, int* value)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return false;
+  }
+  if (dp->type != DatapointType_int) {
+    return false;
+  }
+  if (dp->g_var) {
+    value = ((int*)dp->g_var);
+    return true;
+  }
+  return false;
+}
+
+
+// FAULT code
+
+/**
+ * @brief set the fault (boolean) variable at the url
+ *
+ * @param url the url indicating the fault variable
+ * @param value the value of the fault variable
+ */
+void app_set_fault_variable(const char* url, bool value)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return;
+  }
+  if ((dp->resource.interfaces & OC_IF_A) == 0) {
+    return;
+  }
+  if (dp->g_fault) {
+    *((bool*)dp->g_fault) = value;
+  }
+  //TODO: Add back support for changing the feedback variable
+}
+
+/**
+ * @brief retrieve the fault (boolean) variable at the url
+ *
+ * @param url the url indicating the fault variable
+ * @return the value of the fault variable
+ */
+bool app_retrieve_fault_variable(const char* url)
+{
+  const datapoint_t *dp = get_datapoint_by_url(url);
+  if (dp == NULL) {
+    return false;
+  }
+  if (dp->resource.interfaces & OC_IF_A == 0) {
+    return false;
+  }
+  if (dp->g_fault) {
+    return *((bool*)dp->g_fault);
+  }
+  return false;
+}
+
+// PARAMETER code
+
+bool app_is_url_parameter(const char* url)
+{
+  // all parametes start with /p/pxxx
+  if (strncmp(url,"/p/p",4) == 0 ) {
+    return false;
+  }
+
+  for (int i = 0; i < num_parameters; i++) {
+    const datapoint_t *dp = &g_parameters[i];
+    if (strcmp(get_datapoint_url(dp), url) == 0) {
+      return true;
+    }
+  } 
+  return false;
+}
+
+const char* app_get_parameter_url(int index)
+{
+if (index < num_parameters) {
+    return get_datapoint_url(&g_parameters[index]);
+  } 
+  return NULL;
+}
+
+const char* app_get_parameter_name(int index)
+{
+  if (index < num_parameters) {
+    return get_datapoint_name(&g_parameters[index]);
+  } 
+  return NULL;
+}
+
+bool app_is_secure()
+{
+#ifdef OC_OSCORE
+  return true;
+#else
+  return false;
+#endif /* OC_OSCORE */
+}
+
+static oc_put_struct_t app_put = { NULL };
+
+void
+app_set_put_cb(oc_put_cb_t cb)
+{
+  app_put.cb = cb;
+}
+
+oc_put_struct_t *
+oc_get_put_cb(void)
+{
+  return &app_put;
+}
+
+void do_put_cb(const char* url)
+{
+  oc_put_struct_t *my_cb = oc_get_put_cb();
+  if (my_cb && my_cb->cb) {
+    my_cb->cb(url);
+  }
+}
+
+static oc_get_struct_t app_get = { NULL };
+
+void
+app_set_get_cb(oc_get_cb_t cb)
+{
+  app_get.cb = cb;
+}
+
+oc_get_struct_t *
+oc_get_get_cb(void)
+{
+  return &app_get;
+}
+
+void do_get_cb(const char* url)
+{
+  oc_get_struct_t *my_cb = oc_get_get_cb();
+  if (my_cb && my_cb->cb) {
+    my_cb->cb(url);
+  }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int app_initialize_stack();
+void signal_event_loop(void);
+void register_resources(void);
+void initialize_variables();
+void reset_variables();
+void logic_initialize();
+int app_init(void);
+#ifdef __cplusplus
+}
+#endif
+
+// ===== Event ring =====
+// bounded multi producer, single consumer ring (D. Vyukov). The producers
+// (hardware callbacks, UI threads) claim a cell with a compare and swap on the
+// head, the stack loop is the only consumer and owns the tail, so the
+// producers never touch the stack state and never take a lock.
+// The sequence of a cell is stored relative to its index, so the zero
+// initialized ring is empty. Only the first post after a drain signals the
+// stack loop.
+
+#if (APP_EVENT_RING_SIZE & (APP_EVENT_RING_SIZE - 1)) != 0
+#error "APP_EVENT_RING_SIZE must be a power of 2"
+#endif
+
+#ifdef _MSC_VER
+#define EVENT_LOAD(p) ((uint32_t)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define EVENT_STORE(p, v) InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#define EVENT_XCHG(p, v) ((uint32_t)InterlockedExchange((volatile LONG *)(p), (LONG)(v)))
+#define EVENT_CAS(p, e, v) \
+  ((uint32_t)InterlockedCompareExchange((volatile LONG *)(p), (LONG)(v), (LONG)(e)) == (e))
+#define EVENT_INC(p) InterlockedIncrement((volatile LONG *)(p))
+#else
+#define EVENT_LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define EVENT_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define EVENT_XCHG(p, v) __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#define EVENT_CAS(p, e, v) \
+  __atomic_compare_exchange_n(p, &(uint32_t){ e }, v, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+#define EVENT_INC(p) __atomic_fetch_add(p, 1, __ATOMIC_RELAXED)
+#endif
+
+#define EVENT_MASK (APP_EVENT_RING_SIZE - 1)
+
+typedef enum {
+  EVENT_CALL,
+  EVENT_SET,
+  EVENT_TOGGLE,
+  EVENT_SMODE
+} event_kind_t;
+
+typedef struct event_cell_t
+{
+  volatile uint32_t seq; /**< sequence - cell index */
+  uint8_t kind;
+  uint8_t scope;
+  uint8_t size;
+  app_event_cb_t cb;
+  void *ctx;
+  const char *url;
+  const char *rp;
+  uint8_t value[APP_EVENT_VALUE_SIZE];
+} event_cell_t;
+
+static event_cell_t g_event_ring[APP_EVENT_RING_SIZE];
+static volatile uint32_t g_event_head; /**< next cell to claim, producers */
+static uint32_t g_event_tail;          /**< next cell to process, stack loop */
+static volatile uint32_t g_event_wake; /**< the stack loop is signalled */
+static app_event_stats_t g_event_stats;
+
+/* claims a cell, the caller fills it and calls event_publish */
+static event_cell_t *event_claim(uint32_t *pos)
+{
+  uint32_t p = EVENT_LOAD(&g_event_head);
+  for (;;) {
+    event_cell_t *cell = &g_event_ring[p & EVENT_MASK];
+    int32_t dif = (int32_t)(EVENT_LOAD(&cell->seq) + (p & EVENT_MASK) - p);
+    if (dif == 0) {
+      if (EVENT_CAS(&g_event_head, p, p + 1)) {
+        *pos = p;
+        return cell;
+      }
+      p = EVENT_LOAD(&g_event_head);
+    } else if (dif < 0) {
+      /* full: the cell still holds the event of the previous round */
+      EVENT_INC(&g_event_stats.dropped);
+      return NULL;
+    } else {
+      p = EVENT_LOAD(&g_event_head);
+    }
+  }
+}
+
+static bool event_publish(event_cell_t *cell, uint32_t pos)
+{
+  EVENT_STORE(&cell->seq, pos + 1 - (pos & EVENT_MASK));
+  EVENT_INC(&g_event_stats.posted);
+  if (EVENT_XCHG(&g_event_wake, 1) == 0) {
+    EVENT_INC(&g_event_stats.wakeups);
+    signal_event_loop();
+  }
+  return true;
+}
+
+bool app_event_post_call(app_event_cb_t cb, void *ctx)
+{
+  uint32_t pos;
+  event_cell_t *cell;
+  if (cb == NULL || (cell = event_claim(&pos)) == NULL)
+    return false;
+  cell->kind = EVENT_CALL;
+  cell->cb = cb;
+  cell->ctx = ctx;
+  return event_publish(cell, pos);
+}
+
+bool app_event_post_set(const char *url, const void *value, size_t size)
+{
+  uint32_t pos;
+  event_cell_t *cell;
+  if (url == NULL || value == NULL || size > APP_EVENT_VALUE_SIZE)
+    return false;
+  if ((cell = event_claim(&pos)) == NULL)
+    return false;
+  cell->kind = EVENT_SET;
+  cell->url = url;
+  cell->size = (uint8_t)size;
+  memcpy(cell->value, value, size);
+  return event_publish(cell, pos);
+}
+
+bool app_event_post_toggle(const char *url)
+{
+  uint32_t pos;
+  event_cell_t *cell;
+  if (url == NULL || (cell = event_claim(&pos)) == NULL)
+    return false;
+  cell->kind = EVENT_TOGGLE;
+  cell->url = url;
+  return event_publish(cell, pos);
+}
+
+bool app_event_post_smode(uint8_t scope, const char *url, const char *rp)
+{
+  uint32_t pos;
+  event_cell_t *cell;
+  if (url == NULL || rp == NULL || (cell = event_claim(&pos)) == NULL)
+    return false;
+  cell->kind = EVENT_SMODE;
+  cell->scope = scope;
+  cell->url = url;
+  cell->rp = rp;
+  return event_publish(cell, pos);
+}
+
+static void event_run(event_cell_t *cell)
+{
+  const datapoint_t *dp;
+  uint8_t value[APP_EVENT_VALUE_SIZE];
+
+  switch (cell->kind) {
+  case EVENT_CALL:
+    cell->cb(cell->ctx);
+    break;
+  case EVENT_SET:
+    dp = get_datapoint_by_url(cell->url);
+    if (dp == NULL || get_dpt_size(dp->type) != cell->size) {
+      APP_LOG_ERR(" event: no data point %s of size %d\n", cell->url, cell->size);
+      break;
+    }
+    memcpy(value, cell->value, cell->size);
+    datapoint_set(dp, value, 0, 1);
+    break;
+  case EVENT_TOGGLE:
+    dp = get_datapoint_by_url(cell->url);
+    if (dp == NULL || get_dpt_size(dp->type) != 1 ||
+        app_get_array_elems(cell->url, value, 0, 1) == NULL) {
+      APP_LOG_ERR(" event: no 1 bit data point %s\n", cell->url);
+      break;
+    }
+    value[0] = !value[0];
+    datapoint_set(dp, value, 0, 1);
+    break;
+  case EVENT_SMODE:
+    app_smode_send(cell->scope, cell->url, cell->rp);
+    break;
+  }
+}
+
+int app_event_process(void)
+{
+  int processed = 0;
+  FOOTPRINT_STACK_BASE(&processed);
+  /* cleared before the drain: an event posted from now on signals again */
+  EVENT_XCHG(&g_event_wake, 0);
+  uint32_t depth = EVENT_LOAD(&g_event_head) - g_event_tail;
+  if (depth > g_event_stats.max_depth)
+    g_event_stats.max_depth = depth;
+  /* only the events posted before the drain, the loop must not starve */
+  while (depth-- > 0) {
+    uint32_t pos = g_event_tail;
+    event_cell_t *cell = &g_event_ring[pos & EVENT_MASK];
+    if (EVENT_LOAD(&cell->seq) + (pos & EVENT_MASK) != pos + 1)
+      break; /* claimed, not yet published */
+    event_run(cell);
+    g_event_tail = pos + 1;
+    EVENT_STORE(&cell->seq, pos + APP_EVENT_RING_SIZE - (pos & EVENT_MASK));
+    processed++;
+  }
+  g_event_stats.processed += processed;
+  return processed;
+}
+
+static void event_discard(void)
+{
+  for (;;) {
+    uint32_t pos = g_event_tail;
+    event_cell_t *cell = &g_event_ring[pos & EVENT_MASK];
+    if (EVENT_LOAD(&cell->seq) + (pos & EVENT_MASK) != pos + 1)
+      break;
+    g_event_tail = pos + 1;
+    EVENT_STORE(&cell->seq, pos + APP_EVENT_RING_SIZE - (pos & EVENT_MASK));
+  }
+}
+
+const app_event_stats_t *app_event_get_stats(void)
+{
+  return &g_event_stats;
+}
+
+// DEVBOARD code
+
+/**
+ * @brief devboard button toggle callback
+ *
+ */
+// we no longer have app_set_bool_variable
+//void dev_btn_toggle_cb(char *url)
+//{
+//  PRINT_APP("Handling %s\n", url);
+//  bool val = app_retrieve_bool_variable(url);
+//  if (val == true)
+//  {
+//    val = false;
+//  }
+//  else
+//  {
+//    val = true;
+//  }
+//  app_set_bool_variable(url, val);
+//  oc_do_s_mode_with_scope(5, url, "w");
+//}
+
+/**
+ * @brief s-mode response callback
+ * will be called when a response is received on an s-mode read request
+ *
+ * @param url the url
+ * @param rep the full response
+ * @param rep_value the parsed value of the response
+ */
+void
+oc_add_s_mode_response_cb(char *url, oc_rep_t *rep, oc_rep_t *rep_value)
+{
+  (void)rep;
+  (void)rep_value;
+
+  APP_LOG_DBG("oc_add_s_mode_response_cb %s\n", url);
+}
+
+
+
+/**
+ * @brief function to set the input string to upper case
+ *
+ * @param str the string to make upper case
+ *
+ */
+void app_str_to_upper(char *str){
+  while (*str != '\0')
+  {
+    *str = toupper(*str);
+    str++;
+  }
+}
+
+/**
+ * @brief function to set up the device.
+ *
+ * sets the:
+ * - manufacturer     : cascoda
+ * - serial number    : g_serial_number
+ * - base path
+ * - knx spec version
+ * - hardware version : [0, 4, 0]
+ * - firmware version : [0, 4, 0]
+ * - hardware type    : 000000000000
+ * - device model     : g_app_info.model
+ *
+ */
+int
+app_init(void)
+{
+  int ret = oc_init_platform("cascoda", NULL, NULL);
+  char serial_number_uppercase[20];
+
+  /* set the application name, version, base url, device serial number */
+  ret |= oc_add_device(g_app_info.name, "1.0.0", "//", g_serial_number, NULL, NULL);
+#if APP_MAX_DEVICES > 1
+  ret |= instances_add_devices();
+#endif
+
+  oc_device_info_t *device = oc_core_get_device_info(0);
+
+#ifdef LINUX
+  #define MAX_HOSTNAME 50
+  char hostname[50];
+  // set the hostname
+  ret = gethostname(&hostname[0], 50);
+  if (ret != -1) {
+    printf("Hostname (linux):    %s\n", hostname);
+    oc_core_set_device_hostname(0, hostname);
+  }
+#endif
+#ifdef WIN32
+  char hostname_str[50];
+  int error = gethostname(hostname_str, 50);
+  if (error == 0) {
+    printf("Hostname (win32):    %s\n", hostname_str);
+    oc_core_set_device_hostname(0, hostname_str);
+  }
+#endif
+
+  
+  for (size_t d = 0; d < (size_t)g_num_devices; d++) {
+    /* set the hardware version 0.4.0 */
+    oc_core_set_device_hwv(d, 0, 4, 0);
+  
+  
+    /* set the firmware version 0.4.0 */
+    oc_core_set_device_fwv(d, 0, 4, 0);
+  
+  
+    /* manufacturer id */
+    oc_core_set_device_mid(d, 0x00FA);
+    /* set the hardware type*/
+    oc_core_set_device_hwt(d, "000000000000");
+    /* set the model */
+    oc_core_set_device_model(d, g_app_info.model);
+  }
+
+  oc_set_s_mode_response_cb(oc_add_s_mode_response_cb);
+#ifdef OC_SPAKE
+  if (strlen(oc_spake_get_password()) == 0)
+    oc_spake_set_password(g_app_info.password);
+
+
+  strncpy(serial_number_uppercase, oc_string(device->serialnumber), 19);
+  app_str_to_upper(serial_number_uppercase);
+  printf("\n === QR Code: KNX:S:%s;P:%s ===\n", serial_number_uppercase, oc_spake_get_password());
+#endif
+
+  initialize_variables();
+#if APP_MAX_DEVICES > 1
+  instances_load_values();
+#endif
+  if (g_app_info.init) {
+    /* application specific initialization, e.g. the screen */
+    g_app_info.init();
+  }
+
+  return ret;
+}
+
+/**
+ * @brief returns the password
+ */
+const char* app_get_password()
+{
+#ifdef OC_SPAKE
+  return oc_spake_get_password();
+#else
+  return g_app_info.password;
+#endif
+}
+
+
+bool request_query_get_int(oc_request_t *request, const char *query, int *out)
+{
+  char *query_str;
+  
+  int query_len = oc_get_query_value(request, query, &query_str);
+  if(query_len <= 0) {
+    return false;
+  }
+  char buf[16];
+  strncpy(buf, query_str, query_len);
+  *out = atoi(buf);
+  return true;
+}
+
+// ===== Table index =====
+// summary of the KNX tables: the first group object table entry and the
+// number of entries of each data point, and the number of used entries of
+// each table. Rebuilt when the tables are loaded (lsm_change_cb) or reset,
+// so lookups and the table screens do not scan the tables.
+
+static app_table_summary_t g_table_summary;
+static bool g_table_index_valid;
+
+/* binds the data points written by s-mode to the fast path, see smode_receive */
+static void smode_rx_bind(void)
+{
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    datapoint_state_t *state = &g_datapoint_state[i];
+    const datapoint_t *dp = get_datapoint_by_index((int)i);
+    state->smode_bound = false;
+    state->smode_codec = dpt_codec(dp->type);
+    state->smode_feedback = NULL;
+#if APP_SMODE_FAST_PATH
+    /* scalars held in a global variable only, arrays need pn/ps */
+    if (state->got_count == 0 || state->smode_codec == NULL ||
+        dp->num_elements != 0 || dp->g_var == NULL)
+      continue;
+    const datapoint_t *feedback = get_datapoint_by_url(dp->feedback_url);
+    if (feedback && feedback->type == dp->type && feedback->num_elements == 0) {
+      if (feedback->g_var == NULL)
+        continue;
+      state->smode_feedback = feedback;
+    }
+    state->smode_bound = true;
+#endif
+  }
+}
+
+static void table_index_rebuild(void)
+{
+  app_table_summary_t *summary = &g_table_summary;
+  memset(summary, 0, sizeof(*summary));
+  for (size_t i = 0; i < NUM_DP_STATE; i++) {
+    g_datapoint_state[i].got_first = -1;
+    g_datapoint_state[i].got_count = 0;
+  }
+
+  int size = oc_core_get_group_object_table_total_size();
+  for (int i = 0; i < size; i++) {
+    oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(i);
+    if (entry == NULL || oc_string_len(entry->href) == 0)
+      continue;
+    summary->got_entries++;
+    int index = get_datapoint_index(get_datapoint_by_url(oc_string(entry->href)));
+    if (index < 0) {
+      summary->got_other_entries++;
+      continue;
+    }
+    if (g_datapoint_state[index].got_first < 0)
+      g_datapoint_state[index].got_first = (int16_t)i;
+    if (g_datapoint_state[index].got_count < UINT8_MAX)
+      g_datapoint_state[index].got_count++;
+  }
+  smode_rx_bind();
+  size = oc_core_get_recipient_table_size();
+  for (int i = 0; i < size; i++) {
+    oc_group_rp_table_t *entry = oc_core_get_recipient_table_entry(i);
+    if (entry && entry->id > -1)
+      summary->recipient_entries++;
+  }
+  size = oc_core_get_publisher_table_size();
+  for (int i = 0; i < size; i++) {
+    oc_group_rp_table_t *entry = oc_core_get_publisher_table_entry(i);
+    if (entry && entry->id > -1)
+      summary->publisher_entries++;
+  }
+  size = oc_core_get_at_table_size();
+  for (int i = 0; i < size; i++) {
+    oc_auth_at_t *entry = oc_get_auth_at_entry(0, i);
+    if (entry && oc_string_len(entry->id) != 0)
+      summary->auth_entries++;
+  }
+  summary->generation = g_table_generation;
+  g_table_index_valid = true;
+}
+
+static void table_index_refresh(void)
+{
+  if (!g_table_index_valid || g_table_summary.generation != g_table_generation) {
+    table_index_rebuild();
+  }
+}
+
+const app_table_summary_t *app_get_table_summary(void)
+{
+  table_index_refresh();
+  return &g_table_summary;
+}
+
+int app_get_got_index(const char *url)
+{
+  table_index_refresh();
+  int index = get_datapoint_index(get_datapoint_by_url(url));
+  if (index < 0) {
+    /* not a data point of this device, only scanned if the table has such entries */
+    return g_table_summary.got_other_entries ? oc_core_find_group_object_table_url(url) : -1;
+  }
+  if (g_datapoint_state[index].got_first < 0) {
+    return -1;
+  }
+  oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(g_datapoint_state[index].got_first);
+  if (entry == NULL || oc_string_len(entry->href) == 0 || strcmp(oc_string(entry->href), url) != 0) {
+    /* the table is changed while loading, before the next lsm change */
+    table_index_rebuild();
+    return g_datapoint_state[index].got_first;
+  }
+  return g_datapoint_state[index].got_first;
+}
+
+int app_get_got_count(const char *url)
+{
+  table_index_refresh();
+  int index = get_datapoint_index(get_datapoint_by_url(url));
+  return index < 0 ? 0 : g_datapoint_state[index].got_count;
+}
+
+// ===== Metadata =====
+// the m= query of get_generic is parsed into a bit mask of the requested
+// fields. The fields that do not change at run time are prepared once per
+// data point, the group object table entry comes from the table index.
+
+#define MD_VALUE (1u << 0)
+#define MD_ID (1u << 1)
+#define MD_HREF (1u << 2)
+#define MD_RT (1u << 3)
+#define MD_IF (1u << 4)
+#define MD_DPT (1u << 5)
+#define MD_GA (1u << 6)
+#define MD_EXTRA (1u << 7) /* first entry of the data point metadata array */
+#define MD_ALL 0xFFFFFFFFu
+
+static uint32_t metadata_field(const datapoint_t *dp, const char *m, size_t m_len)
+{
+  switch (m_len) {
+  case 1:
+    if (m[0] == '*')
+      return MD_ALL;
+    break;
+  case 2:
+    if (memcmp(m, "id", 2) == 0)
+      return MD_ID;
+    if (memcmp(m, "rt", 2) == 0)
+      return MD_RT;
+    if (memcmp(m, "if", 2) == 0)
+      return MD_IF;
+    if (memcmp(m, "ga", 2) == 0)
+      return MD_GA;
+    break;
+  case 3:
+    if (memcmp(m, "dpt", 3) == 0)
+      return MD_DPT;
+    break;
+  case 4:
+    if (memcmp(m, "href", 4) == 0)
+      return MD_HREF;
+    break;
+  case 5:
+    if (memcmp(m, "value", 5) == 0)
+      return MD_VALUE;
+    break;
+  }
+  uint32_t bit = MD_EXTRA;
+  for (const char *const *md = get_datapoint_metadata(dp); md && *md && bit; md += 2, bit <<= 1) {
+    if (strlen(md[0]) == m_len && memcmp(m, md[0], m_len) == 0)
+      return bit;
+  }
+  return 0;
+}
+
+static void metadata_prepare(app_metadata_cache_t *cache, const datapoint_t *dp,
+                             const oc_device_info_t *device)
+{
+  snprintf(cache->id, sizeof(cache->id), "knx://sn.%s%s",
+           oc_string(device->serialnumber), get_datapoint_url(dp));
+  const char *dpa = get_datapoint_dpa(dp);
+  cache->rt = dpa ? &dpa[7] : NULL;
+  const char *full_dpt = oc_string(dp->resource.dpt);
+  cache->dpt = full_dpt ? &full_dpt[7] : NULL;
+  cache->num_ifs = 0;
+  for (int i = 1; i <= (1<<OC_MAX_IF_MASKS); i <<=1)
+    if (dp->resource.interfaces&i)
+      cache->ifs[cache->num_ifs++] = get_interface_string(dp->resource.interfaces&i);
+  cache->valid = true;
+}
+
+/* the prepared metadata of device 0 is cached, other devices use scratch */
+static app_metadata_cache_t *metadata_of(const datapoint_t *dp, size_t device_index,
+                                     app_metadata_cache_t *scratch)
+{
+  oc_device_info_t *device = oc_core_get_device_info(device_index);
+  int index = get_datapoint_index(dp);
+  if (device == NULL) {
+    return NULL;
+  }
+  if (device_index != 0 || index < 0) {
+    metadata_prepare(scratch, dp, device);
+    return scratch;
+  }
+  app_metadata_cache_t *cache = &g_datapoint_state[index].metadata;
+  if (!cache->valid) {
+    metadata_prepare(cache, dp, device);
+  }
+  return cache;
+}
+
+static bool metadata_encode(const datapoint_t *dp, app_metadata_cache_t *cache, uint32_t fields,
+                            int pn, int ps)
+{
+  if (fields & MD_VALUE) {
+    if (oc_encode_datapoint(dp, pn, ps, true) == false)
+      return false;
+  }
+  if (fields & MD_ID) {
+    oc_rep_i_set_text_string(root, 0, cache->id);
+  }
+  if (fields & MD_HREF) {
+    // Valid and mandatory metadata, but "can be omitted in response"
+    oc_rep_set_text_string(root, href, get_datapoint_url(dp));
+  }
+  if ((fields & MD_RT) && cache->rt) {
+    oc_rep_set_text_string(root, rt, cache->rt);
+  }
+  if (fields & MD_IF) {
+    oc_rep_set_key(oc_rep_object(root), "if");
+    oc_rep_begin_array(oc_rep_object(root), if);
+    for (int i = 0; i < cache->num_ifs; i++)
+      oc_rep_add_text_string(if, cache->ifs[i]);
+    oc_rep_end_array(oc_rep_object(root), if);
+  }
+  if ((fields & MD_DPT) && cache->dpt) {
+    oc_rep_set_text_string(root, dpt, cache->dpt);
+  }
+  if (fields & MD_GA) {
+    int index = app_get_got_index(get_datapoint_url(dp));
+    oc_group_object_table_t *got_table_entry =
+      index > -1 ? oc_core_get_group_object_table_entry(index) : NULL;
+    if (got_table_entry) {
+      oc_rep_set_int_array(root, ga, got_table_entry->ga, got_table_entry->ga_len);
+    }
+  }
+  uint32_t bit = MD_EXTRA;
+  for (const char *const *md = get_datapoint_metadata(dp); md && *md && bit; md += 2, bit <<= 1) {
+    if (fields & bit) {
+      oc_rep_set_text_string_no_tag(root, md[0]);
+      oc_rep_set_text_string_no_tag(root, md[1]);
+    }
+  }
+  return true;
+}
+
+void
+get_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
+{
+  
+  const datapoint_t *dp = user_data; 
+
+  bool error_state = false; /* the error state, the generated code */
+
+  if (dp == NULL) {
+    dp = get_datapoint_by_url(request->uri_path);
+    if (dp == NULL) {
+      APP_LOG_ERR("Error dp is NULL\n");
+      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
+      return;
+    }
+  }
+
+  APP_LOG_DBG("-- Begin get_generic  (%s) \n", get_datapoint_name(dp));
+  METRICS_START(t_start);
+
+  /* MANUFACTORER: SENSOR add here the code to talk to the HW if one implements a
+     sensor. the call to the HW needs to fill in the global variable before it
+     returns to this function here. alternative is to have a callback from the
+     hardware that sets the global variables.
+  */
+
+  /* check if the accept header is CBOR */
+  if (oc_check_accept_header(request, APPLICATION_CBOR) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
+    return;
+  }
+
+  // check the query parameter m with the various values
+  char *m;
+  char* m_key;
+  size_t m_key_len;
+  size_t m_len = (int)oc_get_query_value(request, "m", &m);
+  int pn, ps;
+  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
+  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
+  if (m_len != -1) {
+    APP_LOG_DBG("  Query param: %.*s\n",(int)m_len, m);
+    app_metadata_cache_t scratch;
+    app_metadata_cache_t *cache = metadata_of(dp, request->resource->device, &scratch);
+    if (cache != NULL) {
+      uint32_t fields = 0;
+      oc_init_query_iterator();
+      while (oc_iterate_query(request, &m_key, &m_key_len, &m, &m_len) != -1) {
+        if (m_key_len == 1 && m_key[0] == 'm') {
+          fields |= metadata_field(dp, m, m_len);
+        }
+      }
+      if (fields == 0) {
+        oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+        error_state = true;
+        goto done;
+      }
+      oc_rep_begin_root_object();
+      if (metadata_encode(dp, cache, fields, pn, ps) == false) {
+        oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
+        error_state = true;
+        goto done;
+      }
+      oc_rep_end_root_object();
+    } else {
+      /* device is NULL */
+      oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
+      error_state = true;
+      goto done;
+    }
+    oc_send_cbor_response(request, OC_STATUS_OK);
+    goto done;
+  }
+  if (oc_encode_datapoint(dp, pn, ps, false) == false) {
+    oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
+    error_state = true;
+    goto done;
+  }
+  if (g_err) {
+    error_state = true;
+  }
+  APP_LOG_DBG("CBOR encoder size %d\n", oc_rep_get_encoded_payload_size());
+  FOOTPRINT_PAYLOAD(oc_rep_get_encoded_payload_size());
+  if (error_state == false) {
+    oc_send_cbor_response(request, OC_STATUS_OK);
+  } else {
+    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
+  }
+done:
+  METRICS_REQUEST(dp, false, t_start, error_state);
+  APP_TRACE(APP_TRACE_GET, get_datapoint_index(dp), error_state);
+  APP_LOG_DBG("-- End get_generic (%s)\n", get_datapoint_url(dp));
+}
+
+// ===== S-mode receive =====
+// redirected s-mode writes of bound data points (see smode_rx_bind) skip the
+// generic PUT handler: the stack resolved the group address to the resource,
+// the resource carries the data point, the binding holds the codec and the
+// feedback. Storing and notifying are deferred by the schedulers.
+
+static app_smode_rx_stats_t g_smode_rx_stats;
+
+/* datapoint_set of a bound data point: no url lookup, no element range */
+static void smode_rx_set(const datapoint_t *dp, const void *in)
+{
+  size_t size = get_dpt_size(dp->type);
+  if (memcmp(dp->g_var, in, size) == 0)
+    return;
+  memcpy(dp->g_var, in, size);
+  datapoint_mark_changed(dp);
+  if (dp->persistent)
+    app_persist_mark_dirty(dp);
+  app_observe_notify(dp);
+#ifdef MQTT_PROXY
+  app_mqtt_publish(dp);
+#endif
+}
+
+static void smode_receive(oc_request_t *request, const datapoint_t *dp, int index)
+{
+  METRICS_START(t_start);
+  const datapoint_state_t *state = &g_datapoint_state[index];
+  oc_rep_t *rep = request->request_payload;
+  uint8_t *new_value = g_dp_scratch.put;
+  bool error_state = true;
+
+  while (rep != NULL && rep->iname != 1) {
+    rep = rep->next;
+  }
+  if (rep != NULL)
+    error_state = !dpt_parse_value(state->smode_codec, rep, new_value);
+  if (error_state) {
+    g_smode_rx_stats.rejected++;
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+  } else {
+    g_smode_rx_stats.fast++;
+    oc_send_response_no_format(request, OC_STATUS_CHANGED);
+    smode_rx_set(dp, new_value);
+    if (state->smode_feedback) {
+      smode_rx_set(state->smode_feedback, new_value);
+      app_smode_send(5, dp->feedback_url, "w");
+    }
+    do_put_cb(get_datapoint_url(dp));
+  }
+  METRICS_LATENCY(smode_fast, t_start);
+  METRICS_REQUEST(dp, true, t_start, error_state);
+  APP_TRACE(APP_TRACE_PUT, index, error_state);
+}
+
+const app_smode_rx_stats_t *app_smode_get_rx_stats(void)
+{
+  return &g_smode_rx_stats;
+}
+
+
+void
+put_generic(oc_request_t *request, oc_interface_mask_t interfaces,
+                void *user_data)
+{
+  (void)interfaces;
+  const datapoint_t *dp = user_data;
+  bool error_state = true;
+
+  if (dp == NULL) {
+    dp = get_datapoint_by_url(request->uri_path);
+    if (dp == NULL) {
+      APP_LOG_ERR("Error dp is NULL\n");
+      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
+      return;
+    }
+  }
+
+  /* handle the different requests e.g. via s-mode or normal CoAP call*/
+  bool redirected = oc_is_redirected_request(request);
+#if APP_SMODE_FAST_PATH
+  if (redirected) {
+    int index = get_datapoint_index(dp);
+    table_index_refresh();
+    if (index >= 0 && g_datapoint_state[index].smode_bound) {
+      smode_receive(request, dp, index);
+      return;
+    }
+  }
+#endif
+
+  APP_LOG_DBG("-- Begin put_generic (%s):\n", get_datapoint_url(dp));
+  METRICS_START(t_start);
+
+  oc_rep_t *rep = NULL;
+  int pn, ps;
+  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
+  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
+  if (redirected) {
+    APP_LOG_DBG("  redirected request..\n");
+    g_smode_rx_stats.slow++;
+  }
+  rep = request->request_payload;
+  FOOTPRINT_REP(rep);
+  /* loop over all the entries in the request */
+  /* handle the type of payload correctly. */
+  void *new_value = g_dp_scratch.put;
+  if (ps < 1 || get_dpt_size(dp->type) * ps > g_dp_scratch.size) {
+    APP_LOG_WARN("  ps out of range: %d\n", ps);
+    error_state = true;
+  } else {
+    METRICS_PEAK(scratch_peak_bytes, get_dpt_size(dp->type) * ps);
+    error_state = !oc_parse_datapoint(dp, rep, new_value, ps);
+  }
+
+  if (error_state == false){
+    /* the observers are notified by datapoint_set, after the value is applied */
+    oc_send_response_no_format(request, OC_STATUS_CHANGED);
+    datapoint_set(dp, new_value, pn*ps, ps);
+    if (dp->feedback_url) {
+      //check types match
+      const datapoint_t *feedback = datapoint_in_device_of(dp, dp->feedback_url);
+      if (feedback != NULL && feedback->type == dp->type && feedback->num_elements == dp->num_elements) {
+        datapoint_set(feedback, new_value, pn*ps, ps);
+        APP_LOG_DBG("  Queue status to '%s' with flag: 'w'\n", get_datapoint_url(feedback));
+        /* the s-mode messages are sent for device 0 only */
+        if (get_datapoint_index(feedback) >= 0)
+          app_smode_send(5, dp->feedback_url, "w");
+      }
+    }
+
+    do_put_cb(get_datapoint_url(dp));
+  } else {
+    /* request data was not recognized, so it was a bad request */
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+  }
+  if (redirected) {
+    METRICS_LATENCY(smode_slow, t_start);
+  }
+  METRICS_REQUEST(dp, true, t_start, error_state);
+  APP_TRACE(APP_TRACE_PUT, get_datapoint_index(dp), error_state);
+  APP_LOG_DBG("-- End put_generic (%s)\n", get_datapoint_url(dp));
+}
+
+
+#if APP_METRICS
+const app_footprint_t *app_footprint_get(void)
+{
+  size_t bytes = NUM_DP_STATE * (sizeof(datapoint_t) + sizeof(datapoint_state_t));
+  bytes += 2 * g_dp_scratch.size;
+  bytes += sizeof(g_event_ring) + sizeof(g_smode_outbox);
+  bytes += sizeof(g_metrics) + sizeof(g_footprint);
+#ifdef MQTT_PROXY
+  bytes += sizeof(g_mqtt_queue);
+#endif
+  g_footprint.static_bytes = (uint32_t)bytes;
+  footprint_heap();
+  return &g_footprint;
+}
+
+int app_metrics_to_text(char *buf, size_t size)
+{
+  const app_latency_t *l;
+  int len = 0;
+  if (buf == NULL || size == 0)
+    return 0;
+  buf[0] = 0;
+#define METRICS_APPEND(...) \
+  do { \
+    if (len < (int)size) { \
+      int r = snprintf(&buf[len], size - len, __VA_ARGS__); \
+      if (r > 0) \
+        len += r; \
+    } \
+  } while (0)
+  l = &g_metrics.encode;
+  METRICS_APPEND("encode: n=%u min=%u max=%u avg=%u us\n", l->count, l->min_us, l->max_us, l->ewma_us);
+  l = &g_metrics.store;
+  METRICS_APPEND("store : n=%u min=%u max=%u avg=%u us\n", l->count, l->min_us, l->max_us, l->ewma_us);
+  l = &g_metrics.load;
+  METRICS_APPEND("load  : n=%u min=%u max=%u avg=%u us\n", l->count, l->min_us, l->max_us, l->ewma_us);
+  l = &g_metrics.smode_fast;
+  METRICS_APPEND("s-mode rx fast: n=%u min=%u max=%u avg=%u us, rejected=%u\n",
+    l->count, l->min_us, l->max_us, l->ewma_us, g_smode_rx_stats.rejected);
+  l = &g_metrics.smode_slow;
+  METRICS_APPEND("s-mode rx slow: n=%u min=%u max=%u avg=%u us\n", l->count, l->min_us, l->max_us, l->ewma_us);
+  METRICS_APPEND("storage writes=%u reads=%u\n", g_metrics.storage_writes, g_metrics.storage_reads);
+  METRICS_APPEND("scratch peak=%u bytes, malloc n=%u peak=%u bytes\n",
+    g_metrics.scratch_peak_bytes, g_metrics.malloc_count, g_metrics.malloc_peak_bytes);
+  METRICS_APPEND("s-mode queued=%u sent=%u dedup=%u overflow=%u dropped=%u depth=%d max=%u\n",
+    g_smode_stats.requested, g_smode_stats.sent, g_smode_stats.deduplicated,
+    g_smode_stats.overflows, g_smode_stats.dropped, g_smode_depth, g_smode_stats.max_depth);
+  METRICS_APPEND("observe requested=%u sent=%u coalesced=%u\n",
+    g_observe_stats.requested, g_observe_stats.sent, g_observe_stats.coalesced);
+  METRICS_APPEND("events posted=%u processed=%u dropped=%u wakeups=%u max=%u\n",
+    g_event_stats.posted, g_event_stats.processed, g_event_stats.dropped,
+    g_event_stats.wakeups, g_event_stats.max_depth);
+#ifdef MQTT_PROXY
+  METRICS_APPEND("mqtt %s published=%u rate=%u/s coalesced=%u busy=%u dropped=%u depth=%d max=%u reconnects=%u\n",
+    g_mqtt_connected ? "connected" : "disconnected", g_mqtt_stats.published, g_mqtt_stats.rate,
+    g_mqtt_stats.coalesced, g_mqtt_stats.busy, g_mqtt_stats.dropped, g_mqtt_depth,
+    g_mqtt_stats.max_depth, g_mqtt_stats.reconnects);
+#endif
+  const app_footprint_t *fp = app_footprint_get();
+  METRICS_APPEND("footprint static=%u heap used=%u peak=%u stack peak=%u payload peak=%u/%u rep peak=%u\n",
+    fp->static_bytes, fp->heap_used_bytes, fp->heap_peak_bytes, fp->stack_peak_bytes,
+    fp->payload_peak_bytes, (unsigned)APP_MAX_APP_DATA_SIZE, fp->rep_peak_objects);
+  const app_swu_status_t *swu = app_swu_get_status();
+  if (swu->binary_size)
+    METRICS_APPEND("swu %s: %u/%u bytes, resumed at %u, %u B/s, stalls=%u errors=%u\n",
+      swu->active ? "active" : "idle", swu->written, swu->binary_size,
+      swu->resumed_from, swu->bytes_per_s, swu->stalls, swu->errors);
+  for (int i = 0; i < (int)NUM_DP_STATE; i++) {
+    const app_dp_metrics_t *m = &g_datapoint_state[i].metrics;
+    if (m->get.count == 0 && m->put.count == 0)
+      continue;
+    METRICS_APPEND("%s: get n=%u avg=%u max=%u, put n=%u avg=%u max=%u, err=%u\n",
+      get_datapoint_url(get_datapoint_by_index(i)),
+      m->get.count, m->get.ewma_us, m->get.max_us,
+      m->put.count, m->put.ewma_us, m->put.max_us, m->errors);
+  }
+#undef METRICS_APPEND
+  return len;
+}
+
+static void
+get_diag(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
+{
+  (void)interfaces;
+  (void)user_data;
+  int pn, ps;
+  const int count = (int)NUM_DP_STATE;
+
+  if (oc_check_accept_header(request, APPLICATION_CBOR) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
+    return;
+  }
+  /* page through the data points, to limit the size of the response */
+  if (!request_query_get_int(request, "pn", &pn) || pn < 0) pn = 0;
+  if (!request_query_get_int(request, "ps", &ps) || ps < 1) ps = 8;
+
+  oc_rep_begin_root_object();
+  oc_rep_set_int(root, encn, g_metrics.encode.count);
+  oc_rep_set_int(root, encavg, g_metrics.encode.ewma_us);
+  oc_rep_set_int(root, encmax, g_metrics.encode.max_us);
+  oc_rep_set_int(root, stavg, g_metrics.store.ewma_us);
+  oc_rep_set_int(root, stmax, g_metrics.store.max_us);
+  oc_rep_set_int(root, ldavg, g_metrics.load.ewma_us);
+  oc_rep_set_int(root, ldmax, g_metrics.load.max_us);
+  oc_rep_set_int(root, smsent, g_smode_stats.sent);
+  oc_rep_set_int(root, smdedup, g_smode_stats.deduplicated);
+  oc_rep_set_int(root, smdrop, g_smode_stats.dropped + g_smode_stats.overflows);
+  oc_rep_set_int(root, smdepth, g_smode_depth);
+  oc_rep_set_int(root, smfast, g_smode_rx_stats.fast);
+  oc_rep_set_int(root, smslow, g_smode_rx_stats.slow);
+  oc_rep_set_int(root, smfavg, g_metrics.smode_fast.ewma_us);
+  oc_rep_set_int(root, smsavg, g_metrics.smode_slow.ewma_us);
+  oc_rep_set_int(root, obsent, g_observe_stats.sent);
+  oc_rep_set_int(root, obcoal, g_observe_stats.coalesced);
+  oc_rep_set_int(root, evdrop, g_event_stats.dropped);
+  app_footprint_get();
+  oc_rep_set_int(root, heap, g_footprint.heap_used_bytes);
+  oc_rep_set_int(root, heapmax, g_footprint.heap_peak_bytes);
+  oc_rep_set_int(root, stkmax, g_footprint.stack_peak_bytes);
+  oc_rep_set_int(root, plmax, g_footprint.payload_peak_bytes);
+  oc_rep_set_int(root, repmax, g_footprint.rep_peak_objects);
+#ifdef MQTT_PROXY
+  oc_rep_set_int(root, mqrate, g_mqtt_stats.rate);
+  oc_rep_set_int(root, mqdepth, g_mqtt_depth);
+  oc_rep_set_int(root, mqdrop, g_mqtt_stats.dropped);
+#endif
+  oc_rep_set_int(root, wr, g_metrics.storage_writes);
+  oc_rep_set_int(root, rd, g_metrics.storage_reads);
+  oc_rep_set_int(root, scratch, g_metrics.scratch_peak_bytes);
+  oc_rep_set_int(root, mallocn, g_metrics.malloc_count);
+  oc_rep_set_int(root, mallocmax, g_metrics.malloc_peak_bytes);
+  oc_rep_set_array(root, dp);
+  for (int i = pn * ps; i < count && i < (pn + 1) * ps; i++) {
+    const app_dp_metrics_t *m = &g_datapoint_state[i].metrics;
+    oc_rep_object_array_begin_item(dp);
+    oc_rep_set_text_string(dp, href, get_datapoint_url(get_datapoint_by_index(i)));
+    oc_rep_set_int(dp, getn, m->get.count);
+    oc_rep_set_int(dp, getavg, m->get.ewma_us);
+    oc_rep_set_int(dp, getmax, m->get.max_us);
+    oc_rep_set_int(dp, putn, m->put.count);
+    oc_rep_set_int(dp, putavg, m->put.ewma_us);
+    oc_rep_set_int(dp, putmax, m->put.max_us);
+    oc_rep_set_int(dp, err, m->errors);
+    oc_rep_object_array_end_item(dp);
+  }
+  oc_rep_close_array(root, dp);
+  oc_rep_end_root_object();
+  oc_send_cbor_response(request, OC_STATUS_OK);
+}
+
+/**
+ * @brief registers the read-only diagnostic resource
+ */
+static void
+register_diag_resource(void)
+{
+  oc_resource_t *res = oc_new_resource("diag", URL_DIAG, 1, THIS_DEVICE);
+  oc_resource_bind_resource_type(res, "urn:knx:diag");
+  oc_resource_bind_content_type(res, APPLICATION_CBOR);
+  oc_resource_bind_resource_interface(res, OC_IF_D);
+  oc_resource_set_discoverable(res, false);
+  oc_resource_set_request_handler(res, OC_GET, get_diag, NULL);
+  oc_add_resource(res);
+}
+#endif /* APP_METRICS */
+
+#ifdef SLEEPY
+// ===== Poll policy parameter =====
+// the policy of the adaptive poll engine of the sleepy main, as a parameter
+
+static void
+get_poll_policy(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
+{
+  (void)interfaces;
+  (void)user_data;
+  const main_poll_policy_t *policy = main_GetPollPolicy();
+
+  if (oc_check_accept_header(request, APPLICATION_CBOR) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
+    return;
+  }
+  oc_rep_begin_root_object();
+  oc_rep_i_set_int(root, 1, policy->fast_poll_ms);
+  oc_rep_i_set_int(root, 2, policy->max_poll_ms);
+  oc_rep_i_set_int(root, 3, policy->active_ms);
+  oc_rep_i_set_int(root, 4, policy->backoff);
+  oc_rep_end_root_object();
+  oc_send_cbor_response(request, OC_STATUS_OK);
+}
+
+static void
+put_poll_policy(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
+{
+  (void)interfaces;
+  (void)user_data;
+  main_poll_policy_t policy = *main_GetPollPolicy();
+  bool error_state = false;
+
+  for (oc_rep_t *rep = request->request_payload; rep != NULL; rep = rep->next) {
+    if (rep->type != OC_REP_INT || rep->value.integer < 0) {
+      error_state = true;
+      break;
+    }
+    switch (rep->iname) {
+    case 1: policy.fast_poll_ms = (uint32_t)rep->value.integer; break;
+    case 2: policy.max_poll_ms = (uint32_t)rep->value.integer; break;
+    case 3: policy.active_ms = (uint32_t)rep->value.integer; break;
+    case 4:
+      error_state = rep->value.integer > UINT8_MAX;
+      policy.backoff = (uint8_t)rep->value.integer;
+      break;
+    default: error_state = true; break;
+    }
+  }
+  /* main_SetPollPolicy validates and stores the policy */
+  if (error_state || !main_SetPollPolicy(&policy)) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
+  oc_send_response_no_format(request, OC_STATUS_CHANGED);
+}
+
+/**
+ * @brief registers the poll policy parameter
+ */
+static void
+register_poll_policy_resource(void)
+{
+  oc_resource_t *res = oc_new_resource("poll", URL_POLL_POLICY, 1, THIS_DEVICE);
+  oc_resource_bind_resource_type(res, "urn:knx:poll");
+  oc_resource_bind_content_type(res, APPLICATION_CBOR);
+  oc_resource_bind_resource_interface(res, OC_IF_D | OC_IF_P);
+  oc_resource_set_discoverable(res, false);
+  oc_resource_set_request_handler(res, OC_GET, get_poll_policy, NULL);
+  oc_resource_set_request_handler(res, OC_PUT, put_poll_policy, NULL);
+  oc_add_resource(res);
+}
+#endif /* SLEEPY */
+
+/**
+ * @brief register all the data point resources to the stack
+ * this function registers all data point level resources:
+ * - each resource path is bind to a specific function for the supported methods
+ *  (GET, PUT)
+ * - each resource is
+ *   - secure
+ *   - observable
+ *   - discoverable through well-known/core
+ *   - used interfaces as: dpa.xxx.yyy
+ *      - xxx : function block number
+ *      - yyy : data point function number
+ */
+void
+register_resources(void)
+{
+  const datapoint_t *it;
+  const char *_t[2] = {
+    "Datapoint",
+    "Parameter"
+  };
+  const char **t = _t;
+  APP_LOG_DBG("Adding const resource block\n");
+  const datapoint_t *dp = &g_datapoints[0];
+
+  oc_ri_add_resource_block(&g_datapoints[0].resource); 
+#if APP_MAX_DEVICES > 1
+  instances_register_resources();
+#endif
+#if APP_METRICS
+  register_diag_resource();
+#endif
+#ifdef SLEEPY
+  register_poll_policy_resource();
+#endif
+}
+
+#ifdef MQTT_PROXY
+void
+configure_mqtt_from_parameters() {
+  strncpy(g_mqttconf_server, gMQTT_hostname0, sizeof(g_mqttconf_server));
+  g_mqttconf_port = gMQTT_port_number0;
+  strncpy(g_mqttconf_username, gMQTT_username0, sizeof(g_mqttconf_username));
+  strncpy(g_mqttconf_pwd, gMQTT_password0, sizeof(g_mqttconf_pwd));
+  strncpy(g_iid_name, gIID_name0, sizeof(g_iid_name));
+  APP_LOG_INFO("MQTT configuration:\n");
+  APP_LOG_INFO(" hostname: %s\n", g_mqttconf_server);
+  APP_LOG_INFO(" port    : %d\n", g_mqttconf_port);
+  APP_LOG_INFO(" username: %s\n", g_mqttconf_username);
+  APP_LOG_INFO(" password: %s\n", g_mqttconf_pwd);
+  APP_LOG_INFO(" IID name: %s\n", g_iid_name);
+}
+#endif
+
+/**
+ * @brief callback when a/lsm state changes
+ * @param device_index the device identifier of the list of devices
+ * @param current_state current state (i.e. after the change)
+ * @param data the supplied data.
+ */
+void
+lsm_change_cb(size_t device_index, oc_lsm_state_t current_state, void *data)
+{
+  (void)device_index;
+  (void)data;
+  /* the tables are (re)loaded */
+  g_table_generation++;
+  if (current_state == LSM_S_LOADED) {
+    table_index_rebuild();
+  }
+}
+
+/**
+ * @brief initiate preset for device
+ * current implementation: device reset as command line argument
+ * @param device_index the device identifier of the list of devices
+ * @param data the supplied data.
+ */
+void
+factory_presets_cb(size_t device_index, void *data)
+{
+  (void)device_index;
+  (void)data;
+  reset_variables();
+}
+
+/**
+ * @brief set the host name on the device (application depended)
+ *
+ * @param device_index the device identifier of the list of devices
+ * @param host_name the host name to be set on the device
+ * @param data the supplied data.
+ */
+void
+hostname_cb(size_t device_index, oc_string_t host_name, void *data)
+{
+  (void)device_index;
+  (void)data;
+
+  APP_LOG_INFO("-----host name ------- %s\n", oc_string(host_name));
+}
+
+static oc_event_callback_retval_t send_delayed_response(void *context)
+{
+  oc_separate_response_t *response = (oc_separate_response_t *)context;
+
+  if (response->active)
+  {
+    oc_set_separate_response_buffer(response);
+    oc_send_separate_response(response, OC_STATUS_CHANGED);
+    APP_LOG_DBG("Delayed response sent\n");
+  }
+  else
+  {
+    APP_LOG_WARN("Delayed response NOT active\n");
+  }
+
+  return OC_EVENT_DONE;
+}
+
+// ===== Software update =====
+// with APP_SWU_PIPELINE the blocks are double buffered, hashed and written
+// from a delayed callback, the written offset is stored to resume an
+// interrupted transfer. Without, only the status and throughput are kept.
+
+static app_swu_status_t g_swu_status;
+static oc_clock_time_t g_swu_start;
+
+static void swu_finish(void);
+static oc_event_callback_retval_t swu_idle_cb(void *data);
+
+#if APP_SWU_PIPELINE
+#define SWU_RESUME_STORE_NAME "swu_resume"
+#define SWU_HASH_INIT 2166136261u
+
+typedef struct swu_buffer_t
+{
+  uint32_t offset;
+  uint32_t hash; /* hash of the image up to the end of this block */
+  uint16_t len;
+  bool full;
+  uint8_t data[APP_SWU_BUFFER_SIZE];
+} swu_buffer_t;
+
+/* stored while receiving: the image [0, offset) is in place */
+typedef struct swu_resume_t
+{
+  uint32_t binary_size;
+  uint32_t offset;
+  uint32_t hash;       /* hash of [0, offset) */
+  uint32_t first_hash; /* hash of the first block, identifies the image */
+} swu_resume_t;
+
+static swu_buffer_t g_swu_buffers[2];
+static uint8_t g_swu_next_write = 0;
+static bool g_swu_write_scheduled = false;
+static swu_resume_t g_swu_resume;
+static uint32_t g_swu_first_hash = 0;
+static uint32_t g_swu_written_hash = SWU_HASH_INIT;
+static uint32_t g_swu_persisted = 0;
+#if defined WIN32 || defined __linux__
+static bool swu_file_write(size_t offset, const uint8_t *data, size_t len);
+static app_swu_write_cb_t g_swu_writer = swu_file_write;
+#else
+static app_swu_write_cb_t g_swu_writer = NULL;
+#endif
+
+static oc_event_callback_retval_t swu_write_cb(void *data);
+
+static uint32_t swu_hash(uint32_t hash, const uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void swu_store_resume(uint32_t offset, uint32_t hash)
+{
+  swu_resume_t resume = { g_swu_status.binary_size, offset, hash,
+                          g_swu_first_hash };
+  long ret = oc_storage_write(SWU_RESUME_STORE_NAME, (uint8_t *)&resume,
+                              sizeof(resume));
+  METRICS_COUNT(storage_writes);
+  if (ret < 0) {
+    APP_LOG_ERR("swu: oc_storage_write failed with error: %ld\n", -ret);
+    return;
+  }
+  g_swu_persisted = offset;
+}
+
+static void swu_clear_resume(void)
+{
+  memset(&g_swu_resume, 0, sizeof(g_swu_resume));
+  oc_storage_erase(SWU_RESUME_STORE_NAME);
+}
+
+static void swu_abort(const char *reason)
+{
+  APP_LOG_WARN("swu: transfer aborted at %u: %s\n",
+    (unsigned)g_swu_status.received, reason);
+  g_swu_status.errors++;
+  g_swu_status.active = false;
+  g_swu_buffers[0].full = false;
+  g_swu_buffers[1].full = false;
+  oc_remove_delayed_callback(NULL, swu_idle_cb);
+}
+
+/* the image [0, end) is handed to the writer */
+static void swu_written(uint32_t end, uint32_t hash)
+{
+  g_swu_status.written = end;
+  g_swu_written_hash = hash;
+  if (end >= g_swu_status.binary_size) {
+    swu_finish();
+  } else if (end - g_swu_persisted >= APP_SWU_PERSIST_BYTES) {
+    swu_store_resume(end, hash);
+  }
+}
+
+/* writes the oldest full buffer */
+static bool swu_write_one(void)
+{
+  swu_buffer_t *buffer = &g_swu_buffers[g_swu_next_write];
+  if (!buffer->full) {
+    return false;
+  }
+  METRICS_START(start);
+  bool ok = g_swu_writer && g_swu_writer(buffer->offset, buffer->data, buffer->len);
+  METRICS_LATENCY(store, start);
+  buffer->full = false;
+  g_swu_next_write ^= 1;
+  if (!ok) {
+    swu_abort("write failed");
+    return false;
+  }
+  swu_written(buffer->offset + buffer->len, buffer->hash);
+  return true;
+}
+
+static oc_event_callback_retval_t swu_write_cb(void *data)
+{
+  (void)data;
+  swu_write_one();
+  if (g_swu_buffers[g_swu_next_write].full) {
+    return OC_EVENT_CONTINUE;
+  }
+  g_swu_write_scheduled = false;
+  return OC_EVENT_DONE;
+}
+
+#endif /* APP_SWU_PIPELINE */
+
+static void swu_finish(void)
+{
+  oc_clock_time_t ticks = oc_clock_time() - g_swu_start;
+  uint32_t ms = (uint32_t)(ticks * 1000 / OC_CLOCK_SECOND);
+  uint32_t bytes = g_swu_status.binary_size - g_swu_status.resumed_from;
+
+  g_swu_status.active = false;
+  g_swu_status.elapsed_ms = ms;
+  g_swu_status.bytes_per_s = ms ? (uint32_t)((uint64_t)bytes * 1000 / ms) : bytes;
+  oc_remove_delayed_callback(NULL, swu_idle_cb);
+#if APP_SWU_PIPELINE
+  if (g_swu_writer) {
+    swu_clear_resume();
+  }
+#endif
+  APP_LOG_INFO("swu: %u bytes in %u ms, %u B/s (resumed at %u), hash %08x\n",
+    (unsigned)g_swu_status.binary_size, (unsigned)ms,
+    (unsigned)g_swu_status.bytes_per_s, (unsigned)g_swu_status.resumed_from,
+    (unsigned)g_swu_status.hash);
+}
+
+static oc_event_callback_retval_t swu_idle_cb(void *data)
+{
+  (void)data;
+#if APP_SWU_PIPELINE
+  while (swu_write_one())
+    ;
+  if (g_swu_status.active && g_swu_writer) {
+    swu_store_resume(g_swu_status.written, g_swu_written_hash);
+  }
+#endif
+  APP_LOG_WARN("swu: no blocks for %d s, transfer interrupted at %u\n",
+    APP_SWU_IDLE_S, (unsigned)g_swu_status.written);
+  g_swu_status.active = false;
+  return OC_EVENT_DONE;
+}
+
+static void swu_start(size_t binary_size)
+{
+  memset(&g_swu_status, 0, sizeof(g_swu_status));
+  g_swu_status.active = true;
+  g_swu_status.binary_size = (uint32_t)binary_size;
+  g_swu_start = oc_clock_time();
+#if APP_SWU_PIPELINE
+  oc_remove_delayed_callback(NULL, swu_write_cb);
+  g_swu_buffers[0].full = false;
+  g_swu_buffers[1].full = false;
+  g_swu_write_scheduled = false;
+  g_swu_next_write = 0;
+  g_swu_status.hash = SWU_HASH_INIT;
+  g_swu_written_hash = SWU_HASH_INIT;
+
+  long ret = oc_storage_read(SWU_RESUME_STORE_NAME, (uint8_t *)&g_swu_resume,
+                             sizeof(g_swu_resume));
+  METRICS_COUNT(storage_reads);
+  if (g_swu_writer == NULL || ret != (long)sizeof(g_swu_resume) ||
+      g_swu_resume.binary_size != (uint32_t)binary_size ||
+      g_swu_resume.offset > (uint32_t)binary_size) {
+    memset(&g_swu_resume, 0, sizeof(g_swu_resume));
+  }
+  g_swu_status.resumed_from = g_swu_resume.offset;
+  g_swu_persisted = g_swu_resume.offset;
+  APP_LOG_INFO("swu: receiving %u bytes, resume at %u\n",
+    (unsigned)binary_size, (unsigned)g_swu_resume.offset);
+#else
+  APP_LOG_INFO("swu: receiving %u bytes\n", (unsigned)binary_size);
+#endif
+}
+
+void app_swu_note_block(size_t binary_size, size_t offset, size_t len)
+{
+  if (offset == 0 || !g_swu_status.active) {
+    swu_start(binary_size);
+  }
+  oc_remove_delayed_callback(NULL, swu_idle_cb);
+  oc_set_delayed_callback(NULL, swu_idle_cb, APP_SWU_IDLE_S);
+  if (offset + len > g_swu_status.received) {
+    g_swu_status.received = (uint32_t)(offset + len);
+  }
+#if APP_SWU_PIPELINE
+  if (g_swu_writer != NULL)
+    return;
+#endif
+  if (g_swu_status.received >= binary_size) {
+    /* the port writes the image, only the throughput is reported */
+    g_swu_status.written = g_swu_status.received;
+    swu_finish();
+  }
+}
+
+#if APP_SWU_PIPELINE
+/* a sender that continues an interrupted transfer at the stored offset,
+ * instead of starting again at 0 */
+static bool swu_continue(size_t binary_size, size_t offset)
+{
+  swu_start(binary_size);
+  if (g_swu_resume.offset == 0 || g_swu_resume.offset != offset) {
+    return false;
+  }
+  g_swu_first_hash = g_swu_resume.first_hash;
+  g_swu_status.hash = g_swu_resume.hash;
+  g_swu_written_hash = g_swu_resume.hash;
+  g_swu_status.received = (uint32_t)offset;
+  g_swu_status.written = (uint32_t)offset;
+  return true;
+}
+
+/* hashes the part of a block that is already stored by an interrupted
+ * transfer, and removes it from the block */
+static bool swu_skip_stored(size_t *offset, const uint8_t **payload, size_t *len)
+{
+  size_t stored = g_swu_status.resumed_from - *offset;
+  if (stored > *len) {
+    stored = *len;
+  }
+  g_swu_status.hash = swu_hash(g_swu_status.hash, *payload, stored);
+  if (*offset == 0) {
+    g_swu_first_hash = g_swu_status.hash;
+    if (g_swu_first_hash != g_swu_resume.first_hash) {
+      /* another image, nothing is skipped */
+      g_swu_status.hash = SWU_HASH_INIT;
+      g_swu_status.resumed_from = 0;
+      g_swu_persisted = 0;
+      swu_clear_resume();
+      return true;
+    }
+  }
+  if (*offset + stored == g_swu_status.resumed_from &&
+      g_swu_status.hash != g_swu_resume.hash) {
+    swu_clear_resume();
+    swu_abort("stored image does not match");
+    return false;
+  }
+  g_swu_status.written = (uint32_t)(*offset + stored);
+  g_swu_written_hash = g_swu_status.hash;
+  *offset += stored;
+  *payload += stored;
+  *len -= stored;
+  return true;
+}
+
+/* queues a block in a free buffer, the oldest buffer is written first */
+static void swu_queue(size_t offset, const uint8_t *payload, size_t len)
+{
+  if (g_swu_buffers[0].full && g_swu_buffers[1].full) {
+    /* the writer is behind, make room */
+    g_swu_status.stalls++;
+    if (!swu_write_one()) {
+      return;
+    }
+  }
+  swu_buffer_t *buffer = &g_swu_buffers[g_swu_next_write];
+  if (buffer->full) {
+    buffer = &g_swu_buffers[g_swu_next_write ^ 1];
+  }
+  memcpy(buffer->data, payload, len);
+  buffer->offset = (uint32_t)offset;
+  buffer->len = (uint16_t)len;
+  buffer->hash = g_swu_status.hash;
+  buffer->full = true;
+  if (!g_swu_write_scheduled) {
+    g_swu_write_scheduled = true;
+    oc_set_delayed_callback_ms(NULL, swu_write_cb, 0);
+  }
+}
+
+bool app_swu_receive(oc_separate_response_t *response, size_t binary_size,
+                     size_t offset, const uint8_t *payload, size_t len)
+{
+  bool accepted = false;
+  uint32_t expected = g_swu_status.active ? g_swu_status.received : 0;
+
+  if (g_swu_writer == NULL || offset + len > binary_size) {
+    APP_LOG_WARN("swu: block %u not accepted\n", (unsigned)offset);
+  } else if (offset != 0 && offset < expected) {
+    /* retransmission of a block that is already received */
+    accepted = true;
+    len = 0;
+  } else if (offset != expected &&
+             (expected != 0 || !swu_continue(binary_size, offset))) {
+    swu_abort("block out of order");
+  } else {
+    app_swu_note_block(binary_size, offset, len);
+    accepted = true;
+    if (offset < g_swu_status.resumed_from) {
+      accepted = swu_skip_stored(&offset, &payload, &len);
+    }
+  }
+  if (accepted && len > 0) {
+    g_swu_status.hash = swu_hash(g_swu_status.hash, payload, len);
+    if (offset == 0) {
+      g_swu_first_hash = g_swu_status.hash;
+    }
+    if (len <= APP_SWU_BUFFER_SIZE) {
+      swu_queue(offset, payload, len);
+    } else {
+      /* does not fit a buffer: write in order, without pipelining */
+      while (swu_write_one())
+        ;
+      if (g_swu_status.active && g_swu_writer(offset, payload, len)) {
+        swu_written((uint32_t)(offset + len), g_swu_status.hash);
+      } else {
+        swu_abort("write failed");
+        accepted = false;
+      }
+    }
+  } else if (accepted && g_swu_status.written >= g_swu_status.binary_size) {
+    /* the whole image was stored by the interrupted transfer */
+    swu_finish();
+  }
+  if (response) {
+    /* acknowledge directly, the next block arrives while this one is written */
+    oc_set_delayed_callback(response, &send_delayed_response, 0);
+  }
+  return accepted;
+}
+
+void app_swu_set_writer(app_swu_write_cb_t writer)
+{
+  g_swu_writer = writer;
+}
+#endif /* APP_SWU_PIPELINE */
+
+bool app_swu_is_active(void)
+{
+  return g_swu_status.active;
+}
+
+const app_swu_status_t *app_swu_get_status(void)
+{
+  return &g_swu_status;
+}
+
+#if APP_SWU_PIPELINE && (defined WIN32 || defined __linux__)
+static bool swu_file_write(size_t offset, const uint8_t *data, size_t len)
+{
+  /* a new image replaces the file, blocks of a resumed transfer are added */
+  FILE *write_ptr = fopen("./downloaded.bin", offset == 0 ? "wb" : "r+b");
+  if (write_ptr == NULL) {
+    return false;
+  }
+  bool ok = fseek(write_ptr, (long)offset, SEEK_SET) == 0 &&
+            fwrite(data, sizeof(*data), len, write_ptr) == len;
+  fclose(write_ptr);
+  return ok;
+}
+
+/**
+ * @brief software update callback
+ *
+ * @param device the device index
+ * @param response the instance of an internal struct that is used to track
+ *       		   the state of the separate response
+ * @param binary_size the full size of the binary
+ * @param offset the offset of the image
+ * @param payload the image data
+ * @param len the length of the image data
+ * @param data the user data
+ */
+void swu_cb(size_t device,
+            oc_separate_response_t *response,
+            size_t binary_size,
+            size_t offset,
+            uint8_t *payload,
+            size_t len,
+            void *data)
+{
+  (void)device;
+  (void)data;
+  APP_LOG_DBG(" swu_cb block=%d size=%d \n", (int)offset, (int)len);
+
+  app_swu_receive(response, binary_size, offset, payload, len);
+}
+#endif
+
+/**
+ * @brief initializes the global variables
+ * for the resources
+ * for the parameters
+ */
+void
+initialize_variables(void)
+{
+  /* initialize global variables for resources */
+  /* if wanted read them from persistent storage */
+  /* parameter variables */
+  uint8_t oc_storage_buf[32];
+  long ret;
+  bool err;
+
+  APP_LOG_INFO("Initializing persistent data\n");
+#if APP_PERSIST_SNAPSHOT
+  snapshot_read();
+#endif
+
+  for(int i = 0; i < num_datapoints; i++) {
+    const datapoint_t *it = &g_datapoints[i];
+    if (!it->persistent && !it->default_present) continue;
+    if (it->g_var == NULL) continue;
+    if (it->num_elements){
+      if (it->default_present){
+        dpt_set_default_value(it->type, get_datapoint_url(it));
+      }
+      if (it->persistent && !snapshot_load(it)) {
+        if (!dpt_persistent_load(it->type, get_datapoint_url(it), (void*)it->g_var, it->num_elements)){
+          APP_LOG_ERR("ERR: persistent load array missing for %d\n", it->type);
+        }
+      }
+    } else {
+      if (it->default_present){
+        dpt_set_default_value(it->type, get_datapoint_url(it));
+      }
+      if (it->persistent && !snapshot_load(it)) {
+        if (!dpt_persistent_load(it->type, get_datapoint_url(it), (void*)it->g_var, 0)){
+          APP_LOG_ERR("ERR: persistent load array missing for %d\n", it->type);
+        }
+      }
+    }
+  } 
+
+  for(int i = 0; i < num_parameters; i++) {
+    const datapoint_t *it = &g_parameters[i];
+    if (!it->persistent && !it->default_present) continue;
+    if (it->g_var == NULL) continue;
+    if (it->num_elements){
+      if (it->default_present){
+        dpt_set_default_value(it->type, get_datapoint_url(it));
+      }
+      if (it->persistent && !snapshot_load(it)) {
+        if (!dpt_persistent_load(it->type, get_datapoint_url(it), (void*)it->g_var, it->num_elements)){
+          APP_LOG_ERR("ERR: persistent load array missing for %d\n", it->type);
+        }
+      }
+    } else {
+      if (it->default_present){
+        dpt_set_default_value(it->type, get_datapoint_url(it));
+      }
+      if (it->persistent && !snapshot_load(it)) {
+        if (!dpt_persistent_load(it->type, get_datapoint_url(it), (void*)it->g_var, 0)){
+          APP_LOG_ERR("ERR: persistent load array missing for %d\n", it->type);
+        }
+      }
+    }
+  }
+
+#if APP_PERSIST_SNAPSHOT
+  if (snapshot_complete()) {
+    /* one read for all persistent data points */
+    g_snapshot_valid = true;
+  } else {
+    /* (partly) loaded from the individual records, create the snapshot for the next start up */
+    snapshot_write();
+  }
+#endif
+}
+/**
+ * @brief reset variables to default value
+ * for the resources
+ * for the parameters
+ */
+void
+reset_variables(void)
+{
+  /* reset variables to default value */
+  APP_LOG_INFO("Resetting to default value\n");
+  /* pending writes would overwrite the reset values */
+  persist_discard();
+  smode_discard();
+  observe_discard();
+  event_discard();
+#ifdef MQTT_PROXY
+  mqtt_discard();
+#endif
+  g_table_generation++;
+#if APP_PERSIST_SNAPSHOT
+  oc_storage_erase(SNAPSHOT_STORE_NAME);
+  g_snapshot_valid = false;
+#endif
+
+  for(int i = 0; i < num_datapoints; i++) {
+    const datapoint_t *it = &g_datapoints[i];
+    if (it->persistent) {
+      persistent_erase_elems(get_datapoint_url(it), get_dpt_size(it->type),
+                             it->num_elements ? it->num_elements : 1);
+    }
+    if (it->default_present){
+      dpt_set_default_value(it->type, get_datapoint_url(it));
+    }
+  } 
+
+  for(int i = 0; i < num_parameters; i++) {
+    const datapoint_t *it = &g_parameters[i];
+    if (it->persistent) {
+      persistent_erase_elems(get_datapoint_url(it), get_dpt_size(it->type),
+                             it->num_elements ? it->num_elements : 1);
+    }
+    if (it->default_present){
+      dpt_set_default_value(it->type, get_datapoint_url(it));
+    }
+  } 
+}
+
+int app_set_serial_number(const char* serial_number)
+{
+  strncpy(g_serial_number, serial_number, 20);
+  return 0;
+}
+
+int app_initialize_stack()
+{
+  int init;
+  char *fname = "my_software_image";
+
+  APP_LOG_INFO("KNX-IOT Server name : \"%s\"\n", g_app_info.name);
+
+  /* show the current working folder */
+  char buff[FILENAME_MAX];
+  char *retbuf = NULL;
+  retbuf = GetCurrentDir(buff, FILENAME_MAX);
+  if (retbuf != NULL) {
+    APP_LOG_INFO("Current working dir: %s\n", buff);
+  }
+
+  /*
+   The storage folder depends on the build system
+   the folder is created in the makefile, with $target as name with _cred as
+   post fix.
+  */
+#ifdef WIN32
+  char storage[400];
+  sprintf(storage,"./%s_%s",g_app_info.storage,g_serial_number);
+  APP_LOG_INFO("\tstorage at '%s' \n",storage);
+  oc_storage_config(storage);
+#else
+  char storage[400];
+  sprintf(storage,"./%s_creds",g_app_info.storage);
+  APP_LOG_INFO("\tstorage at '%s' \n",storage+2);
+  oc_storage_config(storage);
+#endif /* WIN32 */
+
+
+  /* initializes the handlers structure */
+  static oc_handler_t handler = { .init = app_init,
+                                  .signal_event_loop = signal_event_loop,
+                                  .register_resources = register_resources,
+                                  .requests_entry = NULL };
+
+  /* set the application callbacks */
+  oc_set_hostname_cb(hostname_cb, NULL);
+  oc_set_factory_presets_cb(factory_presets_cb, NULL);
+	oc_set_lsm_change_cb(lsm_change_cb, NULL);
+
+#if APP_SWU_PIPELINE && (defined WIN32 || defined __linux__)
+  oc_set_swu_cb(swu_cb, (void *)fname);
+#endif /* WIN32 || defined __linux__ */
+
+  /* start the stack */
+  init = oc_main_init(&handler);
+
+  if (init < 0) {
+    APP_LOG_ERR("oc_main_init failed %d, exiting.\n", init);
+    return init;
+  }
+
+  if (g_reset) {
+    APP_LOG_INFO("factory_presets_cb: resetting device\n");
+    oc_knx_device_storage_reset(0, 2);
+  }
+
+  oc_knx_knx_ignore_smessage_from_self(true);
+
+#ifdef OC_OSCORE
+  APP_LOG_INFO("OSCORE - Enabled\n");
+#else
+  APP_LOG_INFO("OSCORE - Disabled\n");
+#endif /* OC_OSCORE */
+
+  oc_device_info_t *device = oc_core_get_device_info(0);
+  APP_LOG_INFO("serial number: %s\n", oc_string(device->serialnumber));
+  oc_endpoint_t *my_ep = oc_connectivity_get_endpoints(0);
+  if (my_ep != NULL) {
+    PRINTipaddr(*my_ep);
+    PRINT("\n");
+  }
+  APP_LOG_INFO("Server \"%s\" running, waiting on incoming "
+        "connections.\n",
+        g_app_info.name);
+  return 0;
+}
+
+static app_signal_cb_t g_signal_event_loop_cb = NULL;
+
+void
+app_set_signal_event_loop_cb(app_signal_cb_t cb)
+{
+  g_signal_event_loop_cb = cb;
+}
+
+// ===== Event loop =====
+// with APP_LOOP_TICKLESS the main loop waits on one set of kernel objects:
+// the wake event (set by signal_event_loop), a timer armed with the next
+// event of the stack and the handles registered by the application. The
+// timer is armed relative to now with integer math, without rounding to ms.
+// Without it (or when the objects can't be created) the loop waits on the
+// condition variable.
+
+#ifndef NO_MAIN
+static volatile uint32_t g_loop_signalled; /**< set by signal_event_loop */
+#endif /* NO_MAIN */
+
+#if APP_LOOP_TICKLESS && !defined(NO_MAIN)
+typedef struct loop_handle_t
+{
+  app_loop_handle_t handle;
+  app_loop_cb_t cb; /**< NULL = free slot */
+  void *ctx;
+} loop_handle_t;
+
+static loop_handle_t g_loop_handles[APP_LOOP_MAX_HANDLES];
+#ifdef WIN32
+static HANDLE g_loop_wake = NULL;
+static HANDLE g_loop_timer = NULL;
+#define loop_is_open() (g_loop_wake != NULL)
+#else
+static int g_loop_epoll = -1;
+static int g_loop_wake = -1;
+static int g_loop_timer = -1;
+#define loop_is_open() (g_loop_wake >= 0)
+#endif
+
+static loop_handle_t *loop_find(app_loop_handle_t handle)
+{
+  for (int i = 0; i < APP_LOOP_MAX_HANDLES; i++) {
+    if (g_loop_handles[i].cb != NULL && g_loop_handles[i].handle == handle)
+      return &g_loop_handles[i];
+  }
+  return NULL;
+}
+
+/* creates the wake event and the timer, before the stack starts */
+static bool loop_open(void)
+{
+#ifdef WIN32
+  HANDLE wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+  HANDLE timer = CreateWaitableTimer(NULL, FALSE, NULL);
+  if (wake == NULL || timer == NULL) {
+    if (wake != NULL)
+      CloseHandle(wake);
+    if (timer != NULL)
+      CloseHandle(timer);
+    return false;
+  }
+  g_loop_timer = timer;
+  g_loop_wake = wake;
+  return true;
+#else
+  struct epoll_event ev = { .events = EPOLLIN };
+  int ep = epoll_create1(EPOLL_CLOEXEC);
+  int wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  int timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  bool ok = ep >= 0 && wake >= 0 && timer >= 0;
+  ev.data.fd = wake;
+  ok = ok && epoll_ctl(ep, EPOLL_CTL_ADD, wake, &ev) == 0;
+  ev.data.fd = timer;
+  ok = ok && epoll_ctl(ep, EPOLL_CTL_ADD, timer, &ev) == 0;
+  if (!ok) {
+    if (ep >= 0)
+      close(ep);
+    if (wake >= 0)
+      close(wake);
+    if (timer >= 0)
+      close(timer);
+    return false;
+  }
+  g_loop_epoll = ep;
+  g_loop_timer = timer;
+  g_loop_wake = wake;
+  return true;
+#endif
+}
+
+bool app_loop_add_handle(app_loop_handle_t handle, app_loop_cb_t cb, void *ctx)
+{
+  if (cb == NULL || !loop_is_open() || loop_find(handle) != NULL)
+    return false;
+  for (int i = 0; i < APP_LOOP_MAX_HANDLES; i++) {
+    if (g_loop_handles[i].cb != NULL)
+      continue;
+#ifndef WIN32
+    struct epoll_event ev = { .events = EPOLLIN };
+    ev.data.fd = handle;
+    if (epoll_ctl(g_loop_epoll, EPOLL_CTL_ADD, handle, &ev) != 0) {
+      APP_LOG_ERR(" loop: can't wait on fd %d\n", handle);
+      return false;
+    }
+#endif
+    g_loop_handles[i].handle = handle;
+    g_loop_handles[i].cb = cb;
+    g_loop_handles[i].ctx = ctx;
+    return true;
+  }
+  APP_LOG_ERR(" loop: increase APP_LOOP_MAX_HANDLES\n");
+  return false;
+}
+
+bool app_loop_remove_handle(app_loop_handle_t handle)
+{
+  loop_handle_t *lh = loop_find(handle);
+  if (lh == NULL)
+    return false;
+#ifndef WIN32
+  epoll_ctl(g_loop_epoll, EPOLL_CTL_DEL, handle, NULL);
+#endif
+  lh->cb = NULL;
+  return true;
+}
+
+#ifdef WIN32
+static void loop_run(void)
+{
+  HANDLE handles[APP_LOOP_MAX_HANDLES + 2];
+  int slots[APP_LOOP_MAX_HANDLES + 2];
+
+  while (quit != 1) {
+    /* a signal from now on sets the wake event again */
+    EVENT_XCHG(&g_loop_signalled, 0);
+    app_event_process();
+    oc_clock_time_t next_event = oc_main_poll();
+    DWORD timeout = INFINITE;
+    DWORD count = 0;
+    handles[count++] = g_loop_wake;
+    handles[count++] = g_loop_timer;
+    for (int i = 0; i < APP_LOOP_MAX_HANDLES; i++) {
+      if (g_loop_handles[i].cb != NULL) {
+        slots[count] = i;
+        handles[count++] = g_loop_handles[i].handle;
+      }
+    }
+    if (next_event == 0) {
+      CancelWaitableTimer(g_loop_timer);
+    } else {
+      oc_clock_time_t now = oc_clock_time();
+      if (next_event <= now) {
+        timeout = 0;
+      } else {
+        /* relative due time, in 100 ns units */
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((next_event - now) * 10000000 / OC_CLOCK_SECOND);
+        SetWaitableTimer(g_loop_timer, &due, 0, NULL, NULL, FALSE);
+      }
+    }
+    DWORD r = WaitForMultipleObjects(count, handles, FALSE, timeout);
+    if (r >= WAIT_OBJECT_0 + 2 && r < WAIT_OBJECT_0 + count) {
+      loop_handle_t *lh = &g_loop_handles[slots[r - WAIT_OBJECT_0]];
+      if (lh->cb != NULL)
+        lh->cb(lh->handle, lh->ctx);
+    }
+  }
+}
+#else
+static void loop_run(void)
+{
+  struct epoll_event events[APP_LOOP_MAX_HANDLES + 2];
+  struct itimerspec its;
+
+  while (quit != 1) {
+    /* a signal from now on writes the eventfd again */
+    EVENT_XCHG(&g_loop_signalled, 0);
+    app_event_process();
+    oc_clock_time_t next_event = oc_main_poll();
+    int timeout = -1;
+    memset(&its, 0, sizeof(its));
+    if (next_event != 0) {
+      oc_clock_time_t now = oc_clock_time();
+      if (next_event <= now) {
+        timeout = 0;
+      } else {
+        oc_clock_time_t delta = next_event - now;
+        its.it_value.tv_sec = delta / OC_CLOCK_SECOND;
+        its.it_value.tv_nsec =
+          (long)((uint64_t)(delta % OC_CLOCK_SECOND) * 1000000000u / OC_CLOCK_SECOND);
+      }
+    }
+    if (timeout != 0) {
+      /* armed, or disarmed when the stack has no timer */
+      timerfd_settime(g_loop_timer, 0, &its, NULL);
+    }
+    int n = epoll_wait(g_loop_epoll, events, APP_LOOP_MAX_HANDLES + 2, timeout);
+    for (int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      if (fd == g_loop_wake || fd == g_loop_timer) {
+        uint64_t value;
+        ssize_t r = read(fd, &value, sizeof(value));
+        (void)r;
+        continue;
+      }
+      /* may be removed by an earlier callback */
+      loop_handle_t *lh = loop_find(fd);
+      if (lh != NULL)
+        lh->cb(fd, lh->ctx);
+    }
+  }
+}
+#endif /* WIN32 */
+#else
+bool app_loop_add_handle(app_loop_handle_t handle, app_loop_cb_t cb, void *ctx)
+{
+  (void)handle;
+  (void)cb;
+  (void)ctx;
+  APP_LOG_ERR(" loop: handles need APP_LOOP_TICKLESS and the main of the runtime\n");
+  return false;
+}
+
+bool app_loop_remove_handle(app_loop_handle_t handle)
+{
+  (void)handle;
+  return false;
+}
+#endif /* APP_LOOP_TICKLESS && !NO_MAIN */
+
+#ifdef WIN32
+/**
+ * @brief signal the event loop (windows version)
+ * wakes up the main function to handle the next callback
+ */
+void
+signal_event_loop(void)
+{
+  if (g_signal_event_loop_cb) {
+    g_signal_event_loop_cb();
+  }
+#ifndef NO_MAIN
+#if APP_LOOP_TICKLESS
+  if (loop_is_open()) {
+    /* the loop is signalled already, until it clears the flag */
+    if (EVENT_XCHG(&g_loop_signalled, 1) == 0)
+      SetEvent(g_loop_wake);
+    return;
+  }
+#endif /* APP_LOOP_TICKLESS */
+  WakeConditionVariable(&cv);
+#endif /* NO_MAIN */
+}
+#endif /* WIN32 */
+
+#ifdef __linux__
+/**
+ * @brief signal the event loop (Linux)
+ * wakes up the main function to handle the next callback
+ */
+void
+signal_event_loop(void)
+{
+  if (g_signal_event_loop_cb) {
+    g_signal_event_loop_cb();
+  }
+#ifndef NO_MAIN
+  /* the loop is signalled already, until it checks the flag */
+  if (EVENT_XCHG(&g_loop_signalled, 1) != 0)
+    return;
+#if APP_LOOP_TICKLESS
+  if (loop_is_open()) {
+    uint64_t one = 1;
+    ssize_t r = write(g_loop_wake, &one, sizeof(one));
+    (void)r;
+    return;
+  }
+#endif /* APP_LOOP_TICKLESS */
+  pthread_mutex_lock(&mutex);
+  pthread_cond_signal(&cv);
+  pthread_mutex_unlock(&mutex);
+#endif /* NO_MAIN */
+}
+#endif /* __linux__ */
+
+
+#ifdef APP_BENCH
+// ===== Benchmark =====
+// host side measurement of the generic data point layer, started with -bench.
+// output: one CSV line per operation, preceded by a header line.
+
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_STORE_URL "/p/bench"
+
+static uint8_t g_bench_buffer[BENCH_BUFFER_SIZE];
+
+/* the codec operations are measured per path: "layout" is the field layout
+   of the descriptors, "table" the specialised codecs of APP_DPT_FUNCTION_TABLE */
+#if APP_DPT_FUNCTION_TABLE
+#define BENCH_CODEC_PATHS 2
+#else
+#define BENCH_CODEC_PATHS 1
+#endif
+
+static const char *bench_name(char *name, size_t size, const char *operation, int path)
+{
+  snprintf(name, size, "%s/%s", operation, path == 0 ? "layout" : "table");
+  return name;
+}
+
+static uint32_t bench_mallocs(void)
+{
+#if APP_METRICS
+  return g_metrics.malloc_count;
+#else
+  return 0;
+#endif
+}
+
+static void bench_report(const char *name, int count, int array, long iterations,
+                         oc_clock_time_t start, uint32_t mallocs)
+{
+  oc_clock_time_t ticks = oc_clock_time() - start;
+  double seconds = (double)ticks / OC_CLOCK_SECOND;
+  double ops = seconds > 0 ? iterations / seconds : 0;
+  printf("bench,%s,%d,%d,%ld,%.0f,%u\n", name, count, array, iterations, ops,
+    (unsigned)(bench_mallocs() - mallocs));
+}
+
+static void bench_request(oc_request_t *request, oc_response_t *response,
+                          oc_response_buffer_t *response_buffer,
+                          oc_endpoint_t *origin, const datapoint_t *dp)
+{
+  memset(request, 0, sizeof(*request));
+  memset(response, 0, sizeof(*response));
+  memset(response_buffer, 0, sizeof(*response_buffer));
+  memset(origin, 0, sizeof(*origin));
+  response_buffer->buffer = g_bench_buffer;
+  response_buffer->buffer_size = sizeof(g_bench_buffer);
+  response->response_buffer = response_buffer;
+  request->response = response;
+  request->origin = origin;
+  request->resource = (oc_resource_t *)&dp->resource;
+  request->uri_path = get_datapoint_url(dp);
+  request->uri_path_len = strlen(request->uri_path);
+  request->accept = APPLICATION_CBOR;
+  request->content_format = APPLICATION_CBOR;
+  oc_rep_new(g_bench_buffer, sizeof(g_bench_buffer));
+}
+
+/**
+ * @brief runs the benchmark
+ *
+ * @param iterations number of operations per measurement
+ * @param count number of data points to cycle through (0 = all)
+ * @param array number of elements for the array encode and storage
+ */
+static void app_bench_run(long iterations, int count, int array)
+{
+  oc_request_t request;
+  oc_response_t response;
+  oc_response_buffer_t response_buffer;
+  oc_endpoint_t origin;
+  oc_clock_time_t start;
+  uint32_t mallocs;
+  char name[40];
+  long i;
+
+  if (count <= 0 || count > (int)num_datapoints)
+    count = (int)num_datapoints;
+  if (array < 1)
+    array = 1;
+  size_t array_size = get_dpt_size(g_datapoints[0].type) * array;
+  uint8_t *values = calloc(1, array_size);
+  uint8_t *saved = calloc(num_datapoints, g_dp_scratch.size);
+  if (values == NULL || saved == NULL) {
+    APP_LOG_ERR("bench: out of memory\n");
+    free(values);
+    free(saved);
+    return;
+  }
+  /* the PUTs change the values, restore them afterwards */
+  for (int d = 0; d < (int)num_datapoints; d++) {
+    const datapoint_t *dp = &g_datapoints[d];
+    if (dp->g_var && dp->num_elements == 0)
+      memcpy(&saved[d * g_dp_scratch.size], dp->g_var, get_dpt_size(dp->type));
+  }
+
+  printf("bench,operation,datapoints,array,iterations,ops_per_s,mallocs\n");
+
+  mallocs = bench_mallocs();
+  start = oc_clock_time();
+  for (i = 0; i < iterations; i++) {
+    if (get_datapoint_by_url(get_datapoint_url(&g_datapoints[i % count])) == NULL)
+      break;
+  }
+  bench_report("get_datapoint_by_url", count, 1, i, start, mallocs);
+
+  /* the codecs: field layout, then the specialised codecs */
+  for (int path = 0; path < BENCH_CODEC_PATHS; path++) {
+#if BENCH_CODEC_PATHS > 1
+    g_dpt_force_layout = path == 0;
+#endif
+    mallocs = bench_mallocs();
+    start = oc_clock_time();
+    for (i = 0; i < iterations; i++) {
+      oc_rep_new(g_bench_buffer, sizeof(g_bench_buffer));
+      oc_encode_datapoint(&g_datapoints[i % count], 0, 1, false);
+    }
+    bench_report(bench_name(name, sizeof(name), "oc_encode_datapoint", path), count, 1, i, start, mallocs);
+
+    mallocs = bench_mallocs();
+    start = oc_clock_time();
+    for (i = 0; i < iterations; i++) {
+      oc_rep_new(g_bench_buffer, sizeof(g_bench_buffer));
+      dpt_encode(g_datapoints[0].type, values, array, true, false);
+    }
+    bench_report(bench_name(name, sizeof(name), "oc_encode_array", path), 1, array, i, start, mallocs);
+
+    mallocs = bench_mallocs();
+    start = oc_clock_time();
+    for (i = 0; i < iterations; i++) {
+      const datapoint_t *dp = &g_datapoints[i % count];
+      oc_rep_t *rep = NULL;
+      oc_rep_new(g_bench_buffer, sizeof(g_bench_buffer));
+      oc_encode_datapoint(dp, 0, 1, false);
+      if (oc_parse_rep(g_bench_buffer, oc_rep_get_encoded_payload_size(), &rep) != 0)
+        break;
+      oc_parse_datapoint(dp, rep, g_dp_scratch.put, 1);
+      oc_free_rep(rep);
+    }
+    bench_report(bench_name(name, sizeof(name), "oc_parse_datapoint", path), count, 1, i, start, mallocs);
+  }
+#if BENCH_CODEC_PATHS > 1
+  g_dpt_force_layout = false;
+#endif
+
+  mallocs = bench_mallocs();
+  start = oc_clock_time();
+  for (i = 0; i < iterations; i++) {
+    const datapoint_t *dp = &g_datapoints[i % count];
+    bench_request(&request, &response, &response_buffer, &origin, dp);
+    get_generic(&request, OC_IF_D, (void *)dp);
+  }
+  bench_report("get_generic", count, 1, i, start, mallocs);
+
+  mallocs = bench_mallocs();
+  start = oc_clock_time();
+  for (i = 0; i < iterations; i++) {
+    const datapoint_t *dp = &g_datapoints[i % count];
+    uint8_t payload[64];
+    oc_rep_t *rep = NULL;
+    oc_rep_new(payload, sizeof(payload));
+    oc_encode_datapoint(dp, 0, 1, false);
+    if (oc_parse_rep(payload, oc_rep_get_encoded_payload_size(), &rep) != 0)
+      break;
+    bench_request(&request, &response, &response_buffer, &origin, dp);
+    request.request_payload = rep;
+    put_generic(&request, OC_IF_D, (void *)dp);
+    oc_free_rep(rep);
+  }
+  bench_report("put_generic", count, 1, i, start, mallocs);
+
+  size_t elem_size = get_dpt_size(g_datapoints[0].type);
+  mallocs = bench_mallocs();
+  start = oc_clock_time();
+  for (i = 0; i < iterations; i++) {
+    if (!persistent_store_elems(BENCH_STORE_URL, values, elem_size, array, 0, array))
+      break;
+  }
+  bench_report("persistent_store", 1, array, i, start, mallocs);
+
+  mallocs = bench_mallocs();
+  start = oc_clock_time();
+  for (i = 0; i < iterations; i++) {
+    if (!persistent_load_elems(BENCH_STORE_URL, values, elem_size, array, 0, array))
+      break;
+  }
+  bench_report("persistent_load", 1, array, i, start, mallocs);
+  persistent_erase_elems(BENCH_STORE_URL, elem_size, array);
+
+  for (int d = 0; d < (int)num_datapoints; d++) {
+    const datapoint_t *dp = &g_datapoints[d];
+    if (dp->g_var && dp->num_elements == 0)
+      datapoint_set(dp, &saved[d * g_dp_scratch.size], 0, 1);
+  }
+  smode_discard();
+  observe_discard();
+  app_persist_flush();
+  free(values);
+  free(saved);
+}
+
+// ===== Replay =====
+// replays a recorded sequence of events against the data point layer and the
+// put callback of the application, started with -replay <file>.
+// One event per line, '#' starts a comment:
+//   put <url> <fields...>    CoAP PUT, handled by put_generic
+//   smode <url> <fields...>  s-mode write, redirected from /.knx
+//   get <url>                CoAP GET, handled by get_generic
+//   toggle <url>             button press, posted to the event ring
+//   flush                    runs the deferred storing, s-mode and observe work
+//   <name> <args...>         event of the application, see app_replay_set_app
+// The step of the application (e.g. its due timers and the screen) runs after
+// each event and is part of the cpu time of the event.
+// output: one CSV line per event, followed by one summary line per kind.
+
+#define REPLAY_LINE_SIZE 256
+
+typedef struct replay_kind_t
+{
+  const char *name;
+  uint32_t count;
+  uint64_t cpu_us;
+  uint32_t max_us;
+  uint32_t storage_writes;
+  uint32_t smode_sent;
+  uint32_t display_bytes;
+} replay_kind_t;
+
+static replay_kind_t g_replay_kinds[] = {
+  { "put" }, { "smode" }, { "get" }, { "toggle" }, { "flush" }, { "app" }
+};
+
+#define REPLAY_KIND_APP 5
+
+static const app_replay_app_t *g_replay_app = NULL;
+
+void
+app_replay_set_app(const app_replay_app_t *app)
+{
+  g_replay_app = app;
+}
+
+static uint32_t replay_display_bytes(void)
+{
+  if (g_replay_app == NULL || g_replay_app->display_bytes == NULL)
+    return 0;
+  return g_replay_app->display_bytes();
+}
+
+static uint32_t replay_storage_writes(void)
+{
+#if APP_METRICS
+  return g_metrics.storage_writes;
+#else
+  return 0;
+#endif
+}
+
+/* the recorded value, as CBOR payload of a request */
+static bool replay_payload(const datapoint_t *dp, char *fields, uint8_t *payload,
+                           size_t size, oc_rep_t **rep)
+{
+  if (fields == NULL || dp->num_elements != 0 || get_dpt_size(dp->type) > g_dp_scratch.size)
+    return false;
+  if (app_sscanf_dpt(dp->type, g_dp_scratch.put, fields) != 0)
+    return false;
+  oc_rep_new(payload, (int)size);
+  if (!oc_encode_dpt(dp->type, g_dp_scratch.put, false))
+    return false;
+  return oc_parse_rep(payload, oc_rep_get_encoded_payload_size(), rep) == 0;
+}
+
+/* runs one event, false if the line is not a valid event */
+static bool replay_event(int kind, const char *name, const datapoint_t *dp, char *args,
+                         char *fields)
+{
+  oc_request_t request;
+  oc_response_t response;
+  oc_response_buffer_t response_buffer;
+  oc_endpoint_t origin;
+  uint8_t payload[64];
+  oc_rep_t *rep = NULL;
+
+  switch (kind) {
+  case 0: /* put */
+  case 1: /* smode */
+    if (dp == NULL || !replay_payload(dp, fields, payload, sizeof(payload), &rep))
+      return false;
+    bench_request(&request, &response, &response_buffer, &origin, dp);
+    request.request_payload = rep;
+    if (kind == 1) {
+      request.uri_path = ".knx";
+      request.uri_path_len = 4;
+    }
+    put_generic(&request, OC_IF_D, (void *)dp);
+    oc_free_rep(rep);
+    return true;
+  case 2: /* get */
+    if (dp == NULL)
+      return false;
+    bench_request(&request, &response, &response_buffer, &origin, dp);
+    get_generic(&request, OC_IF_D, (void *)dp);
+    return true;
+  case 3: /* toggle */
+    if (dp == NULL || !app_event_post_toggle(get_datapoint_url(dp)))
+      return false;
+    app_event_process();
+    return true;
+  case 4: /* flush */
+    app_persist_flush();
+    app_smode_flush();
+    app_observe_flush();
+    return true;
+  case REPLAY_KIND_APP:
+    return g_replay_app && g_replay_app->event && g_replay_app->event(name, args);
+  }
+  return false;
+}
+
+/**
+ * @brief replays the events of the file
+ *
+ * @param file the recorded events
+ * @return 0 on success, 1 if the file can't be read or has an invalid event
+ */
+static int app_replay_run(const char *file)
+{
+  char line[REPLAY_LINE_SIZE];
+  const int num_kinds = (int)(sizeof(g_replay_kinds) / sizeof(g_replay_kinds[0]));
+  int number = 0;
+  int errors = 0;
+  FILE *fp = fopen(file, "r");
+  if (fp == NULL) {
+    APP_LOG_ERR("replay: can't open %s\n", file);
+    return 1;
+  }
+
+  /* the start up of the application is not part of the recording */
+  if (g_replay_app && g_replay_app->step)
+    g_replay_app->step();
+  printf("replay,line,event,url,cpu_us,storage_writes,smode_sent,display_bytes\n");
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    number++;
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = 0;
+    char *name = strtok(line, " \t\r\n");
+    if (name == NULL)
+      continue;
+    char *args = strtok(NULL, "\r\n");
+    int kind = 0;
+    while (kind < REPLAY_KIND_APP && strcmp(g_replay_kinds[kind].name, name) != 0)
+      kind++;
+    /* the data point events: <url> <fields...> */
+    const datapoint_t *dp = NULL;
+    char *fields = NULL;
+    if (kind < REPLAY_KIND_APP && args) {
+      char *url = strtok(args, " \t");
+      fields = strtok(NULL, "");
+      dp = get_datapoint_by_url(url);
+    }
+
+    uint32_t writes = replay_storage_writes();
+    uint32_t sent = g_smode_stats.sent;
+    uint32_t display = replay_display_bytes();
+    clock_t start = clock();
+    bool ok = replay_event(kind, name, dp, args, fields);
+    if (ok && g_replay_app && g_replay_app->step)
+      g_replay_app->step();
+    uint32_t cpu_us = (uint32_t)((uint64_t)(clock() - start) * 1000000 / CLOCKS_PER_SEC);
+    if (!ok) {
+      APP_LOG_ERR("replay: %s:%d: invalid event '%s'\n", file, number, name);
+      errors++;
+      continue;
+    }
+    replay_kind_t *k = &g_replay_kinds[kind];
+    writes = replay_storage_writes() - writes;
+    sent = g_smode_stats.sent - sent;
+    display = replay_display_bytes() - display;
+    k->count++;
+    k->cpu_us += cpu_us;
+    if (cpu_us > k->max_us)
+      k->max_us = cpu_us;
+    k->storage_writes += writes;
+    k->smode_sent += sent;
+    k->display_bytes += display;
+    printf("replay,%d,%s,%s,%u,%u,%u,%u\n", number, name, dp ? get_datapoint_url(dp) : "",
+      cpu_us, writes, sent, display);
+  }
+  fclose(fp);
+
+  printf("replay_total,event,count,cpu_us,max_us,storage_writes,smode_sent,display_bytes\n");
+  for (int kind = 0; kind < num_kinds; kind++) {
+    const replay_kind_t *k = &g_replay_kinds[kind];
+    printf("replay_total,%s,%u,%u,%u,%u,%u,%u\n", k->name, k->count, (unsigned)k->cpu_us,
+      k->max_us, k->storage_writes, k->smode_sent, k->display_bytes);
+  }
+  smode_discard();
+  observe_discard();
+  app_persist_flush();
+  return errors ? 1 : 0;
+}
+#endif /* APP_BENCH */
+
+#ifndef NO_MAIN
+
+/**
+ * @brief handle Ctrl-C
+ * @param signal the captured signal
+ */
+static void
+handle_signal(int signal)
+{
+  (void)signal;
+  signal_event_loop();
+  quit = 1;
+}
+
+/**
+ * @brief print usage and quits
+ *
+ */
+static void
+print_usage()
+{
+  PRINT("Usage:\n");
+  PRINT("no arguments : starts the server\n");
+  PRINT("-help  : this message\n");
+  PRINT("reset  : does an full reset of the device\n");
+  PRINT("-s <serial number> : sets the serial number of the device\n");
+#if APP_MAX_DEVICES > 1
+  PRINT("-n <count> : runs <count> devices, with serial numbers counting up from -s\n");
+#endif
+#ifdef APP_BENCH
+  PRINT("-bench <iterations> [<datapoints> [<array size>]] : runs the benchmark and quits\n");
+  PRINT("-replay <file> : replays the recorded events of the file and quits\n");
+#endif
+#ifdef MQTT_PROXY
+  PRINT("MQTT proxy configurations (only used before ETS download):\n");
+  PRINT("-host : sets the MQTT broker hostname\n");
+  PRINT("-port : sets the MQTT broker port number\n");
+  PRINT("-username : sets the MQTT username\n");
+  PRINT("-pwd : sets the MQTT password\n");
+#endif
+  exit(0);
+}
+
+/**
+ * @brief main application.
+ * initializes the global variables
+ * registers and starts the handler
+ * handles (in a loop) the next event.
+ * shuts down the stack
+ */
+int
+main(int argc, char *argv[])
+{
+  oc_clock_time_t next_event;
+  bool do_send_s_mode = false;
+#ifdef APP_BENCH
+  long bench_iterations = 0;
+  int bench_count = 0;
+  int bench_array = 1;
+  const char *replay_file = NULL;
+#endif
+
+
+#ifdef HARDWARE_INIT
+  hardware_init();
+#endif /* hardware init */
+
+
+#ifdef KNX_GUI
+  WinMain(GetModuleHandle(NULL), NULL, (LPSTR)GetCommandLine(), SW_SHOWNORMAL);
+#endif /* KNX_GUI */
+
+#ifdef WIN32
+  /* windows specific */
+  InitializeCriticalSection(&cs);
+  InitializeConditionVariable(&cv);
+  /* install Ctrl-C */
+  signal(SIGINT, handle_signal);
+#endif /* WIN32 */
+#ifdef __linux__
+  /* Linux specific */
+  struct sigaction sa;
+  sigfillset(&sa.sa_mask);
+  sa.sa_flags = 0;
+  sa.sa_handler = handle_signal;
+  /* install Ctrl-C */
+  sigaction(SIGINT, &sa, NULL);
+  #define MAX_HOSTNAME 256
+  char hostname[MAX_HOSTNAME];
+  // set the hostname
+  ret = gethostname(&hostname[0], MAX_HOSTNAME);
+  if (ret != -1) {
+    printf("Hostname:    %s\n", hostname);
+    oc_core_set_device_hostname(0, hostname, MAX_HOSTNAME);
+  }
+#endif  /* __linux__ */
+
+  for (int i = 0; i < argc; i++) {
+    PRINT_APP("argv[%d] = %s\n", i, argv[i]);
+    if (strcmp(argv[i], "-help") == 0) {
+      print_usage();
+    }
+    if (strcmp(argv[i], "reset") == 0) {
+      PRINT(" internal reset\n");
+      g_reset = true;
+    }
+    if (strcmp(argv[i], "-s") == 0) {
+      if (i + 1 < argc) {
+        // serial number
+        PRINT("serial number %s\n", argv[i + 1]);
+        app_set_serial_number(argv[i + 1]);
+      } else {
+        PRINT("ERROR: \"-s\" flag detected, but no serial number provided!\n");
+      }
+    }
+#if APP_MAX_DEVICES > 1
+    if (strcmp(argv[i], "-n") == 0) {
+      if (i + 1 < argc) {
+        PRINT("number of devices %s\n", argv[i + 1]);
+        app_set_num_devices(atoi(argv[i + 1]));
+      } else {
+        PRINT("ERROR: \"-n\" flag detected, but no count provided!\n");
+      }
+    }
+#endif
+#ifdef APP_BENCH
+    if (strcmp(argv[i], "-bench") == 0) {
+      bench_iterations = (i + 1 < argc) ? atol(argv[i + 1]) : 0;
+      bench_count = (i + 2 < argc) ? atoi(argv[i + 2]) : 0;
+      bench_array = (i + 3 < argc) ? atoi(argv[i + 3]) : 1;
+      if (bench_iterations <= 0) {
+        bench_iterations = 10000;
+      }
+    }
+    if (strcmp(argv[i], "-replay") == 0) {
+      if (i + 1 < argc) {
+        replay_file = argv[i + 1];
+      } else {
+        PRINT("ERROR: \"-replay\" flag detected, but no file provided!\n");
+      }
+    }
+#endif
+#ifdef MQTT_PROXY
+      if (strcmp(argv[i], "-host") == 0) {
+        if (i + 1 < argc) {
+          // hostname for MQTT proxy server
+          PRINT("MQTT proxy host %s\n", argv[i + 1]);
+          strncpy(g_mqttconf_server, argv[i + 1], sizeof(g_mqttconf_server));
+        } else {
+          PRINT("ERROR: \"-host\" flag detected, but no hostname provided!\n");
+        }
+      }
+      if (strcmp(argv[i], "-port") == 0) {
+        if (i + 1 < argc) {
+          // port number for MQTT proxy server
+          PRINT("MQTT proxy port number %s\n", argv[i + 1]);
+          g_mqttconf_port = atoi(argv[i + 1]);
+        } else {
+          PRINT("ERROR: \"-port\" flag detected, but no port number provided!\n");
+        }
+      }
+      if (strcmp(argv[i], "-username") == 0) {
+        if (i + 1 < argc) {
+          // username for MQTT proxy server
+          PRINT("MQTT proxy username %s\n", argv[i + 1]);
+          strncpy(g_mqttconf_username, argv[i + 1], sizeof(g_mqttconf_username));
+        } else {
+          PRINT("ERROR: \"-username\" flag detected, but no username provided!\n");
+        }
+      }
+      if (strcmp(argv[i], "-pwd") == 0) {
+        if (i + 1 < argc) {
+          // password for MQTT proxy server
+          PRINT("MQTT proxy pwd %s\n", argv[i + 1]);
+          strncpy(g_mqttconf_pwd, argv[i + 1], sizeof(g_mqttconf_pwd));
+        } else {
+          PRINT("ERROR: \"-pwd\" flag detected, but no password provided!\n");
+        }
+      }
+#endif
+  }
+
+#if APP_LOOP_TICKLESS
+  /* before the stack starts: signal_event_loop uses the wake event */
+  if (!loop_open()) {
+    APP_LOG_ERR(" loop: no tickless loop, waiting on the condition variable\n");
+  }
+#endif
+
+  /* do all initialization */
+  app_initialize_stack();
+
+#ifdef APP_BENCH
+  if (bench_iterations > 0) {
+    app_bench_run(bench_iterations, bench_count, bench_array);
+    oc_main_shutdown();
+    return 0;
+  }
+  if (replay_file) {
+    int result = app_replay_run(replay_file);
+    oc_main_shutdown();
+    return result;
+  }
+#endif
+
+#if defined(MQTT_PROXY) && APP_MQTT_CLIENT
+  if (g_mqtt_transport == NULL) {
+    /* the application did not set its own client */
+    app_mqtt_start_client();
+  }
+#endif
+
+#if APP_LOOP_TICKLESS
+  if (loop_is_open()) {
+    loop_run();
+  }
+#endif
+
+#ifdef WIN32
+  /* windows specific loop */
+  while (quit != 1) {
+    app_event_process();
+    next_event = oc_main_poll();
+    if (next_event == 0) {
+      SleepConditionVariableCS(&cv, &cs, INFINITE);
+    } else {
+      oc_clock_time_t now = oc_clock_time();
+      if (now < next_event) {
+        SleepConditionVariableCS(
+          &cv, &cs, (DWORD)((next_event - now) * 1000 / OC_CLOCK_SECOND));
+      }
+    }
+  }
+#endif /* WIN32 */
+
+#ifdef __linux__
+  /* Linux specific loop */
+  while (quit != 1) {
+    /* a signal from now on wakes up the next wait */
+    EVENT_XCHG(&g_loop_signalled, 0);
+    app_event_process();
+    next_event = oc_main_poll();
+    pthread_mutex_lock(&mutex);
+    if (EVENT_LOAD(&g_loop_signalled) != 0) {
+      /* signalled during the poll */
+    } else if (next_event == 0) {
+      pthread_cond_wait(&cv, &mutex);
+    } else {
+      ts.tv_sec = (next_event / OC_CLOCK_SECOND);
+      ts.tv_nsec = (long)((uint64_t)(next_event % OC_CLOCK_SECOND) * 1000000000u / OC_CLOCK_SECOND);
+      pthread_cond_timedwait(&cv, &mutex, &ts);
+    }
+    pthread_mutex_unlock(&mutex);
+  }
+#endif /* __linux__ */
+
+  /* store pending data */
+  app_persist_flush();
+  /* shut down the stack */
+  oc_main_shutdown();
+  return 0;
+}
+#endif /* NO_MAIN */
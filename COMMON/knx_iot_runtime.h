@@ -0,0 +1,1726 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2022-2024 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+*/
+/**
+ * @file
+ *
+ * shared data point runtime of the generated applications.
+ *
+ * The runtime implements the GET/PUT handlers, the codecs, persistence,
+ * s-mode outbox, device instances and the metrics for all data points.
+ * It is type generic: every DPT is described by a struct datapoint_type_t
+ * with its size, CBOR field layout and default value.
+ *
+ * A generated application only emits its tables (g_datapoints,
+ * g_parameters, g_url_index, g_datapoint_types, g_datapoint_state,
+ * g_dp_scratch and g_app_info) and the typed wrappers of its DPTs with
+ * APP_DPT_API.
+ */
+#ifndef KNX_IOT_RUNTIME_H
+#define KNX_IOT_RUNTIME_H
+
+#include <stddef.h>
+#include "oc_api.h"
+#include "oc_core_res.h"
+#include "port/oc_clock.h"
+#include "knx_iot_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM) || defined(__TI_ARM__)
+#define PACKED __attribute__((__packed__)) //!< Helper macro to create smaller packed structs
+#else
+#define PACKED //!< Helper macro to create smaller packed structs
+#endif
+
+#define THIS_DEVICE 0 //!< single device instance, e.g. number 0
+
+/**
+ * @brief the data types of the data points
+ * the generic rows are followed by the DPTs of the application, starting at
+ * DatapointType_APP_FIRST and ending with DatapointType_MAX_NUM.
+ */
+enum {
+  DatapointType_bool,
+  DatapointType_int,
+  DatapointType_float,
+  DatapointType_string,
+  DatapointType_APP_FIRST,
+};
+typedef int DatapointType;
+
+/**
+ * @brief kind of a field of a DPT, selects the CBOR and text encoding
+ */
+typedef enum dpt_field_kind_t {
+  DPT_FIELD_BOOL,  /**< bool, CBOR boolean */
+  DPT_FIELD_INT,   /**< signed integer or enumeration, CBOR integer */
+  DPT_FIELD_UINT,  /**< unsigned integer, CBOR integer */
+  DPT_FIELD_FLOAT, /**< float or double, CBOR floating point */
+} dpt_field_kind_t;
+
+/**
+ * @brief a field of a DPT
+ */
+typedef struct dpt_field_t {
+  uint16_t offset; /**< offset of the member in the DPT */
+  uint8_t size;    /**< size of the member: 1, 2, 4 or 8 */
+  uint8_t kind;    /**< dpt_field_kind_t */
+} dpt_field_t;
+
+/** @brief field for member of struct DPT T */
+#define DPT_FIELD(T, member, kind) \
+  { (uint16_t)offsetof(T, member), (uint8_t)sizeof(((T *)0)->member), (kind) }
+/** @brief the single field of a DPT that is a typedef of a scalar */
+#define DPT_SCALAR(T, kind) { 0, (uint8_t)sizeof(T), (kind) }
+
+#ifndef APP_DPT_FUNCTION_TABLE
+/**
+ * @brief the descriptors carry specialised codecs of their DPT (encode and
+ * parse), called instead of walking the field layout. The layout remains the
+ * fallback, e.g. for other encodings of the value.
+ * Costs flash per DPT; knx_iot_bench compares both paths.
+ */
+#define APP_DPT_FUNCTION_TABLE 0
+#endif
+
+#if APP_DPT_FUNCTION_TABLE
+/** encodes "1: value" in the map parent */
+typedef void (*dpt_encode_fn_t)(CborEncoder *parent, const void *in);
+/** parses the value of key 1, false to fall back to the field layout */
+typedef bool (*dpt_parse_fn_t)(const oc_rep_t *rep, void *out);
+
+/** @brief the specialised codecs of T, at the end of the descriptor */
+#define DPT_CODECS(T) , dpt_encode_##T, dpt_parse_##T
+
+/** @brief specialised codecs of a DPT that is a typedef of a scalar, kind is
+ * BOOL, INT, UINT or FLOAT as in dpt_field_kind_t */
+#define DPT_SCALAR_CODECS(T, kind) \
+  static void dpt_encode_##T(CborEncoder *parent, const void *in) \
+  { oc_rep_i_set_key(parent, 1); DPT_ENCODE_##kind(parent, *(const T *)in); } \
+  static bool dpt_parse_##T(const oc_rep_t *rep, void *out) \
+  { DPT_PARSE_##kind(rep, *(T *)out); }
+
+#define DPT_ENCODE_BOOL(e, v) g_err |= cbor_encode_boolean(e, (v) != 0)
+#define DPT_ENCODE_INT(e, v) g_err |= cbor_encode_int(e, (int64_t)(v))
+#define DPT_ENCODE_UINT(e, v) g_err |= cbor_encode_int(e, (int64_t)(v))
+#define DPT_ENCODE_FLOAT(e, v) g_err |= cbor_encode_double(e, (double)(v))
+#define DPT_PARSE_BOOL(rep, v) \
+  if (rep->type != OC_REP_BOOL) return false; \
+  v = rep->value.boolean; return true;
+#define DPT_PARSE_INT(rep, v) \
+  if (rep->type != OC_REP_INT) return false; \
+  v = rep->value.integer; return true;
+#define DPT_PARSE_UINT(rep, v) DPT_PARSE_INT(rep, v)
+#define DPT_PARSE_FLOAT(rep, v) \
+  if (rep->type == OC_REP_DOUBLE) { v = rep->value.double_p; return true; } \
+  if (rep->type != OC_REP_INT) return false; \
+  v = rep->value.integer; return true;
+#else
+#define DPT_CODECS(T)
+#define DPT_SCALAR_CODECS(T, kind)
+#endif
+
+/**
+ * @brief descriptor of a data type
+ *
+ * The value is encoded with key 1:
+ * - one field: `1: value`
+ * - more fields: `1: [value, value, ...]`
+ * - num_bools leading bool fields, followed by other fields:
+ *   `1: [[bool, bool], value, ...]`
+ *
+ * The generic rows (bool, int, float, string) have no fields, and no codecs.
+ */
+struct datapoint_type_t {
+  size_t size;               /**< size of the type */
+  const dpt_field_t *fields; /**< the fields, in encoding order */
+  uint8_t num_fields;        /**< number of fields, 0 = no codecs */
+  uint8_t num_bools;         /**< leading bool fields encoded as nested array */
+  const void *default_value; /**< the default value, NULL if none */
+#if APP_DPT_FUNCTION_TABLE
+  dpt_encode_fn_t encode;    /**< specialised encoder, NULL = field layout */
+  dpt_parse_fn_t parse;      /**< specialised parser, NULL = field layout */
+#endif
+};
+
+/** @brief rows of the generic types, the start of g_datapoint_types */
+#define DATAPOINT_TYPE_GENERIC_ROWS \
+  { sizeof(bool) }, { sizeof(int) }, { sizeof(float) }, { sizeof(char *) }
+
+typedef struct datapoint_t {
+  oc_resource_t resource;
+  const char *const *metadata;
+  const char *feedback_url;
+  DatapointType type;
+  void *g_var;
+  volatile void *g_fault;
+  bool persistent;
+  bool default_present;
+  int num_elements;
+} datapoint_t;
+
+/**
+ * @brief entry of the url lookup index
+ *
+ * the suffix is the url without the leading "/p/", e.g. "o_1_1" or "p_1_1"
+ */
+typedef struct url_index_entry_t
+{
+  const char *suffix;        /**< url suffix (after "/p/") */
+  const datapoint_t *dp;     /**< the datapoint or parameter */
+} url_index_entry_t;
+
+/**
+ * @brief scratch areas for the value of a single GET or PUT request
+ *
+ * sized by the application for the largest data point (num_elements * size
+ * of the type), so that the request path does not need any heap allocations
+ */
+typedef struct app_scratch_t
+{
+  void *get;   /**< scratch area used by oc_encode_datapoint */
+  void *put;   /**< scratch area used by put_generic */
+  size_t size; /**< size of each area */
+} app_scratch_t;
+
+/**
+ * @brief the device information of the application
+ */
+typedef struct app_info_t
+{
+  const char *name;     /**< name of the device */
+  const char *model;    /**< device model */
+  const char *password; /**< default spake password */
+  const char *storage;  /**< prefix of the storage folder, e.g. "knx_iot_example" */
+  void (*init)(void);   /**< called at the end of app_init, may be NULL */
+} app_info_t;
+
+/* all data points */
+extern const datapoint_t g_datapoints[];
+extern const size_t num_datapoints;
+
+/* all parameters */
+extern const datapoint_t g_parameters[];
+extern const size_t num_parameters;
+
+/* url index over the data points and parameters, sorted on the suffix */
+extern const url_index_entry_t g_url_index[];
+extern const size_t g_url_index_size;
+
+/* descriptors, indexed with DatapointType */
+extern const struct datapoint_type_t g_datapoint_types[];
+extern const size_t num_datapoint_types;
+
+extern const app_scratch_t g_dp_scratch;
+extern const app_info_t g_app_info;
+extern char g_serial_number[20];
+
+/**
+ * @brief Returns the datapoint for the given URL
+ *
+ * Looks up data points (/p/o) and parameters (/p/p) in a sorted index,
+ * using a binary search.
+ *
+ * @param url URL of the datapoint
+ * @return the datapoint, or NULL if the URL is not found
+ */
+const datapoint_t *get_datapoint_by_url(const char *url);
+
+/**
+ * @brief Returns the url of the module by instance
+ *
+ * @param out_url URL of the datapoint given back (e.g. with the corrected post fix)
+ * @param in_url URL of the datapoint of the module
+ * @param module_index URL the module index
+ * @return false if operation successful, true if something went wrong
+ */
+bool get_module_url(char* out_url, const char* in_url, int module_index);
+
+/**
+ * @brief size of a data type
+ *
+ * @param t the type
+ * @return the size, 0 for unknown types
+ */
+size_t get_dpt_size(DatapointType t);
+
+/**
+ * Callback invoked by the stack when a successful put is done
+ *
+ * @param[in] url the url of the put
+ *
+ */
+typedef void (*oc_put_cb_t)(const char* url);
+
+/**
+ * @brief The put callback
+ *
+ */
+typedef struct oc_put_struct_t
+{
+  oc_put_cb_t cb; /**< the put callback, e.g. when something has changed */
+} oc_put_struct_t;
+
+/**
+ * @brief set the put callback (on application level)
+ * 
+ * @param cb the callback
+ */
+
+void app_set_put_cb(oc_put_cb_t cb);
+/**
+ * Callback invoked by the stack when a successful put is done
+ *
+ * @param[in] url the url of the put
+ *
+ */
+typedef void (*oc_get_cb_t)(const char* url);
+
+/**
+ * @brief The get callback
+ *
+ */
+typedef struct oc_get_struct_t
+{
+  oc_get_cb_t cb; /**< the get callback, e.g. when something has changed */
+} oc_get_struct_t;
+
+/**
+ * @brief set the get callback (on application level)
+ * 
+ * @param cb the callback
+ */
+void app_set_get_cb(oc_get_cb_t cb);
+
+/**
+ * Callback invoked when the stack needs an oc_main_poll, e.g. new network
+ * data arrived or a new timer is set.
+ * Can be called from any thread.
+ */
+typedef void (*app_signal_cb_t)(void);
+
+/**
+ * @brief set the event loop signal callback
+ * for applications that run their own event loop around oc_main_poll,
+ * e.g. the GUI
+ *
+ * @param cb the callback, NULL to remove
+ */
+void app_set_signal_event_loop_cb(app_signal_cb_t cb);
+
+/**
+ * @brief initialize the stack
+ * 
+ * @return int 0 == success
+ */
+int app_initialize_stack();
+
+/**
+ * @brief sets the serial number
+ * should be called before app_initialize_stack()
+ * 
+ * @param serial_number the serial number as string
+ * @return int 0 == success
+ */
+int app_set_serial_number(const char* serial_number);
+
+/**
+ * @brief Gets the number of elements in dp/param array
+ * 
+ * @param url the url to check
+ * @return int 0 if not an array endpoint, else length of array
+ */
+int app_get_url_array_size(const char *url);
+
+
+/////// Type generic data point functions ///////
+
+/**
+ * @brief Checks if the url depicts a data point of type t
+ *
+ * @param[in] url the url
+ * @param[in] t the type
+ * @return true: url conveys a t
+ */
+bool app_is_dpt_url(const char *url, DatapointType t);
+
+/**
+ * @brief Set a data point to the default value of its type
+ * Nothing is done if the type has no default value.
+ *
+ * @param[in] url the url of the data point
+ */
+void app_set_dpt_default_value(const char *url);
+
+/**
+ * @brief Set part of a data point array
+ * If n would overflow the array then it is limited to the size
+ * of the array variable. If start > array size then nothing happens.
+ *
+ * @param[in] url the url of the data point
+ * @param[in] in the values to copy, of the type of the data point.
+ * Can be the global variable itself
+ * @param[in] start starting index to write to array
+ * @param[in] n number of elements to write to array
+ * @param[in] store_persistently Whether or not the value should also be stored in persistent store.
+ */
+void app_set_array_elems(const char *url, const void *in, int start, int n, bool store_persistently);
+
+/**
+ * @brief Get part of a data point array
+ *
+ * @param[in] url the url of the data point
+ * @param[out] out the values to copy out to
+ * If NULL, won't copy but return the global variable if available
+ * @param[in] start starting index in global array to copy
+ * @param[in] n number of elements to copy
+ * @return pointer to the (copied) values <br>
+ * If out is NULL then the global variable for url if not
+ * flash only for this datapoint/param <br>
+ * If the variable is flash only then it will return out <br>
+ * If an error occurs while getting the variable, returns NULL
+ */
+const void *app_get_array_elems(const char *url, void *out, int start, int n);
+
+/**
+ * @brief Parse a value of type t from oc_rep_t
+ *
+ * @param[in] t the type
+ * @param[in] rep The oc_rep_t* from which to parse, the value has key 1
+ * @param[out] out The value to store into
+ * @return true: successfully parsed
+ */
+bool oc_parse_dpt(DatapointType t, oc_rep_t *rep, void *out);
+
+/**
+ * @brief Parse an array of type t from oc_rep_t
+ *
+ * @param[in] t the type
+ * @param[in] rep The oc_rep_t* from which to parse, one object per element
+ * @param[out] out The array to store into
+ * @param[in] n The number of elements
+ * @return true: successfully parsed
+ */
+bool oc_parse_dpt_array(DatapointType t, oc_rep_t *rep, void *out, int n);
+
+/**
+ * @brief Encode a value of type t using oc_rep
+ *
+ * @param[in] t the type
+ * @param[in] in The value to encode
+ * @param[in] is_metadata Whether function is called during metadata query handling
+ * @return false if the type has no codec
+ */
+bool oc_encode_dpt(DatapointType t, const void *in, bool is_metadata);
+
+/**
+ * @brief Encode an array of type t using oc_rep
+ *
+ * @param[in] t the type
+ * @param[in] in The array to encode
+ * @param[in] n The number of elements
+ * @return false if the type has no codec
+ */
+bool oc_encode_dpt_array(DatapointType t, const void *in, int n);
+
+/**
+ * @brief Store an array of type t into persistent memory
+ *
+ * @param[in] t the type
+ * @param[in] name name of entry to store
+ * @param[in] in the array to store
+ * @param[in] n number of elements to store
+ */
+void persistent_store_dpt_array(DatapointType t, const char *name, const void *in, int n);
+
+/**
+ * @brief Load an array of type t from persistent memory
+ *
+ * @param[in] t the type
+ * @param[in] name name of entry to load
+ * @param[out] out the array to load into
+ * @param[in] n number of elements in array
+ * @return true on success, false otherwise
+ */
+bool persistent_load_dpt_array(DatapointType t, const char *name, void *out, int n);
+
+/**
+ * @brief Get a value of type t as string, e.g. " 1  0 "
+ *
+ * @param[in] t the type
+ * @param[in] in the value
+ * @param[in] text reserved space to copy the generated text too
+ * @param[in] size size of the allocated text
+ * @return 0 on success
+ */
+int app_sprintf_dpt(DatapointType t, const void *in, char *text, int size);
+
+/**
+ * @brief Get a value of type t from a string, one token per field
+ *
+ * @param[in] t the type
+ * @param[out] in the value
+ * @param[in] text the input string
+ * @return 0 on success
+ */
+int app_sscanf_dpt(DatapointType t, void *in, char *text);
+
+/**
+ * @brief Appends the expected string of type t
+ *
+ * @param[in] t the type
+ * @param[in] select 1 = format, 2 = example
+ * @param[in] text the string to append to
+ * @return 0 on success
+ */
+int app_str_expected_dpt(DatapointType t, int select, char *text);
+
+/**
+ * @brief typed getters/setters and other functions for DPT T
+ * expanded once per DPT in the header of the application, the functions
+ * call the type generic functions above.
+ *
+ * ~~~{.c}
+ * DPT_Switch my_var = true;
+ * app_set_DPT_Switch_variable("/some/url", &my_var);
+ * if (app_get_DPT_Switch_variable("/some/url", &my_var) == NULL) {
+ *   //Something went wrong
+ *   return;
+ * }
+ * ~~~
+ */
+#define APP_DPT_API(T) \
+  static inline bool app_is_##T##_url(const char *url) \
+  { return app_is_dpt_url(url, DatapointType_##T); } \
+  static inline void app_set_##T##_default_value(const char *url) \
+  { app_set_dpt_default_value(url); } \
+  static inline void app_set_##T##_array_elems(const char *url, const T *in, int start, int n, bool store_persistently) \
+  { app_set_array_elems(url, in, start, n, store_persistently); } \
+  static inline void app_set_##T##_array(const char *url, const T *in, int n, bool store_persistently) \
+  { app_set_array_elems(url, in, 0, n, store_persistently); } \
+  static inline void app_set_##T##_variable(const char *url, const T *in) \
+  { app_set_array_elems(url, in, 0, 1, true); } \
+  static inline const T *app_get_##T##_array_elems(const char *url, T *out, int start, int n) \
+  { return (const T *)app_get_array_elems(url, out, start, n); } \
+  static inline const T *app_get_##T##_array(const char *url, T *out, int n) \
+  { return (const T *)app_get_array_elems(url, out, 0, n); } \
+  static inline const T *app_get_##T##_variable(const char *url, T *out) \
+  { return (const T *)app_get_array_elems(url, out, 0, 1); } \
+  static inline bool oc_parse_##T(oc_rep_t *rep, T *out) \
+  { return oc_parse_dpt(DatapointType_##T, rep, out); } \
+  static inline bool oc_parse_##T##_array(oc_rep_t *rep, T *out, int n) \
+  { return oc_parse_dpt_array(DatapointType_##T, rep, out, n); } \
+  static inline void oc_encode_##T(const T *in, bool is_metadata) \
+  { oc_encode_dpt(DatapointType_##T, in, is_metadata); } \
+  static inline void oc_encode_##T##_array(const T *in, int n) \
+  { oc_encode_dpt_array(DatapointType_##T, in, n); } \
+  static inline void persistent_store_##T(const char *name, const T *in) \
+  { persistent_store_dpt_array(DatapointType_##T, name, in, 1); } \
+  static inline void persistent_store_##T##_array(const char *name, const T *in, int n) \
+  { persistent_store_dpt_array(DatapointType_##T, name, in, n); } \
+  static inline bool persistent_load_##T(const char *name, T *out) \
+  { return persistent_load_dpt_array(DatapointType_##T, name, out, 1); } \
+  static inline bool persistent_load_##T##_array(const char *name, T *out, int n) \
+  { return persistent_load_dpt_array(DatapointType_##T, name, out, n); } \
+  static inline int app_sprintf_##T(const T *in, char *text, int size) \
+  { return app_sprintf_dpt(DatapointType_##T, in, text, size); } \
+  static inline int app_sscanf_##T(T *in, char *text) \
+  { return app_sscanf_dpt(DatapointType_##T, in, text); } \
+  static inline int app_str_expected_##T(int select, char *text) \
+  { return app_str_expected_dpt(DatapointType_##T, select, text); }
+
+
+// Getters/Setters for bool
+/**
+ * @brief Checks if the url depicts a bool
+ * 
+ * @param url the url 
+ * @return true: url conveys a bool
+ */
+bool app_is_bool_url(const char* url);
+
+/**
+ * @brief Set a bool
+ * 
+ * @param url the url for the bool to set
+ * @param value value to set
+ */
+void app_set_bool_variable(const char* url, bool value);
+
+/**
+ * @brief Get a bool
+ * 
+ * @param url the url for the bool to get
+ * @return boolean variable
+ */
+bool app_retrieve_bool_variable(const char *url);
+ 
+/**
+ * @brief Get a int
+ * 
+ * @param url the url for the int to get
+ * @param value the value to be used for the return value
+ * @return bool, true, value is set
+ */
+bool app_retrieve_int_variable(const char* url, int* value);
+ 
+ 
+/**
+ * @brief checks if the url represents a parameter
+ *
+ * @param url the url
+ * @return true the url represents a parameter
+ */
+bool app_is_url_parameter(const char* url);
+
+/**
+ * @brief retrieves the url of a parameter
+ * index starts at 1
+ * @param index the index to retrieve the url from
+ * @return the url or NULL
+ */
+const char* app_get_parameter_url(int index);
+
+/**
+ * @brief retrieves the name of a parameter
+ * index starts at 1
+ * @param index the index to retrieve the parameter name from
+ * @return the name or NULL
+ */
+const char* app_get_parameter_name(int index);
+
+/**
+ * @brief sets the fault state of the url/data point 
+ * the caller needs to know if the resource/data point implements a fault situation
+ * 
+ * @param url the url of the resource/data point
+ * @param value the boolean fault value to be set
+ */
+void app_set_fault_variable(const char* url, bool value);
+
+/**
+ * @brief checks if the url is in use (e.g. used in the Group Object Table)
+ * 
+ * @param url the url of the resource/data point
+ * @return true: entry in Group Object Table has the URL
+ * @return false: No entry in Group Object Table has the URL
+ */
+bool app_is_url_in_use(const char* url);
+
+/**
+ * @brief function to report if the (oscore) security is turn on for this instance
+ * 
+ * @return true is secure
+ * @return false is not secure
+ */
+bool app_is_secure();
+
+/**
+ * @brief retrieves the password for showing on screen
+ * 
+ * @return password (as string)
+ */
+const char* app_get_password();
+
+/**
+ * @brief function to set the input string to upper case
+ *
+ * @param str the string to make upper case
+ *
+ */
+void app_str_to_upper(char *str);
+
+/////// Paged storage ///////
+
+#ifndef APP_PERSIST_CHUNK_BYTES
+/**
+ * @brief maximum size of a storage record of a persistent data point.
+ * Arrays are stored as fixed width elements in records of this size,
+ * so that a range of elements can be read or written without touching
+ * the rest of the array. Must be at least the size of the largest DPT.
+ */
+#define APP_PERSIST_CHUNK_BYTES 64
+#endif
+
+/**
+ * @brief store the elements [start, start+n) of a persistent array
+ * Only the records holding these elements are written.
+ *
+ * @param url the url of the data point
+ * @param in the elements to store
+ * @param elem_size size of one element
+ * @param total number of elements of the array
+ * @param start the first element to store
+ * @param n the number of elements to store
+ * @return true on success
+ */
+bool persistent_store_elems(const char *url, const void *in, size_t elem_size, int total, int start, int n);
+
+/**
+ * @brief load the elements [start, start+n) of a persistent array
+ * Only the records holding these elements are read.
+ *
+ * @param url the url of the data point
+ * @param out the loaded elements
+ * @param elem_size size of one element
+ * @param total number of elements of the array
+ * @param start the first element to load
+ * @param n the number of elements to load
+ * @return true on success, false if (part of) the data is not stored
+ */
+bool persistent_load_elems(const char *url, void *out, size_t elem_size, int total, int start, int n);
+
+/**
+ * @brief erase all records of a persistent array
+ *
+ * @param url the url of the data point
+ * @param elem_size size of one element
+ * @param total number of elements of the array
+ */
+void persistent_erase_elems(const char *url, size_t elem_size, int total);
+
+/////// Deferred persistence ///////
+
+#ifndef APP_PERSIST_WINDOW_S
+/**
+ * @brief default window (in seconds) in which writes to persistent data points
+ * are coalesced, before the data is written to storage.
+ * Window 0 writes directly to storage.
+ */
+#define APP_PERSIST_WINDOW_S 2
+#endif
+
+#ifndef APP_PERSIST_SNAPSHOT
+/**
+ * @brief store all persistent data points in one snapshot record, so that
+ * they are loaded with a single read at start up and a flush is one write.
+ * The individual records are only written while no valid snapshot exists,
+ * and are used for data points missing in the snapshot.
+ * Off by default: the whole record is rewritten on every flush.
+ */
+#define APP_PERSIST_SNAPSHOT 0
+#endif
+
+#ifndef APP_PERSIST_SNAPSHOT_BYTES
+/**
+ * @brief size of the static buffer holding the snapshot record.
+ * When the persistent data points do not fit, the individual records are used.
+ */
+#define APP_PERSIST_SNAPSHOT_BYTES 512
+#endif
+
+/**
+ * @brief statistics of the deferred persistence
+ */
+typedef struct app_persist_stats_t
+{
+  uint32_t requested;    /**< number of store requests */
+  uint32_t written;      /**< number of records written to storage */
+  uint32_t saved;        /**< number of writes saved by coalescing */
+  uint32_t flushes;      /**< number of flushes that wrote data */
+  uint32_t last_flush_ms; /**< duration of the last flush in ms */
+  uint32_t max_flush_ms; /**< longest flush in ms */
+} app_persist_stats_t;
+
+/**
+ * @brief mark a persistent data point as changed
+ * The value (dp->g_var) is written to storage when the coalescing window
+ * expires, or when app_persist_flush() is called.
+ *
+ * @param dp the data point
+ */
+void app_persist_mark_dirty(const datapoint_t *dp);
+
+/**
+ * @brief write all changed persistent data points to storage
+ * To be called before sleeping or resetting the device.
+ */
+void app_persist_flush(void);
+
+/**
+ * @brief checks if there are changed data points not yet written to storage
+ *
+ * @return true data is pending
+ * @return false all data is written
+ */
+bool app_persist_is_pending(void);
+
+/**
+ * @brief callback to save application state in app_persist_flush()
+ */
+typedef void (*app_persist_flush_cb_t)(void);
+
+/**
+ * @brief sets the callback that is called on each app_persist_flush(),
+ * e.g. before sleeping, so that application state (not in data points)
+ * is saved at the same moments
+ *
+ * @param cb the callback, NULL to remove it
+ */
+void app_persist_set_flush_cb(app_persist_flush_cb_t cb);
+
+/**
+ * @brief sets the coalescing window
+ *
+ * @param seconds the window in seconds, 0 = write directly to storage
+ */
+void app_persist_set_window(uint16_t seconds);
+
+/**
+ * @brief retrieves the statistics of the deferred persistence
+ *
+ * @return the statistics
+ */
+const app_persist_stats_t *app_persist_get_stats(void);
+
+/////// S-mode outbox ///////
+
+#ifndef APP_SMODE_WINDOW_MS
+/**
+ * @brief default window (in ms) in which s-mode messages are collected before
+ * they are sent as one batch.
+ * Window 0 sends the messages directly.
+ */
+#define APP_SMODE_WINDOW_MS 20
+#endif
+
+#ifndef APP_SMODE_PACE_MS
+/**
+ * @brief default interval (in ms) between the messages of a batch.
+ * 0 sends the whole batch at once.
+ */
+#define APP_SMODE_PACE_MS 5
+#endif
+
+#ifndef APP_SMODE_OUTBOX_SIZE
+/**
+ * @brief number of s-mode messages the outbox can hold
+ */
+#define APP_SMODE_OUTBOX_SIZE 8
+#endif
+
+/**
+ * @brief statistics of the s-mode outbox
+ */
+typedef struct app_smode_stats_t
+{
+  uint32_t requested;    /**< number of messages queued */
+  uint32_t sent;         /**< number of messages sent */
+  uint32_t deduplicated; /**< messages merged with a queued message of the same url */
+  uint32_t overflows;    /**< messages sent unbatched because the outbox was full */
+  uint32_t dropped;      /**< queued messages discarded by a reset */
+  uint32_t batches;      /**< number of batches sent */
+  uint32_t max_depth;    /**< highest number of queued messages */
+} app_smode_stats_t;
+
+/**
+ * @brief queue an s-mode message for the url
+ * The value is read when the message is sent, so repeated updates of the same
+ * url within the window result in a single message with the last value.
+ *
+ * @param scope the scope of the message
+ * @param url the url of the data point (must stay valid, e.g. URL_ define)
+ * @param rp the s-mode flags, e.g. "w"
+ */
+void app_smode_send(uint8_t scope, const char *url, const char *rp);
+
+/**
+ * @brief send all queued s-mode messages now
+ */
+void app_smode_flush(void);
+
+/**
+ * @brief sets the timing of the outbox
+ *
+ * @param window_ms collection window in ms, 0 = send directly
+ * @param pace_ms interval between messages of a batch, 0 = no pacing
+ */
+void app_smode_set_timing(uint16_t window_ms, uint16_t pace_ms);
+
+/**
+ * @brief number of queued s-mode messages
+ */
+int app_smode_get_depth(void);
+
+/**
+ * @brief retrieves the statistics of the s-mode outbox
+ *
+ * @return the statistics
+ */
+const app_smode_stats_t *app_smode_get_stats(void);
+
+/////// S-mode receive ///////
+
+#ifndef APP_SMODE_FAST_PATH
+/**
+ * @brief handle redirected s-mode writes of scalar data points with a group
+ * object table entry on a fast path.
+ * The data point, its codec and its feedback data point are bound when the
+ * group object table changes; a write is parsed without query parsing and is
+ * applied directly to the global variable. Storing and notifying are left to
+ * the persistence and observe schedulers.
+ * 0 = all writes use the generic PUT handler.
+ */
+#define APP_SMODE_FAST_PATH 1
+#endif
+
+/**
+ * @brief statistics of the received s-mode writes
+ * see app_metrics_t for the latency of both paths
+ */
+typedef struct app_smode_rx_stats_t
+{
+  uint32_t fast;     /**< writes handled on the fast path */
+  uint32_t slow;     /**< redirected writes handled by the generic PUT handler */
+  uint32_t rejected; /**< fast path writes with a payload that could not be parsed */
+} app_smode_rx_stats_t;
+
+/**
+ * @brief retrieves the statistics of the received s-mode writes
+ *
+ * @return the statistics
+ */
+const app_smode_rx_stats_t *app_smode_get_rx_stats(void);
+
+/////// Observe scheduler ///////
+
+#ifndef APP_OBSERVE_INTERVAL_MS
+/**
+ * @brief default minimum interval (in ms) between two notifications of the
+ * observers of a data point.
+ * Changes within the interval are coalesced into one notification with the
+ * last value. Interval 0 notifies every change directly.
+ */
+#define APP_OBSERVE_INTERVAL_MS 100
+#endif
+
+/**
+ * @brief statistics of the observe scheduler
+ */
+typedef struct app_observe_stats_t
+{
+  uint32_t requested; /**< number of changes of observable data points */
+  uint32_t sent;      /**< number of notifications sent */
+  uint32_t coalesced; /**< changes merged with a pending notification */
+} app_observe_stats_t;
+
+/**
+ * @brief notify the observers of the data point
+ * Called by the runtime after a changed value is applied. Within the
+ * interval after the last notification the notification is delayed, and
+ * further changes are coalesced.
+ *
+ * @param dp the data point
+ */
+void app_observe_notify(const datapoint_t *dp);
+
+/**
+ * @brief send all pending notifications now
+ */
+void app_observe_flush(void);
+
+/**
+ * @brief sets the minimum interval between the notifications of a data point
+ *
+ * @param interval_ms the interval in ms, 0 = notify directly
+ */
+void app_observe_set_interval(uint16_t interval_ms);
+
+/**
+ * @brief retrieves the statistics of the observe scheduler
+ *
+ * @return the statistics
+ */
+const app_observe_stats_t *app_observe_get_stats(void);
+
+/////// Event ring ///////
+
+#ifndef APP_EVENT_RING_SIZE
+/**
+ * @brief number of events of the event ring, power of 2.
+ * Hardware callbacks and UI threads post the events, the ring is drained by
+ * the stack loop before oc_main_poll. Events posted to a full ring are
+ * dropped.
+ */
+#define APP_EVENT_RING_SIZE 16
+#endif
+
+#ifndef APP_EVENT_VALUE_SIZE
+/**
+ * @brief maximum size of the value of a set event
+ */
+#define APP_EVENT_VALUE_SIZE 16
+#endif
+
+/**
+ * @brief callback of a call event, runs in the stack loop
+ */
+typedef void (*app_event_cb_t)(void *ctx);
+
+/**
+ * @brief statistics of the event ring
+ */
+typedef struct app_event_stats_t
+{
+  uint32_t posted;    /**< number of events posted */
+  uint32_t processed; /**< number of events processed by the stack loop */
+  uint32_t dropped;   /**< events dropped, the ring was full */
+  uint32_t wakeups;   /**< number of signals of the stack loop */
+  uint32_t max_depth; /**< maximum number of events in the ring */
+} app_event_stats_t;
+
+/**
+ * @brief post a callback to the stack loop
+ * Can be called from any thread or from a hardware callback. The callback
+ * runs in the stack loop, and may use the stack.
+ *
+ * @param cb the callback
+ * @param ctx the context of the callback
+ * @return false if the ring is full
+ */
+bool app_event_post_call(app_event_cb_t cb, void *ctx);
+
+/**
+ * @brief post a new value of a data point to the stack loop
+ * Can be called from any thread. The value is copied; it is applied as by a
+ * PUT, so the observers are notified.
+ *
+ * @param url the url of the data point, must stay valid (e.g. URL_X)
+ * @param value the value (the first element of an array)
+ * @param size the size of the value, at most APP_EVENT_VALUE_SIZE
+ * @return false if the ring is full or the value is too large
+ */
+bool app_event_post_set(const char *url, const void *value, size_t size);
+
+/**
+ * @brief post the inversion of a 1 bit value (e.g. DPT_Switch) to the stack
+ * loop
+ * Can be called from any thread.
+ *
+ * @param url the url of the data point, must stay valid (e.g. URL_X)
+ * @return false if the ring is full
+ */
+bool app_event_post_toggle(const char *url);
+
+/**
+ * @brief post an s-mode message to the stack loop, sent with app_smode_send
+ * Can be called from any thread.
+ *
+ * @param scope the scope of the message
+ * @param url the url of the data point, must stay valid (e.g. URL_X)
+ * @param rp the type of message, e.g. "w"
+ * @return false if the ring is full
+ */
+bool app_event_post_smode(uint8_t scope, const char *url, const char *rp);
+
+/**
+ * @brief process the posted events
+ * To be called by the stack loop, before oc_main_poll.
+ *
+ * @return the number of processed events
+ */
+int app_event_process(void);
+
+/**
+ * @brief retrieves the statistics of the event ring
+ *
+ * @return the statistics
+ */
+const app_event_stats_t *app_event_get_stats(void);
+
+/////// Event loop ///////
+
+#ifndef APP_LOOP_TICKLESS
+/**
+ * @brief the main loop of the host builds waits with epoll (Linux) or
+ * WaitForMultipleObjects (Windows) on the wake event, a timer armed for the
+ * next event of the stack and the registered handles, instead of a
+ * condition variable.
+ * Set to 1 to serve extra I/O (e.g. a proxy socket) in the stack loop.
+ */
+#define APP_LOOP_TICKLESS 0
+#endif
+
+#ifndef APP_LOOP_MAX_HANDLES
+/**
+ * @brief maximum number of handles registered with app_loop_add_handle
+ */
+#define APP_LOOP_MAX_HANDLES 4
+#endif
+
+#ifdef WIN32
+typedef void *app_loop_handle_t; /**< waitable HANDLE, e.g. a WSAEVENT */
+#else
+typedef int app_loop_handle_t; /**< file descriptor */
+#endif
+
+/**
+ * @brief callback of a registered handle, runs in the stack loop
+ * (Linux) the fd is readable; (Windows) the handle is signalled
+ */
+typedef void (*app_loop_cb_t)(app_loop_handle_t handle, void *ctx);
+
+/**
+ * @brief wait on the handle in the main loop
+ * Only with APP_LOOP_TICKLESS and the main of the runtime; to be called from
+ * the stack loop, e.g. in app_init or in a callback.
+ *
+ * @param handle the fd (Linux) or HANDLE (Windows)
+ * @param cb the callback
+ * @param ctx the context of the callback
+ * @return false if the handle can't be added
+ */
+bool app_loop_add_handle(app_loop_handle_t handle, app_loop_cb_t cb, void *ctx);
+
+/**
+ * @brief stop waiting on the handle
+ * To be called from the stack loop, also from the callback of the handle.
+ *
+ * @param handle the fd (Linux) or HANDLE (Windows)
+ * @return false if the handle was not added
+ */
+bool app_loop_remove_handle(app_loop_handle_t handle);
+
+#ifdef MQTT_PROXY
+/////// MQTT bridge ///////
+
+#ifndef APP_MQTT_QUEUE_SIZE
+/**
+ * @brief number of data points the outbound queue of the bridge can hold
+ */
+#define APP_MQTT_QUEUE_SIZE 16
+#endif
+
+#ifndef APP_MQTT_WINDOW_MS
+/**
+ * @brief window (in ms) in which changes are collected before they are
+ * published as one batch, also the retry interval when the client is busy
+ */
+#define APP_MQTT_WINDOW_MS 50
+#endif
+
+#ifndef APP_MQTT_PAYLOAD_SIZE
+/**
+ * @brief maximum size of the CBOR payload of a publish
+ */
+#define APP_MQTT_PAYLOAD_SIZE 128
+#endif
+
+#ifndef APP_MQTT_RECONNECT_MAX_S
+/**
+ * @brief maximum interval (in s) between two connection attempts, the
+ * interval starts at 1 s and doubles after each failed attempt
+ */
+#define APP_MQTT_RECONNECT_MAX_S 64
+#endif
+
+#ifndef APP_MQTT_KEEPALIVE_S
+/**
+ * @brief keep alive (in s) of the connection of the built-in client
+ */
+#define APP_MQTT_KEEPALIVE_S 60
+#endif
+
+#ifndef APP_MQTT_INFLIGHT
+/**
+ * @brief QoS 1 publishes of the built-in client waiting for the PUBACK,
+ * more publishes make the client busy
+ */
+#define APP_MQTT_INFLIGHT 4
+#endif
+
+#ifndef APP_MQTT_CLIENT
+/**
+ * @brief built-in MQTT 3.1.1 client (TCP, no TLS) used as the transport of
+ * the bridge, started by the main of the runtime.
+ * Other platforms, or a TLS client, set their own with app_mqtt_set_transport.
+ */
+#ifdef __linux__
+#define APP_MQTT_CLIENT 1
+#else
+#define APP_MQTT_CLIENT 0
+#endif
+#endif
+
+#ifndef APP_MQTT_TOPIC_PREFIX
+/**
+ * @brief topic of a data point: <prefix>/<serial number><url>
+ */
+#define APP_MQTT_TOPIC_PREFIX "knx"
+#endif
+
+/**
+ * @brief result of a publish of the MQTT client
+ */
+typedef enum {
+  APP_MQTT_SENT, /**< handed to the client */
+  APP_MQTT_BUSY, /**< the client can't take it now, e.g. the QoS 1 window is full */
+  APP_MQTT_DROPPED, /**< can't be sent, e.g. too large, the connection is kept */
+  APP_MQTT_ERROR /**< not connected, the bridge reconnects */
+} app_mqtt_result_t;
+
+/**
+ * @brief the MQTT client used by the bridge
+ * The functions are called in the stack loop and must not block, e.g. the
+ * client socket is served with app_loop_add_handle.
+ */
+typedef struct app_mqtt_transport_t
+{
+  /** start connecting, the client calls app_mqtt_connected when done */
+  bool (*connect)(void *ctx, const char *host, int port, const char *username,
+                  const char *pwd);
+  /** publish the payload */
+  app_mqtt_result_t (*publish)(void *ctx, const char *topic,
+                               const uint8_t *payload, size_t len, uint8_t qos);
+} app_mqtt_transport_t;
+
+/**
+ * @brief statistics of the MQTT bridge
+ */
+typedef struct app_mqtt_stats_t
+{
+  uint32_t requested;  /**< number of changes queued */
+  uint32_t published;  /**< number of publishes */
+  uint32_t coalesced;  /**< changes merged with a queued change of the data point */
+  uint32_t dropped;    /**< changes dropped, queue full or payload too large */
+  uint32_t busy;       /**< publishes postponed because the client was busy */
+  uint32_t batches;    /**< number of batches published */
+  uint32_t reconnects; /**< number of connection attempts */
+  uint32_t max_depth;  /**< highest number of queued changes */
+  uint32_t rate;       /**< publishes per second, of the last second */
+} app_mqtt_stats_t;
+
+/**
+ * @brief set the client of the bridge and connect to the configured broker
+ *
+ * @param transport the client, NULL stops the bridge
+ * @param ctx the context of the client functions
+ */
+void app_mqtt_set_transport(const app_mqtt_transport_t *transport, void *ctx);
+
+/**
+ * @brief to be called by the client when the connection state changes
+ *
+ * @param connected true when the broker accepted the connection
+ */
+void app_mqtt_connected(bool connected);
+
+/**
+ * @brief to be called by the client when it can take publishes again, e.g.
+ * after a PUBACK
+ */
+void app_mqtt_resume(void);
+
+/**
+ * @brief queue the value of the data point for publishing
+ * Called by the runtime after a changed value is applied (PUT, s-mode, or
+ * app_set_*). The value is read when published, so the broker gets the last
+ * value once per window.
+ *
+ * @param dp the data point
+ */
+void app_mqtt_publish(const datapoint_t *dp);
+
+/**
+ * @brief sets the QoS of the publishes
+ * With QoS 0 a full queue drops the oldest change, with QoS 1 and 2 it
+ * rejects the new change, so every queued change is delivered.
+ *
+ * @param qos the QoS, 0..2
+ */
+void app_mqtt_set_qos(uint8_t qos);
+
+/**
+ * @brief number of queued changes
+ */
+int app_mqtt_get_depth(void);
+
+/**
+ * @brief retrieves the statistics of the MQTT bridge
+ *
+ * @return the statistics
+ */
+const app_mqtt_stats_t *app_mqtt_get_stats(void);
+
+#if APP_MQTT_CLIENT
+/**
+ * @brief connect the bridge with the built-in client to the configured broker
+ * (-host, -port, -username, -pwd or the MQTT parameters).
+ * Called by the main of the runtime when no transport is set, to be called
+ * by the application with NO_MAIN.
+ * A host name is resolved here, blocking and once; the reconnects from the
+ * stack loop reuse the address.
+ *
+ * @return false if no broker is configured or it can't be resolved
+ */
+bool app_mqtt_start_client(void);
+#endif
+#endif /* MQTT_PROXY */
+
+/////// Device instances ///////
+
+#ifndef APP_MAX_DEVICES
+#if defined(__linux__) && !defined(NO_MAIN)
+/**
+ * @brief maximum number of device instances hosted by one process.
+ * The Linux CLI application can run several virtual devices (-n <count>),
+ * limited as well by the number of devices of the stack (OC_MAX_NUM_DEVICES).
+ */
+#define APP_MAX_DEVICES 256
+#else
+#define APP_MAX_DEVICES 1
+#endif
+#endif
+
+/**
+ * @brief sets the number of device instances, to be called before the stack
+ * is initialized.
+ * Device 0 uses the serial number of the application, the other devices use
+ * the serial number + device index. Each device has its own copy of the data
+ * point values, and stores its persistent values under its own names.
+ *
+ * @param count number of devices (1..APP_MAX_DEVICES)
+ * @return false count is out of range
+ */
+bool app_set_num_devices(int count);
+
+/**
+ * @brief number of device instances
+ *
+ * @return the number of devices
+ */
+int app_get_num_devices(void);
+
+/**
+ * @brief change counter of a data point
+ * incremented when the value is changed by datapoint_set (e.g. by a PUT),
+ * writes of the same value do not count as a change.
+ * a UI can compare the counter with the counter it has displayed.
+ *
+ * @param url the url of the data point
+ * @return the change counter, 0 for unknown urls
+ */
+uint32_t app_get_change_count(const char *url);
+
+/**
+ * @brief checks if a data point is changed since it was seen
+ *
+ * @param url the url of the data point
+ * @param seen the change counter that was seen, updated to the current counter
+ * @return true the data point is changed since *seen
+ * @return false no change
+ */
+bool app_is_changed(const char *url, uint32_t *seen);
+
+/**
+ * @brief total number of changes of all data points
+ *
+ * @return the change counter of the application
+ */
+uint32_t app_get_change_generation(void);
+
+/**
+ * @brief change counter of the KNX tables (GOT, publisher, recipient, auth)
+ * the tables are changed by ETS during loading, so the counter is
+ * incremented on each load state change and on a reset
+ *
+ * @return the change counter of the tables
+ */
+uint32_t app_get_table_generation(void);
+
+/**
+ * @brief number of used entries of the KNX tables
+ */
+typedef struct app_table_summary_t
+{
+  uint32_t generation;     /**< app_get_table_generation() of the counts */
+  int got_entries;         /**< group object table */
+  int got_other_entries;   /**< group object table entries with an url that is not a data point */
+  int recipient_entries;   /**< recipient table */
+  int publisher_entries;   /**< publisher table */
+  int auth_entries;        /**< auth/at table */
+} app_table_summary_t;
+
+/**
+ * @brief summary of the KNX tables
+ * the summary is rebuilt when the tables are loaded or reset, not on each call
+ *
+ * @return the number of used entries of each table
+ */
+const app_table_summary_t *app_get_table_summary(void);
+
+/**
+ * @brief first entry of the Group Object Table with the url
+ *
+ * @param url the url of the data point
+ * @return the index in the Group Object Table, -1 if the url is not in the table
+ */
+int app_get_got_index(const char *url);
+
+/**
+ * @brief number of Group Object Table entries with the url
+ *
+ * @param url the url of the data point
+ * @return the number of entries, 0 for unknown urls
+ */
+int app_get_got_count(const char *url);
+
+/////// Software update ///////
+
+#ifndef APP_SWU_PIPELINE
+#if defined WIN32 || defined __linux__ || CASCODA_OTA_UPGRADE_ENABLED
+/**
+ * @brief 1 = the received image is buffered, hashed and written by the
+ * runtime (app_swu_receive), and an interrupted transfer is resumed.
+ * Default on Linux and Windows, which write "downloaded.bin", and on the
+ * embedded images with CASCODA_OTA_UPGRADE_ENABLED, which write the OTA flash
+ * area through the Cascoda port (main_SwuBlock in knx_iot_boot.c).
+ * Without, the runtime only accounts the blocks (app_swu_note_block) and the
+ * buffers are not compiled in.
+ */
+#define APP_SWU_PIPELINE 1
+#else
+#define APP_SWU_PIPELINE 0
+#endif
+#endif
+
+#ifndef APP_SWU_BUFFER_SIZE
+/**
+ * @brief size of each of the two software update block buffers.
+ * Larger blocks are written directly, without pipelining.
+ */
+#define APP_SWU_BUFFER_SIZE 1024
+#endif
+
+#ifndef APP_SWU_PERSIST_BYTES
+/**
+ * @brief interval (in bytes written) at which the resume offset is stored
+ */
+#define APP_SWU_PERSIST_BYTES (16 * 1024)
+#endif
+
+#ifndef APP_SWU_IDLE_S
+/**
+ * @brief time (in seconds) without blocks after which a transfer is
+ * considered interrupted
+ */
+#define APP_SWU_IDLE_S 30
+#endif
+
+/**
+ * @brief writes a part of the received image, e.g. to flash or a file
+ *
+ * @param offset the offset of the data in the image
+ * @param data the image data
+ * @param len the length of the data
+ * @return false on failure, the transfer is aborted
+ */
+typedef bool (*app_swu_write_cb_t)(size_t offset, const uint8_t *data,
+                                   size_t len);
+
+/**
+ * @brief state and throughput of the software update transfer
+ */
+typedef struct app_swu_status_t
+{
+  bool active;           /**< a transfer is in progress */
+  uint32_t binary_size;  /**< size of the image */
+  uint32_t received;     /**< bytes received in order */
+  uint32_t written;      /**< bytes handed to the writer */
+  uint32_t resumed_from; /**< offset up to which the stored image was reused */
+  uint32_t hash;         /**< FNV-1a hash of the received bytes */
+  uint32_t elapsed_ms;   /**< duration of the transfer */
+  uint32_t bytes_per_s;  /**< achieved throughput */
+  uint32_t stalls;       /**< blocks that waited for a free buffer */
+  uint32_t errors;       /**< out of order blocks and failed writes */
+} app_swu_status_t;
+
+#if APP_SWU_PIPELINE
+/**
+ * @brief sets the writer of the software update pipeline
+ * The Linux and Windows applications write to "downloaded.bin", the embedded
+ * mains set the OTA flash writer of the Cascoda port.
+ *
+ * @param writer the writer, NULL disables the pipeline
+ */
+void app_swu_set_writer(app_swu_write_cb_t writer);
+
+/**
+ * @brief feeds a block of the image into the software update pipeline
+ * The block is copied into one of two buffers and acknowledged directly, the
+ * writer runs afterwards from a delayed callback. Blocks that are already
+ * stored by an interrupted transfer of the same image are only hashed; a
+ * sender may also continue directly at the stored offset.
+ * Sends the separate response.
+ *
+ * @param response the separate response of the block
+ * @param binary_size the full size of the image
+ * @param offset the offset of the block
+ * @param payload the block data
+ * @param len the length of the block
+ * @return false the block was not accepted
+ */
+bool app_swu_receive(oc_separate_response_t *response, size_t binary_size,
+                     size_t offset, const uint8_t *payload, size_t len);
+#endif /* APP_SWU_PIPELINE */
+
+/**
+ * @brief accounts a block of the image for the status and throughput,
+ * for receivers that do not use the pipeline (e.g. the OTA upgrade of the
+ * Cascoda port). Called by app_swu_receive as well.
+ *
+ * @param binary_size the full size of the image
+ * @param offset the offset of the block
+ * @param len the length of the block
+ */
+void app_swu_note_block(size_t binary_size, size_t offset, size_t len);
+
+/**
+ * @brief checks if a software update transfer is in progress
+ */
+bool app_swu_is_active(void);
+
+/**
+ * @brief retrieves the state of the software update transfer
+ *
+ * @return the status
+ */
+const app_swu_status_t *app_swu_get_status(void);
+
+/////// Metrics ///////
+
+#ifndef APP_METRICS
+/**
+ * @brief collect request latency, storage and heap metrics of the data points.
+ * Set to 0 to compile the instrumentation (and the diagnostic resource) out.
+ */
+#define APP_METRICS 1
+#endif
+
+#if APP_METRICS
+/**
+ * @brief url of the read-only diagnostic resource
+ * query parameters pn/ps page through the data point entries
+ */
+#define URL_DIAG "/p/diag"
+
+/**
+ * @brief parameter of the adaptive poll engine of the sleepy builds
+ * {1: fast_poll_ms, 2: max_poll_ms, 3: active_ms, 4: backoff}, see
+ * main_SetPollPolicy. A PUT may hold a subset of the keys.
+ */
+#define URL_POLL_POLICY "/p/poll"
+
+/**
+ * @brief latency statistics, in micro seconds
+ * the resolution is the resolution of oc_clock_time()
+ */
+typedef struct app_latency_t
+{
+  uint32_t count;   /**< number of samples */
+  uint32_t min_us;  /**< shortest duration */
+  uint32_t max_us;  /**< longest duration */
+  uint32_t ewma_us; /**< moving average, new samples weigh 1/8 */
+} app_latency_t;
+
+/**
+ * @brief metrics of a single data point
+ */
+typedef struct app_dp_metrics_t
+{
+  app_latency_t get; /**< GET requests */
+  app_latency_t put; /**< PUT requests, including s-mode */
+  uint32_t errors;   /**< failed requests */
+} app_dp_metrics_t;
+
+/**
+ * @brief metrics of the data point runtime
+ */
+typedef struct app_metrics_t
+{
+  app_latency_t encode;        /**< oc_encode_datapoint */
+  app_latency_t store;         /**< storing persistent data */
+  app_latency_t load;          /**< loading persistent data */
+  app_latency_t smode_fast;    /**< s-mode writes on the fast path */
+  app_latency_t smode_slow;    /**< redirected s-mode writes on the generic path */
+  uint32_t storage_writes;     /**< number of oc_storage_write calls */
+  uint32_t storage_reads;      /**< number of oc_storage_read calls */
+  uint32_t scratch_peak_bytes; /**< largest use of the request scratch area */
+  uint32_t malloc_count;       /**< number of heap allocations */
+  uint32_t malloc_peak_bytes;  /**< largest heap allocation */
+} app_metrics_t;
+
+/**
+ * @brief retrieves the runtime metrics
+ *
+ * @return the metrics
+ */
+const app_metrics_t *app_metrics_get(void);
+
+/**
+ * @brief retrieves the metrics of a data point
+ *
+ * @param url the url of the data point
+ * @return the metrics, NULL if the url is not a data point
+ */
+const app_dp_metrics_t *app_metrics_get_datapoint(const char *url);
+
+/**
+ * @brief clears all metrics
+ */
+void app_metrics_reset(void);
+
+/**
+ * @brief writes a readable summary of the metrics
+ *
+ * @param buf the buffer to write into
+ * @param size size of the buffer
+ * @return number of characters written
+ */
+int app_metrics_to_text(char *buf, size_t size);
+#endif /* APP_METRICS */
+
+/////// Footprint ///////
+
+#ifndef APP_MAX_APP_DATA_SIZE
+/**
+ * @brief application payload size set by the embedded mains
+ * (oc_set_max_app_data_size), tune with payload_peak_bytes of the footprint
+ */
+#define APP_MAX_APP_DATA_SIZE 1024
+#endif
+
+#ifndef APP_MTU_SIZE
+/**
+ * @brief MTU set by the embedded mains (oc_set_mtu_size)
+ */
+#define APP_MTU_SIZE 1232
+#endif
+
+#if APP_METRICS
+/**
+ * @brief run time high-water marks of the memory use
+ * The build reports the static use per section and symbol, see
+ * COMMON/footprint.cmake.
+ */
+typedef struct app_footprint_t
+{
+  uint32_t static_bytes;       /**< RAM of the runtime tables, state and queues */
+  uint32_t heap_used_bytes;    /**< heap in use at the last sample, 0 = unknown */
+  uint32_t heap_peak_bytes;    /**< highest heap use (newlib: arena), 0 = unknown */
+  uint32_t stack_peak_bytes;   /**< deepest sampled stack use below the loop */
+  uint32_t payload_peak_bytes; /**< largest encoded response, vs APP_MAX_APP_DATA_SIZE */
+  uint32_t rep_peak_objects;   /**< largest number of rep objects of a request */
+} app_footprint_t;
+
+/**
+ * @brief samples the heap and retrieves the high-water marks
+ *
+ * @return the footprint
+ */
+const app_footprint_t *app_footprint_get(void);
+#endif /* APP_METRICS */
+
+/////// Data point state ///////
+
+/**
+ * @brief the prepared metadata of a data point of device 0
+ */
+typedef struct app_metadata_cache_t
+{
+  bool valid;
+  char id[48];                            /**< knx://sn.<serial number><url> */
+  const char *rt;                         /**< dpa without "urn:knx:" */
+  const char *dpt;                        /**< dpt without "urn:knx:" */
+  const char *ifs[OC_MAX_IF_MASKS + 1];   /**< interface strings */
+  int num_ifs;
+} app_metadata_cache_t;
+
+/**
+ * @brief run time state of a data point or parameter
+ */
+typedef struct datapoint_state_t
+{
+  uint32_t change_count;         /**< number of changes of the value */
+  int16_t got_first;             /**< first group object table entry, -1 = none */
+  uint8_t got_count;             /**< number of group object table entries */
+  bool smode_bound;              /**< s-mode writes use the fast path */
+  const struct datapoint_type_t *smode_codec; /**< codec of the fast path */
+  const datapoint_t *smode_feedback;          /**< feedback of the fast path, NULL = none */
+  bool persist_dirty;            /**< the value still needs to be stored */
+  bool observe_pending;          /**< a notification is scheduled */
+  uint32_t observe_ms;           /**< time of the last notification, 0 = none */
+#if APP_METRICS
+  app_dp_metrics_t metrics;      /**< request metrics */
+#endif
+  app_metadata_cache_t metadata; /**< prepared metadata */
+} datapoint_state_t;
+
+/* state of g_datapoints followed by g_parameters, zero initialized */
+extern datapoint_state_t g_datapoint_state[];
+
+#ifdef APP_BENCH
+/////// Replay ///////
+
+/**
+ * @brief the application part of a replay (-replay <file>), e.g. the logic
+ * and the display of the device, see "Replay" in knx_iot_runtime.c
+ */
+typedef struct app_replay_app_t
+{
+  bool (*event)(const char *name, char *args); /**< event of the application, false = unknown */
+  void (*step)(void);                          /**< runs after each event, e.g. the due timers */
+  uint32_t (*display_bytes)(void);             /**< bytes pushed to the display so far */
+} app_replay_app_t;
+
+/**
+ * @brief set the application part of the replay, from g_app_info.init
+ *
+ * @param app the callbacks, NULL = data point layer only
+ */
+void app_replay_set_app(const app_replay_app_t *app);
+#endif /* APP_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KNX_IOT_RUNTIME_H */
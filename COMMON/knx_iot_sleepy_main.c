@@ -39,6 +39,7 @@
 #include <unistd.h>
 
 #include <openthread/diag.h>
+#include <openthread/link.h>
 #include <openthread/platform/settings.h>
 #include <openthread/tasklet.h>
 #include <openthread/thread.h>
@@ -64,6 +65,8 @@
 #include "port/oc_assert.h"
 #include "port/oc_clock.h"
 #include "port/oc_log.h"
+#include "knx_iot_log.h"
+#include "knx_iot_runtime.h"
 #include "port/dns-sd.h"
 #include "security/oc_spake2plus.h"
 #include "manufacturer_storage.h"
@@ -104,11 +107,7 @@ void lsm_change_cb(size_t device_index, oc_lsm_state_t current_state, void *data
 void hostname_cb(size_t device_index, oc_string_t host_name, void *data);
 int app_set_serial_number(char *serial_number);
 int app_init(void);
-
-#if CASCODA_OTA_UPGRADE_ENABLED
-// Implemented in the cascoda knx-iot port
-void swu_cb(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data);
-#endif
+bool app_swu_is_active(void);
 
 /**
  * @file
@@ -178,18 +177,189 @@ static void signal_event_loop(void)
 {
 }
 
+// Adaptive data polling
+#define POLL_POLICY_STORE_NAME "sed_poll_policy"
+
+static main_poll_policy_t g_poll_policy = {
+	.fast_poll_ms = 250,
+	.max_poll_ms = 10 * 1000,
+	.active_ms = 3 * 1000,
+	.backoff = 2,
+};
+static main_poll_stats_t g_poll_stats;
+static ca_tasklet g_poll_tasklet;
+static bool g_poll_tasklet_initialised;
+static uint32_t g_poll_period;
+static uint32_t g_poll_last_activity;
+static uint32_t g_poll_last_poll;
+static uint32_t g_wake_time;
+
+static const uint32_t g_histogram_bounds[MAIN_POLL_HISTOGRAM_BUCKETS - 1] = {
+	10, 100, 1000, 10 * 1000, 60 * 1000, 10 * 60 * 1000};
+
+static void histogram_add(uint32_t *histogram, uint32_t ms)
+{
+	int i = 0;
+	while (i < MAIN_POLL_HISTOGRAM_BUCKETS - 1 && ms >= g_histogram_bounds[i])
+		i++;
+	histogram[i]++;
+}
+
+static bool poll_is_active(uint32_t now)
+{
+	return oc_knx_device_in_programming_mode(THIS_DEVICE) || app_swu_is_active() ||
+		   (now - g_poll_last_activity) < g_poll_policy.active_ms;
+}
+
+static ca_error poll_handler(void *context)
+{
+	(void)context;
+	uint32_t now = TIME_ReadAbsoluteTime();
+
+	otLinkSendDataRequest(OT_INSTANCE);
+	g_poll_stats.polls++;
+	histogram_add(g_poll_stats.poll_histogram, now - g_poll_last_poll);
+	g_poll_last_poll = now;
+
+	if (poll_is_active(now))
+	{
+		g_poll_period = g_poll_policy.fast_poll_ms;
+	}
+	else
+	{
+		g_poll_period *= g_poll_policy.backoff;
+		if (g_poll_period >= g_poll_policy.max_poll_ms)
+		{
+			// idle: leave it to the slow poll of SED_InitPolling
+			g_poll_period = 0;
+			return CA_ERROR_SUCCESS;
+		}
+	}
+	TASKLET_ScheduleDelta(&g_poll_tasklet, g_poll_period, NULL);
+	return CA_ERROR_SUCCESS;
+}
+
+void main_PollActivity(void)
+{
+	g_poll_stats.activity++;
+	g_poll_last_activity = TIME_ReadAbsoluteTime();
+	if (g_poll_policy.fast_poll_ms == 0 || g_poll_period == g_poll_policy.fast_poll_ms)
+		return;
+
+	if (!g_poll_tasklet_initialised)
+	{
+		TASKLET_Init(&g_poll_tasklet, &poll_handler);
+		g_poll_tasklet_initialised = true;
+	}
+	else if (TASKLET_IsQueued(&g_poll_tasklet))
+		TASKLET_Cancel(&g_poll_tasklet);
+
+	if (g_poll_period == 0)
+		g_poll_last_poll = g_poll_last_activity;
+	g_poll_period = g_poll_policy.fast_poll_ms;
+	TASKLET_ScheduleDelta(&g_poll_tasklet, g_poll_period, NULL);
+}
+
+static bool poll_policy_is_valid(const main_poll_policy_t *policy)
+{
+	if (policy->fast_poll_ms == 0)
+		return true;
+	return policy->backoff >= 2 && policy->max_poll_ms > policy->fast_poll_ms;
+}
+
+bool main_SetPollPolicy(const main_poll_policy_t *policy)
+{
+	if (!policy || !poll_policy_is_valid(policy))
+	{
+		APP_LOG_WARN("main_SetPollPolicy: invalid policy\n");
+		return false;
+	}
+	g_poll_policy = *policy;
+	oc_storage_write(POLL_POLICY_STORE_NAME, (uint8_t *)&g_poll_policy, sizeof(g_poll_policy));
+
+	// restart so the new periods are used
+	if (g_poll_tasklet_initialised && TASKLET_IsQueued(&g_poll_tasklet))
+		TASKLET_Cancel(&g_poll_tasklet);
+	g_poll_period = 0;
+	if (poll_is_active(TIME_ReadAbsoluteTime()))
+		main_PollActivity();
+	return true;
+}
+
+const main_poll_policy_t *main_GetPollPolicy(void)
+{
+	return &g_poll_policy;
+}
+
+const main_poll_stats_t *main_GetPollStats(void)
+{
+	return &g_poll_stats;
+}
+
+static void poll_policy_load(void)
+{
+	main_poll_policy_t policy;
+	long ret = oc_storage_read(POLL_POLICY_STORE_NAME, (uint8_t *)&policy, sizeof(policy));
+	if (ret == (long)sizeof(policy) && poll_policy_is_valid(&policy))
+	{
+		g_poll_policy = policy;
+		APP_LOG_INFO("poll policy: fast %u ms, max %u ms, active %u ms, backoff %u\n",
+					 (unsigned)policy.fast_poll_ms,
+					 (unsigned)policy.max_poll_ms,
+					 (unsigned)policy.active_ms,
+					 (unsigned)policy.backoff);
+	}
+}
+
+// record the time awake before, and the time asleep after hardware_sleep
+static void poll_stats_sleep(struct ca821x_dev *pDeviceRef, uint32_t nextAppEvent)
+{
+	uint32_t sleep_start = TIME_ReadAbsoluteTime();
+	uint32_t awake = sleep_start - g_wake_time;
+
+	hardware_sleep(pDeviceRef, nextAppEvent);
+
+	g_wake_time = TIME_ReadAbsoluteTime();
+	uint32_t asleep = g_wake_time - sleep_start;
+	if (asleep == 0)
+		return;
+	g_poll_stats.wakes++;
+	g_poll_stats.radio_on_ms += awake;
+	g_poll_stats.asleep_ms += asleep;
+	histogram_add(g_poll_stats.awake_histogram, awake);
+	histogram_add(g_poll_stats.sleep_histogram, asleep);
+}
+
+#if CASCODA_OTA_UPGRADE_ENABLED
+// keep polling fast until the software update transfer is complete
+static void swu_poll_cb(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data)
+{
+	main_PollActivity();
+	main_SwuBlock(device_index, response, binary_size, offset, payload, len, data);
+}
+#endif
+
 static void prog_mode_cb(size_t device_index, bool programming_mode, void *data)
 {
 	(void)data;
-	PRINT_APP("prog_mode_cb(), device: %d, programming_mode %d\n", device_index, programming_mode);
+	APP_LOG_INFO("prog_mode_cb(), device: %d, programming_mode %d\n", device_index, programming_mode);
+	APP_TRACE(APP_TRACE_PROG_MODE, device_index, programming_mode);
 	programming_mode_embedded(device_index, programming_mode);
+	if (programming_mode)
+		main_PollActivity();
 }
 
 static void reset_cb(size_t device_index, int reset_value, void *data)
 {
 	(void)device_index;
-	PRINT_APP("reset_cb()\n");
-
+	APP_LOG_INFO("reset_cb()\n");
+
+	// store pending data before the reset changes or erases it
+	app_persist_flush();
+	// 2 and 7: factory reset, the credentials may be reflashed afterwards
+	if (reset_value == 2 || reset_value == 7)
+		main_SpakeCacheClear();
+	APP_TRACE(APP_TRACE_RESET, device_index, reset_value);
 	reset_embedded(device_index, reset_value, data);
 }
 
@@ -221,7 +391,11 @@ static void sleep_if_possible(struct ca821x_dev *pDeviceRef, oc_clock_time_t tim
 	if (!hardware_can_sleep())
 		return;
 
-	hardware_sleep(pDeviceRef, nextAppEvent);
+	// do not keep unsaved data in RAM while sleeping
+	app_persist_flush();
+	APP_TRACE(APP_TRACE_SLEEP, 0, nextAppEvent);
+	poll_stats_sleep(pDeviceRef, nextAppEvent);
+	APP_TRACE(APP_TRACE_WAKE, 0, 0);
 }
 
 // Skip Thread check, this function is used to allow sleeping before the device
@@ -237,7 +411,11 @@ static void sleep_if_possible_no_thread(struct ca821x_dev *pDeviceRef, uint64_t
 	if (!hardware_can_sleep())
 		return;
 
-	hardware_sleep(pDeviceRef, nextAppEvent);
+	// do not keep unsaved data in RAM while sleeping
+	app_persist_flush();
+	APP_TRACE(APP_TRACE_SLEEP, 0, nextAppEvent);
+	poll_stats_sleep(pDeviceRef, nextAppEvent);
+	APP_TRACE(APP_TRACE_WAKE, 0, 0);
 }
 
 // Variables used for the resynch mechanism
@@ -257,14 +435,50 @@ void main_SetThreadChildTimeout(int seconds)
 	otThreadSetChildTimeout(OT_INSTANCE, seconds);
 }
 
+// work that is not needed to handle requests, done after the first oc_main_poll
+static void boot_deferred_work(void)
+{
+	main_BootPhaseDone(MAIN_BOOT_READY);
+
+	// configure the hostname.
+	// note: this method sets the SN part to uppercase, as that is how
+	// the serial number is stored in the oc_device_info_t
+	oc_device_info_t *device = oc_core_get_device_info(0);
+	char hostname_str[50];
+	memset(hostname_str, 0, 49);
+	strcat(hostname_str, "knx-");
+	strcat(hostname_str, oc_string(device->serialnumber));
+	strcat(hostname_str, ".local");
+	oc_core_set_device_hostname(0, hostname_str);
+
+	// publish the MDNS service on startup
+	// knx_service_sleep_period(SED_POLL_PERIOD);
+	knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
+
+	uint64_t iid = oc_core_get_device_iid(THIS_DEVICE);
+	// Note: we are using printf here instead of PRINT so that
+	// this information always gets printed.
+	printf("Device iid: ");
+	oc_print_uint64_t(iid, DEC_REPRESENTATION);
+	printf("\n");
+
+	printf("group publisher table:\n");
+	oc_print_reduced_group_publisher_table();
+	printf("group recipient table:\n");
+	oc_print_reduced_group_recipient_table();
+
+	main_BootPhaseDone(MAIN_BOOT_DEFERRED);
+	main_BootComplete();
+}
+
 void swu_start_update_cb_imp(size_t device_index, uint32_t start_time, void *data)
 {
 	(void)data;
 	ca_error status = CA_ERROR_FAIL;
-	PRINT_APP("swu_start_update_cb_imp(), device: %d, applying new sofware in %d\n", device_index, start_time);
+	APP_LOG_INFO("swu_start_update_cb_imp(), device: %d, applying new sofware in %d\n", device_index, start_time);
 #if CASCODA_OTA_UPGRADE_ENABLED
 	status = ota_start_upgrade(start_time);
-	PRINT_APP("swu_start_update_cb_imp(), status = %d\n",status);
+	APP_LOG_INFO("swu_start_update_cb_imp(), status = %d\n",status);
 #endif
 }
 
@@ -334,11 +548,13 @@ int main(void)
 	// Hardware specific setup
 	hardware_init();
 	logic_initialize();
+	g_wake_time = TIME_ReadAbsoluteTime();
 
 #if CASCODA_OTA_UPGRADE_ENABLED
 	/* Initialises handling of OTA Firmware Upgrade */
 	ota_upgrade_init();
 #endif
+	main_BootPhaseDone(MAIN_BOOT_CHIP);
 
 	// A backoff/sleep mechanism for joining the network
 	enum backoff_and_sleep_timings
@@ -411,6 +627,7 @@ int main(void)
 
 		WAIT_ms(1);
 	} while (1);
+	main_BootPhaseDone(MAIN_BOOT_JOIN);
 
 	otThreadSetEnabled(OT_INSTANCE, true);
 
@@ -442,13 +659,13 @@ int main(void)
 
 	oc_storage_config("./knx_iot_creds");
 
-	uint8_t sn[6];
+	uint8_t sn[6] = {0};
 	/* configure the serial number. must be done before stack initialization */
 	error = knx_get_stored_serial_number(sn);
 	if (error)
 	{
-		PRINT_APP("ERROR: Unique serial number not found! Using default value...\n");
-		PRINT_APP(
+		APP_LOG_ERR("ERROR: Unique serial number not found! Using default value...\n");
+		APP_LOG_ERR(
 			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
 	} else {
 		// turn binary to hexadecimal
@@ -470,35 +687,21 @@ int main(void)
 	error = knx_get_stored_password(pwd);
 	if (error)
 	{
-		PRINT_APP("Error: Stored password not found! Using default value...\n");
-		PRINT_APP(
+		APP_LOG_WARN("Error: Stored password not found! Using default value...\n");
+		APP_LOG_WARN(
 			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
+		pwd[0] = '\0';
 	}
 	else
 	{
 		oc_spake_set_password(pwd);
 	}
-
-	uint8_t salt[32], rand[32];
-	uint32_t it;
-	mbedtls_mpi w0;
-	mbedtls_ecp_point L;
-	mbedtls_mpi_init(&w0);
-	mbedtls_ecp_point_init(&L);
-	error = knx_get_stored_spake(salt, rand, &it, &w0, &L);
-	if (error)
-	{
-		PRINT_APP("Error: Stored spake record not found! Using runtime generated values\n");
-		PRINT_APP(
-			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
-	}
-	else
-	{
-		oc_spake_set_parameters(rand, salt, it, w0, L);
-		mbedtls_mpi_free(&w0);
-		mbedtls_ecp_point_free(&L);
-	}
 #endif
+	main_BootPhaseDone(MAIN_BOOT_CREDENTIALS);
+#ifdef OC_SPAKE
+	main_BootLoadSpake(sn, sizeof(sn), pwd);
+#endif
+	main_BootPhaseDone(MAIN_BOOT_SPAKE);
 
 	/* set the application callbacks */
 	oc_set_hostname_cb(hostname_cb, NULL);
@@ -506,7 +709,7 @@ int main(void)
 	oc_set_factory_presets_cb(factory_presets_cb, NULL);
 	oc_set_lsm_change_cb(lsm_change_cb, NULL);
 #if CASCODA_OTA_UPGRADE_ENABLED
-	oc_set_swu_cb(swu_cb, (void *)"image_name");
+	oc_set_swu_cb(swu_poll_cb, (void *)"image_name");
 	oc_set_swu_startupdate_cb(swu_start_update_cb_imp, (void *)"image_name");
 #endif
 
@@ -515,42 +718,19 @@ int main(void)
 	/* start the stack */
 	init = oc_main_init(&handler);
 
-	// configure the hostname.
-	// note: this method sets the SN part to uppercase, as that is how
-	// the serial number is stored in the oc_device_info_t
-	oc_device_info_t *device = oc_core_get_device_info(0);
-	char hostname_str[50];
-	memset(hostname_str, 0, 49);
-	strcat(hostname_str, "knx-");
-	strcat(hostname_str, oc_string(device->serialnumber));
-	strcat(hostname_str, ".local");
-	oc_core_set_device_hostname(0, hostname_str);
+	main_BootPhaseDone(MAIN_BOOT_STACK);
 
-	oc_set_max_app_data_size(1024);
-	oc_set_mtu_size(1232);
+	oc_set_max_app_data_size(APP_MAX_APP_DATA_SIZE);
+	oc_set_mtu_size(APP_MTU_SIZE);
 
 	if (init < 0)
 	{
-		PRINT_APP("oc_main_init failed %d.\n", init);
+		APP_LOG_ERR("oc_main_init failed %d.\n", init);
 	}
 
-	// publish the MDNS service on startup
-	// knx_service_sleep_period(SED_POLL_PERIOD);
-	knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
-
-	PRINT("KNX IoT device, waiting on incoming connections.\n");
-
-	uint64_t iid = oc_core_get_device_iid(THIS_DEVICE);
-	// Note: we are using printf here instead of PRINT so that
-	// this information always gets printed.
-	printf("Device iid: ");
-	oc_print_uint64_t(iid, DEC_REPRESENTATION);
-	printf("\n");
+	poll_policy_load();
 
-	printf("group publisher table:\n");
-	oc_print_reduced_group_publisher_table();
-	printf("group recipient table:\n");
-	oc_print_reduced_group_recipient_table();
+	APP_LOG_INFO("KNX IoT device, waiting on incoming connections.\n");
 
 	while (1)
 	{
@@ -559,7 +739,15 @@ int main(void)
 		otTaskletsProcess(OT_INSTANCE);
 		// Sleepy Device
 		// oc_main_poll();
-		sleep_if_possible(&dev, oc_main_poll());
+		app_event_process();
+		next_event = oc_main_poll();
+		if (!main_GetBootProfile()->complete)
+		{
+			// poll again instead of sleeping, the deferred work takes time
+			boot_deferred_work();
+			continue;
+		}
+		sleep_if_possible(&dev, next_event);
 	}
 
 	/* shut down the stack, should not get here */
@@ -0,0 +1,212 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2022-2023 Cascoda Limited
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "oc_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* calls that are implemented in sleepy main */
+
+/**
+ * @brief sets the sleep time of the device (e.g. child)
+ *
+ * @param seconds, time in seconds
+ */
+void main_SetThreadChildTimeout(int seconds);
+
+/**
+ * @brief kicks off the resynch mechanism: sending of MLE Child Update Requests
+ *        periodically to reattach to the parent in case the child was timed out
+ *
+ * @param seconds, time in seconds
+ */
+void main_KickOffChildResynchMechanism(int seconds);
+
+/**
+ * @brief policy of the adaptive data poll engine
+ *
+ * After activity (a received PUT or s-mode message, programming mode or a
+ * running software update) the device polls its parent every fast_poll_ms.
+ * Once active_ms has passed without activity the period is multiplied by
+ * backoff after every poll, until max_poll_ms is reached. From then on only the
+ * slow poll configured with SED_InitPolling is used.
+ * A fast_poll_ms of 0 disables the engine.
+ */
+typedef struct main_poll_policy_t
+{
+    uint32_t fast_poll_ms; /**< poll period directly after activity */
+    uint32_t max_poll_ms;  /**< period at which the engine hands over to the slow poll */
+    uint32_t active_ms;    /**< time after activity during which fast_poll_ms is kept */
+    uint8_t backoff;       /**< period multiplier when idle, 2 is exponential back off */
+} main_poll_policy_t;
+
+/** number of buckets of the sleep/awake histograms */
+#define MAIN_POLL_HISTOGRAM_BUCKETS 7
+
+/**
+ * @brief statistics of the sleepy main
+ *
+ * The histograms use the upper bounds 10 ms, 100 ms, 1 s, 10 s, 1 min and
+ * 10 min, the last bucket holds everything longer.
+ */
+typedef struct main_poll_stats_t
+{
+    uint32_t wakes;        /**< number of wake ups */
+    uint32_t polls;        /**< data polls sent by the adaptive engine */
+    uint32_t activity;     /**< number of activity notifications */
+    uint32_t radio_on_ms;  /**< total time awake with the radio on */
+    uint32_t asleep_ms;    /**< total time asleep */
+    uint32_t sleep_histogram[MAIN_POLL_HISTOGRAM_BUCKETS]; /**< sleep durations */
+    uint32_t awake_histogram[MAIN_POLL_HISTOGRAM_BUCKETS]; /**< awake durations */
+    uint32_t poll_histogram[MAIN_POLL_HISTOGRAM_BUCKETS];  /**< intervals between engine polls */
+} main_poll_stats_t;
+
+/**
+ * @brief notifies the poll engine of activity, the device polls fast for the
+ *        following active_ms
+ */
+void main_PollActivity(void);
+
+/**
+ * @brief sets the policy of the adaptive poll engine and stores it
+ *
+ * The runtime exposes the policy as the parameter URL_POLL_POLICY (/p/poll),
+ * so that it can be configured from ETS.
+ *
+ * @param policy the new policy
+ * @return false the policy is invalid and was not applied
+ */
+bool main_SetPollPolicy(const main_poll_policy_t *policy);
+
+/**
+ * @brief retrieves the active policy of the poll engine
+ */
+const main_poll_policy_t *main_GetPollPolicy(void);
+
+/**
+ * @brief retrieves the poll and sleep statistics
+ */
+const main_poll_stats_t *main_GetPollStats(void);
+
+/* calls that are implemented in both the sleepy and the wakeful main */
+
+/**
+ * @brief phases of the boot, in the order in which they run
+ */
+typedef enum main_boot_phase_t
+{
+    MAIN_BOOT_CHIP = 0,    /**< chip, EVBME, radio and hardware initialisation */
+    MAIN_BOOT_JOIN,        /**< joining the Thread network */
+    MAIN_BOOT_CREDENTIALS, /**< serial number and password */
+    MAIN_BOOT_SPAKE,       /**< SPAKE2+ parameters */
+    MAIN_BOOT_STACK,       /**< oc_main_init, including the persistent data */
+    MAIN_BOOT_READY,       /**< first oc_main_poll, requests are handled from here */
+    MAIN_BOOT_DEFERRED,    /**< hostname, service publication and table printing */
+    MAIN_BOOT_PHASES
+} main_boot_phase_t;
+
+/**
+ * @brief timestamps of the boot
+ *
+ * Filled once during boot and kept afterwards, so the profile of the last
+ * boot (e.g. after a brown-out) can be read at any time.
+ */
+typedef struct main_boot_profile_t
+{
+    uint32_t end_ms[MAIN_BOOT_PHASES]; /**< time since power on at the end of each phase */
+    bool spake_cached;                 /**< the SPAKE2+ parameters were read from the cache */
+    bool complete;                     /**< all phases, including the deferred work, are done */
+} main_boot_profile_t;
+
+/* implemented in knx_iot_boot.c, shared by the sleepy and the wakeful main */
+
+/**
+ * @brief records the end of a boot phase
+ */
+void main_BootPhaseDone(main_boot_phase_t phase);
+
+/**
+ * @brief marks the boot as complete and prints the profile
+ */
+void main_BootComplete(void);
+
+/**
+ * @brief retrieves the boot profile
+ */
+const main_boot_profile_t *main_GetBootProfile(void);
+
+/**
+ * @brief sets the SPAKE2+ parameters from the cache, or decodes them from the
+ *        manufacturer storage and fills the cache
+ *
+ * The cache holds a hash of the serial number and password that were read from
+ * the manufacturer storage; after reflashing other credentials the record is
+ * decoded again.
+ *
+ * @param sn the stored serial number
+ * @param sn_len the length of the serial number
+ * @param pwd the stored password, NULL or empty if not found
+ */
+void main_BootLoadSpake(const uint8_t *sn, size_t sn_len, const char *pwd);
+
+/**
+ * @brief erases the SPAKE2+ cache, done on a factory reset
+ */
+void main_SpakeCacheClear(void);
+
+#if CASCODA_OTA_UPGRADE_ENABLED
+/**
+ * @brief handles a block of the software update, set with oc_set_swu_cb
+ *
+ * With APP_SWU_PIPELINE the block goes through the pipeline of the runtime
+ * (double buffering, hash and resume offset in the storage), which writes it
+ * to the OTA flash area with swu_cb of the Cascoda port. Without, the port
+ * receives the block directly and the runtime only accounts it.
+ */
+void main_SwuBlock(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
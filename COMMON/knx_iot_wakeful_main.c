@@ -59,12 +59,15 @@
 #include "cascoda-bm/cascoda_wait.h"
 
 #include "knx_iot_wakeful_main_extern.h"
+#include "knx_iot_sleepy_main.h"
 
 #include "api/oc_knx_dev.h"
 #include "api/oc_knx_fp.h"
 #include "port/oc_assert.h"
 #include "port/oc_clock.h"
 #include "port/oc_log.h"
+#include "knx_iot_log.h"
+#include "knx_iot_runtime.h"
 #include "port/dns-sd.h"
 #include "security/oc_spake2plus.h"
 #include "manufacturer_storage.h"
@@ -105,11 +108,6 @@ void hostname_cb(size_t device_index, oc_string_t host_name, void *data);
 int app_set_serial_number(char *serial_number);
 int app_init(void);
 
-#if CASCODA_OTA_UPGRADE_ENABLED
-// Implemented in the cascoda knx-iot port
-void swu_cb(size_t device_index, oc_separate_response_t *response, size_t binary_size, size_t offset, uint8_t *payload, size_t len, void *data);
-#endif
-
 /**
  * @file
  *  Example of wakeful main
@@ -193,25 +191,64 @@ static void signal_event_loop(void)
 static void prog_mode_cb(size_t device_index, bool programming_mode, void *data)
 {
 	(void)data;
-	PRINT_APP("prog_mode_cb(), device: %d, programming_mode %d\n", device_index, programming_mode);
+	APP_LOG_INFO("prog_mode_cb(), device: %d, programming_mode %d\n", device_index, programming_mode);
+	APP_TRACE(APP_TRACE_PROG_MODE, device_index, programming_mode);
 	programming_mode_embedded(device_index, programming_mode);
 }
 
 static void reset_cb(size_t device_index, int reset_value, void *data)
 {
 	(void)device_index;
-	PRINT_APP("reset_cb()\n");
-
+	APP_LOG_INFO("reset_cb()\n");
+
+	// store pending data before the reset changes or erases it
+	app_persist_flush();
+	// 2 and 7: factory reset, the credentials may be reflashed afterwards
+	if (reset_value == 2 || reset_value == 7)
+		main_SpakeCacheClear();
+	APP_TRACE(APP_TRACE_RESET, device_index, reset_value);
 	reset_embedded(device_index, reset_value, data);
 }
 
+// work that is not needed to handle requests, done after the first oc_main_poll
+static void boot_deferred_work(void)
+{
+	main_BootPhaseDone(MAIN_BOOT_READY);
+
+	// configure the hostname.
+	// note: this method sets the SN part to uppercase, as that is how
+	// the serial number is stored in the oc_device_info_t
+	oc_device_info_t *device = oc_core_get_device_info(0);
+	char hostname_str[50];
+	memset(hostname_str, 0, 49);
+	strcat(hostname_str, "knx-");
+	strcat(hostname_str, oc_string(device->serialnumber));
+	strcat(hostname_str, ".local");
+	oc_core_set_device_hostname(0, hostname_str);
+
+	uint64_t iid = oc_core_get_device_iid(THIS_DEVICE);
+	// Note: we are using printf here instead of PRINT so that
+	// this information always gets printed.
+	printf("Device iid: ");
+	oc_print_uint64_t(iid, DEC_REPRESENTATION);
+	printf("\n");
+
+	printf("group publisher table:\n");
+	oc_print_reduced_group_publisher_table();
+	printf("group recipient table:\n");
+	oc_print_reduced_group_recipient_table();
+
+	main_BootPhaseDone(MAIN_BOOT_DEFERRED);
+	main_BootComplete();
+}
+
 void swu_start_update_cb_imp(size_t device_index, uint32_t start_time, void *data)
 {
 	ca_error status = CA_ERROR_FAIL;
-	PRINT_APP("swu_start_update_cb_imp(), device: %d, applying new sofware in %d\n", device_index, start_time);
+	APP_LOG_INFO("swu_start_update_cb_imp(), device: %d, applying new sofware in %d\n", device_index, start_time);
 #if CASCODA_OTA_UPGRADE_ENABLED
 	status = ota_start_upgrade(start_time);
-	PRINT_APP("swu_start_update_cb_imp(), status = %d\n",status);
+	APP_LOG_INFO("swu_start_update_cb_imp(), status = %d\n",status);
 #endif
 }
 
@@ -269,6 +306,7 @@ int main(void)
 	/* Initialises handling of OTA Firmware Upgrade */
 	ota_upgrade_init();
 #endif
+	main_BootPhaseDone(MAIN_BOOT_CHIP);
 
 	// A backoff mechanism for joining the network
 	u32_t joinCooldownTimer = 0;
@@ -312,6 +350,7 @@ int main(void)
 
 		WAIT_ms(200);
 	} while (1);
+	main_BootPhaseDone(MAIN_BOOT_JOIN);
 
 	otThreadSetEnabled(OT_INSTANCE, true);
 
@@ -338,13 +377,13 @@ int main(void)
 
 	oc_storage_config("./knx_iot_creds");
 
-	uint8_t sn[6];
+	uint8_t sn[6] = {0};
 	/* configure the serial number. must be done before stack initialization */
 	error = knx_get_stored_serial_number(sn);
 	if (error)
 	{
-		PRINT_APP("ERROR: Unique serial number not found! Using default value...\n");
-		PRINT_APP(
+		APP_LOG_ERR("ERROR: Unique serial number not found! Using default value...\n");
+		APP_LOG_ERR(
 			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
 	} else {
 		// turn binary to hexadecimal
@@ -366,35 +405,21 @@ int main(void)
 	error = knx_get_stored_password(pwd);
 	if (error)
 	{
-		PRINT_APP("Error: Stored password not found! Using default value...\n");
-		PRINT_APP(
+		APP_LOG_WARN("Error: Stored password not found! Using default value...\n");
+		APP_LOG_WARN(
 			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
+		pwd[0] = '\0';
 	}
 	else
 	{
 		oc_spake_set_password(pwd);
 	}
-
-	uint8_t salt[32], rand[32];
-	uint32_t it;
-	mbedtls_mpi w0;
-	mbedtls_ecp_point L;
-	mbedtls_mpi_init(&w0);
-	mbedtls_ecp_point_init(&L);
-	error = knx_get_stored_spake(salt, rand, &it, &w0, &L);
-	if (error)
-	{
-		PRINT_APP("Error: Stored spake record not found! Using runtime generated values\n");
-		PRINT_APP(
-			"Please create the data file using knx-gen-data and flash it with chilictl in order to fix this issue.\n");
-	}
-	else
-	{
-		oc_spake_set_parameters(rand, salt, it, w0, L);
-		mbedtls_mpi_free(&w0);
-		mbedtls_ecp_point_free(&L);
-	}
 #endif
+	main_BootPhaseDone(MAIN_BOOT_CREDENTIALS);
+#ifdef OC_SPAKE
+	main_BootLoadSpake(sn, sizeof(sn), pwd);
+#endif
+	main_BootPhaseDone(MAIN_BOOT_SPAKE);
 
 	/* set the application callbacks */
 	oc_set_hostname_cb(hostname_cb, NULL);
@@ -402,7 +427,7 @@ int main(void)
 	oc_set_factory_presets_cb(factory_presets_cb, NULL);
 	oc_set_lsm_change_cb(lsm_change_cb, NULL);
 #if CASCODA_OTA_UPGRADE_ENABLED
-	oc_set_swu_cb(swu_cb, (void *)"image_name");
+	oc_set_swu_cb(main_SwuBlock, (void *)"image_name");
 	oc_set_swu_startupdate_cb(swu_start_update_cb_imp, (void *)"image_name");
 #endif
 	oc_set_programming_mode_cb(prog_mode_cb, NULL);
@@ -410,45 +435,27 @@ int main(void)
 	/* start the stack */
 	init = oc_main_init(&handler);
 	
-	// configure the hostname.
-	// note: this method sets the SN part to uppercase, as that is how
-	// the serial number is stored in the oc_device_info_t
-	oc_device_info_t *device = oc_core_get_device_info(0);
-	char hostname_str[50];
-	memset(hostname_str, 0, 49);
-	strcat(hostname_str, "knx-");
-	strcat(hostname_str, oc_string(device->serialnumber));
-	strcat(hostname_str, ".local");
-	oc_core_set_device_hostname(0, hostname_str);
+	main_BootPhaseDone(MAIN_BOOT_STACK);
 
-	oc_set_max_app_data_size(1024);
-	oc_set_mtu_size(1232);
+	oc_set_max_app_data_size(APP_MAX_APP_DATA_SIZE);
+	oc_set_mtu_size(APP_MTU_SIZE);
 
 	if (init < 0)
 	{
-		PRINT_APP("oc_main_init failed %d.\n", init);
+		APP_LOG_ERR("oc_main_init failed %d.\n", init);
 	}
 
-	PRINT("KNX IoT device, waiting on incoming connections.\n");
-
-	uint64_t iid = oc_core_get_device_iid(THIS_DEVICE);
-	// Note: we are using printf here instead of PRINT so that
-	// this information always gets printed.
-	printf("Device iid: ");
-	oc_print_uint64_t(iid, DEC_REPRESENTATION);
-	printf("\n");
-
-	printf("group publisher table:\n");
-	oc_print_reduced_group_publisher_table();
-	printf("group recipient table:\n");
-	oc_print_reduced_group_recipient_table();
+	APP_LOG_INFO("KNX IoT device, waiting on incoming connections.\n");
 
 	while (1)
 	{
 		cascoda_io_handler(&dev);
 		otTaskletsProcess(OT_INSTANCE);
 		hardware_poll();
+		app_event_process();
 		oc_main_poll();
+		if (!main_GetBootProfile()->complete)
+			boot_deferred_work();
 	}
 
 	/* shut down the stack, should not get here */
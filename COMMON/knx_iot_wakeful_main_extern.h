@@ -87,6 +87,19 @@ extern "C"
      */
     void reset_embedded(size_t device_index, int reset_value, void *data);
 
+    /**
+     * @brief write all pending (coalesced) persistent data to storage
+     *
+     */
+    void app_persist_flush(void);
+
+    /**
+     * @brief process the events posted by the hardware callbacks,
+     * before oc_main_poll
+     *
+     */
+    int app_event_process(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
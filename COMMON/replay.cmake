@@ -0,0 +1,47 @@
+# replay of recorded events against a baseline
+#
+# app_replay(<bench target> <recording>) adds the target <bench target>_replay,
+# which runs "<bench target> -replay <recording>" in a new folder
+# ${PROJECT_BINARY_DIR}/replay/<bench target> (no stored state of an earlier
+# run) and compares the replay_total lines with the baseline
+# ${PROJECT_SOURCE_DIR}/<bench target>.baseline.csv of the repository:
+#   - the number of events of a kind is the same, else the recording changed
+#   - the storage writes, s-mode messages and display bytes may not grow at all
+#   - with REPLAY_BASELINE_<bench target>, the cpu time of an event kind may grow
+#     by REPLAY_TOLERANCE percent (at least 1 ms)
+# A missing baseline fails the target. REPLAY_UPDATE_BASELINE writes the results
+# as the new baseline, to be committed with the change that explains them.
+# The cpu time of another machine is not comparable: the baseline of the
+# repository is written with cpu_us and max_us 0 and its cpu time is not
+# compared. REPLAY_BASELINE_<bench target> selects a file of the machine, that
+# is written and compared with the cpu time.
+# e.g. cmake --build . --target knx_iot_bench_replay
+
+set(REPLAY_TOLERANCE 25 CACHE STRING "allowed growth in percent of the replay cpu time")
+option(REPLAY_UPDATE_BASELINE "write the replay results as the baseline instead of comparing" OFF)
+set(REPLAY_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/replay_compare.cmake)
+
+function(app_replay target recording)
+  set(baseline ${PROJECT_SOURCE_DIR}/${target}.baseline.csv)
+  set(cpu OFF)
+  if(DEFINED REPLAY_BASELINE_${target})
+    set(baseline ${REPLAY_BASELINE_${target}})
+    set(cpu ON)
+  endif()
+  file(MAKE_DIRECTORY ${PROJECT_BINARY_DIR}/replay)
+  add_custom_target(${target}_replay
+    COMMAND ${CMAKE_COMMAND}
+      -DIMAGE=$<TARGET_FILE:${target}>
+      -DRECORDING=${recording}
+      -DNAME=${target}
+      -DOUT=${PROJECT_BINARY_DIR}/replay
+      -DBASELINE=${baseline}
+      -DTOLERANCE=${REPLAY_TOLERANCE}
+      -DUPDATE=${REPLAY_UPDATE_BASELINE}
+      -DCPU=${cpu}
+      -P ${REPLAY_SCRIPT}
+    DEPENDS ${target} ${recording}
+    WORKING_DIRECTORY ${PROJECT_BINARY_DIR}/replay
+    VERBATIM
+  )
+endfunction()
@@ -0,0 +1,91 @@
+# run by the <target>_replay target of app_replay (replay.cmake), with cmake -P
+# inputs: IMAGE RECORDING NAME OUT BASELINE TOLERANCE UPDATE CPU
+
+# the storage of the application starts empty
+file(REMOVE_RECURSE ${OUT}/${NAME})
+file(MAKE_DIRECTORY ${OUT}/${NAME})
+execute_process(COMMAND ${IMAGE} -replay ${RECORDING}
+  WORKING_DIRECTORY ${OUT}/${NAME}
+  OUTPUT_VARIABLE output
+  RESULT_VARIABLE result)
+file(WRITE ${OUT}/${NAME}.replay.csv "${output}")
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "replay ${NAME}: ${RECORDING} failed (${result}), see ${OUT}/${NAME}.replay.csv")
+endif()
+
+# replay_total,<event>,<count>,<cpu_us>,<max_us>,<storage_writes>,<smode_sent>,<display_bytes>
+string(REGEX MATCHALL "replay_total,[a-z]+,[0-9]+,[0-9]+,[0-9]+,[0-9]+,[0-9]+,[0-9]+" totals "${output}")
+if(NOT totals)
+  message(FATAL_ERROR "replay ${NAME}: no results, see ${OUT}/${NAME}.replay.csv")
+endif()
+if(UPDATE)
+  string(REPLACE ";" "\n" lines "${totals}")
+  if(NOT CPU)
+    # the baseline of the repository: the cpu time is of this machine only
+    string(REGEX REPLACE "(replay_total,[a-z]+,[0-9]+),[0-9]+,[0-9]+," "\\1,0,0," lines "${lines}")
+  endif()
+  file(WRITE ${BASELINE}
+    "# baseline of ${NAME}_replay, written by -DREPLAY_UPDATE_BASELINE=ON, see COMMON/replay.cmake\n"
+    "replay_total,event,count,cpu_us,max_us,storage_writes,smode_sent,display_bytes\n${lines}\n")
+  message(STATUS "replay ${NAME}: baseline written to ${BASELINE}")
+  return()
+endif()
+if(NOT EXISTS ${BASELINE})
+  message(FATAL_ERROR "replay ${NAME}: no baseline ${BASELINE}, configure with -DREPLAY_UPDATE_BASELINE=ON to write it")
+endif()
+
+file(STRINGS ${BASELINE} baseline REGEX "^replay_total,[a-z]+,[0-9]")
+set(failed "")
+foreach(total ${totals})
+  string(REPLACE "," ";" now "${total}")
+  list(GET now 1 event)
+  list(GET now 2 count)
+  list(GET now 3 cpu_us)
+  list(GET now 5 writes)
+  list(GET now 6 sent)
+  list(GET now 7 display)
+  set(old "")
+  foreach(line ${baseline})
+    if(line MATCHES "^replay_total,${event},")
+      string(REPLACE "," ";" old "${line}")
+    endif()
+  endforeach()
+  if(NOT old)
+    string(APPEND failed " ${event}: not in the baseline;")
+    continue()
+  endif()
+  list(GET old 2 old_count)
+  list(GET old 3 old_cpu_us)
+  list(GET old 5 old_writes)
+  list(GET old 6 old_sent)
+  list(GET old 7 old_display)
+  # at least 1 ms, the resolution of clock() on some hosts
+  math(EXPR slack "${old_cpu_us} * ${TOLERANCE} / 100")
+  if(slack LESS 1000)
+    set(slack 1000)
+  endif()
+  math(EXPR max_cpu_us "${old_cpu_us} + ${slack}")
+  if(NOT CPU)
+    # cpu_us 0 in the baseline: not measured on this machine, not compared
+    set(max_cpu_us ${cpu_us})
+  endif()
+  message(STATUS "replay ${NAME} ${event}: ${count} events (baseline ${old_count}), cpu ${cpu_us} us (${old_cpu_us}), storage writes ${writes} (${old_writes}), s-mode ${sent} (${old_sent}), display ${display} bytes (${old_display})")
+  if(NOT count EQUAL old_count)
+    string(APPEND failed " ${event}: ${count} events, the baseline has ${old_count};")
+  endif()
+  if(cpu_us GREATER max_cpu_us)
+    string(APPEND failed " ${event}: cpu ${cpu_us} us > ${max_cpu_us} us;")
+  endif()
+  if(writes GREATER old_writes)
+    string(APPEND failed " ${event}: storage writes ${writes} > ${old_writes};")
+  endif()
+  if(sent GREATER old_sent)
+    string(APPEND failed " ${event}: s-mode ${sent} > ${old_sent};")
+  endif()
+  if(display GREATER old_display)
+    string(APPEND failed " ${event}: display ${display} bytes > ${old_display};")
+  endif()
+endforeach()
+if(failed)
+  message(FATAL_ERROR "replay ${NAME}: worse than ${BASELINE}:${failed}")
+endif()
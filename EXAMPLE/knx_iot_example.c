@@ -44,110 +44,25 @@
  
  * ## Application Design
  *
- * support functions:
+ * the tables of the application:
  *
- * - app_init
- *   initializes the stack values.
- * - register_resources
- *   function that registers all endpoints,
- *   e.g. sets the GET/PUT/POST/DELETE
- *      handlers for each end point
+ * - g_datapoints
+ *   the data points, with their resources and global variables
+ * - g_url_index
+ *   the url lookup index
+ * - g_datapoint_types
+ *   the descriptors of the DPTs of the application
+ * - g_app_info
+ *   the device information
  *
- * - main
- *   starts the stack, with the registered resources.
- *   can be compiled out with NO_MAIN
- *
- *  handlers for the implemented methods (get/put):
- *   - get_[path]
- *     function that is being called when a GET is called on [path]
- *     set the global variables in the output
- *   - put_[path]
- *     function that is being called when a PUT is called on [path]
- *     if input data is of the correct type
- *       updates the global variables
- *
- * ## stack specific defines
- * - __linux__
- *   build for Linux
- * - WIN32
- *   build for Windows
- * - OC_OSCORE
- *   oscore is enabled as compile flag
- * ## File specific defines
- * - NO_MAIN
- *   compile out the function main()
- * - INCLUDE_EXTERNAL
- *   includes header file "external_header.h", so that other tools/dependencies
- *   can be included without changing this code
- * - KNX_GUI
- *   build the GUI with console option, so that all
- *   logging can be seen in the command window
+ * The handlers, the codecs, app_init, register_resources and main are
+ * implemented by the shared runtime, see knx_iot_runtime.c
  */
 #include "oc_api.h"
-#include "oc_core_res.h"
-#include "oc_rep.h"
-#include "oc_helpers.h"
-#include "api/oc_knx_fp.h"
-#include "port/oc_clock.h"
-#include <signal.h>
-/* test purpose only; commandline reset */
-#include "api/oc_knx_dev.h"
-#ifdef OC_SPAKE
-#include "security/oc_spake2plus.h"
-#endif
-#ifdef INCLUDE_EXTERNAL
-/* import external definitions from header file*/
-/* this file should be externally supplied */
-#include "external_header.h"
-#endif
 #include "knx_iot_example.h"
 
-#include <stdlib.h>
-#include <ctype.h>
-
-#ifdef __linux__
-/** linux specific code */
-#include <pthread.h>
-#ifndef NO_MAIN
-static pthread_mutex_t mutex;
-static pthread_cond_t cv;
-static struct timespec ts;
-#endif /* NO_MAIN */
-#endif
-
-#include <stdio.h> /* defines FILENAME_MAX */
-#include <string.h>
-#include <stdbool.h>
-#include <ctype.h>
-#define STORE_PREFIX "app"
-
-#define MY_NAME "KNX Switching example" /**< The name of the application */
-#define APP_MAX_STRING 30
-
-#ifdef WIN32
-/** windows specific code */
-#include <windows.h>
-static CONDITION_VARIABLE cv; /**< event loop variable */
-static CRITICAL_SECTION cs;   /**< event loop variable */
-#include <direct.h>
-#define GetCurrentDir _getcwd
-#else
-#include <unistd.h>
-#define GetCurrentDir getcwd
-#endif
-
-#ifdef HARDWARE_INIT
- void hardware_init(void);
-#endif /* hardware init */
-
-#define btoa(x) ((x) ? "true" : "false")
-volatile int quit = 0;  /**< stop variable, used by handle_signal */
-bool g_reset = false;   /**< reset variable, set by commandline arguments */
 char g_serial_number[20] = "00FA10010710";
 
-
-
-
 volatile DPT_Switch gLED_1;   /**< global variable for LED_1 */
 volatile DPT_Switch gPB_1;   /**< global variable for PB_1 */
 volatile DPT_Switch gInfoOnOff_1;   /**< global variable for InfoOnOff_1 */
@@ -158,7 +73,8 @@ volatile bool g_faultLED_1;   /**< global variable for fault LED_1 */
 void
 get_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data);
 void
-put_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data);const char *const mdLED_1[3] = {
+put_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data);        
+const char *const mdLED_1[3] = {
   "desc", "On/Off switch 1", 
   NULL
 }; const char *const mdPB_1[3] = {
@@ -169,6 +85,7 @@ put_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_da
   NULL
 };  
 const size_t num_datapoints = 3; /** number of data points */ 
+const size_t num_parameters = 0; /** number of parameters */
 
 oc_resource_dummy_t app_resource_end = {NULL, -1};
 oc_resource_data_t runtime_dataLED_1;
@@ -297,1661 +214,58 @@ _Pragma("warning(default:4090)")
 _Pragma("GCC diagnostic pop")
 #endif
 
-typedef const void* (*app_get_variable_fn)(const char*, void*);
-typedef const void* (*app_get_array_fn)(const char*, void*, int);
-typedef const void* (*app_get_array_elems_fn)(const char*, void*, int start, int n);
-typedef void (*app_set_default_value_fn)(const char*);
-typedef void (*app_set_variable_fn)(const char*, const void*);
-typedef void (*app_set_array_fn)(const char*, const void*, int n, bool store_persistently);
-typedef void (*app_set_array_elems_fn)(const char*, const void*, int start, int n, bool store_persistently);
-typedef void (*oc_encode_fn)(const void*, bool is_metadata);
-typedef void (*oc_encode_array_fn)(const void*, int n);
-typedef void (*oc_encode_array_fn)(const void*, int n);
-typedef bool (*oc_parse_fn)(oc_rep_t *rep, void *out);
-typedef bool (*oc_parse_array_fn)(oc_rep_t *rep, void *out, int n);
-typedef bool (*persistent_load_fn)(const char *filename, void *out);
-typedef bool (*persistent_load_array_fn)(const char *filename, void *out, int n);
-
-struct datapoint_type_t {
-  size_t size;
-  app_get_variable_fn app_get_variable;
-  app_get_array_fn app_get_array;
-  app_get_array_elems_fn app_get_array_elems;
-  app_set_default_value_fn app_set_default_value;
-  app_set_variable_fn app_set_variable;
-  app_set_array_fn app_set_array;
-  app_set_array_elems_fn app_set_array_elems;
-  oc_encode_fn oc_encode;
-  oc_encode_array_fn oc_encode_array;
-  oc_parse_fn oc_parse;
-  oc_parse_array_fn oc_parse_array;
-  persistent_load_fn persistent_load;
-  persistent_load_array_fn persistent_load_array;
-};
-
-const struct datapoint_type_t g_datapoint_types[DatapointType_MAX_NUM] = {
-  {sizeof(bool)},
-  {sizeof(int)},
-  {sizeof(float)},
-  {sizeof(char*)},
-  {
-    sizeof(DPT_Switch),   // DPT_Switch DPT_Switch
-    (app_get_variable_fn)app_get_DPT_Switch_variable,
-    (app_get_array_fn)app_get_DPT_Switch_array,
-    (app_get_array_elems_fn)app_get_DPT_Switch_array_elems,
-    (app_set_default_value_fn)app_set_DPT_Switch_default_value,
-    (app_set_variable_fn)app_set_DPT_Switch_variable,
-    (app_set_array_fn)app_set_DPT_Switch_array,
-    (app_set_array_elems_fn)app_set_DPT_Switch_array_elems,
-    (oc_encode_fn)oc_encode_DPT_Switch,
-    (oc_encode_array_fn)oc_encode_DPT_Switch_array,
-    (oc_parse_fn)oc_parse_DPT_Switch,
-    (oc_parse_array_fn)oc_parse_DPT_Switch_array,
-    (persistent_load_fn)persistent_load_DPT_Switch,
-    (persistent_load_array_fn)persistent_load_DPT_Switch_array,
-  }, 
-};
-
-size_t get_dpt_size(DatapointType t) {
-  return g_datapoint_types[t].size;
-}
-
-static const char *get_datapoint_name(const datapoint_t *dp) {
-  return oc_string(dp->resource.name);
-}
-
-static const char *get_datapoint_url(const datapoint_t *dp) {
-  return oc_string(dp->resource.uri);
-}
-
-static const char *get_datapoint_dpt(const datapoint_t *dp) {
-  return oc_string(dp->resource.dpt);
-}
-
-static const char *get_datapoint_dpa(const datapoint_t *dp) {
-  for (int i = 0; i < oc_string_array_size(dp->resource.types); i++) {
-    const char *rt = oc_string_array(dp->resource.types)[i];
-    if (strstr(rt, "dpa.") != NULL)
-      return rt;
-  }
-  return NULL;
-}
-
-static const char *const *get_datapoint_metadata(const datapoint_t *dp) {
-  return dp->metadata;
-}
-
-static bool oc_encode_datapoint(const datapoint_t *dp, int pn, int ps, bool is_metadata) {
-  size_t count = dp->num_elements;
-  const struct datapoint_type_t *dpt = &g_datapoint_types[dp->type];
-  int n = ps;
-  count = count?count:1;
-  if (pn*ps+n >= count)
-    n = count-pn*ps;
-  if (ps > 1 && dpt->oc_encode_array == NULL)
-    return false;
-  if (ps == 1 && dpt->oc_encode == NULL)
-    return false;
-  if (dpt->app_get_array_elems == NULL)
-    return false;
-  void *var = malloc(get_dpt_size(dp->type) * (ps));
-  if(g_datapoint_types[dp->type].app_get_array_elems(get_datapoint_url(dp), var, pn*ps, n) == NULL) {
-    free(var);
-    return false;
-  }
-  
-  if (ps > 1) 
-    g_datapoint_types[dp->type].oc_encode_array(var, n);
-  else 
-    g_datapoint_types[dp->type].oc_encode(var, is_metadata);
-  
-  free(var);
-  return true;
-}
-
-static bool oc_parse_datapoint(const datapoint_t *dp, oc_rep_t *rep, void *out, int n) {
-  const struct datapoint_type_t *dpt = &g_datapoint_types[dp->type];
-  if (out == NULL || rep == NULL)
-    return false;
-  if (n > 1){
-    if (dpt->oc_parse_array == NULL)
-      return false;
-    return dpt->oc_parse_array(rep, out, n);
-  }
-  else{
-    if (dpt->oc_parse == NULL)
-      return false;
-    return dpt->oc_parse(rep, out);
-  } 
-}
-
-void datapoint_set(const datapoint_t *dp, void *in, int start, int n) 
-{
-  if (in == NULL)
-    return;
-  if (start > 0 || n > 1){
-    if (g_datapoint_types[dp->type].app_set_array)
-      g_datapoint_types[dp->type].app_set_array_elems(get_datapoint_url(dp), in, start, n, true);
-  }
-  else
-    if (g_datapoint_types[dp->type].app_set_variable)
-      g_datapoint_types[dp->type].app_set_variable(get_datapoint_url(dp), in);
-}
-
-const datapoint_t *get_datapoint_by_url(const char *url) {
-  //this can likely be optimised in the future for speed
-  //with a binary search or similar
-  
-  bool is_param = false;
-  if (strncmp(url,"/p/p",4) == 0) {
-    is_param = true;
-  }
-  
-
-  if (is_param == false) {
-    for(int i = 0; i < num_datapoints; i++) {
-      const datapoint_t *it = &g_datapoints[i];
-      const char *_url = get_datapoint_url(it);
-      // it always start with /p/<url>
-      if (strcmp((char *)&_url[3], (char *)&url[3]) == 0) {
-        return it;
-      }
-    }
-  } 
- 
-  return NULL;
-}
-
-int app_get_url_array_size(const char *url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL)
-    return -1;
-  return dp->num_elements;
-}
-
-bool get_module_url(char* out_url, const char* in_url, int module_index)
-{
-  int digits_after_underscore = 0;
-  size_t url_length = strlen(in_url);
-  size_t keep_len;
-  char temp[50];
-      
-  // Find out how many more digits we have after the underscore
-  for (int i = url_length - 1; i >= 0; --i)
-  {
-      // We have reached the underscore, we can stop counting
-      if (*(in_url + i) == '_')
-          break; 
-          
-      // We have counted one more digit after the underscore
-      if (isdigit(*(in_url + i)))
-          ++digits_after_underscore;
-      else // We have encountered a non-digit and non-underscore, which is unexpected.
-          return true; 
-  }
-  
-  // We can now calculate the number of characters that we need to keep from the original URL
-  keep_len = url_length - digits_after_underscore;
-  
-  // Copy over those characters into a temp array
-  strncpy(temp, in_url, keep_len);
-  temp[keep_len] = '\0';
-  
-  // Add the module number at the end, and set the out_url pointer
-  sprintf(temp + strlen(temp), "%d", module_index);
-  strcpy(out_url, temp);
-  
-  return false;
-}
-
-// Getters/Setters for DPT_Switch
-
-bool app_is_DPT_Switch_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  
-  if (dp->type == DatapointType_DPT_Switch) {
-    return true;
-  }
-  return false;
-}
-
-void app_set_DPT_Switch_default_value(const char* url)
-{
-  (void)url;
-  // No default value, do nothing...
-}
-
-void app_set_DPT_Switch_array_elems(const char* url, const DPT_Switch* in, int start, int n, bool store_persistently)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return;
-  }
-  if (start+n > max_elem) {
-    n = max_elem-start;
-  }
-  if (dp->g_var) {
-    memcpy(&((DPT_Switch*)dp->g_var)[start], in, sizeof(DPT_Switch)*n);
-    if (dp->persistent && store_persistently) {
-      persistent_store_DPT_Switch_array(get_datapoint_url(dp), (DPT_Switch*)dp->g_var, max_elem);
-    }
-  }else if (dp->persistent && store_persistently) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Switch *data = calloc(sizeof(DPT_Switch), count);
-    memcpy(&data[start], in, n*sizeof(DPT_Switch));
-    persistent_store_DPT_Switch_array(get_datapoint_url(dp), data, count);
-    free(data);
-  }
-  return;
-}
-
-void app_set_DPT_Switch_array(const char* url, const DPT_Switch* in, int n, bool store_persistently)
-{
-  app_set_DPT_Switch_array_elems(url, in, 0, n, store_persistently);
-}
-
-void app_set_DPT_Switch_variable(const char* url, const DPT_Switch* in)
-{
-  app_set_DPT_Switch_array(url, in, 1, true);
-}
-
-const DPT_Switch* app_get_DPT_Switch_array_elems(const char *url, DPT_Switch* out, int start, int n)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return NULL;
-  }
-  int max_elem = dp->num_elements;
-  if(max_elem == 0) {
-    max_elem = 1;
-  }
-  if (start >= max_elem) {
-    return NULL;
-  }
-  if (start+n > max_elem){
-    n = max_elem - start;
-  }
-  if (dp->g_var) {
-    if (out == NULL) {
-      return dp->g_var;
-    }
-    memcpy(out, &((DPT_Switch*)dp->g_var)[start], sizeof(DPT_Switch)*n);
-    return out;
-  }else if (dp->persistent && out) {
-    int count = dp->num_elements;
-    count = count?count:1;
-    DPT_Switch *data = calloc(sizeof(DPT_Switch), count);
-    memset(out, 0, n*sizeof(DPT_Switch));
-    if (persistent_load_DPT_Switch_array(get_datapoint_url(dp), data, count)) {
-      memcpy(out, &data[start], n*sizeof(DPT_Switch));
-    }
-    free(data);
-    return out;
-  }
-  return NULL;
-}
-
-const DPT_Switch* app_get_DPT_Switch_array(const char *url, DPT_Switch* out, int n)
-{
-  return app_get_DPT_Switch_array_elems(url, out, 0, n);
-}
-
-const DPT_Switch* app_get_DPT_Switch_variable(const char *url, DPT_Switch* out)
-{
-  return app_get_DPT_Switch_array(url, out, 1);
-}
-
-bool oc_parse_DPT_Switch_single(oc_rep_t *rep, DPT_Switch *out)
-{
-  oc_array_t arr;
-// ('bool', OrderedDict([('@Id', 'DPST-1-1_F-1'), ('@Cleared', 'Off'), ('@Set', 'On')]))
-  if (rep->type != OC_REP_BOOL) return false;
-  if (rep->type != OC_REP_BOOL) return false;
-  // todo Fix void
-   bool ret = oc_rep_i_get_bool(rep, 1, (void*)out);
-  
-  return ret;
-}
-
-bool oc_parse_DPT_Switch(oc_rep_t *rep, DPT_Switch *out)
-{
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && rep->iname != 1) {
-    rep = rep->next;
-  }
-  if (rep == NULL) {
-    return false;
-  }
-  return oc_parse_DPT_Switch_single(rep, out);
-}
-
-bool oc_parse_DPT_Switch_array(oc_rep_t *rep, DPT_Switch *out, int n)
-{
-  oc_rep_t *rep_arr;
-  int i = 0;
-  if (rep == NULL || out == NULL) {
-    return false;
-  }
-  while (rep != NULL && i < n){
-    if (rep->type != OC_REP_OBJECT) {
-      return false;
-    }
-    oc_parse_DPT_Switch(rep->value.object, &out[i]);
-    rep = rep->next;
-    i++;
-  }
-  return true;
-}
-
-void oc_encode_DPT_Switch_single(CborEncoder *parent, const DPT_Switch *in)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_i_set_key(parent, 1);
-  cbor_encode_boolean(parent, (bool)*in);
-}
-
-void oc_encode_DPT_Switch(const DPT_Switch *in, bool is_metadata)
-{
-  if (in == NULL) {
-    return;
-  }
-  if (!is_metadata) { // Don't begin & end root object as it's already done during metadata handling
-    oc_rep_begin_root_object();
-  }
-  oc_encode_DPT_Switch_single(oc_rep_object(root), in);
-  if (!is_metadata) {
-    oc_rep_end_root_object();
-  }
-}
-
-void oc_encode_DPT_Switch_array(const DPT_Switch *in, int n)
-{
-  if (in == NULL) {
-    return;
-  }
-  oc_rep_begin_links_array();
-  for (int i = 0; i < n; i++) {
-    oc_rep_begin_object(oc_rep_array(links), obj);
-    oc_encode_DPT_Switch_single(oc_rep_object(obj), &in[i]);
-    oc_rep_end_object(oc_rep_array(links), obj);
-  }
-  oc_rep_end_links_array();
-}
-
-void persistent_store_DPT_Switch(const char *name, const DPT_Switch *in)
-{
-  persistent_store_DPT_Switch_array(name, in, 1);
-}
-
-void persistent_store_DPT_Switch_array(const char *name, const DPT_Switch *in, int n)
-{
-  uint8_t *rep_buf;
-  long ret;
-  const size_t max_size = 4 * n + 2;
-  rep_buf = malloc(max_size);
-#ifdef OPTIMIZE_STORAGE
-// use input as storage name with "/p/" prefix removed
- const char* store_name = (char *)&name[3];
-#else
-    char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/');
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-
-  oc_rep_new(rep_buf, max_size);
-  oc_encode_DPT_Switch_array(in, n);
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    PRINT_APP("storing '%s', size: %d\n", name, size);
-    for(int i = 0; i < size; i++) {
-      PRINT_APP("%02X ", rep_buf[i]);
-    }
-    PRINT_APP("\n");
-    ret = oc_storage_write(store_name, rep_buf, size);
-  }else{
-    PRINT_APP("Error encoding DPT_Switch %s for storage\n", name);
-  }
-
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_write failed with error: %d\n", -ret);
-  }
-  free(rep_buf);
-}
-
-bool persistent_load_DPT_Switch(const char *name, DPT_Switch *out)
-{
-  return persistent_load_DPT_Switch_array(name, out, 1);
-}
-
-bool persistent_load_DPT_Switch_array(const char *name, DPT_Switch *out, int n)
-{
-  oc_rep_t *rep = NULL;
-  int max_size = 4 * n + 2;
-  uint8_t *oc_storage_buf;
-#ifdef OPTIMIZE_STORAGE
- // use input as storage name with "/p/" prefix removed
-  const char* store_name = (char *)&name[3];
-#else
-  char store_name[32] = STORE_PREFIX;
-  strcat(store_name, name);
-  char *pos = strchr(store_name, '/'); 
-  while(pos) {
-    *pos = '_';
-    pos = strchr(store_name, '/');
-  }
-#endif
-  long ret;
-  bool error = true;
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-  oc_storage_buf = malloc(max_size);
-  struct oc_memb *prev_rep_obj = oc_rep_get_pool();
-  oc_rep_set_pool(&rep_objects);
-
-  ret = oc_storage_read(store_name, oc_storage_buf, max_size);
-  PRINT_APP("oc_storage_read() returned %d\n", ret);
-  for(int i = 0; i < ret; i++) {
-    PRINT_APP("%02X ", oc_storage_buf[i]);
-  }
-  PRINT_APP("\n");
-  if (ret <= 0) {
-    PRINT_APP("oc_storage_read failed with error: %d\n", -ret);
-    goto err;
-  }
-  if (oc_parse_rep(oc_storage_buf, ret, &rep) != CborNoError) {
-    goto err;
-  }
-  if (oc_parse_DPT_Switch_array(rep, out, n) != true) {
-    goto err;
-  }
-  error = false;
-err:
-  free(oc_storage_buf);
-  oc_free_rep(rep);
-  if(error) {
-    oc_storage_erase(name);
-  }
-  oc_rep_set_pool(prev_rep_obj);
-  return !error;
-}
-
-int app_sprintf_DPT_Switch(const DPT_Switch *in, char* text, int size)
-{
-  char item[50];
-  memset(text, 0, size);
-  if (in == NULL) {
-    return 1;
-  }
-  sprintf(item," %d ", *in);
-  strcat(text, item);
-
-  return 0;
-}
-
-int app_sscanf_DPT_Switch(DPT_Switch *in, char* text)
-{
-  char temp_string[300];
-  const char s[2] = " ";
-  char *token;
-  
-  if (text == NULL) {
-    return 1;
-  }
-  memset(temp_string, 0, 300);
-  strncpy(temp_string, text, 299);
-  int retval = 0;
-
-  // strtok is destructing the input string so copy it first
-  token = strtok(temp_string, s);
-  // bool
-  {
-    int var;
-    retval = sscanf(token, " %d", &var);
-    if (retval != 1) return 1;
-    *in = (bool)var;
-  }
-
-  return 0;
-}
-
-int app_str_expected_DPT_Switch(int select, char* text)
-{
-  if (text == NULL) {
-    return 1;
-  }
-  if (select == 1) {
-  // bool
-    strcat(text, " %d");
-    return 0;
-  }
-  
-  if (select == 2) {
-    strcat(text, " 0");
-    return 0;
-  }
-  
-  return 1;
-}
-
-// BOOLEAN code
-
-/**
- * @brief function to check if the url is represented by a boolean
- *
- * @param true = url value is a boolean
- * @param false = url is not a boolean
- */
-bool app_is_bool_url(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  return dp->type == DatapointType_bool;
-}
-
-/**
- * @brief sets the global boolean variable at the url
- *
- * Note: if the url is ot found then the value is not changed
- *
- * @param url the url indicating the global variable
- * @param value the value to be set
- */
-void app_set_bool_variable(const char* url, bool value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  if (dp->type != DatapointType_bool) {
-    return;
-  }
-  if (dp->g_var) {
-    *((bool*)dp->g_var) = value;
-  }
-}
-
-/**
- * @brief retrieve the global boolean variable at the url
- *
- * @param url the url indicating the global variable
- * @return the value of the variable
- */
-bool app_retrieve_bool_variable(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->type != DatapointType_bool) {
-    return false;
-  }
-  if (dp->g_var) {
-    return *((bool*)dp->g_var);
-  }
-  return false;
-}
-
-
-/**
- * @brief retrieve the global int variable at the url
- *
- * @param url the url indicating the global variable
- * @param value ptr to value (which is going to be set)
- * @return the true if variable is set
- */
-bool app_retrieve_int_variable(const char* url, int* value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->type != DatapointType_int) {
-    return false;
-  }
-  if (dp->g_var) {
-    value = ((int*)dp->g_var);
-    return true;
-  }
-  return false;
-}
-
-
-// FAULT code
-
-/**
- * @brief set the fault (boolean) variable at the url
- *
- * @param url the url indicating the fault variable
- * @param value the value of the fault variable
- */
-void app_set_fault_variable(const char* url, bool value)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return;
-  }
-  if ((dp->resource.interfaces & OC_IF_A) == 0) {
-    return;
-  }
-  if (dp->g_fault) {
-    *((bool*)dp->g_fault) = value;
-  }
-  //TODO: Add back support for changing the feedback variable
-}
-
-/**
- * @brief retrieve the fault (boolean) variable at the url
- *
- * @param url the url indicating the fault variable
- * @return the value of the fault variable
- */
-bool app_retrieve_fault_variable(const char* url)
-{
-  const datapoint_t *dp = get_datapoint_by_url(url);
-  if (dp == NULL) {
-    return false;
-  }
-  if (dp->resource.interfaces & OC_IF_A == 0) {
-    return false;
-  }
-  if (dp->g_fault) {
-    return *((bool*)dp->g_fault);
-  }
-  return false;
-}
-
-// PARAMETER code
-
-bool app_is_url_parameter(const char* url)
-{
-  // all parametes start with /p/pxxx
-  if (strncmp(url,"/p/p",4) == 0 ) {
-    return false;
-  }
-
-   
-  return false;
-}
-
-const char* app_get_parameter_url(int index)
-{
- 
-  return NULL;
-}
-
-const char* app_get_parameter_name(int index)
-{
-   
-  return NULL;
-}
-
-bool app_is_secure()
-{
-#ifdef OC_OSCORE
-  return true;
-#else
-  return false;
-#endif /* OC_OSCORE */
-}
-
-static oc_put_struct_t app_put = { NULL };
-
-void
-app_set_put_cb(oc_put_cb_t cb)
-{
-  app_put.cb = cb;
-}
-
-oc_put_struct_t *
-oc_get_put_cb(void)
-{
-  return &app_put;
-}
-
-void do_put_cb(const char* url)
-{
-  oc_put_struct_t *my_cb = oc_get_put_cb();
-  if (my_cb && my_cb->cb) {
-    my_cb->cb(url);
-  }
-}
-
-static oc_get_struct_t app_get = { NULL };
-
-void
-app_set_get_cb(oc_get_cb_t cb)
-{
-  app_get.cb = cb;
-}
-
-oc_get_struct_t *
-oc_get_get_cb(void)
-{
-  return &app_get;
-}
-
-void do_get_cb(const char* url)
-{
-  oc_get_struct_t *my_cb = oc_get_get_cb();
-  if (my_cb && my_cb->cb) {
-    my_cb->cb(url);
-  }
-}
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-int app_initialize_stack();
-void signal_event_loop(void);
-void register_resources(void);
-void initialize_variables();
-void reset_variables();
-void logic_initialize();
-int app_init(void);
-#ifdef __cplusplus
-}
-#endif
-
-// DEVBOARD code
-
-/**
- * @brief devboard button toggle callback
- *
- */
-// we no longer have app_set_bool_variable
-//void dev_btn_toggle_cb(char *url)
-//{
-//  PRINT_APP("Handling %s\n", url);
-//  bool val = app_retrieve_bool_variable(url);
-//  if (val == true)
-//  {
-//    val = false;
-//  }
-//  else
-//  {
-//    val = true;
-//  }
-//  app_set_bool_variable(url, val);
-//  oc_do_s_mode_with_scope(5, url, "w");
-//}
-
-/**
- * @brief s-mode response callback
- * will be called when a response is received on an s-mode read request
- *
- * @param url the url
- * @param rep the full response
- * @param rep_value the parsed value of the response
- */
-void
-oc_add_s_mode_response_cb(char *url, oc_rep_t *rep, oc_rep_t *rep_value)
-{
-  (void)rep;
-  (void)rep_value;
-
-  PRINT("oc_add_s_mode_response_cb %s\n", url);
-}
-
-
-
-/**
- * @brief function to set the input string to upper case
- *
- * @param str the string to make upper case
- *
- */
-void app_str_to_upper(char *str){
-  while (*str != '\0')
-  {
-    *str = toupper(*str);
-    str++;
-  }
-}
-
-/**
- * @brief function to set up the device.
- *
- * sets the:
- * - manufacturer     : cascoda
- * - serial number    : 00FA10010710
- * - base path
- * - knx spec version
- * - hardware version : [0, 4, 0]
- * - firmware version : [0, 4, 0]
- * - hardware type    : 000000000000
- * - device model     : dev board example
- *
- */
-int
-app_init(void)
-{
-  int ret = oc_init_platform("cascoda", NULL, NULL);
-  char serial_number_uppercase[20];
-
-  /* set the application name, version, base url, device serial number */
-  ret |= oc_add_device(MY_NAME, "1.0.0", "//", g_serial_number, NULL, NULL);
-
-  oc_device_info_t *device = oc_core_get_device_info(0);
-
-#ifdef LINUX
-  #define MAX_HOSTNAME 50
-  char hostname[50];
-  // set the hostname
-  ret = gethostname(&hostname[0], 50);
-  if (ret != -1) {
-    printf("Hostname (linux):    %s\n", hostname);
-    oc_core_set_device_hostname(0, hostname);
-  }
-#endif
-#ifdef WIN32
-  char hostname_str[50];
-  int error = gethostname(hostname_str, 50);
-  if (error == 0) {
-    printf("Hostname (win32):    %s\n", hostname_str);
-    oc_core_set_device_hostname(0, hostname_str);
-  }
-#endif
-
-  
-  /* set the hardware version 0.4.0 */
-  oc_core_set_device_hwv(0, 0, 4, 0);
-  
-  
-  /* set the firmware version 0.4.0 */
-  oc_core_set_device_fwv(0, 0, 4, 0);
-  
-  
-  /* manufacturer id */
-  oc_core_set_device_mid(0, 0x00FA);
-  /* set the hardware type*/
-  oc_core_set_device_hwt(0, "000000000000");
-  /* set the model */
-  oc_core_set_device_model(0, "dev board example");
-
-  oc_set_s_mode_response_cb(oc_add_s_mode_response_cb);
-#define PASSWORD "4N6AFK6T83YWDUTW23U2"
-#ifdef OC_SPAKE
-  if (strlen(oc_spake_get_password()) == 0)
-    oc_spake_set_password(PASSWORD);
-
-
-  strncpy(serial_number_uppercase, oc_string(device->serialnumber), 19);
-  app_str_to_upper(serial_number_uppercase);
-  printf("\n === QR Code: KNX:S:%s;P:%s ===\n", serial_number_uppercase, oc_spake_get_password());
-#endif
-
-  initialize_variables();  
-
-  return ret;
-}
+const datapoint_t g_parameters[1]; /**< no parameters */
 
 /**
- * @brief returns the password
- */
-const char* app_get_password()
-{
-#ifdef OC_SPAKE
-  return oc_spake_get_password();
-#else
-  return PASSWORD;
-#endif
-}
-
-
-bool request_query_get_int(oc_request_t *request, const char *query, int *out)
-{
-  char *query_str;
-  
-  int query_len = oc_get_query_value(request, query, &query_str);
-  if(query_len <= 0) {
-    return false;
-  }
-  char buf[16];
-  strncpy(buf, query_str, query_len);
-  *out = atoi(buf);
-  return true;
-}
-
-void
-get_generic(oc_request_t *request, oc_interface_mask_t interfaces, void *user_data)
-{
-  
-  const datapoint_t *dp = user_data; 
-
-  bool error_state = false; /* the error state, the generated code */
-
-  if (dp == NULL) {
-    dp = get_datapoint_by_url(request->uri_path);
-    if (dp == NULL) {
-      PRINT("Error dp is NULL\n");
-      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-      return;
-    }
-  }
-
-  PRINT("-- Begin get_generic  (%s) \n", get_datapoint_name(dp));
-
-  /* MANUFACTORER: SENSOR add here the code to talk to the HW if one implements a
-     sensor. the call to the HW needs to fill in the global variable before it
-     returns to this function here. alternative is to have a callback from the
-     hardware that sets the global variables.
-  */
-
-  /* check if the accept header is CBOR */
-  if (oc_check_accept_header(request, APPLICATION_CBOR) == false) {
-    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-    return;
-  }
-
-  // check the query parameter m with the various values
-  char *m;
-  char* m_key;
-  size_t m_key_len;
-  size_t m_len = (int)oc_get_query_value(request, "m", &m);
-  int pn, ps;
-  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
-  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
-  if (m_len != -1) {
-    PRINT("  Query param: %.*s\n",(int)m_len, m);
-    oc_init_query_iterator();
-    size_t device_index = request->resource->device;
-    oc_device_info_t *device = oc_core_get_device_info(device_index);
-    if (device != NULL) {
-      bool m_valid = false;
-      oc_rep_begin_root_object();
-      while (oc_iterate_query(request, &m_key, &m_key_len, &m, &m_len) != -1) {
-        // value
-        if ((strncmp(m, "value", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          if (oc_encode_datapoint(dp, pn, ps, true) == false) {
-            oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-            goto done;
-          }
-        }
-        // unique identifier
-        if ((strncmp(m, "id", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          char mystring[100];
-          snprintf(mystring,99,"knx://sn.%s%s",oc_string(device->serialnumber),
-            oc_string(request->resource->uri));
-          oc_rep_i_set_text_string(root, 0, mystring);
-        }
-        // href, i.e. url
-        if ((strncmp(m, "href", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          // Valid and mandatory metadata, but "can be omitted in response"
-          m_valid = true;
-          oc_rep_set_text_string(root, href, get_datapoint_url(dp));
-        }
-        // resource types
-        if ((strncmp(m, "rt", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          const char *dpa = get_datapoint_dpa(dp);
-          if (dpa)
-            oc_rep_set_text_string(root, rt, &dpa[7]);
-        }
-        // interfaces
-        if ((strncmp(m, "if", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          oc_rep_set_key(oc_rep_object(root), "if");
-          oc_rep_begin_array(oc_rep_object(root), if);
-          for (int i = 1; i <= (1<<OC_MAX_IF_MASKS); i <<=1)
-            if (dp->resource.interfaces&i)
-              oc_rep_add_text_string(if, get_interface_string(dp->resource.interfaces&i));
-          oc_rep_end_array(oc_rep_object(root), if);
-        }
-        if ((strncmp(m, "dpt", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          char *full_dpt = oc_string(request->resource->dpt);
-          oc_rep_set_text_string(root, dpt, &full_dpt[7]);
-        }
-        // ga
-        if ((strncmp(m, "ga", m_len) == 0) |
-            (strncmp(m, "*", m_len) == 0) ) {
-          m_valid = true;
-          int index = oc_core_find_group_object_table_url(oc_string(request->resource->uri));
-          if (index > -1) {
-            oc_group_object_table_t* got_table_entry = oc_core_get_group_object_table_entry(index);
-            if (got_table_entry) {
-               oc_rep_set_int_array(root, ga, got_table_entry->ga, got_table_entry->ga_len);
-            }
-          }
-        }
-        for (const char *const *md = get_datapoint_metadata(dp); md && *md; md+=2) {
-          if((strncmp(m, md[0], m_len) == 0) |
-              (strncmp(m, "*", m_len) == 0) ) {
-                m_valid = true;
-                oc_rep_set_text_string_no_tag(root, md[0]);
-                oc_rep_set_text_string_no_tag(root, md[1]);
-              }
-        }
-      } /* query iterator */
-      oc_rep_end_root_object();
-      if (m_valid == false) {
-        oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
-        goto done;
-      }
-    } else {
-      /* device is NULL */
-      oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-      goto done;
-    }
-    oc_send_cbor_response(request, OC_STATUS_OK);
-    goto done;
-  }
-  if (oc_encode_datapoint(dp, pn, ps, false) == false) {
-    oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-    goto done;
-  }
-  if (g_err) {
-    error_state = true;
-  }
-  PRINT("CBOR encoder size %d\n", oc_rep_get_encoded_payload_size());
-  if (error_state == false) {
-    oc_send_cbor_response(request, OC_STATUS_OK);
-  } else {
-    oc_send_response_no_format(request, OC_STATUS_BAD_OPTION);
-  }
-done:
-  PRINT("-- End get_generic (%s)\n", get_datapoint_url(dp));
-}
-
-
-void
-put_generic(oc_request_t *request, oc_interface_mask_t interfaces,
-                void *user_data)
-{
-  (void)interfaces;
-  const datapoint_t *dp = user_data;
-  bool error_state = true;
-
-  if (dp == NULL) {
-    dp = get_datapoint_by_url(request->uri_path);
-    if (dp == NULL) {
-      PRINT("Error dp is NULL\n");
-      oc_send_response_no_format(request, OC_STATUS_INTERNAL_SERVER_ERROR);
-      return;
-    }
-  }
-
-  PRINT("-- Begin put_generic (%s):\n", get_datapoint_url(dp));
-
-  oc_rep_t *rep = NULL;
-  int pn, ps;
-  if(!request_query_get_int(request, "pn", &pn) || dp->num_elements == 0) pn = 0;
-  if(!request_query_get_int(request, "ps", &ps) || dp->num_elements == 0) ps = 1;
-  /* handle the different requests e.g. via s-mode or normal CoAP call*/
-  if (oc_is_redirected_request(request)) {
-    PRINT("  redirected request..\n");
-  }
-  rep = request->request_payload;
-  /* loop over all the entries in the request */
-  /* handle the type of payload correctly. */
-  void *new_value = malloc(get_dpt_size(dp->type) * ps);
-  error_state = !oc_parse_datapoint(dp, rep, new_value, ps);
-
-  if (error_state == false){
-    const oc_resource_t *my_resource =
-    oc_ri_get_app_resource_by_uri(request->uri_path, strlen(request->uri_path), 0);
-    if (my_resource != NULL)
-      oc_notify_observers(my_resource);
-
-    oc_send_response_no_format(request, OC_STATUS_CHANGED);
-    datapoint_set(dp, new_value, pn*ps, ps);
-    if (dp->feedback_url) {
-      //check types match
-      const datapoint_t *feedback = get_datapoint_by_url(dp->feedback_url);
-      if (feedback->type == dp->type && feedback->num_elements == dp->num_elements) {
-        datapoint_set(feedback, new_value, pn*ps, ps);
-        PRINT("  Send status to '%s' with flag: 'w'\n", get_datapoint_url(feedback));
-        oc_do_s_mode_with_scope(5, dp->feedback_url, "w");
-      }
-    }
-
-    do_put_cb(get_datapoint_url(dp));
-  } else {
-    /* request data was not recognized, so it was a bad request */
-    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
-  }
-  free(new_value);
-  PRINT("-- End put_generic (%s)\n", get_datapoint_url(dp));
-}
-
-
-/**
- * @brief register all the data point resources to the stack
- * this function registers all data point level resources:
- * - each resource path is bind to a specific function for the supported methods
- *  (GET, PUT)
- * - each resource is
- *   - secure
- *   - observable
- *   - discoverable through well-known/core
- *   - used interfaces as: dpa.xxx.yyy
- *      - xxx : function block number
- *      - yyy : data point function number
- */
-void
-register_resources(void)
-{
-  const datapoint_t *it;
-  const char *_t[2] = {
-    "Datapoint",
-    "Parameter"
-  };
-  const char **t = _t;
-  PRINT_APP("Adding const resource block\n");
-  const datapoint_t *dp = &g_datapoints[0];
-
-  oc_ri_add_resource_block(&g_datapoints[0].resource); 
-}
-
-#ifdef MQTT_PROXY
-void
-configure_mqtt_from_parameters() {
-  strncpy(g_mqttconf_server, gMQTT_hostname0, sizeof(g_mqttconf_server));
-  g_mqttconf_port = gMQTT_port_number0;
-  strncpy(g_mqttconf_username, gMQTT_username0, sizeof(g_mqttconf_username));
-  strncpy(g_mqttconf_pwd, gMQTT_password0, sizeof(g_mqttconf_pwd));
-  strncpy(g_iid_name, gIID_name0, sizeof(g_iid_name));
-  PRINT("MQTT configuration:\n");
-  PRINT(" hostname: %s\n", g_mqttconf_server);
-  PRINT(" port    : %d\n", g_mqttconf_port);
-  PRINT(" username: %s\n", g_mqttconf_username);
-  PRINT(" password: %s\n", g_mqttconf_pwd);
-  PRINT(" IID name: %s\n", g_iid_name);
-}
-#endif
-
-/**
- * @brief callback when a/lsm state changes
- * @param device_index the device identifier of the list of devices
- * @param current_state current state (i.e. after the change)
- * @param data the supplied data.
- */
-void
-lsm_change_cb(size_t device_index, oc_lsm_state_t current_state, void *data)
-{
-  (void)device_index;
-  (void)data;
-}
-
-/**
- * @brief initiate preset for device
- * current implementation: device reset as command line argument
- * @param device_index the device identifier of the list of devices
- * @param data the supplied data.
- */
-void
-factory_presets_cb(size_t device_index, void *data)
-{
-  (void)device_index;
-  (void)data;
-  reset_variables();
-}
-
-/**
- * @brief set the host name on the device (application depended)
+ * @brief url lookup index, covering datapoints (/p/o) and parameters (/p/p)
  *
- * @param device_index the device identifier of the list of devices
- * @param host_name the host name to be set on the device
- * @param data the supplied data.
+ * sorted on the suffix (strcmp order), so that a binary search can be used
  */
-void
-hostname_cb(size_t device_index, oc_string_t host_name, void *data)
-{
-  (void)device_index;
-  (void)data;
-
-  PRINT("-----host name ------- %s\n", oc_string(host_name));
-}
-
-static oc_event_callback_retval_t send_delayed_response(void *context)
-{
-  oc_separate_response_t *response = (oc_separate_response_t *)context;
-
-  if (response->active)
-  {
-    oc_set_separate_response_buffer(response);
-    oc_send_separate_response(response, OC_STATUS_CHANGED);
-    PRINT_APP("Delayed response sent\n");
-  }
-  else
-  {
-    PRINT_APP("Delayed response NOT active\n");
-  }
-
-  return OC_EVENT_DONE;
-}
+const url_index_entry_t g_url_index[] = {
+  { "o_1_1", &g_datapoints[0] },
+  { "o_2_2", &g_datapoints[1] },
+  { "o_3_3", &g_datapoints[2] },
+};
+const size_t g_url_index_size =
+  sizeof(g_url_index) / sizeof(g_url_index[0]);
 
-#if defined WIN32 || defined __linux__
 /**
- * @brief software update callback
+ * @brief scratch area for the value of a single GET or PUT request
  *
- * @param device the device index
- * @param response the instance of an internal struct that is used to track
- *       		   the state of the separate response
- * @param binary_size the full size of the binary
- * @param offset the offset of the image
- * @param payload the image data
- * @param len the length of the image data
- * @param data the user data
- */
-void swu_cb(size_t device,
-            oc_separate_response_t *response,
-            size_t binary_size,
-            size_t offset,
-            uint8_t *payload,
-            size_t len,
-            void *data)
-{
-  (void)device;
-  (void)binary_size;
-  char filename[] = "./downloaded.bin";
-  PRINT(" swu_cb %s block=%d size=%d \n", filename, (int)offset, (int)len);
-
-  FILE *write_ptr = fopen("downloaded_bin", "ab");
-  size_t r = fwrite(payload, sizeof(*payload), len, write_ptr);
-  fclose(write_ptr);
-
-  oc_set_delayed_callback(response, &send_delayed_response, 0);
-}
-#endif
-
-/**
- * @brief initializes the global variables
- * for the resources
- * for the parameters
- */
-void
-initialize_variables(void)
-{
-  /* initialize global variables for resources */
-  /* if wanted read them from persistent storage */
-  /* parameter variables */
-  uint8_t oc_storage_buf[32];
-  long ret;
-  bool err;
-
-  PRINT_APP("Initializing persistent data\n");
-
-  for(int i = 0; i < num_datapoints; i++) {
-    const datapoint_t *it = &g_datapoints[i];
-    if (!it->persistent && !it->default_present) continue;
-    if (it->g_var == NULL) continue;
-    if (it->num_elements){
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load_array == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load_array(get_datapoint_url(it), (void*)it->g_var, it->num_elements);
-        }
-      }
-    } else {
-      if (it->default_present){
-        g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-      }
-      if (it->persistent) {
-        if (g_datapoint_types[it->type].persistent_load == NULL){
-          PRINT_APP("ERR: persistent load array missing for %d\n", it->type);
-        } else {
-          g_datapoint_types[it->type].persistent_load(get_datapoint_url(it), (void*)it->g_var);
-        }
-      }
-    }
-  } 
- 
-}
-/**
- * @brief reset variables to default value
- * for the resources
- * for the parameters
- */
-void
-reset_variables(void)
-{
-  /* reset variables to default value */
-  PRINT_APP("Resetting to default value\n");
-
-  for(int i = 0; i < num_datapoints; i++) {
-    const datapoint_t *it = &g_datapoints[i];
-    if (it->persistent) {
-      oc_storage_erase(get_datapoint_url(it));
-    }
-    if (it->default_present){
-      g_datapoint_types[it->type].app_set_default_value(get_datapoint_url(it));
-    }
-  } 
- 
-}
-
-int app_set_serial_number(const char* serial_number)
-{
-  strncpy(g_serial_number, serial_number, 20);
-  return 0;
-}
-
-int app_initialize_stack()
-{
-  int init;
-  char *fname = "my_software_image";
-
-  PRINT("KNX-IOT Server name : \"%s\"\n", MY_NAME);
-
-  /* show the current working folder */
-  char buff[FILENAME_MAX];
-  char *retbuf = NULL;
-  retbuf = GetCurrentDir(buff, FILENAME_MAX);
-  if (retbuf != NULL) {
-    PRINT("Current working dir: %s\n", buff);
-  }
-
-  /*
-   The storage folder depends on the build system
-   the folder is created in the makefile, with $target as name with _cred as
-   post fix.
-  */
-#ifdef WIN32
-  char storage[400];
-  sprintf(storage,"./knx_iot_example_%s",g_serial_number);
-  PRINT("\tstorage at '%s' \n",storage);
-  oc_storage_config(storage);
-#else
-  PRINT("\tstorage at 'knx_iot_example_creds' \n");
-  oc_storage_config("./knx_iot_example_creds");
-#endif /* WIN32 */
-
-
-  /* initializes the handlers structure */
-  static oc_handler_t handler = { .init = app_init,
-                                  .signal_event_loop = signal_event_loop,
-                                  .register_resources = register_resources,
-                                  .requests_entry = NULL };
-
-  /* set the application callbacks */
-  oc_set_hostname_cb(hostname_cb, NULL);
-  oc_set_factory_presets_cb(factory_presets_cb, NULL);
-	oc_set_lsm_change_cb(lsm_change_cb, NULL);
-
-#if defined WIN32 || defined __linux__
-  oc_set_swu_cb(swu_cb, (void *)fname);
-#endif /* WIN32 || defined __linux__ */
-
-  /* start the stack */
-  init = oc_main_init(&handler);
-
-  if (init < 0) {
-    PRINT("oc_main_init failed %d, exiting.\n", init);
-    return init;
-  }
-
-  if (g_reset) {
-    PRINT("factory_presets_cb: resetting device\n");
-    oc_knx_device_storage_reset(0, 2);
-  }
-
-  oc_knx_knx_ignore_smessage_from_self(true);
-
-#ifdef OC_OSCORE
-  PRINT("OSCORE - Enabled\n");
-#else
-  PRINT("OSCORE - Disabled\n");
-#endif /* OC_OSCORE */
-
-  oc_device_info_t *device = oc_core_get_device_info(0);
-  PRINT("serial number: %s\n", oc_string(device->serialnumber));
-  oc_endpoint_t *my_ep = oc_connectivity_get_endpoints(0);
-  if (my_ep != NULL) {
-    PRINTipaddr(*my_ep);
-    PRINT("\n");
-  }
-  PRINT("Server \"%s\" running, waiting on incoming "
-        "connections.\n",
-        MY_NAME);
-  return 0;
-}
-
-#ifdef WIN32
-/**
- * @brief signal the event loop (windows version)
- * wakes up the main function to handle the next callback
- */
-void
-signal_event_loop(void)
-{
-
-#ifndef NO_MAIN
-  WakeConditionVariable(&cv);
-#endif /* NO_MAIN */
-}
-#endif /* WIN32 */
-
-#ifdef __linux__
-/**
- * @brief signal the event loop (Linux)
- * wakes up the main function to handle the next callback
+ * sized for the largest data point (num_elements * size of the type),
+ * so that the request path does not need any heap allocations
  */
-void
-signal_event_loop(void)
+typedef union dp_scratch_t
 {
-#ifndef NO_MAIN
-  pthread_mutex_lock(&mutex);
-  pthread_cond_signal(&cv);
-  pthread_mutex_unlock(&mutex);
-#endif /* NO_MAIN */
-}
-#endif /* __linux__ */
+  DPT_Switch v_DPT_Switch[1];
+  uint64_t align;
+} dp_scratch_t;
+static dp_scratch_t g_get_scratch; /**< scratch area used by oc_encode_datapoint */
+static dp_scratch_t g_put_scratch; /**< scratch area used by put_generic */
+const app_scratch_t g_dp_scratch = { &g_get_scratch, &g_put_scratch, sizeof(dp_scratch_t) };
 
+/* the fields of the DPTs, in encoding order */
+static const dpt_field_t fDPT_Switch[] = { DPT_SCALAR(DPT_Switch, DPT_FIELD_BOOL) };
 
-#ifndef NO_MAIN
+/* the specialised codecs of the DPTs, with APP_DPT_FUNCTION_TABLE */
+DPT_SCALAR_CODECS(DPT_Switch, BOOL)
 
 /**
- * @brief handle Ctrl-C
- * @param signal the captured signal
+ * @brief the descriptors of the data types, indexed with DatapointType
  */
-static void
-handle_signal(int signal)
-{
-  (void)signal;
-  signal_event_loop();
-  quit = 1;
-}
-
-/**
- * @brief print usage and quits
- *
- */
-static void
-print_usage()
-{
-  PRINT("Usage:\n");
-  PRINT("no arguments : starts the server\n");
-  PRINT("-help  : this message\n");
-  PRINT("reset  : does an full reset of the device\n");
-  PRINT("-s <serial number> : sets the serial number of the device\n");
-#ifdef MQTT_PROXY
-  PRINT("MQTT proxy configurations (only used before ETS download):\n");
-  PRINT("-host : sets the MQTT broker hostname\n");
-  PRINT("-port : sets the MQTT broker port number\n");
-  PRINT("-username : sets the MQTT username\n");
-  PRINT("-pwd : sets the MQTT password\n");
-#endif
-  exit(0);
-}
-
-/**
- * @brief main application.
- * initializes the global variables
- * registers and starts the handler
- * handles (in a loop) the next event.
- * shuts down the stack
- */
-int
-main(int argc, char *argv[])
-{
-  oc_clock_time_t next_event;
-  bool do_send_s_mode = false;
-
-
-#ifdef HARDWARE_INIT
-  hardware_init();
-#endif /* hardware init */
-
-
-#ifdef KNX_GUI
-  WinMain(GetModuleHandle(NULL), NULL, (LPSTR)GetCommandLine(), SW_SHOWNORMAL);
-#endif /* KNX_GUI */
-
-#ifdef WIN32
-  /* windows specific */
-  InitializeCriticalSection(&cs);
-  InitializeConditionVariable(&cv);
-  /* install Ctrl-C */
-  signal(SIGINT, handle_signal);
-#endif /* WIN32 */
-#ifdef __linux__
-  /* Linux specific */
-  struct sigaction sa;
-  sigfillset(&sa.sa_mask);
-  sa.sa_flags = 0;
-  sa.sa_handler = handle_signal;
-  /* install Ctrl-C */
-  sigaction(SIGINT, &sa, NULL);
-  #define MAX_HOSTNAME 256
-  char hostname[MAX_HOSTNAME];
-  // set the hostname
-  ret = gethostname(&hostname[0], MAX_HOSTNAME);
-  if (ret != -1) {
-    printf("Hostname:    %s\n", hostname);
-    oc_core_set_device_hostname(0, hostname, MAX_HOSTNAME);
-  }
-#endif  /* __linux__ */
-
-  for (int i = 0; i < argc; i++) {
-    PRINT_APP("argv[%d] = %s\n", i, argv[i]);
-    if (strcmp(argv[i], "-help") == 0) {
-      print_usage();
-    }
-    if (strcmp(argv[i], "reset") == 0) {
-      PRINT(" internal reset\n");
-      g_reset = true;
-    }
-    if (strcmp(argv[i], "-s") == 0) {
-      if (i + 1 < argc) {
-        // serial number
-        PRINT("serial number %s\n", argv[i + 1]);
-        app_set_serial_number(argv[i + 1]);
-      } else {
-        PRINT("ERROR: \"-s\" flag detected, but no serial number provided!\n");
-      }
-    }
-#ifdef MQTT_PROXY
-      if (strcmp(argv[i], "-host") == 0) {
-        if (i + 1 < argc) {
-          // hostname for MQTT proxy server
-          PRINT("MQTT proxy host %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_server, argv[i + 1], sizeof(g_mqttconf_server));
-        } else {
-          PRINT("ERROR: \"-host\" flag detected, but no hostname provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-port") == 0) {
-        if (i + 1 < argc) {
-          // port number for MQTT proxy server
-          PRINT("MQTT proxy port number %s\n", argv[i + 1]);
-          g_mqttconf_port = atoi(argv[i + 1]);
-        } else {
-          PRINT("ERROR: \"-port\" flag detected, but no port number provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-username") == 0) {
-        if (i + 1 < argc) {
-          // username for MQTT proxy server
-          PRINT("MQTT proxy username %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_username, argv[i + 1], sizeof(g_mqttconf_username));
-        } else {
-          PRINT("ERROR: \"-username\" flag detected, but no username provided!\n");
-        }
-      }
-      if (strcmp(argv[i], "-pwd") == 0) {
-        if (i + 1 < argc) {
-          // password for MQTT proxy server
-          PRINT("MQTT proxy pwd %s\n", argv[i + 1]);
-          strncpy(g_mqttconf_pwd, argv[i + 1], sizeof(g_mqttconf_pwd));
-        } else {
-          PRINT("ERROR: \"-pwd\" flag detected, but no password provided!\n");
-        }
-      }
-#endif
-  }
-
-  /* do all initialization */
-  app_initialize_stack();
-
-#ifdef WIN32
-  /* windows specific loop */
-  while (quit != 1) {
-    next_event = oc_main_poll();
-    if (next_event == 0) {
-      SleepConditionVariableCS(&cv, &cs, INFINITE);
-    } else {
-      oc_clock_time_t now = oc_clock_time();
-      if (now < next_event) {
-        SleepConditionVariableCS(
-          &cv, &cs, (DWORD)((next_event - now) * 1000 / OC_CLOCK_SECOND));
-      }
-    }
-  }
-#endif /* WIN32 */
+const struct datapoint_type_t g_datapoint_types[DatapointType_MAX_NUM] = {
+  DATAPOINT_TYPE_GENERIC_ROWS,
+  /* DPT_Switch */ { sizeof(DPT_Switch), fDPT_Switch, 1, 0, NULL DPT_CODECS(DPT_Switch) },
+};
+const size_t num_datapoint_types = DatapointType_MAX_NUM;
 
-#ifdef __linux__
-  /* Linux specific loop */
-  while (quit != 1) {
-    next_event = oc_main_poll();
-    pthread_mutex_lock(&mutex);
-    if (next_event == 0) {
-      pthread_cond_wait(&cv, &mutex);
-    } else {
-      ts.tv_sec = (next_event / OC_CLOCK_SECOND);
-      ts.tv_nsec = (next_event % OC_CLOCK_SECOND) * 1.e09 / OC_CLOCK_SECOND;
-      pthread_cond_timedwait(&cv, &mutex, &ts);
-    }
-    pthread_mutex_unlock(&mutex);
-  }
-#endif /* __linux__ */
+/* state of the data points, num_datapoints + num_parameters */
+datapoint_state_t g_datapoint_state[3];
 
-  /* shut down the stack */
-  oc_main_shutdown();
-  return 0;
-}
-#endif /* NO_MAIN */
+const app_info_t g_app_info = {
+  "KNX Switching example", /* name */
+  "dev board example",     /* model */
+  "4N6AFK6T83YWDUTW23U2",  /* spake password */
+  "knx_iot_example",       /* storage */
+  NULL,                    /* init */
+};
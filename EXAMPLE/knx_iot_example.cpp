@@ -44,6 +44,7 @@
 #ifndef WX_PRECOMP
     #include <wx/wx.h>
 #endif
+#include <atomic>
 
 #define NO_MAIN
 #include "knx_iot_example.h"
@@ -66,7 +67,8 @@ enum
   REC_TABLE_ID = PUB_TABLE_ID + 1, // ID for the recipient table window
   PARAMETER_LIST_ID = REC_TABLE_ID + 1, // ID for the parameter window
   AT_TABLE_ID = PARAMETER_LIST_ID + 1, // ID for the auth/at window
-  CHECK_GA_DISPLAY = AT_TABLE_ID + 1 , // ga display check
+  STACK_UPDATE_ID = AT_TABLE_ID + 1, // ID for the stack thread update event
+  CHECK_GA_DISPLAY = STACK_UPDATE_ID + 1 , // ga display check
   CHECK_IID_DISPLAY = CHECK_GA_DISPLAY + 1, // iid display check
   CHECK_GRPID_DISPLAY = CHECK_IID_DISPLAY + 1, // grpid display check
   CHECK_SLEEPY = CHECK_GRPID_DISPLAY + 1 , // sleepy check
@@ -83,6 +85,186 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] =
 
 wxCmdLineParser* g_cmd;
 
+//----------------------------------------------------
+//----------------------------------------------------
+//----------------------------------------------------
+
+/**
+ * @brief lock for all access to the stack
+ * the stack is polled on its own thread (StackThread),
+ * the UI thread takes this lock before reading or changing stack data.
+ * recursive, since the update functions are also called from handlers
+ * that already hold the lock.
+ */
+static wxMutex g_stack_mutex(wxMUTEX_RECURSIVE);
+
+/**
+ * @brief the UI parts that need an update, set by the stack thread
+ */
+enum
+{
+  UI_DIRTY_DATAPOINTS = 1, // data point values
+  UI_DIRTY_DEVICE = 2      // IA, IID, programming mode, load state
+};
+static std::atomic<unsigned> g_ui_dirty(0);
+
+/**
+ * @brief runs the stack
+ * polls the stack, then waits until the next timer of the stack expires
+ * or until the stack is signalled (e.g. network data received).
+ * changes are posted to the UI thread as a wxThreadEvent (QueueEvent).
+ */
+class StackThread : public wxThread
+{
+public:
+  StackThread(wxEvtHandler* frame) : wxThread(wxTHREAD_JOINABLE), m_cv(m_mutex), m_frame(frame) {}
+  void Wake(bool force);
+  void Stop();
+  void SetSleepy(bool sleepy) { m_sleepy = sleepy; }
+  void PostUpdate(unsigned dirty);
+
+private:
+  virtual ExitCode Entry();
+  void WaitUntil(oc_clock_time_t next_event, bool force_only);
+
+  wxMutex m_mutex;
+  wxCondition m_cv;
+  bool m_wake = false;       // signalled by the stack
+  bool m_force_wake = false; // signalled by the UI, also wakes a sleepy device
+  std::atomic<bool> m_quit{ false };
+  std::atomic<bool> m_sleepy{ false };
+  int m_sleep_seconds = 20;
+  wxEvtHandler* m_frame;
+};
+
+static StackThread* g_stack_thread = NULL;
+
+/**
+ * @brief wakes up the stack thread
+ *
+ * @param force true: wake up a sleeping (sleepy) device too
+ */
+void StackThread::Wake(bool force)
+{
+  wxMutexLocker lock(m_mutex);
+  m_wake = true;
+  if (force) {
+    m_force_wake = true;
+  }
+  m_cv.Signal();
+}
+
+/**
+ * @brief stops the thread, call Wait() afterwards
+ */
+void StackThread::Stop()
+{
+  m_quit = true;
+  Wake(true);
+}
+
+/**
+ * @brief waits until next_event (stack time, 0 = no timeout) or a wake up
+ *
+ * @param next_event the time of the next stack event
+ * @param force_only only a forced wake up (from the UI) ends the wait
+ */
+void StackThread::WaitUntil(oc_clock_time_t next_event, bool force_only)
+{
+  wxMutexLocker lock(m_mutex);
+  while (!m_quit && !m_force_wake && !(m_wake && !force_only)) {
+    if (next_event == 0) {
+      m_cv.Wait();
+      continue;
+    }
+    oc_clock_time_t now = oc_clock_time();
+    if (now >= next_event) {
+      break;
+    }
+    m_cv.WaitTimeout((unsigned long)((next_event - now) * 1000 / OC_CLOCK_SECOND) + 1);
+  }
+  m_wake = false;
+  m_force_wake = false;
+}
+
+/**
+ * @brief the stack loop
+ * takes into account if the device is sleepy
+ * e.g. then it only does an poll each 20 seconds
+ */
+wxThread::ExitCode StackThread::Entry()
+{
+  oc_device_info_t last_device;
+  memset(&last_device, 0, sizeof(last_device));
+
+  while (!m_quit) {
+    oc_clock_time_t next_event;
+    bool in_pm;
+    bool device_changed;
+    {
+      wxMutexLocker lock(g_stack_mutex);
+      // the events posted by the UI, before the poll
+      app_event_process();
+      next_event = oc_main_poll();
+      in_pm = oc_knx_device_in_programming_mode(0);
+      oc_device_info_t* device = oc_core_get_device_info(0);
+      device_changed = device->ia != last_device.ia || device->iid != last_device.iid ||
+        device->pm != last_device.pm || device->lsm_s != last_device.lsm_s;
+      last_device.ia = device->ia;
+      last_device.iid = device->iid;
+      last_device.pm = device->pm;
+      last_device.lsm_s = device->lsm_s;
+    }
+    if (device_changed) {
+      this->PostUpdate(UI_DIRTY_DEVICE);
+    }
+    if (m_sleepy && !in_pm) {
+      // sleepy device: sleep for the sleep period, only the UI can wake it up
+      // in programming mode the device stays reactive.
+      WaitUntil(oc_clock_time() + m_sleep_seconds * OC_CLOCK_SECOND, true);
+    } else {
+      WaitUntil(next_event, false);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief post an update of the UI to the UI thread
+ * only one update is queued at the time
+ *
+ * @param dirty the parts of the UI that need an update
+ */
+void StackThread::PostUpdate(unsigned dirty)
+{
+  if (g_ui_dirty.fetch_or(dirty) == 0) {
+    m_frame->QueueEvent(new wxThreadEvent(wxEVT_THREAD, STACK_UPDATE_ID));
+  }
+}
+
+/**
+ * @brief called by the stack (on any thread) when it needs a poll
+ */
+static void gui_signal_event_loop(void)
+{
+  if (g_stack_thread) {
+    g_stack_thread->Wake(false);
+  }
+}
+
+/**
+ * @brief called by the stack thread when a data point is changed by a put
+ *
+ * @param url the url of the data point
+ */
+static void gui_put_cb(const char* url)
+{
+  (void)url;
+  if (g_stack_thread) {
+    g_stack_thread->PostUpdate(UI_DIRTY_DATAPOINTS);
+  }
+}
+
 class CustomDialog : public wxDialog
 {
 public:
@@ -135,6 +317,7 @@ class MyFrame : public wxFrame
 {
 public:
   MyFrame(char* serial_number);
+  ~MyFrame();
 private:
   void OnGroupObjectTable(wxCommandEvent& event);
   void OnPublisherTable(wxCommandEvent& event);
@@ -147,7 +330,7 @@ private:
   void OnClearTables(wxCommandEvent& event);
   void OnExit(wxCommandEvent& event);
   void OnAbout(wxCommandEvent& event);
-  void OnTimer(wxTimerEvent& event);    
+  void OnStackUpdate(wxThreadEvent& event);
   void OnPressed_PB_1(wxCommandEvent& event); 
 
   void updateInfoCheckBoxes();
@@ -162,11 +345,6 @@ private:
   wxMenu* m_menuFile;
   wxMenu* m_menuDisplay;
   wxMenu* m_menuOptions;
-  wxTimer m_timer;
-  
-  // sleepy information
-  int m_sleep_counter = 0;
-  int m_sleep_seconds = 20;
 
   wxTextCtrl* m_ia_text;  // text control for internal address
   wxTextCtrl* m_iid_text; // text control for installation id
@@ -359,9 +537,26 @@ MyFrame::MyFrame(char* str_serial_number)
   this->updateInfoCheckBoxes();
   this->updateTextButtons();
   this->updateInfoCheckBoxes();
-  // start the timer for UI updates and stack polls
-  m_timer.Bind(wxEVT_TIMER, &MyFrame::OnTimer, this);
-  m_timer.Start(1, wxTIMER_CONTINUOUS);  // 1 millisecond interval
+  // run the stack on its own thread, the UI is only updated on changes
+  Bind(wxEVT_THREAD, &MyFrame::OnStackUpdate, this, STACK_UPDATE_ID);
+  app_set_put_cb(gui_put_cb);
+  g_stack_thread = new StackThread(this);
+  app_set_signal_event_loop_cb(gui_signal_event_loop);
+  g_stack_thread->Run();
+}
+
+/**
+ * @brief Destroy the My Frame:: My Frame object
+ * stops the stack thread
+ */
+MyFrame::~MyFrame()
+{
+  app_set_signal_event_loop_cb(NULL);
+  app_set_put_cb(NULL);
+  g_stack_thread->Stop();
+  g_stack_thread->Wait();
+  delete g_stack_thread;
+  g_stack_thread = NULL;
 }
 
 /**
@@ -383,6 +578,7 @@ void MyFrame::OnProgrammingMode(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Changing programming mode");
+  wxMutexLocker lock(g_stack_mutex);
 
   bool my_val = m_menuFile->IsChecked(CHECK_PM);
   oc_device_info_t* device = oc_core_get_device_info(0);
@@ -392,6 +588,7 @@ void MyFrame::OnProgrammingMode(wxCommandEvent& event)
   this->updateTextButtons();
   // update mdns
   knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
+  g_stack_thread->Wake(true);
 }
 
 
@@ -404,8 +601,10 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
 {
  int device_index = 0;
   SetStatusText("Changing sleepy mode");
+  wxMutexLocker lock(g_stack_mutex);
 
   bool my_sleepy = m_menuOptions->IsChecked(CHECK_SLEEPY);
+  g_stack_thread->SetSleepy(my_sleepy);
   oc_device_info_t* device = oc_core_get_device_info(0);
   
   if (my_sleepy) {
@@ -415,6 +614,7 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
   }
   // update mdns
   knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -427,6 +627,7 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
  */
 void MyFrame::updateTextButtons()
 {
+  wxMutexLocker lock(g_stack_mutex);
 
   char text[500];
   size_t device_index = 0;
@@ -466,10 +667,12 @@ void MyFrame::OnClearTables(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Clear Tables");
+  wxMutexLocker lock(g_stack_mutex);
   // reset the device
   oc_knx_device_storage_reset(device_index, 7);
   // update the UI
   this->updateTextButtons();
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -481,10 +684,12 @@ void MyFrame::OnReset(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Device Reset");
+  wxMutexLocker lock(g_stack_mutex);
   // reset the device
   oc_knx_device_storage_reset(device_index, 2);
   // update the UI
   this->updateTextButtons();
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -505,6 +710,7 @@ void MyFrame::OnGroupObjectTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
   int total = oc_core_get_group_object_table_total_size();
   for (int index = 0; index < total; index++) {
     oc_group_object_table_t* entry = oc_core_get_group_object_table_entry(index);
@@ -529,6 +735,7 @@ void MyFrame::OnGroupObjectTable(wxCommandEvent& event)
   }
   strcpy(windowtext, "Group Object Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List Group Object Table");
 }
@@ -553,6 +760,7 @@ void MyFrame::OnPublisherTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
   
   int total =  oc_core_get_publisher_table_size();
   for (int index = 0; index < total; index++) {
@@ -602,6 +810,7 @@ void MyFrame::OnPublisherTable(wxCommandEvent& event)
   }
   strcpy(windowtext, "Publisher Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List Publisher Table");
 }
@@ -626,6 +835,7 @@ void MyFrame::OnRecipientTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
 
   int total =  oc_core_get_recipient_table_size();
   for (int index = 0; index < total; index++) {
@@ -674,6 +884,7 @@ void MyFrame::OnRecipientTable(wxCommandEvent& event)
   }
   strcpy(windowtext, "Recipient Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List Recipient Table");
 }
@@ -695,6 +906,7 @@ void MyFrame::OnParameterList(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
 
   int index = 1;
   const char* url = app_get_parameter_url(index);
@@ -739,6 +951,7 @@ void MyFrame::OnParameterList(wxCommandEvent& event)
   strcat(windowtext, oc_string(device->serialnumber));
   //wxMessageBox(text, windowtext,
   //  wxOK | wxICON_NONE);
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List Parameters and their current set values");
 }
@@ -762,6 +975,7 @@ void MyFrame::OnAuthTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
 
   strcpy(text, "");
   for (index = 0; index < max_entries; index++) {
@@ -869,6 +1083,7 @@ void MyFrame::OnAuthTable(wxCommandEvent& event)
 
   strcpy(windowtext, "Auth AT Table ");
   strcat(windowtext, oc_string(device->serialnumber));
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List security entries");
 }
@@ -903,44 +1118,22 @@ void MyFrame::OnAbout(wxCommandEvent& event)
 }
 
 /**
- * @brief update the UI on the timer ticks
+ * @brief update the UI on changes reported by the stack thread
  * updates:
- * - check boxes
- * - info buttons
- * - text buttons
- * does a oc_main_poll to give a tick to the stack
- * takes into account if the device is sleepy
- * e.g. then it only does an poll each 20 seconds
- * @param event triggered by a timer
+ * - check boxes and info buttons, when data points are changed
+ * - text buttons, when the device state is changed
+ * @param event posted by the stack thread
  */
-void MyFrame::OnTimer(wxTimerEvent& event)
+void MyFrame::OnStackUpdate(wxThreadEvent& event)
 {
-  bool do_poll = true;
-  bool sleepy = m_menuOptions->IsChecked(CHECK_SLEEPY);
-  // do whatever you want to do every millisecond here
-  if (sleepy)
-  {
-    do_poll = false;
-    m_sleep_counter++;
-    if ((m_sleep_counter / 1000) > m_sleep_seconds) {
-      // only do a poll each x (20) seconds
-      do_poll = true;
-      m_sleep_counter = 0;
-    }
-    if (oc_knx_device_in_programming_mode(0)) {
-      // make sure that the device is reactive in programming mode
-      // e.g. keep on polling
-      do_poll = true;
-    }
+  unsigned dirty = g_ui_dirty.exchange(0);
+  if (dirty & UI_DIRTY_DATAPOINTS) {
+    this->updateInfoCheckBoxes();
+    this->updateInfoButtons();
   }
-
-  if (do_poll) {
-    oc_clock_time_t next_event;
-   next_event = oc_main_poll();
+  if (dirty & UI_DIRTY_DEVICE) {
+    this->updateTextButtons();
   }
-  this->updateInfoCheckBoxes();
-  this->updateInfoButtons(); 
-  this->updateTextButtons();
 }
 
 
@@ -953,6 +1146,7 @@ void MyFrame::OnTimer(wxTimerEvent& event)
  */
 void  MyFrame::updateInfoCheckBoxes()
 {
+  wxMutexLocker lock(g_stack_mutex);
   bool p;
   p = *app_get_DPT_Switch_variable("/p/o_1_1", NULL); // set toggle of LED_1
   m_LED_1->SetValue(p);  
@@ -1102,6 +1296,7 @@ void MyFrame::double2text(double value, char* text)
  */
 void  MyFrame::updateInfoButtons()
 {
+  wxMutexLocker lock(g_stack_mutex);
   char text[200];
   bool p;
   int p_int;
@@ -1111,18 +1306,14 @@ void  MyFrame::updateInfoButtons()
 } 
 void MyFrame::OnPressed_PB_1(wxCommandEvent& event)
 {
-  char url[] = "/p/o_2_2";
+  // the stack thread inverts the value and sends the s-mode messages
+  const char* url = URL_PB_1;
   char my_text[100];
-  bool p = (bool)*app_get_DPT_Switch_variable(url, NULL);
-  if (p == true) {
-    p = false;
-  }
-  else {
-    p = true;
-  }
-  app_set_DPT_Switch_variable(url, (DPT_Switch*)&p);
-  oc_do_s_mode_with_scope(2, url, "w");
-  oc_do_s_mode_with_scope(5, url, "w");
+  bool p = !(bool)*app_get_DPT_Switch_variable(url, NULL);
+  app_event_post_toggle(url);
+  app_event_post_smode(2, url, "w");
+  app_event_post_smode(5, url, "w");
+  g_stack_thread->Wake(true);
   sprintf(my_text, "PB_1 ('%s') pressed: %d", url, (int)p);
   SetStatusText(my_text);
 }    
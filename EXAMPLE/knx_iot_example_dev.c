@@ -187,12 +187,9 @@ void lssb_ShortPress_cb(void *context)
 {
   (void)context;
   PRINT_APP("LSSB button pressed\n");
-  DPT_Switch sw;
-  app_get_DPT_Switch_variable(URL_PB_1, &sw);
-  sw = !sw; // invert
-  app_set_DPT_Switch_variable(URL_PB_1, &sw);
-  // send out the s-mode message
-  oc_do_s_mode_with_scope(5, URL_PB_1, "w");
+  // invert and send out the s-mode message, in the stack loop
+  app_event_post_toggle(URL_PB_1);
+  app_event_post_smode(5, URL_PB_1, "w");
 }
 
 
@@ -221,11 +218,15 @@ void actuator_test_init();
  * @param url the url that received a PUT invocation.
  */
 void dev_put_callback(const char* url){
+#ifdef SLEEPY
+  // received PUT or s-mode write: poll fast for follow-up messages
+  main_PollActivity();
+#endif
   if (strcmp(url, URL_LED_1) == 0) {
         /* update led */ 
         setLED(LED_lsab, *app_get_DPT_Switch_variable(URL_LED_1, NULL));
         app_set_DPT_Switch_variable(URL_INFOONOFF_1, app_get_DPT_Switch_variable(URL_LED_1, NULL));
-        oc_do_s_mode_with_scope(5, URL_INFOONOFF_1, "w");
+        app_smode_send(5, URL_INFOONOFF_1, "w");
   }
 }
 
@@ -703,20 +704,8 @@ void hardware_poll()
 
 bool app_is_url_in_use(const char* url)
 {
-   int index;
-   oc_string_t oc_str;
-   int table_size = oc_core_get_group_object_table_total_size();
-
-  // check if the URL is in the Group Object Table
-  for (index = 0; index++; index < table_size) {
-    oc_str = oc_core_find_group_object_table_url_from_index( index);
-    if (oc_string_len(oc_str) > 0) {
-        if (strcmp(url, oc_string(oc_str)) == 0) {
-            return true;
-        }
-    }
-  }
-  return false;
+  // check if the URL is in the Group Object Table, using the table index
+  return app_get_got_index(url) > -1;
 }
 
 #ifdef ACTUATOR_TEST_MODE
@@ -45,6 +45,7 @@
     #include <wx/wx.h>
 #endif
 #include <inttypes.h>
+#include <atomic>
 
 #ifdef WIN32
 #include <winsock.h>
@@ -71,7 +72,9 @@ enum
   REC_TABLE_ID = PUB_TABLE_ID + 1, // ID for the recipient table window
   PARAMETER_LIST_ID = REC_TABLE_ID + 1, // ID for the parameter window
   AT_TABLE_ID = PARAMETER_LIST_ID + 1, // ID for the auth/at window
-  CHECK_GA_DISPLAY = AT_TABLE_ID + 1 , // ga display check
+  DIAG_ID = AT_TABLE_ID + 1, // ID for the diagnostics window
+  STACK_UPDATE_ID = DIAG_ID + 1, // ID for the stack thread update event
+  CHECK_GA_DISPLAY = STACK_UPDATE_ID + 1 , // ga display check
   CHECK_IID_DISPLAY = CHECK_GA_DISPLAY + 1, // iid display check
   CHECK_GRPID_DISPLAY = CHECK_IID_DISPLAY + 1, // grpid display check
   CHECK_SLEEPY = CHECK_GRPID_DISPLAY + 1 , // sleepy check
@@ -89,6 +92,199 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] =
 
 wxCmdLineParser* g_cmd;
 
+//----------------------------------------------------
+//----------------------------------------------------
+//----------------------------------------------------
+
+/**
+ * @brief lock for all access to the stack
+ * the stack is polled on its own thread (StackThread),
+ * the UI thread takes this lock before reading or changing stack data.
+ * recursive, since the update functions are also called from handlers
+ * that already hold the lock.
+ */
+static wxMutex g_stack_mutex(wxMUTEX_RECURSIVE);
+
+/**
+ * @brief the UI parts that need an update, set by the stack thread
+ */
+enum
+{
+  UI_DIRTY_DATAPOINTS = 1, // data point values
+  UI_DIRTY_DEVICE = 2      // IA, IID, programming mode, load state
+};
+static std::atomic<unsigned> g_ui_dirty(0);
+
+/**
+ * @brief runs the stack
+ * polls the stack, then waits until the next timer of the stack expires
+ * or until the stack is signalled (e.g. network data received).
+ * changes are posted to the UI thread as a wxThreadEvent (QueueEvent).
+ */
+class StackThread : public wxThread
+{
+public:
+  StackThread(wxEvtHandler* frame) : wxThread(wxTHREAD_JOINABLE), m_cv(m_mutex), m_frame(frame) {}
+  void Wake(bool force);
+  void Stop();
+  void SetSleepy(bool sleepy) { m_sleepy = sleepy; }
+  void PostUpdate(unsigned dirty);
+
+private:
+  virtual ExitCode Entry();
+  void WaitUntil(oc_clock_time_t next_event, bool force_only);
+
+  wxMutex m_mutex;
+  wxCondition m_cv;
+  bool m_wake = false;       // signalled by the stack
+  bool m_force_wake = false; // signalled by the UI, also wakes a sleepy device
+  std::atomic<bool> m_quit{ false };
+  std::atomic<bool> m_sleepy{ false };
+  int m_sleep_seconds = 20;
+  wxEvtHandler* m_frame;
+};
+
+static StackThread* g_stack_thread = NULL;
+
+/**
+ * @brief wakes up the stack thread
+ *
+ * @param force true: wake up a sleeping (sleepy) device too
+ */
+void StackThread::Wake(bool force)
+{
+  wxMutexLocker lock(m_mutex);
+  m_wake = true;
+  if (force) {
+    m_force_wake = true;
+  }
+  m_cv.Signal();
+}
+
+/**
+ * @brief stops the thread, call Wait() afterwards
+ */
+void StackThread::Stop()
+{
+  m_quit = true;
+  Wake(true);
+}
+
+/**
+ * @brief waits until next_event (stack time, 0 = no timeout) or a wake up
+ *
+ * @param next_event the time of the next stack event
+ * @param force_only only a forced wake up (from the UI) ends the wait
+ */
+void StackThread::WaitUntil(oc_clock_time_t next_event, bool force_only)
+{
+  wxMutexLocker lock(m_mutex);
+  while (!m_quit && !m_force_wake && !(m_wake && !force_only)) {
+    if (next_event == 0) {
+      m_cv.Wait();
+      continue;
+    }
+    oc_clock_time_t now = oc_clock_time();
+    if (now >= next_event) {
+      break;
+    }
+    m_cv.WaitTimeout((unsigned long)((next_event - now) * 1000 / OC_CLOCK_SECOND) + 1);
+  }
+  m_wake = false;
+  m_force_wake = false;
+}
+
+/**
+ * @brief the stack loop
+ * takes into account if the device is sleepy
+ * e.g. then it only does an poll each 20 seconds
+ */
+wxThread::ExitCode StackThread::Entry()
+{
+  oc_device_info_t last_device;
+  uint32_t last_generation = 0;
+  memset(&last_device, 0, sizeof(last_device));
+
+  while (!m_quit) {
+    oc_clock_time_t next_event;
+    bool in_pm;
+    bool device_changed;
+    bool data_changed;
+    {
+      wxMutexLocker lock(g_stack_mutex);
+      // the events posted by the UI, before the poll
+      app_event_process();
+      next_event = oc_main_poll();
+      in_pm = oc_knx_device_in_programming_mode(0);
+      oc_device_info_t* device = oc_core_get_device_info(0);
+      device_changed = device->ia != last_device.ia || device->iid != last_device.iid ||
+        device->pm != last_device.pm || device->lsm_s != last_device.lsm_s;
+      last_device.ia = device->ia;
+      last_device.iid = device->iid;
+      last_device.pm = device->pm;
+      last_device.lsm_s = device->lsm_s;
+      // e.g. a toggle posted by the UI
+      uint32_t generation = app_get_change_generation();
+      data_changed = generation != last_generation;
+      last_generation = generation;
+    }
+    if (device_changed) {
+      this->PostUpdate(UI_DIRTY_DEVICE);
+    }
+    if (data_changed) {
+      this->PostUpdate(UI_DIRTY_DATAPOINTS);
+    }
+    if (m_sleepy && !in_pm) {
+      // sleepy device: sleep for the sleep period, only the UI can wake it up
+      // in programming mode the device stays reactive.
+      WaitUntil(oc_clock_time() + m_sleep_seconds * OC_CLOCK_SECOND, true);
+    } else {
+      WaitUntil(next_event, false);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief post an update of the UI to the UI thread
+ * only one update is queued at the time
+ *
+ * @param dirty the parts of the UI that need an update
+ */
+void StackThread::PostUpdate(unsigned dirty)
+{
+  if (g_ui_dirty.fetch_or(dirty) == 0) {
+    m_frame->QueueEvent(new wxThreadEvent(wxEVT_THREAD, STACK_UPDATE_ID));
+  }
+}
+
+/**
+ * @brief called by the stack (on any thread) when it needs a poll
+ */
+static void gui_signal_event_loop(void)
+{
+  if (g_stack_thread) {
+    g_stack_thread->Wake(false);
+  }
+}
+
+/**
+ * @brief called by the stack thread after a put
+ * the UI is only updated when the put changed a value
+ *
+ * @param url the url of the data point
+ */
+static void gui_put_cb(const char* url)
+{
+  static uint32_t posted_generation = 0;
+  (void)url;
+  uint32_t generation = app_get_change_generation();
+  if (g_stack_thread && generation != posted_generation) {
+    posted_generation = generation;
+    g_stack_thread->PostUpdate(UI_DIRTY_DATAPOINTS);
+  }
+}
+
 
 //----------------------------------------------------
 //----------------------------------------------------
@@ -220,6 +416,11 @@ public:
   //--------------------------      
   void OnPressedPB_1(wxCommandEvent& event); 
   void OnPressedInfoOnOff_1(wxCommandEvent& event); 
+  void UpdatePressedStatus();
+  // the button of the status text, shown after the stack thread ran the toggle
+  const char* m_pressed_name = NULL;
+  const char* m_pressed_url = NULL;
+  uint32_t m_pressed_generation = 0; // change generation before the toggle
   //DP_IDLED_1 bool
   wxCheckBox* mLED_1 ; // LED_1 if.a  
   //DP_IDPB_1 bool
@@ -229,61 +430,107 @@ public:
 }; 
 void ScrolledWidgetsPane::OnPressedPB_1(wxCommandEvent& event)
 {
-  char url[] = "/p/o_2_2";
-  char my_text[100];
-  bool p = (bool)*app_get_DPT_Switch_variable(url, NULL);
-  if (p == true) {
-    p = false;
-  }
-  else {
-    p = true;
+  // the stack thread inverts the value and sends the s-mode messages
+  const char* url = URL_PB_1;
+  {
+    wxMutexLocker lock(g_stack_mutex);
+    m_pressed_generation = app_get_change_generation();
   }
-  app_set_DPT_Switch_variable(url, (DPT_Switch*)&p);
-  oc_do_s_mode_with_scope(2, url, "w");
-  oc_do_s_mode_with_scope(5, url, "w");
-  sprintf(my_text, "PB_1 ('%s') pressed: %d", url, (int)p);
-  this->m_parentFrame->SetStatusText(my_text);
+  app_event_post_toggle(url);
+  app_event_post_smode(2, url, "w");
+  app_event_post_smode(5, url, "w");
+  m_pressed_name = "PB_1";
+  m_pressed_url = url;
+  g_stack_thread->Wake(true);
 }  
 void ScrolledWidgetsPane::OnPressedInfoOnOff_1(wxCommandEvent& event)
 {
-  char url[] = "/p/o_3_3";
+  // the stack thread inverts the value and sends the s-mode messages
+  const char* url = URL_INFOONOFF_1;
+  {
+    wxMutexLocker lock(g_stack_mutex);
+    m_pressed_generation = app_get_change_generation();
+  }
+  app_event_post_toggle(url);
+  app_event_post_smode(2, url, "w");
+  app_event_post_smode(5, url, "w");
+  m_pressed_name = "InfoOnOff_1";
+  m_pressed_url = url;
+  g_stack_thread->Wake(true);
+}     
+
+/**
+ * @brief show the value of the pressed button in the status bar
+ * called on the stack update that follows the toggle
+ */
+void ScrolledWidgetsPane::UpdatePressedStatus()
+{
   char my_text[100];
-  bool p = (bool)*app_get_DPT_Switch_variable(url, NULL);
-  if (p == true) {
-    p = false;
+  bool p;
+  if (m_pressed_url == NULL) {
+    return;
   }
-  else {
-    p = true;
+  {
+    wxMutexLocker lock(g_stack_mutex);
+    if (app_get_change_generation() == m_pressed_generation) {
+      // an update from before the toggle
+      return;
+    }
+    p = (bool)*app_get_DPT_Switch_variable(m_pressed_url, NULL);
   }
-  app_set_DPT_Switch_variable(url, (DPT_Switch*)&p);
-  oc_do_s_mode_with_scope(2, url, "w");
-  oc_do_s_mode_with_scope(5, url, "w");
-  sprintf(my_text, "InfoOnOff_1 ('%s') pressed: %d", url, (int)p);
+  sprintf(my_text, "%s ('%s') pressed: %d", m_pressed_name, m_pressed_url, (int)p);
   this->m_parentFrame->SetStatusText(my_text);
-}     
+  m_pressed_url = NULL;
+}
 
 //----------------------------------------------------
 //----------------------------------------------------
 //----------------------------------------------------
 //----------------------------------------------------
 
+/**
+ * @brief cached text of a table window
+ * the text is only rebuilt when the tables or the display options are changed
+ */
+struct TableText
+{
+  wxString text;
+  uint32_t generation = 0;
+  int options = -1; // display options of the text, -1 == not valid
+
+  bool IsValid(int display_options) const
+  {
+    return options == display_options && generation == app_get_table_generation();
+  }
+  void Store(const char* new_text, int display_options)
+  {
+    text = new_text;
+    options = display_options;
+    generation = app_get_table_generation();
+  }
+  void Invalidate() { options = -1; }
+};
+
 class MyFrame : public wxFrame
 {
 public:
   MyFrame(char* serial_number);
+  ~MyFrame();
 private:
   void OnGroupObjectTable(wxCommandEvent& event);
   void OnPublisherTable(wxCommandEvent& event);
   void OnRecipientTable(wxCommandEvent& event);
   void OnParameterList(wxCommandEvent& event);
   void OnAuthTable(wxCommandEvent& event);
+  void OnDiagnostics(wxCommandEvent& event);
   void OnProgrammingMode(wxCommandEvent& event);
   void OnSleepyMode(wxCommandEvent& event);
   void OnReset(wxCommandEvent& event);
   void OnClearTables(wxCommandEvent& event);
   void OnExit(wxCommandEvent& event);
   void OnAbout(wxCommandEvent& event);
-  void OnTimer(wxTimerEvent& event);
+  void OnStackUpdate(wxThreadEvent& event);
+  void OnDisplayMode(wxCommandEvent& event);
 
   void updateInfoCheckBoxes();
   void updateInfoButtons();
@@ -298,12 +545,7 @@ private:
   wxMenu* m_menuFile;
   wxMenu* m_menuDisplay;
   wxMenu* m_menuOptions;
-  wxTimer m_timer;
   ScrolledWidgetsPane* m_scrolledwindow;
-  
-  // sleepy information
-  int m_sleep_counter = 0;
-  int m_sleep_seconds = 20;
 
   wxTextCtrl* m_ia_text;  // text control for internal address
   wxTextCtrl* m_iid_text; // text control for installation id
@@ -311,6 +553,22 @@ private:
   wxTextCtrl* m_ls_text;  // text control for load state
   wxTextCtrl* m_hostname_text; // text control for host name
   wxTextCtrl* m_secured_text; // text secure/not secure
+
+  // values shown by the text controls, only changed values are updated
+  bool m_text_valid = false;
+  uint32_t m_shown_ia = 0;
+  uint64_t m_shown_iid = 0;
+  bool m_shown_iid_conversion = false;
+  bool m_shown_pm = false;
+  oc_lsm_state_t m_shown_lsm;
+  wxString m_shown_hostname;
+  // cached texts of the table windows
+  TableText m_got_text;
+  TableText m_pub_text;
+  TableText m_rec_text;
+  // change counters of the data points shown by the widgets
+  uint32_t m_checkbox_seen_LED_1 = UINT32_MAX;
+  uint32_t m_button_seen_LED_1 = UINT32_MAX;
 };
 
 wxIMPLEMENT_APP(MyApp);
@@ -353,6 +611,9 @@ MyFrame::MyFrame(char* str_serial_number)
   m_menuFile->Append(PUB_TABLE_ID, "List Publisher Table", "List the Publisher table", false);
   m_menuFile->Append(REC_TABLE_ID, "List Recipient Table", "List the Recipient table", false);
   m_menuFile->Append(AT_TABLE_ID, "List Auth/AT Table", "List the security data of the device", false);
+#if APP_METRICS
+  m_menuFile->Append(DIAG_ID, "Show Diagnostics", "Show the request latency and storage metrics", false);
+#endif
   m_menuFile->Append(CHECK_PM, "Programming Mode", "Sets the application in programming mode", true);
   m_menuFile->Append(RESET_TABLE, "Reset (7) (Tables)", "Reset 7 (Reset to default without IA).", false);
   m_menuFile->Append(RESET, "Reset (2)(ex-factory)", "Reset 2 (Reset to default state)", false);
@@ -390,8 +651,10 @@ MyFrame::MyFrame(char* str_serial_number)
   Bind(wxEVT_MENU, &MyFrame::OnRecipientTable, this, REC_TABLE_ID);
   Bind(wxEVT_MENU, &MyFrame::OnParameterList, this, PARAMETER_LIST_ID);
   Bind(wxEVT_MENU, &MyFrame::OnAuthTable, this, AT_TABLE_ID);
+  Bind(wxEVT_MENU, &MyFrame::OnDiagnostics, this, DIAG_ID);
   Bind(wxEVT_MENU, &MyFrame::OnProgrammingMode, this, CHECK_PM);
   Bind(wxEVT_MENU, &MyFrame::OnSleepyMode, this, CHECK_SLEEPY);
+  Bind(wxEVT_MENU, &MyFrame::OnDisplayMode, this, CHECK_IID_DISPLAY);
   Bind(wxEVT_MENU, &MyFrame::OnReset, this, RESET);
   Bind(wxEVT_MENU, &MyFrame::OnAbout, this, wxID_ABOUT);
   Bind(wxEVT_MENU, &MyFrame::OnExit, this, wxID_EXIT);
@@ -508,9 +771,26 @@ m_hostname_text->SetToolTip("Hostname of the PC");
   this->updateTextButtons();
   this->updateInfoButtons();
   this->updateInfoCheckBoxes();
-  // start the timer for UI updates and stack polls
-  m_timer.Bind(wxEVT_TIMER, &MyFrame::OnTimer, this);
-  m_timer.Start(1, wxTIMER_CONTINUOUS);  // 1 millisecond interval
+  // run the stack on its own thread, the UI is only updated on changes
+  Bind(wxEVT_THREAD, &MyFrame::OnStackUpdate, this, STACK_UPDATE_ID);
+  app_set_put_cb(gui_put_cb);
+  g_stack_thread = new StackThread(this);
+  app_set_signal_event_loop_cb(gui_signal_event_loop);
+  g_stack_thread->Run();
+}
+
+/**
+ * @brief Destroy the My Frame:: My Frame object
+ * stops the stack thread
+ */
+MyFrame::~MyFrame()
+{
+  app_set_signal_event_loop_cb(NULL);
+  app_set_put_cb(NULL);
+  g_stack_thread->Stop();
+  g_stack_thread->Wait();
+  delete g_stack_thread;
+  g_stack_thread = NULL;
 }
 
 /**
@@ -532,6 +812,7 @@ void MyFrame::OnProgrammingMode(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Changing programming mode");
+  wxMutexLocker lock(g_stack_mutex);
 
   bool my_val = m_menuFile->IsChecked(CHECK_PM);
   oc_device_info_t* device = oc_core_get_device_info(0);
@@ -541,6 +822,7 @@ void MyFrame::OnProgrammingMode(wxCommandEvent& event)
   this->updateTextButtons();
   // update mdns
   knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
+  g_stack_thread->Wake(true);
 }
 
 
@@ -553,8 +835,10 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
 {
  int device_index = 0;
   SetStatusText("Changing sleepy mode");
+  wxMutexLocker lock(g_stack_mutex);
 
   bool my_sleepy = m_menuOptions->IsChecked(CHECK_SLEEPY);
+  g_stack_thread->SetSleepy(my_sleepy);
   oc_device_info_t* device = oc_core_get_device_info(0);
   
   if (my_sleepy) {
@@ -564,6 +848,7 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
   }
   // update mdns
   knx_publish_service(oc_string(device->serialnumber), device->iid, device->ia, device->pm);
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -576,6 +861,7 @@ void MyFrame::OnSleepyMode(wxCommandEvent& event)
  */
 void MyFrame::updateTextButtons()
 {
+  wxMutexLocker lock(g_stack_mutex);
 
   char text[500];
   size_t device_index = 0;
@@ -583,27 +869,54 @@ void MyFrame::updateTextButtons()
 
   // get the device data structure
   oc_device_info_t* device = oc_core_get_device_info(device_index);
-  // update the text labels
-  // ia_0 == AAxxxxxx = AA
-  // ia_1 == xxAAxxxx = AA
-  // ia_2 == xxxxAAAA = AAAA
-  uint32_t ia = device->ia;
-  uint32_t ia_o = (ia >> 12);
-  uint32_t ia_1 = (ia >> 8) & 0xF;
-  uint32_t ia_2 = (ia & 0x000000FF);
-  sprintf(text, "IA: %d.%d.%d   [%d]", ia_o, ia_1, ia_2, device->ia);
-  m_ia_text->SetLabelText(text);
-  sprintf(text, "LoadState: %s", oc_core_get_lsm_state_as_string(device->lsm_s));
-  m_pm_text->SetLabelText(text);
-  sprintf(text, "Programming Mode : % d", device->pm);
-  m_ls_text->SetLabelText(text);
-  strcpy(text, "IID: ");
-  this->int2grpidtext(device->iid, text, iid_conversion);
-  m_iid_text->SetLabelText(text);
-  sprintf(text, "host name: %s", oc_string(device->hostname));
-  m_hostname_text->SetLabelText(text);
-  // reset the programming mode to what the device has
-  m_menuFile->Check(CHECK_PM, device->pm);
+  // update the text labels, only when the value is changed
+  if (!m_text_valid || device->ia != m_shown_ia) {
+    // ia_0 == AAxxxxxx = AA
+    // ia_1 == xxAAxxxx = AA
+    // ia_2 == xxxxAAAA = AAAA
+    uint32_t ia = device->ia;
+    uint32_t ia_o = (ia >> 12);
+    uint32_t ia_1 = (ia >> 8) & 0xF;
+    uint32_t ia_2 = (ia & 0x000000FF);
+    sprintf(text, "IA: %d.%d.%d   [%d]", ia_o, ia_1, ia_2, device->ia);
+    m_ia_text->SetLabelText(text);
+    m_shown_ia = device->ia;
+  }
+  if (!m_text_valid || device->lsm_s != m_shown_lsm) {
+    sprintf(text, "LoadState: %s", oc_core_get_lsm_state_as_string(device->lsm_s));
+    m_pm_text->SetLabelText(text);
+    m_shown_lsm = device->lsm_s;
+  }
+  if (!m_text_valid || device->pm != m_shown_pm) {
+    sprintf(text, "Programming Mode : % d", device->pm);
+    m_ls_text->SetLabelText(text);
+    // reset the programming mode to what the device has
+    m_menuFile->Check(CHECK_PM, device->pm);
+    m_shown_pm = device->pm;
+  }
+  if (!m_text_valid || device->iid != m_shown_iid || iid_conversion != m_shown_iid_conversion) {
+    strcpy(text, "IID: ");
+    this->int2grpidtext(device->iid, text, iid_conversion);
+    m_iid_text->SetLabelText(text);
+    m_shown_iid = device->iid;
+    m_shown_iid_conversion = iid_conversion;
+  }
+  if (!m_text_valid || m_shown_hostname != oc_string(device->hostname)) {
+    sprintf(text, "host name: %s", oc_string(device->hostname));
+    m_hostname_text->SetLabelText(text);
+    m_shown_hostname = oc_string(device->hostname);
+  }
+  m_text_valid = true;
+}
+
+/**
+ * @brief changes the display of the IID
+ *
+ * @param event command triggered by the menu button
+ */
+void MyFrame::OnDisplayMode(wxCommandEvent& event)
+{
+  this->updateTextButtons();
 }
 
 /**
@@ -615,10 +928,15 @@ void MyFrame::OnClearTables(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Clear Tables");
+  wxMutexLocker lock(g_stack_mutex);
   // reset the device
   oc_knx_device_storage_reset(device_index, 7);
+  m_got_text.Invalidate();
+  m_pub_text.Invalidate();
+  m_rec_text.Invalidate();
   // update the UI
   this->updateTextButtons();
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -630,10 +948,15 @@ void MyFrame::OnReset(wxCommandEvent& event)
 {
   int device_index = 0;
   SetStatusText("Device Reset");
+  wxMutexLocker lock(g_stack_mutex);
   // reset the device
   oc_knx_device_storage_reset(device_index, 2);
+  m_got_text.Invalidate();
+  m_pub_text.Invalidate();
+  m_rec_text.Invalidate();
   // update the UI
   this->updateTextButtons();
+  g_stack_thread->Wake(true);
 }
 
 /**
@@ -654,31 +977,37 @@ void MyFrame::OnGroupObjectTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
-  int total = oc_core_get_group_object_table_total_size();
-  for (int index = 0; index < total; index++) {
-    oc_group_object_table_t* entry = oc_core_get_group_object_table_entry(index);
-
-    if (entry && entry->ga_len > 0) {
-      sprintf(line, "Index %d \n", index);
-      strcat(text, line);
-      sprintf(line, "  id: '%d'  ", entry->id);
-      strcat(text, line);
-      sprintf(line, "  url: '%s' ", oc_string(entry->href));
-      strcat(text, line);
-      sprintf(line, "  cflags : '%d' ", (int)entry->cflags);
-      oc_cflags_as_string(line, entry->cflags);
-      strcat(text, line);
-      strcpy(line,"  ga : [");
-      for (int i = 0; i < entry->ga_len; i++) {
-        this->int2gatext(entry->ga[i], line, ga_conversion);
+  g_stack_mutex.Lock();
+  int options = ga_conversion ? 1 : 0;
+  if (!m_got_text.IsValid(options)) {
+    int total = oc_core_get_group_object_table_total_size();
+    for (int index = 0; index < total; index++) {
+      oc_group_object_table_t* entry = oc_core_get_group_object_table_entry(index);
+
+      if (entry && entry->ga_len > 0) {
+        sprintf(line, "Index %d \n", index);
+        strcat(text, line);
+        sprintf(line, "  id: '%d'  ", entry->id);
+        strcat(text, line);
+        sprintf(line, "  url: '%s' ", oc_string(entry->href));
+        strcat(text, line);
+        sprintf(line, "  cflags : '%d' ", (int)entry->cflags);
+        oc_cflags_as_string(line, entry->cflags);
+        strcat(text, line);
+        strcpy(line,"  ga : [");
+        for (int i = 0; i < entry->ga_len; i++) {
+          this->int2gatext(entry->ga[i], line, ga_conversion);
+        }
+        strcat(line," ]\n");
+        strcat(text, line);
       }
-      strcat(line," ]\n");
-      strcat(text, line);
     }
+    m_got_text.Store(text, options);
   }
   strcpy(windowtext, "Group Object Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
-  CustomDialog(windowtext, text);
+  g_stack_mutex.Unlock();
+  CustomDialog(windowtext, m_got_text.text);
   SetStatusText("List Group Object Table");
 }
 
@@ -702,60 +1031,65 @@ void MyFrame::OnPublisherTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
-  
-  int total =  oc_core_get_publisher_table_size();
-  for (int index = 0; index < total; index++) {
-    oc_group_rp_table_t* entry = oc_core_get_publisher_table_entry(index);
-
-    if (entry && entry->id >= 0) {
-      sprintf(line, "Index %d \n", index);
-      strcat(text, line);
-      sprintf(line, "  id: '%d'  ", entry->id);
-      strcat(text, line);
-       if ( entry->ia >= 0) {
-        sprintf(line, "  ia: '%d' ", entry->ia);
-        strcat(text, line);
-      }
-      if ( entry->iid >= 0) {
-        strcpy(line, "  iid: ");
-        this->int2grpidtext(entry->iid, line, iid_conversion);
-        strcat(text, line);
-      }
-      if ( entry->fid >= 0) {
-        sprintf(line, "  fid: '%lld' ", entry->fid);
-        strcat(text, line);
-      }
-      if ( entry->grpid > 0) {
-        //sprintf(line, "  grpid: '%u' ", entry->grpid);
-        strcpy(line, "  grpid: ");
-        this->int2grpidtext(entry->grpid, line, grpid_conversion);
-        strcat(text, line);
-      }
-      if (oc_string_len(entry->url) > 0) {
-        sprintf(line, "  url: '%s' ", oc_string(entry->url));
-        strcat(text, line);
-      }
-      if (oc_string_len(entry->path) > 0) {
-        sprintf(line, "  path: '%s' ", oc_string(entry->path));
+  g_stack_mutex.Lock();
+  int options = (ga_conversion ? 1 : 0) | (grpid_conversion ? 2 : 0) | (iid_conversion ? 4 : 0);
+  if (!m_pub_text.IsValid(options)) {
+    int total =  oc_core_get_publisher_table_size();
+    for (int index = 0; index < total; index++) {
+      oc_group_rp_table_t* entry = oc_core_get_publisher_table_entry(index);
+
+      if (entry && entry->id >= 0) {
+        sprintf(line, "Index %d \n", index);
         strcat(text, line);
-      }
-      if (oc_string_len(entry->at) > 0){
-        sprintf(line, "  at: '%s' ", oc_string(entry->at));
+        sprintf(line, "  id: '%d'  ", entry->id);
         strcat(text, line);
-      }
-      if ( entry->ga_len > 0) {
-        strcpy(line,"  ga : [");
-        for (int i = 0; i < entry->ga_len; i++) {
-          this->int2gatext(entry->ga[i], line, ga_conversion);
+         if ( entry->ia >= 0) {
+          sprintf(line, "  ia: '%d' ", entry->ia);
+          strcat(text, line);
+        }
+        if ( entry->iid >= 0) {
+          strcpy(line, "  iid: ");
+          this->int2grpidtext(entry->iid, line, iid_conversion);
+          strcat(text, line);
+        }
+        if ( entry->fid >= 0) {
+          sprintf(line, "  fid: '%lld' ", entry->fid);
+          strcat(text, line);
+        }
+        if ( entry->grpid > 0) {
+          //sprintf(line, "  grpid: '%u' ", entry->grpid);
+          strcpy(line, "  grpid: ");
+          this->int2grpidtext(entry->grpid, line, grpid_conversion);
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->url) > 0) {
+          sprintf(line, "  url: '%s' ", oc_string(entry->url));
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->path) > 0) {
+          sprintf(line, "  path: '%s' ", oc_string(entry->path));
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->at) > 0){
+          sprintf(line, "  at: '%s' ", oc_string(entry->at));
+          strcat(text, line);
+        }
+        if ( entry->ga_len > 0) {
+          strcpy(line,"  ga : [");
+          for (int i = 0; i < entry->ga_len; i++) {
+            this->int2gatext(entry->ga[i], line, ga_conversion);
+          }
+          strcat(line," ]\n");
+          strcat(text, line);
         }
-        strcat(line," ]\n");
-        strcat(text, line);
       }
     }
+    m_pub_text.Store(text, options);
   }
   strcpy(windowtext, "Publisher Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
-  CustomDialog(windowtext, text);
+  g_stack_mutex.Unlock();
+  CustomDialog(windowtext, m_pub_text.text);
   SetStatusText("List Publisher Table");
 }
 
@@ -779,61 +1113,65 @@ void MyFrame::OnRecipientTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
-
-  int total =  oc_core_get_recipient_table_size();
-  for (int index = 0; index < total; index++) {
-    oc_group_rp_table_t* entry = oc_core_get_recipient_table_entry(index);
-
-    if (entry && entry->id >= 0) {
-      sprintf(line, "Index %d \n", index);
-      strcat(text, line);
-      sprintf(line, "  id: '%d'  ", entry->id);
-      strcat(text, line);
-      if ( entry->ia >= 0) {
-        sprintf(line, "  ia: '%d' ", entry->ia);
-        strcat(text, line);
-      }
-      if ( entry->iid >= 0) {
-        strcpy(line, "  iid: ");
-        this->int2grpidtext(entry->iid, line, iid_conversion);
-        strcat(text, line);
-      }
-      if ( entry->fid >= 0) {
-        sprintf(line, "  fid: '%lld' ", entry->fid);
+  g_stack_mutex.Lock();
+  int options = (ga_conversion ? 1 : 0) | (grpid_conversion ? 2 : 0) | (iid_conversion ? 4 : 0);
+  if (!m_rec_text.IsValid(options)) {
+    int total =  oc_core_get_recipient_table_size();
+    for (int index = 0; index < total; index++) {
+      oc_group_rp_table_t* entry = oc_core_get_recipient_table_entry(index);
+      if (entry && entry->id >= 0) {
+        sprintf(line, "Index %d \n", index);
         strcat(text, line);
-      }
-      if ( entry->grpid >= 0) {
-        strcpy(line, "  grpid: ");
-        this->int2grpidtext(entry->grpid, line, grpid_conversion);
-        strcat(text, line);
-      }
-      if (oc_string_len(entry->url) > 0) {
-        sprintf(line, "  url: '%s' ", oc_string(entry->url));
-        strcat(text, line);
-      }
-      if (oc_string_len(entry->path) > 0){
-        sprintf(line, "  path: '%s' ", oc_string(entry->path));
-        strcat(text, line);
-      }
-      if (oc_string_len(entry->at) > 0){
-        sprintf(line, "  at: '%s' ", oc_string(entry->at));
+        sprintf(line, "  id: '%d'  ", entry->id);
         strcat(text, line);
-      }
-      if ( entry->ga_len > 0) {
-        strcpy(line,"  ga : [");
-        for (int i = 0; i < entry->ga_len; i++) {
-          this->int2gatext(entry->ga[i], line, ga_conversion);
+        if ( entry->ia >= 0) {
+          sprintf(line, "  ia: '%d' ", entry->ia);
+          strcat(text, line);
         }
-        strcat(line," ]\n");
+        if ( entry->iid >= 0) {
+          strcpy(line, "  iid: ");
+          this->int2grpidtext(entry->iid, line, iid_conversion);
+          strcat(text, line);
+        }
+        if ( entry->fid >= 0) {
+          sprintf(line, "  fid: '%lld' ", entry->fid);
+          strcat(text, line);
+        }
+        if ( entry->grpid >= 0) {
+          strcpy(line, "  grpid: ");
+          this->int2grpidtext(entry->grpid, line, grpid_conversion);
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->url) > 0) {
+          sprintf(line, "  url: '%s' ", oc_string(entry->url));
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->path) > 0){
+          sprintf(line, "  path: '%s' ", oc_string(entry->path));
+          strcat(text, line);
+        }
+        if (oc_string_len(entry->at) > 0){
+          sprintf(line, "  at: '%s' ", oc_string(entry->at));
+          strcat(text, line);
+        }
+        if ( entry->ga_len > 0) {
+          strcpy(line,"  ga : [");
+          for (int i = 0; i < entry->ga_len; i++) {
+            this->int2gatext(entry->ga[i], line, ga_conversion);
+          }
+          strcat(line," ]\n");
+          strcat(text, line);
+        }
+        sprintf(line, "  non: %d  mt: %d\n", entry->non, entry->mt);
         strcat(text, line);
       }
-      sprintf(line, "  non: %d  mt: %d\n", entry->non, entry->mt);
-      strcat(text, line);
     }
+    m_rec_text.Store(text, options);
   }
   strcpy(windowtext, "Recipient Table  ");
   strcat(windowtext, oc_string(device->serialnumber));
-  CustomDialog(windowtext, text);
+  g_stack_mutex.Unlock();
+  CustomDialog(windowtext, m_rec_text.text);
   SetStatusText("List Recipient Table");
 }
 /**
@@ -854,6 +1192,7 @@ void MyFrame::OnParameterList(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
   strcpy(windowtext, "Parameter List ");
   strcat(windowtext, oc_string(device->serialnumber));
 
@@ -919,6 +1258,7 @@ void MyFrame::OnParameterList(wxCommandEvent& event)
 
   //wxMessageBox(text, windowtext,
   //  wxOK | wxICON_NONE);
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List Parameters and their current set values");
 }
@@ -942,6 +1282,7 @@ void MyFrame::OnAuthTable(wxCommandEvent& event)
   if (device == NULL) {
     return;
   }
+  g_stack_mutex.Lock();
 
   strcpy(text, "");
   for (index = 0; index < max_entries; index++) {
@@ -1038,10 +1379,28 @@ void MyFrame::OnAuthTable(wxCommandEvent& event)
 
   strcpy(windowtext, "Auth AT Table ");
   strcat(windowtext, oc_string(device->serialnumber));
+  g_stack_mutex.Unlock();
   CustomDialog(windowtext, text);
   SetStatusText("List security entries");
 }
 
+/**
+ * @brief shows the request latency and storage metrics
+ * 
+ * @param event command triggered by a menu button
+ */
+void MyFrame::OnDiagnostics(wxCommandEvent& event)
+{
+#if APP_METRICS
+  char text[1024 * 10];
+  g_stack_mutex.Lock();
+  app_metrics_to_text(text, sizeof(text));
+  g_stack_mutex.Unlock();
+  CustomDialog("Diagnostics", text);
+  SetStatusText("Show diagnostics");
+#endif
+}
+
 /**
  * @brief shows static info about the application
  * 
@@ -1073,44 +1432,23 @@ void MyFrame::OnAbout(wxCommandEvent& event)
 }
 
 /**
- * @brief update the UI on the timer ticks
+ * @brief update the UI on changes reported by the stack thread
  * updates:
- * - check boxes
- * - info buttons
- * - text buttons
- * does a oc_main_poll to give a tick to the stack
- * takes into account if the device is sleepy
- * e.g. then it only does an poll each 20 seconds
- * @param event triggered by a timer
+ * - check boxes and info buttons, when data points are changed
+ * - text buttons, when the device state is changed
+ * @param event posted by the stack thread
  */
-void MyFrame::OnTimer(wxTimerEvent& event)
+void MyFrame::OnStackUpdate(wxThreadEvent& event)
 {
-  bool do_poll = true;
-  bool sleepy = m_menuOptions->IsChecked(CHECK_SLEEPY);
-  // do whatever you want to do every millisecond here
-  if (sleepy)
-  {
-    do_poll = false;
-    m_sleep_counter++;
-    if ((m_sleep_counter / 1000) > m_sleep_seconds) {
-      // only do a poll each x (20) seconds
-      do_poll = true;
-      m_sleep_counter = 0;
-    }
-    if (oc_knx_device_in_programming_mode(0)) {
-      // make sure that the device is reactive in programming mode
-      // e.g. keep on polling
-      do_poll = true;
-    }
+  unsigned dirty = g_ui_dirty.exchange(0);
+  if (dirty & UI_DIRTY_DATAPOINTS) {
+    this->updateInfoCheckBoxes();
+    this->updateInfoButtons();
+    m_scrolledwindow->UpdatePressedStatus();
   }
-
-  if (do_poll) {
-    oc_clock_time_t next_event;
-   next_event = oc_main_poll();
+  if (dirty & UI_DIRTY_DEVICE) {
+    this->updateTextButtons();
   }
-  this->updateInfoCheckBoxes();
-  this->updateInfoButtons(); 
-  this->updateTextButtons();
 }
 
 
@@ -1123,9 +1461,12 @@ void MyFrame::OnTimer(wxTimerEvent& event)
  */
 void  MyFrame::updateInfoCheckBoxes()
 {
+  wxMutexLocker lock(g_stack_mutex);
   bool p;
-  p = *app_get_DPT_Switch_variable("/p/o_1_1", NULL); // set toggle of LED_1
-  m_scrolledwindow->mLED_1->SetValue(p);   
+  if (app_is_changed("/p/o_1_1", &m_checkbox_seen_LED_1)) {
+    p = *app_get_DPT_Switch_variable("/p/o_1_1", NULL); // set toggle of LED_1
+    m_scrolledwindow->mLED_1->SetValue(p);
+  }
 
 }
 
@@ -1286,17 +1627,20 @@ void MyFrame::double2text(double value, char* text)
  */
 void  MyFrame::updateInfoButtons()
 {
+  wxMutexLocker lock(g_stack_mutex);
   char text[200];
   bool p;
   int p_int;
   float f;
   double d;
   // name=LED_1 dpt=urn:knx:dpt.switch if=if.a ctype=bool
-  p = (bool)*app_get_DPT_Switch_variable(URL_LED_1, NULL);  
-  // set text of LED_1
-  strcpy(text, "");
-  this->bool2text(p, text);
-  m_scrolledwindow->mLED_1->SetLabel(text); 
+  if (app_is_changed(URL_LED_1, &m_button_seen_LED_1)) {
+    p = (bool)*app_get_DPT_Switch_variable(URL_LED_1, NULL);
+    // set text of LED_1
+    strcpy(text, "");
+    this->bool2text(p, text);
+    m_scrolledwindow->mLED_1->SetLabel(text);
+  }
 
 }
 
@@ -0,0 +1,598 @@
+/*
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ Copyright (c) 2024 Cascoda Ltd
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list
+ *    of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Cascoda Limited.
+ *    integrated circuit in a product or a software update for such product, must
+ *    reproduce the above copyright notice, this list of  conditions and the following
+ *    disclaimer in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Cascoda Limited nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * 4. This software, whether provided in binary or any other form must not be decompiled,
+ *    disassembled, reverse engineered or otherwise modified.
+ *
+ *  5. This software, in whole or in part, must only be used with a Cascoda Limited circuit.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CASCODA LIMITED "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CASCODA LIMITED OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+*/
+/**
+ * @file
+ *
+ * load generator for KNX IoT devices, using the client part of the stack.
+ *
+ * Sends ETS like traffic (s-mode writes, metadata GETs, paged reads, group
+ * object table downloads) at a target rate to one or more devices, and reports
+ * throughput, latency percentiles and response codes as CSV lines.
+ * With -soak the diagnostic resource of the devices is sampled periodically,
+ * to follow heap and storage usage over a long run.
+ *
+ * The got profile is destructive: it overwrites the group object table of the
+ * devices without the load state machine sequence of a download, and does not
+ * restore the original table. It is only sent with -destructive, to devices
+ * that are downloaded again by ETS afterwards.
+ *
+ * Usage:
+ *   knx_iot_loadgen -d <endpoint> [-d <endpoint> ...] [options]
+ *   e.g. knx_iot_loadgen -d "coap://[fe80::1%eth0]:5683" -p smode,meta -r 50 -t 60
+ */
+
+#include "oc_api.h"
+#include "oc_rep.h"
+#include "port/oc_clock.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+static CONDITION_VARIABLE cv; /**< event loop variable */
+static CRITICAL_SECTION cs;   /**< event loop variable */
+#endif
+#ifdef __linux__
+#include <pthread.h>
+static pthread_mutex_t mutex;
+static pthread_cond_t cv;
+static struct timespec ts;
+#endif
+
+#define MAX_DEVICES 16        /**< max number of target devices */
+#define MAX_PROFILES 8        /**< max number of profiles in the mix */
+#define MAX_WINDOW 1024       /**< max number of outstanding requests */
+#define MAX_LATENCY_MS 10000  /**< latencies above are counted in the last bucket */
+#define MAX_STATUS 256        /**< number of counted response codes */
+#define TICK_MS 10            /**< interval of the request scheduler */
+#define URL_DIAG "/p/diag"    /**< diagnostic resource of the example app */
+
+typedef enum loadgen_profile_t {
+  PROFILE_WRITE, /**< PUT of the value of the url */
+  PROFILE_SMODE, /**< s-mode write to /.knx */
+  PROFILE_META,  /**< GET of the url with m=* */
+  PROFILE_PAGED, /**< GET of the url with pn/ps */
+  PROFILE_GOT,   /**< POST of group object table entries to /fp/g, destructive */
+} loadgen_profile_t;
+
+static const char *g_profile_names[] = { "write", "smode", "meta", "paged", "got" };
+
+typedef struct request_slot_t {
+  oc_clock_time_t start; /**< time the request was sent */
+  bool busy;             /**< waiting for the response */
+} request_slot_t;
+
+typedef struct loadgen_stats_t {
+  uint32_t sent;      /**< requests sent */
+  uint32_t received;  /**< responses received */
+  uint32_t failed;    /**< requests that could not be sent */
+  uint32_t timeouts;  /**< requests without a response: timeout, closed or cancelled */
+  uint32_t throttled; /**< requests skipped, window full */
+  uint32_t status[MAX_STATUS]; /**< responses per code */
+  uint32_t latency_ms[MAX_LATENCY_MS + 1]; /**< latency histogram, 1 ms buckets */
+  uint32_t max_ms;    /**< highest latency */
+} loadgen_stats_t;
+
+static volatile int quit = 0;
+static oc_endpoint_t g_devices[MAX_DEVICES];
+static int g_num_devices = 0;
+static loadgen_profile_t g_profiles[MAX_PROFILES];
+static int g_num_profiles = 0;
+static const char *g_url = "/p/o_1_1";
+static int g_rate = 10;          /**< requests per second */
+static int g_duration_s = 10;    /**< 0 = until Ctrl-C */
+static int g_window = 16;        /**< outstanding requests */
+static int g_ga = 1;             /**< group address of the s-mode writes */
+static int g_got_entries = 16;   /**< entries per GOT download */
+static int g_page_size = 1;      /**< ps of the paged reads */
+static int g_report_s = 0;       /**< interval of intermediate reports, 0 = end only */
+static int g_soak_s = 0;         /**< interval of the diagnostic samples, 0 = off */
+static bool g_destructive = false; /**< profiles that overwrite the tables are allowed */
+
+static request_slot_t g_slots[MAX_WINDOW];
+static loadgen_stats_t g_stats;
+static oc_clock_time_t g_start_time;
+static oc_clock_time_t g_last_report;
+static oc_clock_time_t g_last_soak;
+static double g_credit = 0;      /**< requests allowed by the rate, not yet sent */
+static uint32_t g_sequence = 0;
+
+static uint32_t
+ticks_to_ms(oc_clock_time_t ticks)
+{
+  return (uint32_t)(ticks * 1000 / OC_CLOCK_SECOND);
+}
+
+static bool
+parse_profiles(const char *list)
+{
+  char buf[100];
+  strncpy(buf, list, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = 0;
+  g_num_profiles = 0;
+  for (char *p = strtok(buf, ","); p != NULL; p = strtok(NULL, ",")) {
+    bool found = false;
+    for (int i = 0; i < (int)(sizeof(g_profile_names) / sizeof(g_profile_names[0])); i++) {
+      if (strcmp(p, g_profile_names[i]) == 0 && g_num_profiles < MAX_PROFILES) {
+        g_profiles[g_num_profiles++] = (loadgen_profile_t)i;
+        found = true;
+      }
+    }
+    if (!found) {
+      PRINT("ERROR: unknown profile '%s'\n", p);
+      return false;
+    }
+  }
+  return g_num_profiles > 0;
+}
+
+static bool
+add_device(const char *address)
+{
+  oc_string_t str;
+  if (g_num_devices >= MAX_DEVICES) {
+    PRINT("ERROR: too many devices, max %d\n", MAX_DEVICES);
+    return false;
+  }
+  oc_new_string(&str, address, strlen(address));
+  int ret = oc_string_to_endpoint(&str, &g_devices[g_num_devices], NULL);
+  oc_free_string(&str);
+  if (ret != 0) {
+    PRINT("ERROR: invalid endpoint '%s'\n", address);
+    return false;
+  }
+  g_num_devices++;
+  return true;
+}
+
+// ===== Statistics =====
+
+static uint32_t
+latency_percentile(const loadgen_stats_t *stats, int percent)
+{
+  uint32_t total = 0;
+  for (int i = 0; i <= MAX_LATENCY_MS; i++) {
+    total += stats->latency_ms[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint32_t target = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+  uint32_t count = 0;
+  for (int i = 0; i <= MAX_LATENCY_MS; i++) {
+    count += stats->latency_ms[i];
+    if (count >= target) {
+      return (uint32_t)i;
+    }
+  }
+  return MAX_LATENCY_MS;
+}
+
+static void
+print_report(void)
+{
+  oc_clock_time_t now = oc_clock_time();
+  uint32_t elapsed_ms = ticks_to_ms(now - g_start_time);
+  double rps = elapsed_ms ? g_stats.received * 1000.0 / elapsed_ms : 0;
+
+  printf("stats,%u,%u,%u,%u,%u,%u,%.1f,%u,%u,%u,%u\n", elapsed_ms / 1000,
+         g_stats.sent, g_stats.received, g_stats.failed, g_stats.timeouts,
+         g_stats.throttled, rps,
+         latency_percentile(&g_stats, 50), latency_percentile(&g_stats, 90),
+         latency_percentile(&g_stats, 99), g_stats.max_ms);
+  for (int i = 0; i < MAX_STATUS; i++) {
+    if (g_stats.status[i]) {
+      printf("status,%u,%d,%u\n", elapsed_ms / 1000, i, g_stats.status[i]);
+    }
+  }
+  fflush(stdout);
+}
+
+// ===== Requests =====
+
+static request_slot_t *
+slot_take(void)
+{
+  for (int i = 0; i < g_window; i++) {
+    if (!g_slots[i].busy) {
+      g_slots[i].busy = true;
+      g_slots[i].start = oc_clock_time();
+      return &g_slots[i];
+    }
+  }
+  return NULL;
+}
+
+static void
+response_handler(oc_client_response_t *data)
+{
+  request_slot_t *slot = (request_slot_t *)data->user_data;
+  if (slot == NULL || !slot->busy) {
+    return;
+  }
+  uint32_t ms = ticks_to_ms(oc_clock_time() - slot->start);
+  slot->busy = false;
+  if (data->code >= __NUM_OC_STATUS_CODES__) {
+    /* OC_REQUEST_TIMEOUT and the like: no response, no latency */
+    g_stats.timeouts++;
+    return;
+  }
+  g_stats.received++;
+  g_stats.latency_ms[ms < MAX_LATENCY_MS ? ms : MAX_LATENCY_MS]++;
+  if (ms > g_stats.max_ms) {
+    g_stats.max_ms = ms;
+  }
+  int code = (int)data->code;
+  g_stats.status[(code >= 0 && code < MAX_STATUS) ? code : MAX_STATUS - 1]++;
+}
+
+static void
+encode_smode(uint32_t sequence)
+{
+  /* { 5: { 6: "w", 7: ga, 1: value } } */
+  oc_rep_begin_root_object();
+  oc_rep_i_set_key(oc_rep_object(root), 5);
+  oc_rep_begin_object(oc_rep_object(root), value);
+  oc_rep_i_set_key(oc_rep_object(value), 6);
+  cbor_encode_text_stringz(oc_rep_object(value), "w");
+  oc_rep_i_set_key(oc_rep_object(value), 7);
+  cbor_encode_int(oc_rep_object(value), g_ga);
+  oc_rep_i_set_key(oc_rep_object(value), 1);
+  cbor_encode_boolean(oc_rep_object(value), sequence & 1);
+  oc_rep_end_object(oc_rep_object(root), value);
+  oc_rep_end_root_object();
+}
+
+static void
+encode_got(uint32_t sequence)
+{
+  /* [ { 0: id, 11: href, 7: [ga], 8: cflags }, ... ] */
+  oc_rep_begin_links_array();
+  for (int i = 0; i < g_got_entries; i++) {
+    oc_rep_begin_object(oc_rep_array(links), obj);
+    oc_rep_i_set_key(oc_rep_object(obj), 0);
+    cbor_encode_int(oc_rep_object(obj), i + 1);
+    oc_rep_i_set_key(oc_rep_object(obj), 11);
+    cbor_encode_text_stringz(oc_rep_object(obj), g_url);
+    oc_rep_i_set_key(oc_rep_object(obj), 7);
+    oc_rep_begin_array(oc_rep_object(obj), ga);
+    oc_rep_add_int(ga, (int64_t)(g_ga + ((sequence + i) % 16)));
+    oc_rep_end_array(oc_rep_object(obj), ga);
+    oc_rep_i_set_key(oc_rep_object(obj), 8);
+    cbor_encode_int(oc_rep_object(obj), 0x14); /* write + transmit */
+    oc_rep_end_object(oc_rep_array(links), obj);
+  }
+  oc_rep_end_links_array();
+}
+
+static bool
+send_request(oc_endpoint_t *device, loadgen_profile_t profile, request_slot_t *slot)
+{
+  char query[30];
+  uint32_t sequence = g_sequence++;
+
+  switch (profile) {
+  case PROFILE_WRITE:
+    if (!oc_init_put(g_url, device, NULL, response_handler, LOW_QOS, slot)) {
+      return false;
+    }
+    oc_rep_begin_root_object();
+    oc_rep_i_set_key(oc_rep_object(root), 1);
+    cbor_encode_boolean(oc_rep_object(root), sequence & 1);
+    oc_rep_end_root_object();
+    return oc_do_put_ex(APPLICATION_CBOR, APPLICATION_CBOR);
+  case PROFILE_SMODE:
+    if (!oc_init_post("/.knx", device, NULL, response_handler, LOW_QOS, slot)) {
+      return false;
+    }
+    encode_smode(sequence);
+    return oc_do_post_ex(APPLICATION_CBOR, APPLICATION_CBOR);
+  case PROFILE_META:
+    return oc_do_get_ex(g_url, device, "m=*", response_handler, LOW_QOS,
+                        APPLICATION_CBOR, APPLICATION_CBOR, slot);
+  case PROFILE_PAGED:
+    snprintf(query, sizeof(query), "pn=%u&ps=%d", sequence % 4, g_page_size);
+    return oc_do_get_ex(g_url, device, query, response_handler, LOW_QOS,
+                        APPLICATION_CBOR, APPLICATION_CBOR, slot);
+  case PROFILE_GOT:
+    if (!oc_init_post("/fp/g", device, NULL, response_handler, HIGH_QOS, slot)) {
+      return false;
+    }
+    encode_got(sequence);
+    return oc_do_post_ex(APPLICATION_CBOR, APPLICATION_CBOR);
+  }
+  return false;
+}
+
+// ===== Soak: diagnostic samples =====
+
+static void
+diag_handler(oc_client_response_t *data)
+{
+  int index = (int)(intptr_t)data->user_data;
+  uint32_t elapsed_s = ticks_to_ms(oc_clock_time() - g_start_time) / 1000;
+
+  printf("diag,%u,%d,%d", elapsed_s, index, (int)data->code);
+  for (oc_rep_t *rep = data->payload; rep != NULL; rep = rep->next) {
+    if (rep->type == OC_REP_INT) {
+      printf(",%s=%lld", oc_string(rep->name), (long long)rep->value.integer);
+    }
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+static void
+sample_diagnostics(void)
+{
+  for (int i = 0; i < g_num_devices; i++) {
+    oc_do_get_ex(URL_DIAG, &g_devices[i], NULL, diag_handler, HIGH_QOS,
+                 APPLICATION_CBOR, APPLICATION_CBOR, (void *)(intptr_t)i);
+  }
+}
+
+// ===== Scheduler =====
+
+static oc_event_callback_retval_t
+tick_cb(void *data)
+{
+  (void)data;
+  oc_clock_time_t now = oc_clock_time();
+
+  if (g_duration_s > 0 && now - g_start_time >= (oc_clock_time_t)g_duration_s * OC_CLOCK_SECOND) {
+    quit = 1;
+    return OC_EVENT_DONE;
+  }
+  /* the rate gives credit each tick, the window limits the requests in flight */
+  g_credit += g_rate * TICK_MS / 1000.0;
+  while (g_credit >= 1) {
+    g_credit -= 1;
+    request_slot_t *slot = slot_take();
+    if (slot == NULL) {
+      g_stats.throttled++;
+      continue;
+    }
+    oc_endpoint_t *device = &g_devices[g_sequence % g_num_devices];
+    loadgen_profile_t profile = g_profiles[g_sequence % g_num_profiles];
+    if (send_request(device, profile, slot)) {
+      g_stats.sent++;
+    } else {
+      slot->busy = false;
+      g_stats.failed++;
+    }
+  }
+  if (g_report_s > 0 && now - g_last_report >= (oc_clock_time_t)g_report_s * OC_CLOCK_SECOND) {
+    g_last_report = now;
+    print_report();
+  }
+  if (g_soak_s > 0 && now - g_last_soak >= (oc_clock_time_t)g_soak_s * OC_CLOCK_SECOND) {
+    g_last_soak = now;
+    sample_diagnostics();
+  }
+  return OC_EVENT_CONTINUE;
+}
+
+static void
+issue_requests(void)
+{
+  g_start_time = oc_clock_time();
+  g_last_report = g_start_time;
+  g_last_soak = g_start_time;
+  printf("stats,elapsed_s,sent,received,failed,timeouts,throttled,rps,p50_ms,p90_ms,p99_ms,max_ms\n");
+  if (g_soak_s > 0) {
+    sample_diagnostics();
+  }
+  oc_set_delayed_callback_ms(NULL, tick_cb, TICK_MS);
+}
+
+// ===== Main =====
+
+static int
+app_init(void)
+{
+  int ret = oc_init_platform("cascoda", NULL, NULL);
+  ret |= oc_add_device("KNX IoT load generator", "1.0.0", "//", "00FA10019999", NULL, NULL);
+  return ret;
+}
+
+static void
+signal_event_loop(void)
+{
+#ifdef WIN32
+  WakeConditionVariable(&cv);
+#endif
+#ifdef __linux__
+  pthread_mutex_lock(&mutex);
+  pthread_cond_signal(&cv);
+  pthread_mutex_unlock(&mutex);
+#endif
+}
+
+static void
+handle_signal(int signal)
+{
+  (void)signal;
+  signal_event_loop();
+  quit = 1;
+}
+
+static void
+print_usage(void)
+{
+  PRINT("Usage:\n");
+  PRINT("-d <endpoint> : target device, e.g. coap://[fe80::1%%eth0]:5683 (repeatable)\n");
+  PRINT("-p <profiles> : comma separated mix of write,smode,meta,paged,got (default smode)\n");
+  PRINT("                got overwrites the group object table, needs -destructive\n");
+  PRINT("-u <url>      : data point url (default /p/o_1_1)\n");
+  PRINT("-r <rate>     : requests per second (default 10)\n");
+  PRINT("-t <seconds>  : duration, 0 = until Ctrl-C (default 10)\n");
+  PRINT("-w <window>   : max outstanding requests (default 16)\n");
+  PRINT("-ga <ga>      : group address of the s-mode writes (default 1)\n");
+  PRINT("-g <entries>  : group object table entries per download (default 16)\n");
+  PRINT("-ps <size>    : page size of the paged reads (default 1)\n");
+  PRINT("-i <seconds>  : interval of intermediate reports (default end only)\n");
+  PRINT("-soak <seconds> : samples " URL_DIAG " of the devices at this interval\n");
+  PRINT("-destructive  : allows the got profile, the table is not restored\n");
+  exit(0);
+}
+
+int
+main(int argc, char *argv[])
+{
+  oc_clock_time_t next_event;
+
+  for (int i = 1; i < argc; i++) {
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(argv[i], "-destructive") == 0) {
+      g_destructive = true;
+      continue;
+    }
+    if (strcmp(argv[i], "-help") == 0 || value == NULL) {
+      print_usage();
+    }
+    if (strcmp(argv[i], "-d") == 0) {
+      if (!add_device(value)) {
+        return 1;
+      }
+    } else if (strcmp(argv[i], "-p") == 0) {
+      if (!parse_profiles(value)) {
+        return 1;
+      }
+    } else if (strcmp(argv[i], "-u") == 0) {
+      g_url = value;
+    } else if (strcmp(argv[i], "-r") == 0) {
+      g_rate = atoi(value);
+    } else if (strcmp(argv[i], "-t") == 0) {
+      g_duration_s = atoi(value);
+    } else if (strcmp(argv[i], "-w") == 0) {
+      g_window = atoi(value);
+    } else if (strcmp(argv[i], "-ga") == 0) {
+      g_ga = atoi(value);
+    } else if (strcmp(argv[i], "-g") == 0) {
+      g_got_entries = atoi(value);
+    } else if (strcmp(argv[i], "-ps") == 0) {
+      g_page_size = atoi(value);
+    } else if (strcmp(argv[i], "-i") == 0) {
+      g_report_s = atoi(value);
+    } else if (strcmp(argv[i], "-soak") == 0) {
+      g_soak_s = atoi(value);
+    } else {
+      print_usage();
+    }
+    i++;
+  }
+  if (g_num_devices == 0) {
+    print_usage();
+  }
+  if (g_num_profiles == 0) {
+    parse_profiles("smode");
+  }
+  for (int i = 0; i < g_num_profiles; i++) {
+    if (g_profiles[i] == PROFILE_GOT && !g_destructive) {
+      PRINT("ERROR: the got profile overwrites the group object table of the devices,"
+            " add -destructive to run it\n");
+      return 1;
+    }
+  }
+  if (g_window < 1 || g_window > MAX_WINDOW) {
+    g_window = MAX_WINDOW;
+  }
+  if (g_rate < 1) {
+    g_rate = 1;
+  }
+
+#ifdef WIN32
+  InitializeCriticalSection(&cs);
+  InitializeConditionVariable(&cv);
+  signal(SIGINT, handle_signal);
+#endif
+#ifdef __linux__
+  struct sigaction sa;
+  sigfillset(&sa.sa_mask);
+  sa.sa_flags = 0;
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+#endif
+
+  static oc_handler_t handler = { .init = app_init,
+                                  .signal_event_loop = signal_event_loop,
+                                  .register_resources = NULL,
+                                  .requests_entry = issue_requests };
+  oc_storage_config("./knx_iot_loadgen_creds");
+  if (oc_main_init(&handler) < 0) {
+    PRINT("oc_main_init failed, exiting.\n");
+    return 1;
+  }
+
+#ifdef WIN32
+  while (quit != 1) {
+    next_event = oc_main_poll();
+    if (next_event == 0) {
+      SleepConditionVariableCS(&cv, &cs, INFINITE);
+    } else {
+      oc_clock_time_t now = oc_clock_time();
+      if (now < next_event) {
+        SleepConditionVariableCS(
+          &cv, &cs, (DWORD)((next_event - now) * 1000 / OC_CLOCK_SECOND));
+      }
+    }
+  }
+#endif
+#ifdef __linux__
+  while (quit != 1) {
+    next_event = oc_main_poll();
+    pthread_mutex_lock(&mutex);
+    if (next_event == 0) {
+      pthread_cond_wait(&cv, &mutex);
+    } else {
+      ts.tv_sec = (next_event / OC_CLOCK_SECOND);
+      ts.tv_nsec = (next_event % OC_CLOCK_SECOND) * 1.e09 / OC_CLOCK_SECOND;
+      pthread_cond_timedwait(&cv, &mutex, &ts);
+    }
+    pthread_mutex_unlock(&mutex);
+  }
+#endif
+
+  print_report();
+  oc_main_shutdown();
+  return 0;
+}